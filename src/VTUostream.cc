@@ -50,6 +50,63 @@ VTUostream::VTUostream ( std::ostream& o ) : m_os ( &o ), D ( WALL_RELATIVE_THIC
     header();
 }
 //-----------------------------------------------------------------------------
+
+void VTUostream::set_cells ( std::vector<size_t> const& cells )
+{
+    m_cells = cells;
+}
+//-----------------------------------------------------------------------------
+
+std::vector<Cell const*> VTUostream::out_cells ( Tissue const& t ) const
+{
+    std::vector<Cell const*> cells;
+    if ( m_cells.empty() )
+    {
+        cells.reserve ( t.numCell() );
+        for ( size_t i = 0; i < t.numCell(); ++i )
+            cells.push_back ( &t.cell ( i ) );
+    }
+    else
+    {
+        cells.reserve ( m_cells.size() );
+        for ( size_t i = 0; i < m_cells.size(); ++i )
+            cells.push_back ( &t.cell ( m_cells[i] ) );
+    }
+    return cells;
+}
+//-----------------------------------------------------------------------------
+
+std::vector<int> VTUostream::out_wall_vertices ( Tissue const& t, std::vector<size_t>& points ) const
+{
+    std::vector<int> local_index ( t.numVertex(), -1 );
+    points.clear();
+    if ( m_cells.empty() )
+    {
+        points.reserve ( t.numVertex() );
+        for ( size_t i = 0; i < t.numVertex(); ++i )
+            points.push_back ( i );
+    }
+    else
+    {
+        std::vector<char> used ( t.numVertex(), 0 );
+        for ( size_t i = 0; i < m_cells.size(); ++i )
+        {
+            Cell const& c = t.cell ( m_cells[i] );
+            for ( size_t k = 0; k < c.numWall(); ++k )
+            {
+                used[c.wall ( k )->vertex1()->index()] = 1;
+                used[c.wall ( k )->vertex2()->index()] = 1;
+            }
+        }
+        for ( size_t i = 0; i < t.numVertex(); ++i )
+            if ( used[i] )
+                points.push_back ( i );
+    }
+    for ( size_t i = 0; i < points.size(); ++i )
+        local_index[points[i]] = i;
+    return local_index;
+}
+//-----------------------------------------------------------------------------
 //BEGIN cell and wall geometry for walls as line segments
 void VTUostream::write_cells ( Tissue const& t )
 {
@@ -130,7 +187,7 @@ void VTUostream::write_cell_geometry ( Tissue const& t, Cell_type ct )
     {
         // this part relays on the experimental 'unordered_set' but does not assume that vertices are cyclically ordered vertices in the cell
         //     typedef std::vector<Wall*>::const_iterator WallIter;
-        //     std::vector<Wall*> const& walls = cit->wall();
+        //     Cell::WallList const& walls = cit->wall();
         //     std::unordered_set<size_t> indices;
         //     typedef std::unordered_set<size_t>::iterator IndexIter;
         //     WallIter wit, wend;
@@ -157,8 +214,8 @@ void VTUostream::write_cell_geometry ( Tissue const& t, Cell_type ct )
         //     }
         //     *m_os << "\n";
         // this part needs cyclically ordered vertices in the cell
-        typedef std::vector<Vertex*>::const_iterator CVIter;
-        std::vector<Vertex*> const& verts = cit->vertex();
+        typedef Cell::VertexList::const_iterator CVIter;
+        Cell::VertexList const& verts = cit->vertex();
         CVIter cviter, cvend;
         for ( cviter = verts.begin(), cvend = verts.end(); cviter != cvend; ++cviter )
         {
@@ -200,8 +257,8 @@ void VTUostream::write_wall_point_geometry ( Tissue const& t )
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
         Cell &c = const_cast<Cell&> ( *cit );
-        typedef std::vector<Wall*>::const_iterator WallIter;
-        std::vector<Wall*> const& walls = c.wall();
+        typedef Cell::WallList::const_iterator WallIter;
+        Cell::WallList const& walls = c.wall();
 
         std::vector<double> cent ( 3 );
         cent = c.positionFromVertex();
@@ -323,20 +380,20 @@ void VTUostream::write_wall_geometry ( Tissue const& t )
 //BEGIN cell and wall geometry for 2D walls
 void VTUostream::write_cells2 ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     int npts = 0;
     CellIter cit, cend;
     bool triangles = true;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        int nvrt = cit->numVertex();
+        int nvrt = ( *cit )->numVertex();
         if ( nvrt != 3 )
             triangles = false;
         npts += nvrt;
     }
 
-    write_piece_header ( npts, t.numCell() );
+    write_piece_header ( npts, cells.size() );
     write_cell_point_geometry2 ( t );
     if ( triangles )
         write_cell_geometry2 ( t, VTUostream::TRIANGLE );
@@ -354,19 +411,21 @@ void VTUostream::write_cells2 ( Tissue const& t )
 // single walls
 void VTUostream::write_walls2 ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     int ncell = 0;
     CellIter cit, cend;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
-        ncell += cit->numWall();
+        ncell += ( *cit )->numWall();
     ;
     std::vector<Vertex*> verts;
     verts.reserve ( t.numWall() *2 );
+    std::vector<size_t> points;
+    std::vector<int> const local_index = out_wall_vertices ( t, points );
 
-    write_piece_header ( t.numVertex() + ncell, ncell );
-    write_wall_point_geometry2 ( t, verts );
-    write_wall_geometry2 ( t, verts );
+    write_piece_header ( points.size() + ncell, ncell );
+    write_wall_point_geometry2 ( t, verts, points );
+    write_wall_geometry2 ( t, verts, local_index, points.size() );
     write_wall_data_header ( "Scalars=\"wall variable 0\"" );
     write_wall_data ( t );
     write_wall_data_footer();
@@ -376,18 +435,20 @@ void VTUostream::write_walls2 ( Tissue const& t )
 // double walls
 void VTUostream::write_walls3 ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     int ncell = 0;
     CellIter cit, cend;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
-        ncell += cit->numWall();
+        ncell += ( *cit )->numWall();
 
     std::vector<Vertex*> verts;
     verts.reserve ( t.numWall() *2 );
-    write_piece_header ( t.numVertex() + ncell, ncell );
-    write_wall_point_geometry2 ( t, verts );
-    write_wall_geometry2 ( t, verts );
+    std::vector<size_t> points;
+    std::vector<int> const local_index = out_wall_vertices ( t, points );
+    write_piece_header ( points.size() + ncell, ncell );
+    write_wall_point_geometry2 ( t, verts, points );
+    write_wall_geometry2 ( t, verts, local_index, points.size() );
     write_wall_data_header ( "Scalars=\"wall variable 0\"" );
     //  std::cout << "write_wall data2\n";
     write_wall_data2 ( t );
@@ -397,25 +458,25 @@ void VTUostream::write_walls3 ( Tissue const& t )
 //-----------------------------------------------------------------------------
 void VTUostream::write_cell_point_geometry2 ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
 
     *m_os << "<Points>\n"
           << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"ascii\">\n";
     CellIter cit, cend;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
 	//HJ: removed due to unused variable warning
         //typedef std::vector<Wall*>::const_iterator WallIter;
-        //std::vector<Wall*> const& walls = c.wall();
+        //Cell::WallList const& walls = c.wall();
 
         std::vector<double> cent ( 3 );
         cent = c.positionFromVertex();
         Point center ( cent[0], cent[1], cent[2] );
 
-        typedef std::vector<Vertex*>::const_iterator CVIter;
-        std::vector<Vertex*> const& verts = c.vertex();
+        typedef Cell::VertexList::const_iterator CVIter;
+        Cell::VertexList const& verts = c.vertex();
         CVIter cviter, cvend;
         for ( cviter = verts.begin(), cvend = verts.end(); cviter != cvend; ++cviter )
         {
@@ -429,8 +490,8 @@ void VTUostream::write_cell_point_geometry2 ( Tissue const& t )
 //-----------------------------------------------------------------------------
 void VTUostream::write_cell_geometry2 ( Tissue const& t, Cell_type ct )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
 
     *m_os << "<Cells>\n"
           << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
@@ -438,7 +499,7 @@ void VTUostream::write_cell_geometry2 ( Tissue const& t, Cell_type ct )
     int count = 0;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        int nverts = cit->numVertex();
+        int nverts = ( *cit )->numVertex();
         for ( int i = 0; i < nverts; ++i, ++count )
         {
             *m_os << count << " ";
@@ -451,14 +512,14 @@ void VTUostream::write_cell_geometry2 ( Tissue const& t, Cell_type ct )
     int total_offset = 0;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        total_offset += cit->numVertex();
+        total_offset += ( *cit )->numVertex();
         *m_os << total_offset << " ";
     }
     *m_os << "\n"
 
           << "</DataArray>\n"
           << "<DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">\n";
-    for ( size_t i = 0; i < t.numCell(); ++i )
+    for ( size_t i = 0; i < cells.size(); ++i )
     {
         *m_os << ct << " ";
     }
@@ -467,19 +528,16 @@ void VTUostream::write_cell_geometry2 ( Tissue const& t, Cell_type ct )
           << "</Cells>\n";
 }
 //-----------------------------------------------------------------------------
-void VTUostream::write_wall_point_geometry2 ( Tissue const& t, std::vector<Vertex*> &verts )
+void VTUostream::write_wall_point_geometry2 ( Tissue const& t, std::vector<Vertex*> &verts, std::vector<size_t> const& points )
 {
-    //write all the vertices first in the order of their indices
-    typedef std::vector<Vertex>::const_iterator VertexIter;
-    std::vector<Vertex> const& vertices = t.vertex();
-
-    VertexIter viter, vend;
+    //write the vertices of the walls first in the order of their indices
     *m_os << "<Points>\n"
           << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for ( viter = vertices.begin(), vend = vertices.end(); viter != vend; ++viter )
+    for ( size_t i = 0; i < points.size(); ++i )
     {
-        std::vector<double> const& p = viter->position();
-        size_t npos = viter->numPosition();
+        Vertex const& v = t.vertex ( points[i] );
+        std::vector<double> const& p = v.position();
+        size_t npos = v.numPosition();
         for ( size_t j = 0; j < npos; ++j )
             *m_os << p[j] << " ";
         if ( npos < 3 )
@@ -488,15 +546,15 @@ void VTUostream::write_wall_point_geometry2 ( Tissue const& t, std::vector<Verte
     }
 
     //write the displaced vertices of each cell
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
 
     CellIter cit, cend;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
-        typedef std::vector<Wall*>::const_iterator WallIter;
-        std::vector<Wall*> const& walls = c.wall();
+        Cell &c = const_cast<Cell&> ( **cit );
+        typedef Cell::WallList::const_iterator WallIter;
+        Cell::WallList const& walls = c.wall();
 
         WallIter wit, wend;
         wit = walls.begin();
@@ -558,12 +616,12 @@ void VTUostream::write_wall_point_geometry2 ( Tissue const& t, std::vector<Verte
     VertexPIter vpit = verts.begin(); //, vpend = verts.end();
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         std::vector<double> cent ( 3 );
         cent = c.positionFromVertex();
         Point center ( cent[0], cent[1], cent[2] );
         
-        int nwall = cit->numWall();
+        int nwall = ( *cit )->numWall();
         for ( int i = 0; i < nwall; ++i )
 
         {
@@ -575,27 +633,27 @@ void VTUostream::write_wall_point_geometry2 ( Tissue const& t, std::vector<Verte
           << "</Points>\n";
 }
 //-----------------------------------------------------------------------------
-void VTUostream::write_wall_geometry2 ( Tissue const& t, std::vector<Vertex*> const& verts )
+void VTUostream::write_wall_geometry2 ( Tissue const& t, std::vector<Vertex*> const& verts, std::vector<int> const& local_index, size_t offset )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     *m_os << "<Cells>\n"
           << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    int count = 0, offset = t.numVertex();
+    int count = 0;
     //construct quad walls by ordering vertices circularly: first 2 original verices of the wall then 2 displaced vertices
     std::vector<Vertex*> ::const_iterator vit = verts.begin(), vstart; //, vend = verts.end();
     CellIter cit, cend;
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
         vstart = vit;
-        int nwall = cit->numWall() - 1, temp = offset + count;
+        int nwall = ( *cit )->numWall() - 1, temp = offset + count;
         for ( int i = 0; i < nwall; ++i )
         {
-            *m_os << ( *vit++ )->index() << " ";
-            *m_os << ( *vit )->index() << " " << temp + i + 1 << " " << temp + i << " ";
+            *m_os << local_index[( *vit++ )->index()] << " ";
+            *m_os << local_index[( *vit )->index()] << " " << temp + i + 1 << " " << temp + i << " ";
         }
-        *m_os << ( *vit++ )->index() << " " << ( *vstart )->index() << " " << temp << " " << temp + nwall << " ";
-        count += cit->numWall();
+        *m_os << local_index[( *vit++ )->index()] << " " << local_index[( *vstart )->index()] << " " << temp << " " << temp + nwall << " ";
+        count += ( *cit )->numWall();
     }
     *m_os << "\n";
     *m_os << "</DataArray>\n"
@@ -727,9 +785,9 @@ void VTUostream::write_cell_point_geometry3 ( Tissue const& t, std::vector<Point
     {
         Cell &c = const_cast<Cell&> ( *cit );
         std::vector<double> cent ( 3 );
-        typedef std::vector<Vertex*>::const_iterator CVIter;
-        std::vector<Vertex*> const& verts = c.vertex();
-        CVIter cviter, cvend, cvprev = --verts.end(), cvnext = verts.begin();
+        typedef Cell::VertexList::const_iterator CVIter;
+        Cell::VertexList const& verts = c.vertex();
+        CVIter cviter, cvend, cvprev = verts.end()-1, cvnext = verts.begin();
         for ( cviter = verts.begin(), cvend = verts.end(); cviter != cvend; ++cviter )
         {
             ++cvnext;
@@ -821,7 +879,7 @@ std::pair<size_t, size_t> VTUostream::prepare_wall_point_geometry3 ( Tissue cons
     {
         Cell &c = const_cast<Cell&> ( *cit );
         //count the walls that need displacement
-        typedef std::vector<Wall*>::const_iterator CWIter;
+        typedef Cell::WallList::const_iterator CWIter;
         CWIter cwiter, cwend;
         for ( cwiter = c.wall().begin(), cwend = c.wall().end(); cwiter != cwend; ++cwiter )
         {
@@ -831,9 +889,9 @@ std::pair<size_t, size_t> VTUostream::prepare_wall_point_geometry3 ( Tissue cons
                 ++counter;
         }
         //displace vertices of these walls
-        typedef std::vector<Vertex*>::const_iterator CVIter;
-        std::vector<Vertex*> const& verts = c.vertex();
-        CVIter cviter, cvend, cvprev = --verts.end(), cvnext = verts.begin();
+        typedef Cell::VertexList::const_iterator CVIter;
+        Cell::VertexList const& verts = c.vertex();
+        CVIter cviter, cvend, cvprev = verts.end()-1, cvnext = verts.begin();
         for ( cviter = verts.begin(), cvend = verts.end(); cviter != cvend; ++cviter )
         {
             ++cvnext;
@@ -924,7 +982,7 @@ void VTUostream::write_outer_wall_geometry3 ( Tissue const& t, std::vector<uint>
     {
         Cell &c = const_cast<Cell&> ( *cit );
 
-        typedef std::vector<Wall*>::const_iterator CWIter;
+        typedef Cell::WallList::const_iterator CWIter;
         CWIter cwiter, cwend;
         for ( cwiter = c.wall().begin(), cwend = c.wall().end(); cwiter != cwend; ++cwiter )
         {
@@ -1017,7 +1075,7 @@ void VTUostream::write_inner_wall_geometry3 ( Tissue const& t, std::vector<uint>
     {
         Cell &c = const_cast<Cell&> ( *cit );
 
-        typedef std::vector<Wall*>::const_iterator CWIter;
+        typedef Cell::WallList::const_iterator CWIter;
         CWIter cwiter, cwend;
         for ( cwiter = c.wall().begin(), cwend = c.wall().end(); cwiter != cwend; ++cwiter )
         {
@@ -1104,6 +1162,11 @@ void VTUostream::write_cell_data ( Tissue const& t )
 
     CellIter cit = cells.begin(), cend;
     int nvars = cit->numVariable();
+    //write the stable cell identities (unchanged by renumbering)
+    *m_os << "<DataArray type=\"Int32\" Name=\"cell id\" format=\"ascii\">\n";
+    for ( size_t i = 0; i < cells.size(); ++i )
+        *m_os << t.cellStableId ( i ) << " ";
+    *m_os << "\n" << "</DataArray>\n";
     //write a cell vector data assuming first 3 cell variables are vector components and 4th is a length
     *m_os << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" Name=\"cell vector\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
@@ -1135,11 +1198,16 @@ void VTUostream::write_cell_data ( Tissue const& t )
 //----------------------------------------------------------for having 3 cell vectors
 void VTUostream::write_cell_data3V ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
 
     CellIter cit = cells.begin(), cend;
-    int nvars = cit->numVariable();
+    int nvars = ( *cit )->numVariable();
+    //write the stable cell identities (unchanged by renumbering)
+    *m_os << "<DataArray type=\"Int32\" Name=\"cell id\" format=\"ascii\">\n";
+    for ( size_t i = 0; i < cells.size(); ++i )
+        *m_os << t.cellStableId ( cells[i]->index() ) << " ";
+    *m_os << "\n" << "</DataArray>\n";
     //write 3 cell vector data assuming 
     // 0,1,2 cell variables are 1st vector components and 3 is a length
     // 4,5,6 cell variables are 1st vector components and 7 is a length
@@ -1147,14 +1215,14 @@ void VTUostream::write_cell_data3V ( Tissue const& t )
     *m_os << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" Name=\"cell vector1\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 0 ) << " " << c.variable ( 1 ) << " " << c.variable ( 2 ) << "\n";
     }
     *m_os << "</DataArray>\n";
     *m_os << "<DataArray type=\"Float64\" Name=\"cell vector1 length\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 3 ) << " ";
     }
     *m_os << "\n"<< "</DataArray>\n";
@@ -1162,14 +1230,14 @@ void VTUostream::write_cell_data3V ( Tissue const& t )
     *m_os << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" Name=\"cell vector2\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 4 ) << " " << c.variable ( 5 ) << " " << c.variable ( 6 ) << "\n";
     }
     *m_os << "</DataArray>\n";
     *m_os << "<DataArray type=\"Float64\" Name=\"cell vector2 length\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 7 ) << " ";
     }
     *m_os << "\n"<< "</DataArray>\n";
@@ -1177,14 +1245,14 @@ void VTUostream::write_cell_data3V ( Tissue const& t )
     *m_os << "<DataArray type=\"Float64\" NumberOfComponents=\"3\" Name=\"cell vector3\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 8 ) << " " << c.variable ( 9 ) << " " << c.variable ( 10 ) << "\n";
     }
     *m_os << "</DataArray>\n";
     *m_os << "<DataArray type=\"Float64\" Name=\"cell vector3 length\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
+        Cell &c = const_cast<Cell&> ( **cit );
         *m_os << c.variable ( 11 ) << " ";
     }
     *m_os << "\n"<< "</DataArray>\n";
@@ -1195,7 +1263,7 @@ void VTUostream::write_cell_data3V ( Tissue const& t )
         *m_os << "<DataArray type=\"Float64\" Name=\"cell variable " << i << "\" format=\"ascii\">\n";
         for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
         {
-            Cell &c = const_cast<Cell&> ( *cit );
+            Cell &c = const_cast<Cell&> ( **cit );
             *m_os << c.variable ( i ) << " ";
         }
         *m_os << "\n"
@@ -1205,18 +1273,18 @@ void VTUostream::write_cell_data3V ( Tissue const& t )
 //-----------------------------------------------------------------------------
 void VTUostream::write_wall_data ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     CellIter cit = cells.begin(), cend;
-    Cell &c = const_cast<Cell&> ( *cit );
+    Cell &c = const_cast<Cell&> ( **cit );
 
     //Print wall lengths
     *m_os << "<DataArray type=\"Float64\" Name=\"wall length\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
-        typedef std::vector<Wall*>::const_iterator WallIter;
-        std::vector<Wall*> const& walls = c.wall();
+        Cell &c = const_cast<Cell&> ( **cit );
+        typedef Cell::WallList::const_iterator WallIter;
+        Cell::WallList const& walls = c.wall();
         WallIter wit, wend;
         for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
         {
@@ -1234,9 +1302,9 @@ void VTUostream::write_wall_data ( Tissue const& t )
         *m_os << "<DataArray type=\"Float64\" Name=\"wall variable " << i << "\" format=\"ascii\">\n";
         for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
         {
-            Cell &c = const_cast<Cell&> ( *cit );
-            typedef std::vector<Wall*>::const_iterator WallIter;
-            std::vector<Wall*> const& walls = c.wall();
+            Cell &c = const_cast<Cell&> ( **cit );
+            typedef Cell::WallList::const_iterator WallIter;
+            Cell::WallList const& walls = c.wall();
             WallIter wit, wend;
             for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
             {
@@ -1251,17 +1319,17 @@ void VTUostream::write_wall_data ( Tissue const& t )
 //-----------------------------------------------------------------------------
 void VTUostream::write_wall_data2 ( Tissue const& t )
 {
-    typedef std::vector<Cell>::const_iterator CellIter;
-    std::vector<Cell> const& cells = t.cell();
+    typedef std::vector<Cell const*>::const_iterator CellIter;
+    std::vector<Cell const*> const cells = out_cells ( t );
     CellIter cit = cells.begin(), cend;
-    Cell &c = const_cast<Cell&> ( *cit );
+    Cell &c = const_cast<Cell&> ( **cit );
     //Print wall lengths
     *m_os << "<DataArray type=\"Float64\" Name=\"wall length\" format=\"ascii\">\n";
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
-        Cell &c = const_cast<Cell&> ( *cit );
-        typedef std::vector<Wall*>::const_iterator WallIter;
-        std::vector<Wall*> const& walls = c.wall();
+        Cell &c = const_cast<Cell&> ( **cit );
+        typedef Cell::WallList::const_iterator WallIter;
+        Cell::WallList const& walls = c.wall();
         WallIter wit, wend;
         for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
         {
@@ -1285,10 +1353,10 @@ void VTUostream::write_wall_data2 ( Tissue const& t )
         *m_os << "<DataArray type=\"Float64\" Name=\"wall variable " << i/2 << "\" format=\"ascii\">\n";
         for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
         {
-            Cell &c = const_cast<Cell&> ( *cit );
+            Cell &c = const_cast<Cell&> ( **cit );
             size_t c_id = c.index();
-            typedef std::vector<Wall*>::const_iterator WallIter;
-            std::vector<Wall*> const& walls = c.wall();
+            typedef Cell::WallList::const_iterator WallIter;
+            Cell::WallList const& walls = c.wall();
             WallIter wit, wend;
             for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
             {
@@ -1326,8 +1394,8 @@ void VTUostream::write_wall_data3 ( Tissue const& t, size_t flag_pos, double fla
     for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
     {
         Cell &c = const_cast<Cell&> ( *cit );
-        typedef std::vector<Wall*>::const_iterator WallIter;
-        std::vector<Wall*> const& walls = c.wall();
+        typedef Cell::WallList::const_iterator WallIter;
+        Cell::WallList const& walls = c.wall();
         WallIter wit, wend;
         for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
         {
@@ -1355,8 +1423,8 @@ void VTUostream::write_wall_data3 ( Tissue const& t, size_t flag_pos, double fla
         {
             Cell &c = const_cast<Cell&> ( *cit );
             size_t c_id = c.index();
-            typedef std::vector<Wall*>::const_iterator WallIter;
-            std::vector<Wall*> const& walls = c.wall();
+            typedef Cell::WallList::const_iterator WallIter;
+            Cell::WallList const& walls = c.wall();
             WallIter wit, wend;
             for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
             {
@@ -1393,8 +1461,8 @@ void VTUostream::write_wall_data3 ( Tissue const& t, size_t flag_pos, double fla
         for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
         {
             Cell &c = const_cast<Cell&> ( *cit );
-            typedef std::vector<Wall*>::const_iterator WallIter;
-            std::vector<Wall*> const& walls = c.wall();
+            typedef Cell::WallList::const_iterator WallIter;
+            Cell::WallList const& walls = c.wall();
             WallIter wit, wend;
             for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
             {
@@ -1409,8 +1477,8 @@ void VTUostream::write_wall_data3 ( Tissue const& t, size_t flag_pos, double fla
         for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
         {
             Cell &c = const_cast<Cell&> ( *cit );
-            typedef std::vector<Wall*>::const_iterator WallIter;
-            std::vector<Wall*> const& walls = c.wall();
+            typedef Cell::WallList::const_iterator WallIter;
+            Cell::WallList const& walls = c.wall();
             WallIter wit, wend;
             for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
             {
@@ -1429,8 +1497,8 @@ void VTUostream::write_wall_data3 ( Tissue const& t, size_t flag_pos, double fla
             for ( cit = cells.begin(), cend = cells.end(); cit != cend; ++cit )
             {
                 Cell &c = const_cast<Cell&> ( *cit );
-                typedef std::vector<Wall*>::const_iterator WallIter;
-                std::vector<Wall*> const& walls = c.wall();
+                typedef Cell::WallList::const_iterator WallIter;
+                Cell::WallList const& walls = c.wall();
                 WallIter wit, wend;
                 for ( wit = walls.begin(), wend = walls.end(); wit != wend; ++wit )
                 {
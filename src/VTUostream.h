@@ -10,6 +10,7 @@
 #include <vector>
 #include <map>
 class Tissue;
+class Cell;
 class Vertex;
 //-----------------------------------------------------------------------------
 namespace IO
@@ -123,6 +124,10 @@ public:
   {
     return m_os->width(wide);
   }
+  /// @brief Restricts write_cells2, write_walls2 and write_walls3 to the given
+  /// cell indices, e.g. for writing one piece of a partitioned tissue (an
+  /// empty list writes all cells)
+  void set_cells(std::vector<size_t> const& cells);
   /// @brief Write cells using geometry directly from tissue without making room for the walls display
   void write_cells(Tissue const& t);
   /// @brief Write cells with shrinked geometry leaving space for walls display
@@ -150,8 +155,8 @@ protected:
   // cell and wall geometry for 2D walls
   void write_cell_point_geometry2(Tissue const& t);
   void write_cell_geometry2(Tissue const& t, Cell_type ct = POLYGON);
-  void write_wall_point_geometry2(Tissue const& t, std::vector<Vertex*> & verts);
-  void write_wall_geometry2(Tissue const& t, std::vector<Vertex*> const& verts);
+  void write_wall_point_geometry2(Tissue const& t, std::vector<Vertex*> & verts, std::vector<size_t> const& points);
+  void write_wall_geometry2(Tissue const& t, std::vector<Vertex*> const& verts, std::vector<int> const& local_index, size_t offset);
   // cell and wall geometry for 2D walls printing inner and outer cell walls separately based on the flag in the last wall variable
   void write_cell_point_geometry3(Tissue const& t, std::vector<IO::Point>& disp_points, std::vector<char>& vertex_flag, std::vector< std::map<size_t,size_t> >& cvp_map, size_t flag_pos);
   void write_cell_geometry3(Tissue const& t, Cell_type ct = POLYGON);
@@ -161,6 +166,12 @@ protected:
   void write_outer_wall_geometry3 ( Tissue const& t, std::vector<uint>& index_map, std::vector< std::map<size_t,size_t> >& cvp_map, size_t offset, size_t flag_pos, double flag_val );
   void write_inner_wall_point_geometry3 ( Tissue const& t, std::vector<char>& vertex_flag, std::vector<uint>& index_map, size_t counter );
   void write_inner_wall_geometry3( Tissue const& t, std::vector<uint>& index_map, size_t flag_pos, double flag_val );
+  /// @brief The cells written, in output order (all cells if no subset is set)
+  std::vector<Cell const*> out_cells(Tissue const& t) const;
+  /// @brief The vertices of the walls of the written cells in index order
+  /// (all vertices if no subset is set), returning their local (point)
+  /// index for each tissue vertex (-1 if not written)
+  std::vector<int> out_wall_vertices(Tissue const& t, std::vector<size_t>& points) const;
   void write_piece_header(int n_pts, int n_cell);
   void write_piece_footer();
 
@@ -203,6 +214,7 @@ protected:
   //    std::ios::pos_type mark;
   std::ostream* m_os;
   const double D;
+  std::vector<size_t> m_cells;
 };
 //-----------------------------------------------------------------------------
 inline VTUostream& operator<<(VTUostream& os, const char* s)
@@ -9,6 +9,7 @@
 #include"adhocReaction.h"
 #include"tissue.h"
 #include"baseReaction.h"
+#include"reactionSchedule.h"
 #include<cmath>
 #include<cstdlib>
 #include<ctime>
@@ -2080,6 +2081,12 @@ derivs(Tissue &T,
   }  
 }
 
+void diffusion3D::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 VertexTranslateToMax::
 VertexTranslateToMax(std::vector<double> &paraValue, 
 		     std::vector< std::vector<size_t> > 
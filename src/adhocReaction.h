@@ -539,6 +539,12 @@ public:
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 private:
    
   std::vector< std::vector<double> > Cells3d; //holds the wall_indices and neighbohrhood info
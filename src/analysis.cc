@@ -0,0 +1,287 @@
+//
+// Filename     : analysis.cc
+// Description  : In-situ reductions of the tissue state written at print times
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <cmath>
+#include <cstdlib>
+#include "analysis.h"
+#include "baseReaction.h"
+#include "tissue.h"
+
+namespace {
+  void checkCellVariable(const DataMatrix &cellData,size_t variable,
+			 const std::string &name)
+  {
+    for( size_t i=0 ; i<cellData.size() ; ++i )
+      if( variable>=cellData[i].size() ) {
+	std::cerr << name << "::compute() Cell variable " << variable
+		  << " out of range." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+  }
+}
+
+Reduction::~Reduction()
+{
+}
+
+Reduction* Reduction::createReduction(std::istream &IN)
+{
+  std::string idValue;
+  IN >> idValue;
+  if( idValue=="NumCell" )
+    return new NumCell();
+  else if( idValue=="TotalVolume" )
+    return new TotalVolume();
+  else if( idValue=="CellStatistics" )
+    return new CellStatistics(IN);
+  else if( idValue=="CellHistogram" )
+    return new CellHistogram(IN);
+  else if( idValue=="CellMeanByType" )
+    return new CellMeanByType(IN);
+  else if( idValue=="CellValue" )
+    return new CellValue(IN);
+  else if( idValue=="VertexValue" )
+    return new VertexValue(IN);
+  else if( idValue=="ReactionParameter" )
+    return new ReactionParameter(IN);
+  std::cerr << "Reduction::createReduction() Unknown reduction: " << idValue
+	    << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+void NumCell::header(std::ostream &os) const
+{
+  os << " numCell";
+}
+
+void NumCell::compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+		      DataMatrix &vertexData,std::vector<double> &value) const
+{
+  value.push_back( cellData.size() );
+}
+
+void TotalVolume::header(std::ostream &os) const
+{
+  os << " volume";
+}
+
+void TotalVolume::compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+			  DataMatrix &vertexData,std::vector<double> &value) const
+{
+  double volume=0.0;
+  for( size_t i=0 ; i<T.numCell() ; ++i )
+    volume += T.cell(i).calculateVolume(vertexData);
+  value.push_back(volume);
+}
+
+CellStatistics::CellStatistics(std::istream &IN)
+{
+  IN >> variable_;
+}
+
+void CellStatistics::header(std::ostream &os) const
+{
+  os << " mean(" << variable_ << ") std(" << variable_ << ") min("
+     << variable_ << ") max(" << variable_ << ")";
+}
+
+void CellStatistics::compute(Tissue &T,DataMatrix &cellData,
+			     DataMatrix &wallData,DataMatrix &vertexData,
+			     std::vector<double> &value) const
+{
+  checkCellVariable(cellData,variable_,"CellStatistics");
+  size_t numCell = cellData.size();
+  double sum=0.0, sum2=0.0, min=0.0, max=0.0;
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    double v = cellData[i][variable_];
+    sum += v;
+    sum2 += v*v;
+    if( i==0 || v<min )
+      min = v;
+    if( i==0 || v>max )
+      max = v;
+  }
+  double mean = numCell ? sum/numCell : 0.0;
+  double var = numCell ? sum2/numCell-mean*mean : 0.0;
+  value.push_back(mean);
+  value.push_back( std::sqrt(var>0.0 ? var : 0.0) );
+  value.push_back(min);
+  value.push_back(max);
+}
+
+CellHistogram::CellHistogram(std::istream &IN)
+{
+  IN >> variable_ >> min_ >> max_ >> numBin_;
+  if( !numBin_ || !(max_>min_) ) {
+    std::cerr << "CellHistogram::CellHistogram() Needs numBin>0 and max>min."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void CellHistogram::header(std::ostream &os) const
+{
+  double width = (max_-min_)/numBin_;
+  for( size_t b=0 ; b<numBin_ ; ++b )
+    os << " hist(" << variable_ << ";" << min_+b*width << ")";
+}
+
+void CellHistogram::compute(Tissue &T,DataMatrix &cellData,
+			    DataMatrix &wallData,DataMatrix &vertexData,
+			    std::vector<double> &value) const
+{
+  checkCellVariable(cellData,variable_,"CellHistogram");
+  std::vector<double> count(numBin_,0.0);
+  for( size_t i=0 ; i<cellData.size() ; ++i ) {
+    double x = (cellData[i][variable_]-min_)/(max_-min_)*numBin_;
+    size_t b = x<0.0 ? 0 : static_cast<size_t>(x);
+    if( b>=numBin_ )
+      b = numBin_-1;
+    count[b] += 1.0;
+  }
+  value.insert(value.end(),count.begin(),count.end());
+}
+
+CellMeanByType::CellMeanByType(std::istream &IN)
+{
+  IN >> variable_ >> typeVariable_ >> numType_;
+}
+
+void CellMeanByType::header(std::ostream &os) const
+{
+  for( size_t k=0 ; k<numType_ ; ++k )
+    os << " mean(" << variable_ << ";type" << k << ")";
+}
+
+void CellMeanByType::compute(Tissue &T,DataMatrix &cellData,
+			     DataMatrix &wallData,DataMatrix &vertexData,
+			     std::vector<double> &value) const
+{
+  checkCellVariable(cellData,variable_,"CellMeanByType");
+  checkCellVariable(cellData,typeVariable_,"CellMeanByType");
+  std::vector<double> sum(numType_,0.0), count(numType_,0.0);
+  for( size_t i=0 ; i<cellData.size() ; ++i ) {
+    double type = std::floor(cellData[i][typeVariable_]+0.5);
+    if( type<0.0 || type>=numType_ )
+      continue;
+    size_t k = static_cast<size_t>(type);
+    sum[k] += cellData[i][variable_];
+    count[k] += 1.0;
+  }
+  for( size_t k=0 ; k<numType_ ; ++k )
+    value.push_back( count[k]>0.0 ? sum[k]/count[k] : 0.0 );
+}
+
+CellValue::CellValue(std::istream &IN)
+{
+  IN >> cell_ >> variable_;
+}
+
+void CellValue::header(std::ostream &os) const
+{
+  os << " cell" << cell_ << "(" << variable_ << ")";
+}
+
+void CellValue::compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+			DataMatrix &vertexData,std::vector<double> &value) const
+{
+  if( cell_>=cellData.size() || variable_>=cellData[cell_].size() ) {
+    std::cerr << "CellValue::compute() Cell " << cell_ << " variable "
+	      << variable_ << " out of range." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  value.push_back( cellData[cell_][variable_] );
+}
+
+VertexValue::VertexValue(std::istream &IN)
+{
+  IN >> vertex_ >> dimension_;
+}
+
+void VertexValue::header(std::ostream &os) const
+{
+  os << " vertex" << vertex_ << "(" << dimension_ << ")";
+}
+
+void VertexValue::compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+			  DataMatrix &vertexData,std::vector<double> &value) const
+{
+  if( vertex_>=vertexData.size() || dimension_>=vertexData[vertex_].size() ) {
+    std::cerr << "VertexValue::compute() Vertex " << vertex_ << " dimension "
+	      << dimension_ << " out of range." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  value.push_back( vertexData[vertex_][dimension_] );
+}
+
+ReactionParameter::ReactionParameter(std::istream &IN)
+{
+  IN >> reaction_ >> parameter_;
+}
+
+void ReactionParameter::header(std::ostream &os) const
+{
+  os << " reaction" << reaction_ << "(" << parameter_ << ")";
+}
+
+void ReactionParameter::compute(Tissue &T,DataMatrix &cellData,
+				DataMatrix &wallData,DataMatrix &vertexData,
+				std::vector<double> &value) const
+{
+  if( reaction_>=T.numReaction() ||
+      parameter_>=T.reaction(reaction_)->numParameter() ) {
+    std::cerr << "ReactionParameter::compute() Reaction " << reaction_
+	      << " parameter " << parameter_ << " out of range." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  value.push_back( T.reaction(reaction_)->parameter(parameter_) );
+}
+
+InSituAnalysis::InSituAnalysis(std::istream &IN)
+{
+  size_t numReduction=0;
+  if( !(IN >> fileName_ >> numReduction) ) {
+    std::cerr << "InSituAnalysis::InSituAnalysis() Expected 'Analysis fileName"
+	      << " numReduction'." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  for( size_t k=0 ; k<numReduction ; ++k )
+    reduction_.push_back( Reduction::createReduction(IN) );
+  if( !IN ) {
+    std::cerr << "InSituAnalysis::InSituAnalysis() Error reading the "
+	      << numReduction << " reductions." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  OUT_.open(fileName_.c_str());
+  if( !OUT_ ) {
+    std::cerr << "InSituAnalysis::InSituAnalysis() Cannot open file "
+	      << fileName_ << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  OUT_ << "# time";
+  for( size_t k=0 ; k<reduction_.size() ; ++k )
+    reduction_[k]->header(OUT_);
+  OUT_ << std::endl;
+}
+
+InSituAnalysis::~InSituAnalysis()
+{
+  for( size_t k=0 ; k<reduction_.size() ; ++k )
+    delete reduction_[k];
+}
+
+void InSituAnalysis::write(double t,Tissue &T,DataMatrix &cellData,
+			   DataMatrix &wallData,DataMatrix &vertexData)
+{
+  std::vector<double> value;
+  for( size_t k=0 ; k<reduction_.size() ; ++k )
+    reduction_[k]->compute(T,cellData,wallData,vertexData,value);
+  OUT_ << t;
+  for( size_t k=0 ; k<value.size() ; ++k )
+    OUT_ << " " << value[k];
+  OUT_ << std::endl;
+}
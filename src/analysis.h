@@ -0,0 +1,232 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+//
+// Filename     : analysis.h
+// Description  : In-situ reductions of the tissue state written at print times
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myTypedefs.h"
+
+class Tissue;
+
+///
+/// @brief Base class for reductions of the tissue state to a fixed number of
+/// values (columns) per print time point
+///
+/// @details Each reduction is read from a single line in the Analysis block
+/// (see InSituAnalysis), starting with its identity string followed by its
+/// parameters.
+///
+class Reduction {
+
+ public:
+  virtual ~Reduction();
+  ///
+  /// @brief Factory reading a reduction identity and its parameters from IN
+  ///
+  static Reduction* createReduction(std::istream &IN);
+  ///
+  /// @brief Appends the names of the columns (separated by spaces) to os
+  ///
+  virtual void header(std::ostream &os) const = 0;
+  ///
+  /// @brief Appends the reduced values to value
+  ///
+  virtual void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+		       DataMatrix &vertexData,std::vector<double> &value) const = 0;
+};
+
+///
+/// @brief Number of cells
+///
+/// In the Analysis block: 'NumCell'.
+///
+class NumCell : public Reduction {
+
+ public:
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Summed volume (area in 2D) of all cells calculated from the vertex
+/// positions
+///
+/// In the Analysis block: 'TotalVolume'.
+///
+class TotalVolume : public Reduction {
+
+ public:
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Mean, standard deviation, minimum and maximum of a cell variable
+///
+/// In the Analysis block: 'CellStatistics variable'.
+///
+class CellStatistics : public Reduction {
+
+ private:
+  size_t variable_;
+
+ public:
+  CellStatistics(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Histogram (cell counts) of a cell variable in numBin equal bins
+/// over [min,max)
+///
+/// In the Analysis block: 'CellHistogram variable min max numBin'. Values
+/// outside the range are counted in the first or last bin.
+///
+class CellHistogram : public Reduction {
+
+ private:
+  size_t variable_;
+  double min_;
+  double max_;
+  size_t numBin_;
+
+ public:
+  CellHistogram(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Mean of a cell variable for each cell type
+///
+/// In the Analysis block: 'CellMeanByType variable typeVariable numType'.
+/// The type of a cell is its (rounded) value in typeVariable, and types
+/// outside [0,numType) are ignored. Types without cells give a zero mean.
+///
+class CellMeanByType : public Reduction {
+
+ private:
+  size_t variable_;
+  size_t typeVariable_;
+  size_t numType_;
+
+ public:
+  CellMeanByType(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Value of a variable in a single cell
+///
+/// In the Analysis block: 'CellValue cell variable'. Gives the single-cell
+/// outputs of printFlag 50-55.
+///
+class CellValue : public Reduction {
+
+ private:
+  size_t cell_;
+  size_t variable_;
+
+ public:
+  CellValue(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Position of a single vertex in one dimension
+///
+/// In the Analysis block: 'VertexValue vertex dimension'.
+///
+class VertexValue : public Reduction {
+
+ private:
+  size_t vertex_;
+  size_t dimension_;
+
+ public:
+  VertexValue(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Value of a reaction parameter (e.g. for parameter scans)
+///
+/// In the Analysis block: 'ReactionParameter reaction parameter'.
+///
+class ReactionParameter : public Reduction {
+
+ private:
+  size_t reaction_;
+  size_t parameter_;
+
+ public:
+  ReactionParameter(std::istream &IN);
+  void header(std::ostream &os) const;
+  void compute(Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	       DataMatrix &vertexData,std::vector<double> &value) const;
+};
+
+///
+/// @brief Computes a list of reductions at each print time point and appends
+/// them as a row to a table file
+///
+/// @details The analysis is declared in a block following the solver
+/// parameters in the solver file (see BaseSolver::getSolver()):
+/// @verbatim
+/// Analysis fileName numReduction
+/// reductionId parameters
+/// ...
+/// @endverbatim
+/// e.g.
+/// @verbatim
+/// Analysis tissue.adata 4
+/// NumCell
+/// TotalVolume
+/// CellStatistics 1
+/// CellHistogram 1 0.0 1.0 10
+/// @endverbatim
+/// The table starts with a '#' line naming the columns, followed by one row
+/// per print time point with the time and the values of all reductions. For
+/// runs needing only the reductions, printFlag 100 turns off the tissue
+/// output.
+///
+class InSituAnalysis {
+
+ private:
+  std::string fileName_;
+  std::ofstream OUT_;
+  std::vector<Reduction*> reduction_;
+
+ public:
+  ///
+  /// @brief Reads the block (after the 'Analysis' keyword) and opens the file
+  ///
+  InSituAnalysis(std::istream &IN);
+  ~InSituAnalysis();
+  ///
+  /// @brief Computes all reductions and appends a row to the table
+  ///
+  void write(double t,Tissue &T,DataMatrix &cellData,DataMatrix &wallData,
+	     DataMatrix &vertexData);
+};
+
+#endif
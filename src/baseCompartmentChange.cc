@@ -150,8 +150,35 @@ update(Tissue *T,size_t i,DataMatrix &cellData,
   exit(0);
 }  
 
+int BaseCompartmentChange::hasPlan() const
+{
+  return 0;
+}
+
+void BaseCompartmentChange::
+plan(Tissue *T,size_t i,const DataMatrix &cellData,
+     const DataMatrix &wallData,
+     const DataMatrix &vertexData,
+     DivisionPlan &plan) {
+  std::cerr << "BaseCompartmentChange::plan() not available for " << id()
+	    << "." << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+void BaseCompartmentChange::
+commit(Tissue *T,size_t i,const DivisionPlan &plan,DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       DataMatrix &cellDerivs, 
+       DataMatrix &wallDerivs,
+       DataMatrix &vertexDerivs ) {
+  std::cerr << "BaseCompartmentChange::commit() not available for " << id()
+	    << "." << std::endl;
+  exit(EXIT_FAILURE);
+}
+
 void BaseCompartmentChange::
-printCellWallError(DataMatrix &vertexData,
+printCellWallError(const DataMatrix &vertexData,
                    Cell *divCell, 
                    std::vector<size_t> &w3Tmp, 
                    size_t &wI, 
@@ -338,7 +365,7 @@ findTwoDivisionWalls(DataMatrix &vertexData,
 }
 
 int BaseCompartmentChange::
-findSecondDivisionWall(DataMatrix &vertexData, 
+findSecondDivisionWall(const DataMatrix &vertexData, 
 		       Cell *divCell, size_t &wI, size_t &w3I, 
 		       std::vector<double> &v1Pos, 
 		       std::vector<double> &n, 
@@ -17,6 +17,26 @@
 class Tissue;
 class Cell;
 
+///
+/// @brief The division of a cell calculated by
+/// BaseCompartmentChange::plan() and applied by BaseCompartmentChange::commit()
+///
+/// @details The walls are given as positions in the wall list of the
+/// dividing cell, and the positions are those of the new vertices on them.
+/// The new cell, the first of the three new walls and the first of the two
+/// new vertices are set before the commit, when the elements have been
+/// appended (Tissue::appendDivisionElements()).
+///
+struct DivisionPlan {
+  size_t wall1;
+  size_t wall2;
+  std::vector<double> position1;
+  std::vector<double> position2;
+  size_t newCell;
+  size_t newWall;
+  size_t newVertex;
+};
+
 ///
 /// @brief A base class for classes defining updates relating to changes in tissue size, e.g. cell division
 ///
@@ -107,12 +127,44 @@ class BaseCompartmentChange {
 		      DataMatrix &cellDerivs,
 		      DataMatrix &wallDerivs,
 		      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Returns 1 if the update is split into plan() and commit()
+  ///
+  /// @details Divisions (numChange()==1) providing a plan are applied by
+  /// Tissue::checkCompartmentChange() in rounds, where the plans of all
+  /// flagged cells are calculated in parallel and then committed for a set
+  /// of cells not sharing any wall. The default is 0 (update() is used).
+  ///
+  virtual int hasPlan() const;
+  ///
+  /// @brief Calculates the division of cell i without changing the tissue
+  ///
+  /// @details Called in parallel for different cells, and may only read
+  /// the tissue and data.
+  ///
+  virtual void plan(Tissue* T,size_t i,
+		    const DataMatrix &cellData,
+		    const DataMatrix &wallData,
+		    const DataMatrix &vertexData,
+		    DivisionPlan &plan);
+  ///
+  /// @brief Divides cell i as given by a plan from plan()
+  ///
+  /// The new elements given in the plan are already appended.
+  ///
+  virtual void commit(Tissue* T,size_t i,const DivisionPlan &plan,
+		      DataMatrix &cellData,
+		      DataMatrix &wallData,
+		      DataMatrix &vertexData,
+		      DataMatrix &cellDerivs,
+		      DataMatrix &wallDerivs,
+		      DataMatrix &vertexDerivs );
   
   ///
   /// @brief Prints the wall positions and different other stuff for
   /// error checking in gnuplot.
   ///
-  void printCellWallError(DataMatrix &vertexData,
+  void printCellWallError(const DataMatrix &vertexData,
 			  Cell *divCell, 
 			  std::vector<size_t> &w3Tmp, 
 			  size_t &wI, 
@@ -140,7 +192,7 @@ class BaseCompartmentChange {
   /// It uses a position on a wall and a direction to find a second
   /// vertex position for a division.
   ///
-  int findSecondDivisionWall(DataMatrix &vertexData, 
+  int findSecondDivisionWall(const DataMatrix &vertexData, 
 			     Cell *divCell, size_t &wI, size_t &w3I, 
 			     std::vector<double> &v1Pos, 
 			     std::vector<double> &nW2, 
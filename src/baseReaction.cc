@@ -21,6 +21,7 @@
 #include "mechanicalSpring.h"
 #include "mechanicalTRBS.h"
 #include "network.h"
+#include "reactionSchedule.h"
 #include "transport.h"
 #include "sisterVertex.h"
 #include "membraneCycling.h"
@@ -705,6 +706,42 @@ void BaseReaction::update(Tissue &T,
 {
 }
 
+int BaseReaction::linearCellTransport(Tissue &T,
+				      DataMatrix &cellData,
+				      DataMatrix &wallData,
+				      DataMatrix &vertexData,
+				      std::vector<size_t> &species,
+				      DataMatrix &coefficient)
+{
+  return 0;
+}
+
+int BaseReaction::geometryDerivs(const Geometry &G,
+				 const GeometryState &state,
+				 GeometryState &derivs)
+{
+  return 0;
+}
+
+void BaseReaction::access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
+int BaseReaction::channel(ReactionChannel &C) const
+{
+  return 0;
+}
+
+int BaseReaction::vertexJacobian(Tissue &T,
+				 DataMatrix &cellData,
+				 DataMatrix &wallData,
+				 DataMatrix &vertexData,
+				 VertexJacobian &J)
+{
+  return 0;
+}
+
 void BaseReaction::print( std::ofstream &os ) 
 {
   std::cerr << "BaseReaction::print(ofstream) should not be used. "
@@ -719,3 +756,9 @@ void BaseReaction::printState(Tissue *T,
 			      std::ostream &os)
 {
 }
+
+void BaseChemicalReaction::access(ReactionAccess &A) const
+{
+  A.addVariableIndex(*this,1,2);
+  A.read(ReactionAccess::vertexData);
+}
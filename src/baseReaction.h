@@ -14,7 +14,12 @@
 #include<fstream>
 #include"myTypedefs.h"
 
+class Geometry;
+class GeometryState;
+class ReactionAccess;
+class ReactionChannel;
 class Tissue;
+class VertexJacobian;
 
 ///
 /// @brief A factory class for classes describing differential equation
@@ -326,6 +331,91 @@ class BaseReaction {
 		      DataMatrix &vertexData,
 		      double h);
   ///
+  /// @brief For reactions that are linear cell-to-cell transport and can be
+  /// integrated implicitly
+  ///
+  /// A reaction whose contribution to the cell variables is of the form
+  ///
+  /// @f[ \frac{dy_{i,s}}{dt} = \sum_k a_{s,ik} (y_{j(k),s} - y_{i,s}) @f]
+  ///
+  /// where the sum is over the neighbors of cell i in the order given by the
+  /// TissueTopology cell -> cell CSR arrays (TissueTopology::cellNeighbor()),
+  /// can return 1 and provide the variable indices (species) and the
+  /// coefficients a (coefficient[s][k] for the k-th CSR entry). The
+  /// coefficients may depend on the current state (e.g. geometry). The
+  /// derivs() function still has to provide the same contribution. If not
+  /// defined for a specific reaction this virtual function returns 0, and the
+  /// reaction is treated as a general (explicit) reaction.
+  ///
+  /// @see IMEX
+  ///
+  virtual int linearCellTransport(Tissue &T,
+				  DataMatrix &cellData,
+				  DataMatrix &wallData,
+				  DataMatrix &vertexData,
+				  std::vector<size_t> &species,
+				  DataMatrix &coefficient);
+  ///
+  /// @brief Derivative function using the index based Geometry and flat state
+  ///
+  /// @details Reactions only depending on the mesh connectivity and on
+  /// vertex, wall (edge) and cell (face) variables can provide this version,
+  /// which is used by Tissue::derivs() when the geometry kernels are switched
+  /// on (Tissue::setGeometryFlag()). The state is gathered once per
+  /// derivative call, and the contributions are added to derivs, with the
+  /// same layout as the Tissue data. Reactions not defining it (or not
+  /// supporting a specific parameter/index setting) return 0, and the
+  /// derivs(Tissue&,...) version is used instead.
+  ///
+  /// @see Geometry
+  /// @see GeometryState
+  ///
+  virtual int geometryDerivs(const Geometry &G,
+			     const GeometryState &state,
+			     GeometryState &derivs);
+  ///
+  /// @brief Declares the tissue variable columns read and written in derivs()
+  ///
+  /// @details Used by the ReactionSchedule to find reactions that can be run
+  /// concurrently (Tissue::setScheduleFlag()). The default declares the
+  /// reaction exclusive, since the columns used can not be derived from the
+  /// variable indices in general (e.g. the center triangulation variables
+  /// following an index). Reactions declaring their columns are scheduled
+  /// concurrently, and cell and wall chemistry can derive from
+  /// BaseChemicalReaction.
+  ///
+  /// @see ReactionAccess
+  ///
+  virtual void access(ReactionAccess &A) const;
+  ///
+  /// @brief Describes the reaction as a stochastic channel within each cell
+  ///
+  /// @details Reactions given by a propensity from a product of cell
+  /// variables and fixed changes of cell variables per event (e.g. mass
+  /// action reactions) can set the channel and return 1, which allows them
+  /// to be simulated as discrete events by the HybridStochastic engine. The
+  /// default returns 0 (not available).
+  ///
+  /// @see ReactionChannel
+  ///
+  virtual int channel(ReactionChannel &C) const;
+  ///
+  /// @brief Adds the Jacobian of the vertex derivatives with respect to the
+  /// vertex positions
+  ///
+  /// @details Mechanical reactions can add the analytic derivatives of their
+  /// contribution to vertexDerivs in derivs() (minus the element stiffness)
+  /// to the blocks of J and return 1. The default returns 0, and
+  /// Tissue::vertexJacobian() then uses finite differences of derivs().
+  ///
+  /// @see VertexJacobian
+  ///
+  virtual int vertexJacobian(Tissue &T,
+			     DataMatrix &cellData,
+			     DataMatrix &wallData,
+			     DataMatrix &vertexData,
+			     VertexJacobian &J);
+  ///
   /// @brief Prints the data structure of a reaction.
   ///
   /// Prints the data structure in a format readable for (re)creating a reaction.
@@ -350,6 +440,23 @@ class BaseReaction {
 			  std::ostream &os=std::cout);
 };
 
+///
+/// @brief Base class for cell and wall chemistry reactions
+///
+/// @details Declares the accessed columns (BaseReaction::access()) for
+/// reactions only updating indexed cell and wall variables: each indexed
+/// cell column and the indexed wall column and the one following it (the
+/// two sides of a wall variable) are read and their derivatives written,
+/// and the vertex positions are read (e.g. for cell volumes). The vertex
+/// derivatives are not accessed.
+///
+class BaseChemicalReaction : public BaseReaction {
+
+ public:
+
+  void access(ReactionAccess &A) const;
+};
+
 inline std::string BaseReaction::id() const {
   return id_;
 }
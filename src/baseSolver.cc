@@ -14,18 +14,32 @@
 #include "rungeKutta.h"
 #include "euler.h"
 #include "heunito.h"
+#include "quasiStatic.h"
+#include "strangSplitting.h"
+#include "imex.h"
+#include "analysis.h"
+#include "convergence.h"
+#include "hybridStochastic.h"
+#include "stateHistory.h"
 #include "myConfig.h"
 #include "myFiles.h"
 #include "myTimes.h"
 #include "pvd_file.h"
+#include "vertexJacobian.h"
 #include "ply_file.h"
 
 BaseSolver::BaseSolver()
+  : T_(0), renumberFlag_(false), renumberInterval_(0), renumberCount_(0),
+    vtuNumPiece_(1), vtuPartition_(PVD_file::INDEX), analysis_(0),
+    convergence_(0), hybrid_(0), history_(0),
+    printedRevision_(static_cast<size_t>(-1))
 {
   //C_=0;
 }
 
 BaseSolver::BaseSolver(Tissue *T,std::ifstream &IN)
+  : analysis_(0), convergence_(0), hybrid_(0), history_(0),
+    printedRevision_(static_cast<size_t>(-1))
 {
   //C_=0;
   setTissue(T);
@@ -36,28 +50,144 @@ BaseSolver::BaseSolver(Tissue *T,std::ifstream &IN)
   if(!debugCheck.empty()) {
     std::cerr << "Performing simulation in debug-mode\n";
     debugFlag_ = true;
-    if (debugFlag_) {
-      int numCopy = 10;
-      cellDataCopy_.resize(numCopy);
+    int numState = 10;
+    std::string stepCheck = myConfig::getValue("debug_steps", 0);
+    if(!stepCheck.empty()) {
+      numState = atoi(stepCheck.c_str());
+      if (numState<1) {
+	std::cerr << "BaseSolver::BaseSolver() Number given to -debug_steps must"
+		  << " be positive." << std::endl;
+	exit(EXIT_FAILURE);
+      }
     }
+    history_ = new StateHistory(numState);
   }
   else 
     debugFlag_=false;
+  
+  //check renumbering status (at load and with a given step interval)
+  renumberFlag_=false;
+  renumberInterval_=renumberCount_=0;
+  std::string renumberCheck = myConfig::getValue("renumber", 0);
+  if(!renumberCheck.empty()) {
+    int interval = atoi(renumberCheck.c_str());
+    if (interval<0) {
+      std::cerr << "BaseSolver::BaseSolver() Interval given to -renumber must be"
+		<< " non-negative." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    renumberFlag_ = true;
+    renumberInterval_ = static_cast<size_t>(interval);
+    T_->renumber(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+		 vertexDerivs_,1);
+  }
+
+  //check partitioned vtu output (number of pieces and partitioning of cells)
+  vtuNumPiece_=1;
+  vtuPartition_=PVD_file::INDEX;
+  std::string pieceCheck = myConfig::getValue("vtu_pieces", 0);
+  if(!pieceCheck.empty()) {
+    int numPiece = atoi(pieceCheck.c_str());
+    if (numPiece<1) {
+      std::cerr << "BaseSolver::BaseSolver() Number given to -vtu_pieces must be"
+		<< " positive." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    vtuNumPiece_ = static_cast<size_t>(numPiece);
+  }
+  std::string partitionCheck = myConfig::getValue("vtu_partition", 0);
+  if(!partitionCheck.empty()) {
+    if (partitionCheck=="index")
+      vtuPartition_ = PVD_file::INDEX;
+    else if (partitionCheck=="spatial")
+      vtuPartition_ = PVD_file::SPATIAL;
+    else {
+      std::cerr << "BaseSolver::BaseSolver() Partition given to -vtu_partition"
+		<< " not recognized (index, spatial allowed)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
 }
 
 BaseSolver::~BaseSolver()
 {
-  
+  if( T_ && T_->stateBound(cellData_,wallData_,vertexData_) )
+    T_->unbindState();
+  delete analysis_;
+  delete convergence_;
+  if( T_ && hybrid_ )
+    T_->setHybrid(0);
+  delete hybrid_;
+  delete history_;
 }
 
-size_t BaseSolver::debugCount() const
+void BaseSolver::recordDebug()
 {
-  static size_t count = 0;
-  if (debugFlag()) 
-    return count++ % cellDataCopy_.size(); 
-  std::cerr << "Warning  BaseSolver::debugCount() should never be" 
-	    << " called when debugFlag == " << debugFlag() << "\n"; 
-  exit(-1);
+  if (!history_) {
+    std::cerr << "Warning  BaseSolver::recordDebug() should never be" 
+	      << " called when debugFlag == " << debugFlag() << "\n"; 
+    exit(-1);
+  }
+  history_->record(t_,T_->topologyRevision(),cellData_,wallData_,vertexData_);
+}
+
+void BaseSolver::checkRenumber()
+{
+  if (!renumberFlag_ || !renumberInterval_)
+    return;
+  if (++renumberCount_ % renumberInterval_)
+    return;
+  T_->renumber(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+}
+
+void BaseSolver::printStableId(bool append) const
+{
+  if (!renumberFlag_)
+    return;
+  std::ofstream of;
+  if (append)
+    of.open("tissue.ids",std::ios_base::app | std::ios_base::out);
+  else
+    of.open("tissue.ids");
+  if (!of) {
+    std::cerr << "BaseSolver::printStableId() Cannot open file tissue.ids."
+	      << std::endl;
+    return;
+  }
+  of << t_ << " " << T_->numCell() << " " << T_->numWall() << " "
+     << T_->numVertex() << std::endl;
+  for (size_t i=0; i<T_->numCell(); ++i)
+    of << (i ? " " : "") << T_->cellStableId(i);
+  of << std::endl;
+  for (size_t i=0; i<T_->numWall(); ++i)
+    of << (i ? " " : "") << T_->wallStableId(i);
+  of << std::endl;
+  for (size_t i=0; i<T_->numVertex(); ++i)
+    of << (i ? " " : "") << T_->vertexStableId(i);
+  of << std::endl;
+}
+
+int BaseSolver::checkVertexJacobian(std::ostream &os,double tolerance)
+{
+  T_->initiateReactions(cellData_,wallData_,vertexData_,cellDerivs_,
+			wallDerivs_,vertexDerivs_);
+  VertexJacobian analytic,numeric;
+  size_t numNumeric = T_->vertexJacobian(cellData_,wallData_,vertexData_,
+					 analytic);
+  T_->vertexJacobian(cellData_,wallData_,vertexData_,numeric,0);
+  double maxValue=0.0;
+  double maxDiff = analytic.maxDifference(numeric,maxValue);
+  double relativeDiff = maxValue>0.0 ? maxDiff/maxValue : maxDiff;
+  // Also fails for NaN deviations
+  int passed = relativeDiff<=tolerance;
+  os << "Vertex Jacobian with " << analytic.numBlock() << " blocks ("
+     << numeric.numBlock() << " from finite differences), " << numNumeric
+     << " reaction(s) without analytic blocks." << std::endl
+     << "Maximal deviation " << maxDiff << " (relative "
+     << relativeDiff << ") " << (passed ? "within" : "exceeds")
+     << " tolerance " << tolerance << "." << std::endl;
+  return passed;
 }
 
 BaseSolver* BaseSolver::getSolver(Tissue *T, const std::string &file)
@@ -80,18 +210,83 @@ BaseSolver* BaseSolver::getSolver(Tissue *T, const std::string &file)
     solver = new Euler(T,(std::ifstream &) *IN);
   else if (idValue == "HeunIto")
     solver = new HeunIto(T,(std::ifstream &) *IN);
+  else if (idValue == "HeunItoAdaptive")
+    solver = new HeunItoAdaptive(T,(std::ifstream &) *IN);
+  else if (idValue == "QuasiStatic")
+    solver = new QuasiStatic(T,(std::ifstream &) *IN);
+  else if (idValue == "StrangSplitting")
+    solver = new StrangSplitting(T,(std::ifstream &) *IN);
+  else if (idValue == "IMEX")
+    solver = new IMEX(T,(std::ifstream &) *IN);
   else {
     std::cerr << "BaseSolver::BaseSolver() - "
 	      << "Unknown solver: " << idValue << std::endl;
     delete IN;
     exit(EXIT_FAILURE);
   }
+  // Optional blocks following the solver parameters
+  std::string blockId;
+  while (*IN >> blockId) {
+    if (blockId == "Analysis")
+      solver->readAnalysis(*IN);
+    else if (blockId == "Convergence")
+      solver->readConvergence(*IN);
+    else if (blockId == "Hybrid")
+      solver->readHybrid(*IN);
+    else {
+      std::cerr << "Warning BaseSolver::getSolver() - "
+		<< "Ignoring '" << blockId << "' and the rest of " << file
+		<< " after the solver parameters (unknown block)." << std::endl;
+      break;
+    }
+  }
   delete IN;
   return solver;
 }
 
+void BaseSolver::readAnalysis(std::istream &IN)
+{
+  delete analysis_;
+  analysis_ = new InSituAnalysis(IN);
+}
+
+void BaseSolver::readConvergence(std::istream &IN)
+{
+  delete convergence_;
+  convergence_ = new ConvergenceMonitor(IN);
+}
+
+void BaseSolver::readHybrid(std::istream &IN)
+{
+  delete hybrid_;
+  hybrid_ = new HybridStochastic(*T_,startTime_,IN);
+  T_->setHybrid(hybrid_);
+  hybrid_->print(*T_,std::cerr);
+  std::cerr << std::endl;
+}
+
+void BaseSolver::updateHybrid(double h)
+{
+  if (hybrid_)
+    hybrid_->advance(*T_,cellData_,h);
+}
+
+bool BaseSolver::checkConvergence()
+{
+  if( !convergence_ ||
+      !convergence_->update(cellDerivs_,wallDerivs_,vertexDerivs_) )
+    return false;
+  std::cerr << "BaseSolver::checkConvergence() Converged at t = " << t_
+	    << " (window of " << convergence_->window() << " steps:";
+  convergence_->print(std::cerr);
+  std::cerr << ")." << std::endl;
+  return true;
+}
+
 void BaseSolver::getInit()
 {
+  if( T_->stateBound(cellData_,wallData_,vertexData_) )
+    T_->unbindState();
   //
   // Resize data vectors
   //
@@ -126,6 +321,10 @@ void BaseSolver::getInit()
     for( size_t j=0 ; j<vertexData_[i].size() ; ++j )
       vertexData_[i][j] = T_->vertex(i).position(j);
   }
+  //
+  // From here on the tissue elements refer to the solver data
+  //
+  T_->bindState(cellData_,wallData_,vertexData_);
 }
 
 void BaseSolver::setTissueVariables(size_t numCellVariable)
@@ -144,6 +343,11 @@ void BaseSolver::setTissueVariables(size_t numCellVariable)
     exit(-1);
   }
   //
+  // The tissue elements already refer to the data
+  //
+  if( T_->stateBound(cellData_,wallData_,vertexData_) )
+    return;
+  //
   // Copy variable values to tissue
   //
   if (numCellVariable==size_t(-1)) { // default, all cell variables copied
@@ -211,6 +415,9 @@ void BaseSolver::print(std::ostream &os)
   NOld = cellData_.size();
   okOld = numOk_;
   badOld = numBad_;
+  if( analysis_ )
+    analysis_->write(t_,*T_,cellData_,wallData_,vertexData_);
+  printStableId(tCount>0);
   //
   // Print vertex, cell, and wall variables
   //
@@ -276,10 +483,18 @@ void BaseSolver::print(std::ostream &os)
     std::string wallFile = "vtk/VTK_walls.vtu";
     static size_t numCellVar = T_->cell(0).numVariable();
     setTissueVariables(numCellVar);
-    if( tCount==0 ) {
-      PVD_file::writeFullPvd(pvdFile,cellFile,wallFile,numPrint_);
+    if( vtuNumPiece_>1 ) {
+      if( tCount==0 )
+	PVD_file::writeFullPvd(pvdFile,"vtk/VTK_cells.pvtu","vtk/VTK_walls.pvtu",
+			       numPrint_);
+      PVD_file::writePieces(*T_,cellFile,wallFile,tCount,vtuNumPiece_,vtuPartition_);
+    }
+    else {
+      if( tCount==0 ) {
+	PVD_file::writeFullPvd(pvdFile,cellFile,wallFile,numPrint_);
+      }
+      PVD_file::write(*T_,cellFile,wallFile,tCount);
     }
-    PVD_file::write(*T_,cellFile,wallFile,tCount);
   }
   //
   // Print in vtu format assuming two wall components for wall variables (except for length)
@@ -290,10 +505,19 @@ void BaseSolver::print(std::ostream &os)
     std::string wallFile = "vtk/VTK_walls.vtu";
     static size_t numCellVar = T_->cell(0).numVariable();
     setTissueVariables(numCellVar);
-    if( tCount==0 ) {
+    if( vtuNumPiece_>1 ) {
+      if( tCount==0 )
+	PVD_file::writeFullPvd(pvdFile,"vtk/VTK_cells.pvtu","vtk/VTK_walls.pvtu",
+			       numPrint_);
+      PVD_file::writePieces(*T_,cellFile,wallFile,tCount,vtuNumPiece_,vtuPartition_,
+			    true);
+    }
+    else {
+      if( tCount==0 ) {
         PVD_file::writeFullPvd(pvdFile,cellFile,wallFile,numPrint_);
+      }
+      PVD_file::writeTwoWall(*T_,cellFile,wallFile,tCount);
     }
-    PVD_file::writeTwoWall(*T_,cellFile,wallFile,tCount);
   }
   //
   // Print vertex and cell variables
@@ -612,6 +836,66 @@ void BaseSolver::print(std::ostream &os)
     of << "#tCount = " << tCount << std::endl;
     printInit(of);    
     }
+  //
+  // As (0), but the connectivity is only printed when the topology has changed
+  //
+  else if( printFlag_==11 ) {
+    if( tCount==0 ) {
+      os << numPrint_ << "\n";
+      printedRevision_ = static_cast<size_t>(-1);
+    }
+    size_t revision = T_->topologyRevision();
+    size_t Nc = cellData_.size();
+    size_t Nw = wallData_.size();
+    size_t Nv = vertexData_.size(); 
+    if( revision!=printedRevision_ ) {
+      os << revision << " 1" << std::endl;
+      //Print the vertices of the cells and walls
+      os << Nc << std::endl;
+      for( size_t i=0 ; i<Nc ; ++i ) {
+	size_t Ncv = T_->cell(i).numVertex(); 
+	os << Ncv;
+	for( size_t k=0 ; k<Ncv ; ++k )
+	  os << " " << T_->cell(i).vertex(k)->index();
+	os << std::endl;
+      }
+      os << Nw << std::endl;
+      for( size_t i=0 ; i<Nw ; ++i )
+	os << T_->wall(i).vertex1()->index() << " " 
+	   << T_->wall(i).vertex2()->index() << std::endl;
+      printedRevision_ = revision;
+    }
+    else
+      os << revision << " 0" << std::endl;
+    //Print the vertex positions
+    size_t dimension = Nv ? T_->vertex(0).numPosition() : 0;
+    os << Nv << " " << dimension << std::endl;
+    for( size_t i=0 ; i<Nv ; ++i ) {
+      for( size_t d=0 ; d<dimension ; ++d )
+	os << vertexData_[i][d] << " ";
+      os << std::endl;
+    }
+    //Print the cell variables
+    size_t numPrintCellVar = Nc ? T_->cell(0).numVariable() : 0;
+    os << Nc << " " << numPrintCellVar+2 << std::endl;
+    for( size_t i=0 ; i<Nc ; ++i ) {
+      for (size_t k=0; k<numPrintCellVar; ++k)
+	os << cellData_[i][k] << " ";
+      os << T_->cell(i).calculateVolume(vertexData_) << " ";
+      os << T_->cell(i).numWall() << std::endl;
+    }		
+    //Print the wall variables
+    os << Nw << " " << (Nw ? T_->wall(0).numVariable()+5 : 0) << std::endl;
+    for( size_t i=0 ; i<Nw ; ++i ) {
+      for( size_t k=0 ; k<wallData_[i].size() ; ++k )
+	os << wallData_[i][k] << " ";
+      double distance = T_->wall(i).lengthFromVertexPosition(vertexData_);
+      os << i << " " << distance
+	 << " " << distance-wallData_[i][0] << " " << (distance-wallData_[i][0])/wallData_[i][0]
+	 << std::endl;
+    }		
+    os << std::endl;
+  }
 
   //
   // Ad hoc and temporary print flags
@@ -2077,6 +2361,9 @@ else if( printFlag_==62 ) {  // for ploting angels of MT, stress and P-strain
  else if (printFlag_==107) {// Init style
    printInit(os);
  }
+
+ else if (printFlag_==100) {// No tissue output (in-situ analysis only)
+ }
   
  else
    std::cerr << "BaseSolver::print() Wrong printFlag value\n";
@@ -2470,19 +2757,7 @@ void BaseSolver::printInitTri(std::ostream &os) const
 
 void BaseSolver::printDebug(std::ostream &os) const
 {
-	os << cellDataCopy_.size() << "\n";
-	size_t startElement = debugCount();
-	for (size_t c=startElement; c<startElement+cellDataCopy_.size(); ++c) {
-		size_t n = c%cellDataCopy_.size();
-		os << cellDataCopy_[n].size() << " " << cellDataCopy_[n][c].size() << " " 
-			 << c-startElement << "\n";
-		for (size_t i=0; i<cellDataCopy_[n].size(); i++) {
-			for (size_t j=0; j<cellDataCopy_[n][c].size(); j++) {
-				os << cellDataCopy_[n][i][j] << " ";
-			}
-			os << "\n";
-		}
-		os << "\n\n";
-	}
+  if (history_)
+    history_->print(os);
 }
 
@@ -11,6 +11,11 @@
 
 #include "tissue.h"
 
+class ConvergenceMonitor;
+class HybridStochastic;
+class InSituAnalysis;
+class StateHistory;
+
 ///
 /// @brief A factory class for classes describing different numerical solvers
 /// for the ordinary differential equations
@@ -31,7 +36,6 @@ protected:
   DataMatrix cellDerivs_; 
   DataMatrix wallDerivs_; 
   DataMatrix vertexDerivs_; 
-  std::vector< DataMatrix > cellDataCopy_;
   double t_;
   double startTime_;
   double endTime_;
@@ -39,6 +43,20 @@ protected:
   int numPrint_;
   unsigned int numOk_, numBad_;
   bool debugFlag_;
+  bool renumberFlag_;
+  size_t renumberInterval_;
+  size_t renumberCount_;
+  size_t vtuNumPiece_;
+  int vtuPartition_;
+  InSituAnalysis *analysis_;
+  ConvergenceMonitor *convergence_;
+  HybridStochastic *hybrid_;
+  StateHistory *history_;
+  ///
+  /// @brief Topology revision of the connectivity last written by print()
+  /// with printFlag 11
+  ///
+  size_t printedRevision_;
   //size_t numSimulation_;
   
  public:
@@ -63,15 +81,69 @@ protected:
   /// @endverbatim
   /// where the solverId is the name of the numerical method (class) used. The
   /// parameters used can be found in the links below which lists the
-  /// currently available methods/classes.
+  /// currently available methods/classes. The solver parameters can be
+  /// followed by an 'Analysis' block declaring reductions computed at each
+  /// print time point (see InSituAnalysis), a 'Convergence' block
+  /// declaring when the simulation is stopped at a steady state (see
+  /// ConvergenceMonitor), and a 'Hybrid' block declaring cell variables
+  /// simulated as discrete events (see HybridStochastic).
   ///
   /// @see RK5Adaptive::readParameterFile()
   /// @see RK4::readParameterFile()
   /// @see Euler::readParameterFile()
+  /// @see HeunIto::readParameterFile()
+  /// @see HeunItoAdaptive::readParameterFile()
+  /// @see QuasiStatic::readParameterFile()
+  /// @see StrangSplitting::readParameterFile()
+  /// @see IMEX::readParameterFile()
   ///
   static BaseSolver* getSolver(Tissue *T, const std::string &file);
   
-  size_t debugCount() const;
+  ///
+  /// @brief Adds the current state to the debug history (-debug_output)
+  ///
+  /// @details Should be called by the solvers at the start of each step
+  /// when debugFlag() is set.
+  ///
+  /// @see StateHistory
+  ///
+  void recordDebug();
+  ///
+  /// @brief Renumbers the tissue (and data) if the interval of steps has passed
+  ///
+  /// @details Renumbering is activated by the -renumber interval option to the
+  /// simulator, and is then applied at load and every interval steps (never
+  /// during the simulation if interval=0). Should be called by the solvers
+  /// after the compartment changes have been applied in a step.
+  ///
+  /// @see Tissue::renumber()
+  ///
+  void checkRenumber();
+  ///
+  /// @brief Writes the stable ids of the current cell, wall and vertex indices
+  ///
+  /// @details Only applies when renumbering is active (-renumber), since the
+  /// printed and init outputs then are ordered by the renumbered indices. A
+  /// block with 't numCell numWall numVertex' followed by one line each of
+  /// cell, wall and vertex stable ids is written to the file tissue.ids,
+  /// which is restarted if append is false.
+  ///
+  /// @see Tissue::cellStableId()
+  ///
+  void printStableId(bool append=true) const;
+  ///
+  /// @brief Compares the assembled vertex Jacobian (analytic blocks where
+  /// provided) with central differences of all reactions
+  ///
+  /// @details Used by the -jacobian_check option to the simulator. The
+  /// reactions are initiated on the current state, and the number of
+  /// blocks, the reactions without analytic Jacobian and the maximal
+  /// (absolute and relative) deviation are printed to os. Returns 1 if the
+  /// relative deviation is within tolerance and 0 otherwise.
+  ///
+  /// @see Tissue::vertexJacobian()
+  ///
+  int checkVertexJacobian(std::ostream &os,double tolerance);
   
   ///
   /// @brief Sets internal variables from values in the tissue.
@@ -97,6 +169,8 @@ protected:
   /// 0) Standard output for openGL developed plotting of cell and wall variables 
   /// 1) Standard vtu output assuming single wall compartment for wall variables
   /// 2) Standard vtu output assuming two wall compartment for wall variables (except for initial length)
+  ///    For (1) and (2) the -vtu_pieces and -vtu_partition options split the output into pieces
+  ///    (see PVD_file::writePieces()).
   /// 3) Standard output for openGL developed plotting of cell variables 
   /// 4) Standard output for openGL developed plotting of wall variables
   /// 5) Output that can be used for plotting in gnuplot.
@@ -104,6 +178,9 @@ protected:
   /// 7) PLY format assuming centraltriangulation
   /// 10) As (2), and in addition a file is generated (tissue.idata) storing the states in init format.
   /// The time points are divided by a line '#tCount = value' to find individual time points in file.
+  /// 11) As (0), but with the cell and wall vertex lists only printed when the topology revision
+  ///     has changed since the last printed frame (see FrameReader for the format).
+  /// 100) No tissue output (e.g. when only the reductions of an Analysis block are needed).
   /// In addition there are several methods for plotting also membrane data (e.g. PIN1),
   /// @endverbatim 
   /// as well as specific methods.
@@ -112,6 +189,43 @@ protected:
   ///
   void print(std::ostream &os=std::cout);
   ///
+  /// @brief Reads an in-situ analysis block (following the 'Analysis' keyword)
+  ///
+  /// @see InSituAnalysis
+  ///
+  void readAnalysis(std::istream &IN);
+  ///
+  /// @brief Reads a convergence block (following the 'Convergence' keyword)
+  ///
+  /// @see ConvergenceMonitor
+  ///
+  void readConvergence(std::istream &IN);
+  ///
+  /// @brief Returns true if the declared convergence criteria are fulfilled
+  ///
+  /// @details Adds the current derivatives (cellDerivs_, wallDerivs_,
+  /// vertexDerivs_) to the window of the ConvergenceMonitor, and reports the
+  /// convergence time when converged. Should be called by the solvers after
+  /// the derivatives have been updated at the start of a step, and the
+  /// simulation is then ended with the final time point printed. Always
+  /// false if no Convergence block is given.
+  ///
+  bool checkConvergence();
+  ///
+  /// @brief Reads a hybrid block (following the 'Hybrid' keyword)
+  ///
+  /// @see HybridStochastic
+  ///
+  void readHybrid(std::istream &IN);
+  ///
+  /// @brief Fires the stochastic events of the Hybrid block within a step
+  ///
+  /// @details Should be called by the solvers after each (accepted) step of
+  /// size h, before the discrete (reaction and compartment) updates. Does
+  /// nothing if no Hybrid block is given.
+  ///
+  void updateHybrid(double h);
+  ///
   /// @brief Prints standard tissue init
   ///
   /// Prints the current state in init format using the data matrices.
@@ -145,7 +259,9 @@ protected:
   ///
   void printInitTri(std::ostream &os) const;
 
-
+  ///
+  /// @brief Prints the last states kept in debug mode (see StateHistory::print())
+  ///
   void printDebug(std::ostream &os) const;
   
   virtual void readParameterFile(std::ifstream &IN);
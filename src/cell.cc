@@ -17,6 +17,7 @@
 Cell::Cell() {
   
   mitosisFlag_=0;
+  variableStore_=0;
 }
 
 Cell::Cell( const Cell & cellCopy ) {
@@ -27,13 +28,16 @@ Cell::Cell( const Cell & cellCopy ) {
   mitosisFlag_ = cellCopy.mitosisFlag();
   wall_ = cellCopy.wall();
   vertex_ = cellCopy.vertex();
-  variable_ = cellCopy.variable();
+  variableStore_ = cellCopy.variableStore_;
+  if( !variableStore_ )
+    variable_ = cellCopy.variable_;
   E_ = cellCopy.getPCAPlane();
 }
 
 Cell::Cell(size_t indexVal,std::string idVal) {
   setIndex(indexVal);
   setId(idVal);
+  variableStore_=0;
 }
 
 Cell::~Cell() {
@@ -45,9 +49,24 @@ void Cell::setVariable( std::vector<double> &val )
     std::cerr << "Cell::setVariable(vector) Warning: "
 	      << "Not the same number of variables in the cell as in the given vector."
 	      << std::endl;    
-    variable_.resize(val.size());
+    variableRef().resize(val.size());
   }
-  variable_=val;
+  variableRef()=val;
+}
+
+void Cell::bindVariable(DataMatrix &data)
+{
+  assert( index_<data.size() );
+  variableStore_ = &data;
+  std::vector<double>().swap(variable_);
+}
+
+void Cell::unbindVariable()
+{
+  if( !variableStore_ )
+    return;
+  variable_ = (*variableStore_)[index_];
+  variableStore_ = 0;
 }
 
 void Cell::sortWallAndVertexOld(Tissue &T) {
@@ -144,9 +163,11 @@ void Cell::sortWallAndVertexOld(Tissue &T) {
 	//					<< wall(i)->vertex2()->index() << std::endl; 
 }
 
-void Cell::sortWallAndVertex(Tissue &T) {
+void Cell::sortWallAndVertex(Tissue &T, int topologyFlag) {
 	
 	assert( numWall()==numVertex() );
+	if( topologyFlag )
+		T.topologyChanged();
 	
 // 	std::cerr << "Cell " << index() << std::endl;
 // 	for( size_t i=0 ; i<numVertex() ; ++i )
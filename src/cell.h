@@ -18,6 +18,7 @@
 #include<vector>
 
 #include"myTypedefs.h"
+#include"smallVector.h"
 #include"wall.h"
 
 //class Wall;
@@ -34,14 +35,26 @@ class Tissue;
 ///
 class Cell {
   
+ public:
+  
+  ///
+  /// @brief Containers for the wall and vertex neighbors, holding up to
+  /// eight elements inline
+  ///
+  /// @see SmallVector
+  ///
+  typedef SmallVector<Wall*,8> WallList;
+  typedef SmallVector<Vertex*,8> VertexList;
+  
  private:
   
   size_t index_;
   std::string id_;           
   
-  std::vector<Wall*> wall_;
-  std::vector<Vertex*> vertex_;
+  WallList wall_;
+  VertexList vertex_;
   std::vector<double> variable_;
+  DataMatrix *variableStore_;
 	// For center triangulation
   std::vector<double> centerPosition_;
   std::vector<double> edgeLength_;
@@ -53,6 +66,9 @@ class Cell {
   // The vectors obtained from PCA.
   DataMatrix E_;
   
+  inline std::vector<double> & variableRef();
+  inline const std::vector<double> & variableRef() const;
+  
  public:
   
   ///
@@ -136,7 +152,7 @@ class Cell {
   ///
   /// @brief Returns a reference to the wall vector
   ///
-  inline const std::vector<Wall*> & wall() const;
+  inline const WallList & wall() const;
   ///
   /// @brief Returns a wall pointer from position k in the vector
   ///
@@ -152,7 +168,7 @@ class Cell {
   ///
   /// @brief Returns a reference to the vertex vector
   ///
-  inline const std::vector<Vertex*> & vertex() const;
+  inline const VertexList & vertex() const;
   ///
   /// @brief Returns a vertex pointer from position v in the vector
   ///
@@ -255,6 +271,25 @@ class Cell {
   ///  
   inline void addVariable( double val );
   ///
+  /// @brief Lets the cell variables refer to row index() of data
+  ///
+  /// @details While bound, all variable functions read and write the row in
+  /// data (e.g. the solver state BaseSolver::cellData_) and the cell does not
+  /// store its own copy. The row is used as is (the values of the cell are
+  /// not copied), and it has to follow the cell index.
+  ///
+  /// @see Tissue::bindState()
+  ///
+  void bindVariable(DataMatrix &data);
+  ///
+  /// @brief Copies the row back into the cell and ends the binding
+  ///
+  void unbindVariable();
+  ///
+  /// @brief Returns true if the variables refer to external data
+  ///
+  inline int variableBound() const;
+  ///
   /// @brief Sets a center position at index in the centerPosition vector
   ///  
   /// @see centerPosition()
@@ -330,7 +365,11 @@ class Cell {
   /// to generate a consistent cell normal direction (the normals point in 'the same' direction
   /// for all cells).
   ///
-  void sortWallAndVertex(Tissue &T);
+  /// If topologyFlag is zero the topology revision of the tissue is not
+  /// increased, which is used when cells are sorted in parallel threads and
+  /// the caller increases it once.
+  ///
+  void sortWallAndVertex(Tissue &T, int topologyFlag=1);
   
   ///
   /// @brief Returns TRUE if the cell has any 'concave' wall pairs
@@ -503,13 +542,13 @@ inline size_t Cell::numVertex() const
 
 inline size_t Cell::numVariable() const 
 { 
-  return variable_.size(); 
+  return variableRef().size(); 
 }
 
 inline size_t Cell::setNumVariable(size_t n) 
 { 
-  variable_.resize(n);
-  return variable_.size(); 
+  variableRef().resize(n);
+  return variableRef().size(); 
 }
   
 inline size_t Cell::numCenterPosition() const 
@@ -522,7 +561,7 @@ inline size_t Cell::numEdgeLength() const
   return edgeLength_.size(); 
 }
 
-inline const std::vector<Wall*> & Cell::wall() const 
+inline const Cell::WallList & Cell::wall() const 
 { 
   return wall_; 
 }
@@ -539,12 +578,12 @@ inline Wall& Cell::wallRef( size_t k )
 
 inline int Cell::hasWall( Wall *val ) 
 {
-  std::vector<Wall*>::iterator it = find(wall_.begin(),wall_.end(),val);
+  WallList::iterator it = std::find(wall_.begin(),wall_.end(),val);
   if( it != wall_.end() ) return 1;
   return 0;
 }
 
-inline const std::vector<Vertex*> & Cell::vertex() const 
+inline const Cell::VertexList & Cell::vertex() const 
 { 
   return vertex_; 
 }
@@ -556,19 +595,34 @@ inline Vertex* Cell::vertex( size_t v ) const
 
 inline int Cell::hasVertex( Vertex *val ) 
 {
-  std::vector<Vertex*>::iterator it = find(vertex_.begin(),vertex_.end(),val);
+  VertexList::iterator it = std::find(vertex_.begin(),vertex_.end(),val);
   if( it != vertex_.end() ) return 1;
   return 0;
 }
 
 inline const std::vector<double> & Cell::variable() const 
 { 
-  return variable_; 
+  return variableRef(); 
 }
 
 inline double Cell::variable(size_t i) const 
 { 
-  return variable_[i];
+  return variableRef()[i];
+}
+
+inline int Cell::variableBound() const
+{
+  return variableStore_!=0;
+}
+
+inline std::vector<double> & Cell::variableRef()
+{
+  return variableStore_ ? (*variableStore_)[index_] : variable_;
+}
+
+inline const std::vector<double> & Cell::variableRef() const
+{
+  return variableStore_ ? (*variableStore_)[index_] : variable_;
 }
 
 inline const std::vector<double> & Cell::centerPosition() const 
@@ -635,12 +689,12 @@ inline void Cell::addVertex( Vertex* val )
 
 inline void Cell::setVariable( size_t index,double val ) 
 {
-  variable_[index]=val;
+  variableRef()[index]=val;
 }
 
 inline void Cell::addVariable( double val ) 
 {
-  variable_.push_back(val);
+  variableRef().push_back(val);
 }
 
 inline void Cell::setCenterPosition( size_t index,double val ) 
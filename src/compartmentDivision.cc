@@ -79,6 +79,27 @@ namespace Division {
 	 DataMatrix &wallDeriv,
 	 DataMatrix &vertexDeriv ) {
     
+    DivisionPlan P;
+    plan(T,i,cellData,wallData,vertexData,P);
+    P.newCell = T->numCell();
+    P.newWall = T->numWall();
+    P.newVertex = T->numVertex();
+    T->appendDivisionElements(1);
+    commit(T,i,P,cellData,wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv);
+  }
+  
+  int VolumeViaLongestWall::hasPlan() const
+  {
+    return 1;
+  }
+  
+  void VolumeViaLongestWall::
+  plan(Tissue *T,size_t i,
+       const DataMatrix &cellData,
+       const DataMatrix &wallData,
+       const DataMatrix &vertexData,
+       DivisionPlan &plan) {
+    
     Cell *divCell = &(T->cell(i));
     size_t dimension = vertexData[0].size();
     assert( divCell->numWall() > 1 );
@@ -87,9 +108,9 @@ namespace Division {
     // Find longest wall
     // 
     size_t wI=0,w3I=divCell->numWall();
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -124,19 +145,35 @@ namespace Division {
 		<< "failed to find the second wall for division!" << std::endl;
       exit(EXIT_FAILURE);
     }
+    plan.wall1 = wI;
+    plan.wall2 = w3I;
+    plan.position1.swap(v1Pos);
+    plan.position2.swap(v2Pos);
+  }
+  
+  void VolumeViaLongestWall::
+  commit(Tissue *T,size_t i,const DivisionPlan &plan,
+	 DataMatrix &cellData,
+	 DataMatrix &wallData,
+	 DataMatrix &vertexData,
+	 DataMatrix &cellDeriv,
+	 DataMatrix &wallDeriv,
+	 DataMatrix &vertexDeriv ) {
+    
     //
     // Do the division (add one cell, three walls, and two vertices)
     //
-    size_t numWallTmp=wallData.size();
-    assert( numWallTmp==T->numWall() );
+    std::vector<double> v1Pos(plan.position1),v2Pos(plan.position2);
+    assert( wallData.size()==plan.newWall );
     //Divide
-    T->divideCell(divCell,wI,w3I,v1Pos,v2Pos,cellData,wallData,vertexData,
-		  cellDeriv,wallDeriv,vertexDeriv,variableIndex(0),
-		  parameter(2));
-    assert( numWallTmp+3 == T->numWall() );
+    T->divideCell(&(T->cell(i)),plan.wall1,plan.wall2,v1Pos,v2Pos,cellData,
+		  wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv,
+		  variableIndex(0),parameter(2),plan.newCell,plan.newWall,
+		  plan.newVertex);
+    assert( plan.newWall+3 == wallData.size() );
     
     //Change length of new wall between the divided daugther cells 
-    wallData[numWallTmp][0] *= parameter(1);
+    wallData[plan.newWall][0] *= parameter(1);
     
     //Check that the division did not mess up the data structure
     //T->checkConnectivity(1);	
@@ -221,9 +258,9 @@ namespace Division {
     // Find longest wall
     // 
     size_t wI=0,w3I=divCell->numWall();
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -360,9 +397,9 @@ namespace Division {
     //Find longest wall
     //
     size_t wI=0, w3I=divCell->numWall();
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -624,9 +661,9 @@ namespace Division {
     // Find longest wall
     // 
     size_t wI=0, w3I=brCell->numWall();
-    double maxLength = brCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = brCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<w3I ; ++k ) {
-      double tmpLength = brCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = brCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -648,9 +685,9 @@ namespace Division {
       wI=wallsBack[rand() % s];
     }
     
-    maxLength = brCell->wall(wI)->setLengthFromVertexPosition(vertexData);
+    maxLength = brCell->wall(wI)->lengthFromVertexPosition(vertexData);
   
-    double minLength=brCell->wall((wI+1)%(brCell->numWall()))->setLengthFromVertexPosition(vertexData);  
+    double minLength=brCell->wall((wI+1)%(brCell->numWall()))->lengthFromVertexPosition(vertexData);  
   
   
     // Find position for first two new vertices on the wall
@@ -870,9 +907,9 @@ namespace Division {
     // Find longest wall
     // 
     size_t wI=0,w3I=divCell->numWall();
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -1002,9 +1039,9 @@ namespace Division {
     //Find longest wall
     //////////////////////////////////////////////////////////////////////
     size_t wI=0;
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -1251,9 +1288,9 @@ namespace Division {
     //Find longest wall
     //////////////////////////////////////////////////////////////////////
     size_t wI=0;
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
 	wI=k;
 	maxLength = tmpLength;
@@ -2628,7 +2665,7 @@ namespace Division {
 	}
 	else {
 	}	      
-	//double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+	//double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
 	//if( tmpLength > maxLength ) {
 	//wI=k;
 	//maxLength = tmpLength;
@@ -5834,9 +5871,9 @@ namespace Division {
     // Find longest wall
     // 
     size_t wI=0,w3I=divCell->numWall();
-    double maxLength = divCell->wall(0)->setLengthFromVertexPosition(vertexData);
+    double maxLength = divCell->wall(0)->lengthFromVertexPosition(vertexData);
     for( size_t k=1 ; k<divCell->numWall() ; ++k ) {
-      double tmpLength = divCell->wall(k)->setLengthFromVertexPosition(vertexData);
+      double tmpLength = divCell->wall(k)->lengthFromVertexPosition(vertexData);
       if( tmpLength > maxLength ) {
   wI=k;
   maxLength = tmpLength;
@@ -55,6 +55,26 @@ namespace Division {
 		DataMatrix &cellDerivs,
 		DataMatrix &wallDerivs,
 		DataMatrix &vertexDerivs );  
+    ///
+    /// @brief The division is split into plan() and commit()
+    ///
+    int hasPlan() const;
+    ///
+    /// @brief Finds the longest wall and the opposite wall hit by the plane
+    /// perpendicular to it through its center
+    ///
+    void plan(Tissue* T,size_t i,
+	      const DataMatrix &cellData,
+	      const DataMatrix &wallData,
+	      const DataMatrix &vertexData,
+	      DivisionPlan &plan);
+    void commit(Tissue* T,size_t i,const DivisionPlan &plan,
+		DataMatrix &cellData,
+		DataMatrix &wallData,
+		DataMatrix &vertexData,
+		DataMatrix &cellDerivs,
+		DataMatrix &wallDerivs,
+		DataMatrix &vertexDerivs );
   };
 
   ///
@@ -0,0 +1,119 @@
+//
+// Filename     : convergence.cc
+// Description  : Steady state detection from the derivatives over a window of steps
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <cmath>
+#include <cstdlib>
+#include "convergence.h"
+
+ConvergenceMonitor::ConvergenceMonitor(std::istream &IN) :
+  window_(0), next_(0), numStored_(0)
+{
+  size_t numCriterion=0;
+  if( !(IN >> window_ >> numCriterion) || !window_ || !numCriterion ) {
+    std::cerr << "ConvergenceMonitor::ConvergenceMonitor() Expected 'Convergence"
+	      << " window numCriterion' with positive values." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  criterion_.resize(numCriterion);
+  for( size_t k=0 ; k<numCriterion ; ++k ) {
+    std::string blockId;
+    size_t numColumn=0;
+    IN >> blockId >> criterion_[k].maxTolerance >> criterion_[k].rmsTolerance
+       >> numColumn;
+    if( blockId=="cell" )
+      criterion_[k].block = cell;
+    else if( blockId=="wall" )
+      criterion_[k].block = wall;
+    else if( blockId=="vertex" )
+      criterion_[k].block = vertex;
+    else {
+      std::cerr << "ConvergenceMonitor::ConvergenceMonitor() Block '" << blockId
+		<< "' not recognized (cell, wall, vertex allowed)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    criterion_[k].column.resize(numColumn);
+    for( size_t c=0 ; c<numColumn ; ++c )
+      IN >> criterion_[k].column[c];
+  }
+  if( !IN ) {
+    std::cerr << "ConvergenceMonitor::ConvergenceMonitor() Error reading the "
+	      << numCriterion << " criteria." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  history_.resize(window_,std::vector<double>(2*numCriterion));
+}
+
+void ConvergenceMonitor::measure(const DataMatrix &derivs,
+				 const std::vector<size_t> &column,
+				 double &maxValue,double &rmsValue)
+{
+  maxValue = rmsValue = 0.0;
+  size_t count=0;
+  for( size_t i=0 ; i<derivs.size() ; ++i ) {
+    size_t numColumn = column.size() ? column.size() : derivs[i].size();
+    for( size_t c=0 ; c<numColumn ; ++c ) {
+      size_t j = column.size() ? column[c] : c;
+      if( j>=derivs[i].size() ) {
+	std::cerr << "ConvergenceMonitor::update() Column " << j
+		  << " out of range." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      double value = std::fabs(derivs[i][j]);
+      if( value>maxValue )
+	maxValue = value;
+      rmsValue += value*value;
+      ++count;
+    }
+  }
+  if( count )
+    rmsValue = std::sqrt(rmsValue/count);
+}
+
+int ConvergenceMonitor::fulfilled(size_t k,const std::vector<double> &value) const
+{
+  return ( criterion_[k].maxTolerance<0.0 ||
+	   value[2*k]<criterion_[k].maxTolerance ) &&
+    ( criterion_[k].rmsTolerance<0.0 ||
+      value[2*k+1]<criterion_[k].rmsTolerance );
+}
+
+bool ConvergenceMonitor::update(const DataMatrix &cellDerivs,
+				const DataMatrix &wallDerivs,
+				const DataMatrix &vertexDerivs)
+{
+  const DataMatrix *derivs[3] = {&cellDerivs,&wallDerivs,&vertexDerivs};
+  std::vector<double> &value = history_[next_];
+  for( size_t k=0 ; k<criterion_.size() ; ++k )
+    measure(*derivs[criterion_[k].block],criterion_[k].column,value[2*k],
+	    value[2*k+1]);
+  next_ = (next_+1)%window_;
+  if( numStored_<window_ )
+    ++numStored_;
+  if( numStored_<window_ )
+    return false;
+  for( size_t n=0 ; n<window_ ; ++n )
+    for( size_t k=0 ; k<criterion_.size() ; ++k )
+      if( !fulfilled(k,history_[n]) )
+	return false;
+  return true;
+}
+
+void ConvergenceMonitor::print(std::ostream &os) const
+{
+  const char *blockName[3] = {"cell","wall","vertex"};
+  for( size_t k=0 ; k<criterion_.size() ; ++k ) {
+    double maxValue=0.0,rmsValue=0.0;
+    for( size_t n=0 ; n<numStored_ ; ++n ) {
+      if( history_[n][2*k]>maxValue )
+	maxValue = history_[n][2*k];
+      if( history_[n][2*k+1]>rmsValue )
+	rmsValue = history_[n][2*k+1];
+    }
+    os << " " << blockName[criterion_[k].block] << " max " << maxValue
+       << " rms " << rmsValue;
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+//
+// Filename     : convergence.h
+// Description  : Steady state detection from the derivatives over a window of steps
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myTypedefs.h"
+
+///
+/// @brief Detects a steady state from the maximal and root mean square
+/// derivatives of variable blocks over a sliding window of steps
+///
+/// @details The monitor is declared in a block following the solver
+/// parameters in the solver file (see BaseSolver::getSolver()):
+/// @verbatim
+/// Convergence window numCriterion
+/// block maxTolerance rmsTolerance numColumn [column ...]
+/// ...
+/// @endverbatim
+/// where block is one of cell, wall or vertex, and the criterion is applied
+/// to the listed columns of the derivatives of that block (all columns if
+/// numColumn is 0). A step fulfils a criterion if the maximal absolute
+/// derivative is below maxTolerance and the root mean square derivative is
+/// below rmsTolerance (a negative tolerance is not checked). The state is
+/// converged when all criteria have been fulfilled for the last window
+/// steps, e.g.
+/// @verbatim
+/// Convergence 20 1
+/// vertex 1e-6 1e-7 0
+/// @endverbatim
+/// stops a mechanical relaxation when all vertex velocities have been below
+/// 1e-6 for 20 consecutive steps. When converged, the solvers end the
+/// simulation and print the final time point.
+///
+/// @see BaseSolver::checkConvergence()
+///
+class ConvergenceMonitor {
+
+ public:
+
+  enum Block {
+    cell=0,
+    wall,
+    vertex
+  };
+
+ private:
+
+  struct Criterion {
+    int block;
+    double maxTolerance;
+    double rmsTolerance;
+    std::vector<size_t> column;
+  };
+  std::vector<Criterion> criterion_;
+  size_t window_;
+  ///
+  /// @brief Maximal and root mean square derivative for each criterion in
+  /// the last window steps (ring buffer starting at next_)
+  ///
+  std::vector< std::vector<double> > history_;
+  size_t next_;
+  size_t numStored_;
+
+  static void measure(const DataMatrix &derivs,
+		      const std::vector<size_t> &column,
+		      double &maxValue,double &rmsValue);
+  int fulfilled(size_t k,const std::vector<double> &value) const;
+
+ public:
+  ///
+  /// @brief Reads the block (after the 'Convergence' keyword)
+  ///
+  ConvergenceMonitor(std::istream &IN);
+  ///
+  /// @brief Adds the derivatives of a step to the window and returns true if
+  /// all criteria are fulfilled over the full window
+  ///
+  bool update(const DataMatrix &cellDerivs,const DataMatrix &wallDerivs,
+	      const DataMatrix &vertexDerivs);
+  ///
+  /// @brief Prints the largest maximal and root mean square derivatives
+  /// over the window for each criterion
+  ///
+  void print(std::ostream &os) const;
+  inline size_t window() const;
+};
+
+inline size_t ConvergenceMonitor::window() const { return window_; }
+
+#endif
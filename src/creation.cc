@@ -7,6 +7,7 @@
 //
 #include"tissue.h"
 #include"baseReaction.h"
+#include"hybridStochastic.h"
 #include"creation.h"
 #include<cmath>
 
@@ -62,6 +63,14 @@ derivs(Tissue &T,
   }
 }
 
+int CreationZero::
+channel(ReactionChannel &C) const
+{
+  C.setRate(parameter(0));
+  C.addChange(variableIndex(0,0),1.0);
+  return 1;
+}
+
 void CreationZero::
 derivsWithAbs(Tissue &T,
 	      DataMatrix &cellData,
@@ -140,6 +149,15 @@ derivs(Tissue &T,
   }
 }
 
+int CreationOne::
+channel(ReactionChannel &C) const
+{
+  C.setRate(parameter(0));
+  C.addFactor(variableIndex(1,0));
+  C.addChange(variableIndex(0,0),1.0);
+  return 1;
+}
+
 void CreationOne::
 derivsWithAbs(Tissue &T,
 	      DataMatrix &cellData,
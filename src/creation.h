@@ -29,7 +29,7 @@
 /// c_index
 /// @endverbatim
 ///
-class CreationZero : public BaseReaction {
+class CreationZero : public BaseChemicalReaction {
   
  public:
   
@@ -61,6 +61,12 @@ class CreationZero : public BaseReaction {
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
   ///
+  /// @brief Describes the reaction as a stochastic channel (copy numbers)
+  ///
+  /// @see BaseReaction::channel()
+  ///
+  int channel(ReactionChannel &C) const;
+  ///
   /// @brief Derivative function for this reaction class calculating the absolute value for noise solvers
   ///
   /// @see BaseReaction::derivsWithAbs(Compartment &compartment,size_t species,...)
@@ -97,7 +103,7 @@ class CreationZero : public BaseReaction {
 /// X_index
 /// @endverbatim
 ///
-class CreationOne : public BaseReaction {
+class CreationOne : public BaseChemicalReaction {
   
  public:
   
@@ -129,6 +135,12 @@ class CreationOne : public BaseReaction {
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
   ///
+  /// @brief Describes the reaction as a stochastic channel (copy numbers)
+  ///
+  /// @see BaseReaction::channel()
+  ///
+  int channel(ReactionChannel &C) const;
+  ///
   /// @brief Derivative function for this reaction class calculating the absolute value for noise solvers
   ///
   /// @see BaseReaction::derivsWithAbs(Compartment &compartment,size_t species,...)
@@ -145,7 +157,7 @@ class CreationOne : public BaseReaction {
 		     DataMatrix &sdydtVertex );
 };
 
-class CreationTwo : public BaseReaction {
+class CreationTwo : public BaseChemicalReaction {
   
  public:
   
@@ -199,7 +211,7 @@ class CreationTwo : public BaseReaction {
 /// c_index
 /// @endverbatim
 ///
-class CreationSpatialSphere : public BaseReaction {
+class CreationSpatialSphere : public BaseChemicalReaction {
   
  public:
   
@@ -258,7 +270,7 @@ class CreationSpatialSphere : public BaseReaction {
 /// c_index
 /// @endverbatim
 ///
-class CreationSpatialRing : public BaseReaction {
+class CreationSpatialRing : public BaseChemicalReaction {
   
  public:
   
@@ -317,7 +329,7 @@ class CreationSpatialRing : public BaseReaction {
 /// x_index
 /// @endverbatim
 ///
-class CreationSpatialCoordinate: public BaseReaction {
+class CreationSpatialCoordinate: public BaseChemicalReaction {
   
  public:
   
@@ -377,7 +389,7 @@ class CreationSpatialCoordinate: public BaseReaction {
 /// x_index
 /// @endverbatim
 ///
-class CreationSpatialPlane: public BaseReaction {
+class CreationSpatialPlane: public BaseChemicalReaction {
   
  public:
   
@@ -429,7 +441,7 @@ class CreationSpatialPlane: public BaseReaction {
 /// a list of indices with n members
 /// @endverbatim
 ///
-class CreationFromList: public BaseReaction {
+class CreationFromList: public BaseChemicalReaction {
   
   
 private: 
@@ -487,7 +499,7 @@ public:
 /// X_index
 /// @endverbatim
 ///
-class CreationOneGeometric : public BaseReaction {
+class CreationOneGeometric : public BaseChemicalReaction {
   
  public:
   
@@ -540,7 +552,7 @@ class CreationOneGeometric : public BaseReaction {
 /// index
 /// @endverbatim
 ///
-class CreationSinus : public BaseReaction {
+class CreationSinus : public BaseChemicalReaction {
 
  private:
 
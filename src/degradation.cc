@@ -7,6 +7,7 @@
 //
 #include"tissue.h"
 #include"baseReaction.h"
+#include"hybridStochastic.h"
 #include"degradation.h"
 #include<cmath>
 
@@ -62,6 +63,15 @@ derivs(Tissue &T,
   }
 }
 
+int DegradationOne::
+channel(ReactionChannel &C) const
+{
+  C.setRate(parameter(0));
+  C.addFactor(variableIndex(0,0));
+  C.addChange(variableIndex(0,0),-1.0);
+  return 1;
+}
+
 
 void DegradationOne::
 derivsWithAbs(Tissue &T,
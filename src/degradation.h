@@ -30,7 +30,7 @@
 /// c_index
 /// @endverbatim
 ///
-class DegradationOne : public BaseReaction {
+class DegradationOne : public BaseChemicalReaction {
   
  public:
   
@@ -61,6 +61,12 @@ class DegradationOne : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Describes the reaction as a stochastic channel (copy numbers)
+  ///
+  /// @see BaseReaction::channel()
+  ///
+  int channel(ReactionChannel &C) const;
 
 
       void derivsWithAbs(Tissue &T,
@@ -95,7 +101,7 @@ class DegradationOne : public BaseReaction {
 /// X_index
 /// @endverbatim
 ///
-class DegradationTwo : public BaseReaction {
+class DegradationTwo : public BaseChemicalReaction {
   
  public:
   
@@ -147,7 +153,7 @@ class DegradationTwo : public BaseReaction {
 /// X_0 .. X_n
 /// @endverbatim
 ///
-class DegradationN : public BaseReaction {
+class DegradationN : public BaseChemicalReaction {
   
  public:
   
@@ -208,7 +214,7 @@ class DegradationN : public BaseReaction {
 ///
 /// where index1 is the degraded molecule and index2 is the other (e.g miRNA) molecule in the Hill.
 ///
-class DegradationHill : public BaseReaction {
+class DegradationHill : public BaseChemicalReaction {
   
  public:
   
@@ -276,7 +282,7 @@ class DegradationHill : public BaseReaction {
 /// k'_0 .. k'_M              # indices of repressors
 /// @endverbatim
 ///
-class DegradationHillN : public BaseReaction {
+class DegradationHillN : public BaseChemicalReaction {
   
  public:
   
@@ -334,7 +340,7 @@ class DegradationHillN : public BaseReaction {
 /// X_index
 /// @endverbatim
 ///
-class DegradationTwoGeometric : public BaseReaction {
+class DegradationTwoGeometric : public BaseChemicalReaction {
   
  public:
   
@@ -385,7 +391,7 @@ class DegradationTwoGeometric : public BaseReaction {
 /// cw_index
 /// @endverbatim
 ///
-class DegradationOneWall : public BaseReaction {
+class DegradationOneWall : public BaseChemicalReaction {
   
  public:
   
@@ -451,7 +457,7 @@ class DegradationOneWall : public BaseReaction {
 /// c_index
 /// @endverbatim
 ///
-class DegradationOneBoundary : public BaseReaction {
+class DegradationOneBoundary : public BaseChemicalReaction {
   
  public:
   
@@ -516,7 +522,7 @@ class DegradationOneBoundary : public BaseReaction {
 /// cell_index_0 .. cell_index_N
 /// @endverbatim
 ///
-class DegradationOneFromList : public BaseReaction {
+class DegradationOneFromList : public BaseChemicalReaction {
 
  private:
   size_t numCellI;
@@ -9,6 +9,7 @@
 #include"directionReaction.h"
 #include"tissue.h"
 #include"baseReaction.h"
+#include"reactionSchedule.h"
 #include"myMath.h"
 #include<cmath>
 
@@ -207,6 +208,12 @@ void ContinousMTDirection3d::derivs(Tissue &T,
 
 }
 
+void ContinousMTDirection3d::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 UpdateMTDirection::UpdateMTDirection(std::vector<double> &paraValue,
 				     std::vector< std::vector<size_t> > &indValue)
 {
@@ -285,6 +292,12 @@ void UpdateMTDirection::update(Tissue &T,
   }
 }
 
+void UpdateMTDirection::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 UpdateMTDirectionEquilibrium::UpdateMTDirectionEquilibrium(std::vector<double> &paraValue,
 				     std::vector< std::vector<size_t> > &indValue)
 {
@@ -510,6 +523,12 @@ void UpdateMTDirectionConcenHill::derivs(Tissue &T,
 
 }
 
+void UpdateMTDirectionConcenHill::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 void UpdateMTDirectionConcenHill::update(Tissue &T,
 			       DataMatrix &cellData,
 			       DataMatrix &wallData,
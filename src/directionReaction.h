@@ -77,6 +77,12 @@ public:
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs);
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -115,6 +121,12 @@ class UpdateMTDirection : public BaseReaction
 		    DataMatrix &cellDerivs,
 		    DataMatrix &wallDerivs,
 		    DataMatrix &vertexDerivs );
+	///
+	/// @brief Declares exclusive access since tissue data is updated in derivs()
+	///
+	/// @see BaseReaction::access()
+	///
+	void access(ReactionAccess &A) const;
 	void update(Tissue &T,
 		    DataMatrix &cellData,
 		    DataMatrix &wallData,
@@ -214,6 +226,12 @@ class UpdateMTDirectionConcenHill : public BaseReaction
 		    DataMatrix &cellDerivs,
 		    DataMatrix &wallDerivs,
 		    DataMatrix &vertexDerivs );
+	///
+	/// @brief Declares exclusive access since tissue data is updated in derivs()
+	///
+	/// @see BaseReaction::access()
+	///
+	void access(ReactionAccess &A) const;
 	void update(Tissue &T,
 		    DataMatrix &cellData,
 		    DataMatrix &wallData,
@@ -7,6 +7,7 @@
 //
 #include <cmath>
 #include "euler.h"
+#include "solverState.h"
 
 Euler::Euler(Tissue *T,std::ifstream &IN)
   : BaseSolver(T,IN)
@@ -93,12 +94,16 @@ void Euler::simulate(size_t verbose)
   numOk_ = numBad_ = 0;
   while( t_<endTime_ ) {
     if (debugFlag()) {
-      cellDataCopy_[debugCount()] = cellData_;
+      recordDebug();
     } 
     //Update the derivatives
     T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
 	       vertexDerivs_);
     
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+    
     //Print if applicable 
     if( doPrint && t_ >= printTime ) {
       printTime += printDeltaTime;
@@ -119,12 +124,14 @@ void Euler::simulate(size_t verbose)
     //
     T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
 			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
     T_->updateReactions(cellData_,wallData_,vertexData_,h_);
     T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
 			       cellDerivs_,wallDerivs_,vertexDerivs_ );
     
     // Check the tissue connectivity in each step
     T_->checkConnectivity(1);
+    checkRenumber();
         
     //update time variable
     if( (t_+h_)==t_ ) {
@@ -148,14 +155,8 @@ void Euler::eulerStep()
   // Take step
   // Is this derivs calculation needed?
   T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,vertexDerivs_);
-  for( size_t i=0 ; i<cellData_.size() ; ++i )
-    for( size_t j=0 ; j<cellData_[i].size() ; ++j )
-      cellData_[i][j] = cellData_[i][j] + h_*cellDerivs_[i][j];
-  for( size_t i=0 ; i<wallData_.size() ; ++i )
-    for( size_t j=0 ; j<wallData_[i].size() ; ++j )
-      wallData_[i][j] = wallData_[i][j] + h_*wallDerivs_[i][j];
-  for( size_t i=0 ; i<vertexData_.size() ; ++i )
-    for( size_t j=0 ; j<vertexData_[i].size() ; ++j )
-      vertexData_[i][j] = vertexData_[i][j] + h_*vertexDerivs_[i][j];
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  y.axpy(h_,dydt);
 }
 
@@ -0,0 +1,345 @@
+//
+// Filename     : frameStream.cc
+// Description  : Streaming (frame by frame) reading and processing of simulator output
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+#include "frameStream.h"
+#include "myParallel.h"
+
+void Frame::cellNeighbor(std::vector< std::vector<size_t> > &neighbor) const
+{
+  // Collect all cell edges (sorted vertex pairs) and match equal ones
+  size_t numCell = cellVertex.size();
+  typedef std::pair< std::pair<size_t,size_t>,size_t > CellEdge;
+  std::vector<CellEdge> edge;
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    size_t numV = cellVertex[i].size();
+    for( size_t k=0 ; k<numV ; ++k ) {
+      size_t v1 = cellVertex[i][k], v2 = cellVertex[i][(k+1)%numV];
+      edge.push_back( CellEdge(std::make_pair(std::min(v1,v2),std::max(v1,v2)),i) );
+    }
+  }
+  std::sort(edge.begin(),edge.end());
+  neighbor.assign(numCell,std::vector<size_t>());
+  for( size_t k=1 ; k<edge.size() ; ++k )
+    if( edge[k].first==edge[k-1].first && edge[k].second!=edge[k-1].second ) {
+      neighbor[edge[k].second].push_back(edge[k-1].second);
+      neighbor[edge[k-1].second].push_back(edge[k].second);
+    }
+}
+
+FrameReader::FrameReader(std::istream &IN, int printFlag)
+{
+  if( printFlag!=0 && printFlag!=3 && printFlag!=4 && printFlag!=11 ) {
+    std::cerr << "FrameReader::FrameReader() Only printFlag 0, 3, 4 and 11 output "
+	      << "can be read (" << printFlag << " given)." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  IN_ = &IN;
+  printFlag_ = printFlag;
+  numFrame_ = frameCount_ = 0;
+  revision_ = 0;
+  topologyRead_ = false;
+  if( !(IN >> numFrame_) ) {
+    std::cerr << "FrameReader::FrameReader() Cannot read number of frames."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+bool FrameReader::read(Frame &frame)
+{
+  std::istream &IN = *IN_;
+  if( printFlag_==11 )
+    return readTopologyDelta(frame);
+  size_t numVertex,dimension;
+  if( !(IN >> numVertex >> dimension) )
+    return false;
+  frame.index = frameCount_;
+  frame.vertexPosition.resize(numVertex);
+  for( size_t i=0 ; i<numVertex ; ++i ) {
+    frame.vertexPosition[i].resize(dimension);
+    for( size_t d=0 ; d<dimension ; ++d )
+      IN >> frame.vertexPosition[i][d];
+  }
+  frame.cellData.clear();
+  frame.cellVertex.clear();
+  frame.wallData.clear();
+  frame.wallVertex.clear();
+  if( !numVertex ) {
+    // Empty tissue, a single '0 0' line follows
+    size_t tmp;
+    IN >> tmp >> tmp;
+  }
+  else {
+    if( printFlag_==0 || printFlag_==3 ) {
+      size_t numCell,numVar;
+      IN >> numCell >> numVar;
+      frame.cellData.resize(numCell);
+      frame.cellVertex.resize(numCell);
+      for( size_t i=0 ; i<numCell && IN ; ++i ) {
+	size_t numCellVertex;
+	IN >> numCellVertex;
+	frame.cellVertex[i].resize(numCellVertex);
+	for( size_t k=0 ; k<numCellVertex ; ++k )
+	  IN >> frame.cellVertex[i][k];
+	frame.cellData[i].resize(numVar);
+	for( size_t k=0 ; k<numVar ; ++k )
+	  IN >> frame.cellData[i][k];
+      }
+    }
+    if( printFlag_==0 || printFlag_==4 ) {
+      size_t numWall,numVar;
+      IN >> numWall >> numVar;
+      frame.wallData.resize(numWall);
+      frame.wallVertex.resize(numWall);
+      for( size_t i=0 ; i<numWall && IN ; ++i ) {
+	size_t numWallVertex=2;
+	if( printFlag_==4 )
+	  IN >> numWallVertex;
+	frame.wallVertex[i].resize(numWallVertex);
+	for( size_t k=0 ; k<numWallVertex ; ++k )
+	  IN >> frame.wallVertex[i][k];
+	frame.wallData[i].resize(numVar);
+	for( size_t k=0 ; k<numVar ; ++k )
+	  IN >> frame.wallData[i][k];
+      }
+    }
+  }
+  if( !IN ) {
+    std::cerr << "FrameReader::read() Frame " << frameCount_
+	      << " is incomplete and is ignored." << std::endl;
+    return false;
+  }
+  ++frameCount_;
+  return true;
+}
+
+bool FrameReader::readTopologyDelta(Frame &frame)
+{
+  std::istream &IN = *IN_;
+  size_t revision,changed;
+  if( !(IN >> revision >> changed) )
+    return false;
+  if( changed ) {
+    size_t numCell,numWall;
+    IN >> numCell;
+    cellVertex_.resize(numCell);
+    for( size_t i=0 ; i<numCell && IN ; ++i ) {
+      size_t numCellVertex;
+      IN >> numCellVertex;
+      cellVertex_[i].resize(numCellVertex);
+      for( size_t k=0 ; k<numCellVertex ; ++k )
+	IN >> cellVertex_[i][k];
+    }
+    IN >> numWall;
+    wallVertex_.resize(numWall);
+    for( size_t i=0 ; i<numWall && IN ; ++i ) {
+      wallVertex_[i].resize(2);
+      IN >> wallVertex_[i][0] >> wallVertex_[i][1];
+    }
+    revision_ = revision;
+    topologyRead_ = true;
+  }
+  else if( !topologyRead_ || revision!=revision_ ) {
+    std::cerr << "FrameReader::readTopologyDelta() Frame " << frameCount_
+	      << " refers to topology revision " << revision
+	      << " which has not been read." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  frame.index = frameCount_;
+  size_t numVertex,dimension;
+  IN >> numVertex >> dimension;
+  frame.vertexPosition.resize(numVertex);
+  for( size_t i=0 ; i<numVertex && IN ; ++i ) {
+    frame.vertexPosition[i].resize(dimension);
+    for( size_t d=0 ; d<dimension ; ++d )
+      IN >> frame.vertexPosition[i][d];
+  }
+  size_t numCell,numWall,numVar;
+  IN >> numCell >> numVar;
+  frame.cellData.resize(numCell);
+  for( size_t i=0 ; i<numCell && IN ; ++i ) {
+    frame.cellData[i].resize(numVar);
+    for( size_t k=0 ; k<numVar ; ++k )
+      IN >> frame.cellData[i][k];
+  }
+  IN >> numWall >> numVar;
+  frame.wallData.resize(numWall);
+  for( size_t i=0 ; i<numWall && IN ; ++i ) {
+    frame.wallData[i].resize(numVar);
+    for( size_t k=0 ; k<numVar ; ++k )
+      IN >> frame.wallData[i][k];
+  }
+  if( !IN ) {
+    std::cerr << "FrameReader::readTopologyDelta() Frame " << frameCount_
+	      << " is incomplete and is ignored." << std::endl;
+    return false;
+  }
+  if( numCell!=cellVertex_.size() || numWall!=wallVertex_.size() ) {
+    std::cerr << "FrameReader::readTopologyDelta() Frame " << frameCount_
+	      << " does not match the size of topology revision " << revision_
+	      << "." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  frame.cellVertex = cellVertex_;
+  frame.wallVertex = wallVertex_;
+  ++frameCount_;
+  return true;
+}
+
+FrameFilter::~FrameFilter()
+{
+}
+
+CellVariableFilter::CellVariableFilter(const std::vector<size_t> &column)
+  : column_(column)
+{
+}
+
+void CellVariableFilter::process(const Frame &frame, std::ostream &os) const
+{
+  for( size_t i=0 ; i<frame.cellData.size() ; ++i ) {
+    os << frame.index << " " << i;
+    for( size_t k=0 ; k<column_.size() ; ++k ) {
+      if( column_[k]>=frame.cellData[i].size() ) {
+	std::cerr << "CellVariableFilter::process() Column " << column_[k]
+		  << " out of range." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      os << " " << frame.cellData[i][column_[k]];
+    }
+    os << std::endl;
+  }
+}
+
+CellStatisticsFilter::CellStatisticsFilter(const std::vector<size_t> &column)
+  : column_(column)
+{
+}
+
+void CellStatisticsFilter::process(const Frame &frame, std::ostream &os) const
+{
+  size_t numCell = frame.cellData.size();
+  os << frame.index << " " << numCell;
+  for( size_t k=0 ; k<column_.size() ; ++k ) {
+    size_t col = column_[k];
+    double sum=0.0, sum2=0.0, min=0.0, max=0.0;
+    for( size_t i=0 ; i<numCell ; ++i ) {
+      if( col>=frame.cellData[i].size() ) {
+	std::cerr << "CellStatisticsFilter::process() Column " << col
+		  << " out of range." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      double value = frame.cellData[i][col];
+      sum += value;
+      sum2 += value*value;
+      if( i==0 || value<min )
+	min = value;
+      if( i==0 || value>max )
+	max = value;
+    }
+    double mean = numCell ? sum/numCell : 0.0;
+    double var = numCell ? sum2/numCell-mean*mean : 0.0;
+    os << " " << mean << " " << std::sqrt(var>0.0 ? var : 0.0) << " " << min
+       << " " << max;
+  }
+  os << std::endl;
+}
+
+CellPeakFilter::CellPeakFilter(size_t column)
+  : column_(column)
+{
+}
+
+void CellPeakFilter::process(const Frame &frame, std::ostream &os) const
+{
+  size_t numCell = frame.cellData.size();
+  std::vector< std::vector<size_t> > neighbor;
+  frame.cellNeighbor(neighbor);
+  for( size_t i=0 ; i<numCell ; ++i )
+    if( column_>=frame.cellData[i].size() ) {
+      std::cerr << "CellPeakFilter::process() Column " << column_
+		<< " out of range." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  // Greedy uphill walk from each cell, flag holds the (1-based) maximum
+  // reached (same as Tissue::findPeaksGradientAscent())
+  std::vector<size_t> flag(numCell,0);
+  std::vector<size_t> cellTmp,walkTmp;
+  size_t count=1;
+  for( size_t iStart=0 ; iStart<numCell ; ++iStart ) {
+    size_t i=iStart;
+    walkTmp.assign(1,i);
+    if( !flag[i] ) {
+      double value,newValue;
+      do {
+	newValue=value=frame.cellData[i][column_];
+	size_t newI=i;
+	for( size_t k=0 ; k<neighbor[i].size() ; ++k ) {
+	  size_t j = neighbor[i][k];
+	  if( frame.cellData[j][column_]>newValue ) {
+	    newValue=frame.cellData[j][column_];
+	    newI=j;
+	  }
+	}
+	i=newI;
+	walkTmp.push_back(i);
+      } while( newValue>value && !flag[i] );
+    }
+    size_t n = flag[i];
+    if( !n ) {
+      cellTmp.push_back(i);
+      n = count++;
+    }
+    for( size_t a=0 ; a<walkTmp.size() ; ++a )
+      flag[walkTmp[a]] = n;
+  }
+  std::vector<size_t> cellMax;
+  for( size_t n=0 ; n<cellTmp.size() ; ++n )
+    if( frame.cellData[cellTmp[n]][column_]>0.0 )
+      cellMax.push_back(cellTmp[n]);
+  os << frame.index << " " << cellMax.size();
+  for( size_t n=0 ; n<cellMax.size() ; ++n )
+    os << " " << cellMax[n];
+  os << std::endl;
+}
+
+size_t processFrames(FrameReader &reader,
+		     const std::vector<FrameFilter*> &filter,
+		     std::ostream &os)
+{
+  size_t batchSize = myParallel::numThread();
+  if( batchSize<1 )
+    batchSize = 1;
+  std::vector<Frame> frame(batchSize);
+  std::vector<std::string> output(batchSize);
+  size_t numProcessed=0;
+  while( true ) {
+    size_t n=0;
+    while( n<batchSize && reader.read(frame[n]) )
+      ++n;
+    if( !n )
+      break;
+    myParallel::forEach(0,n,[&](size_t k) {
+	std::ostringstream out;
+	for( size_t f=0 ; f<filter.size() ; ++f )
+	  filter[f]->process(frame[k],out);
+	output[k] = out.str();
+      });
+    for( size_t k=0 ; k<n ; ++k )
+      os << output[k];
+    numProcessed += n;
+    if( n<batchSize )
+      break;
+  }
+  return numProcessed;
+}
@@ -0,0 +1,200 @@
+#ifndef FRAMESTREAM_H
+#define FRAMESTREAM_H
+//
+// Filename     : frameStream.h
+// Description  : Streaming (frame by frame) reading and processing of simulator output
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "myTypedefs.h"
+
+///
+/// @brief A single time point (frame) of simulator output
+///
+/// @details The data is stored as printed, i.e. the cell rows hold the cell
+/// variables followed by the derived columns written by BaseSolver::print()
+/// (printFlag 0: volume and number of walls; printFlag 3: index, volume and
+/// number of walls), and the wall rows hold the wall length and variables
+/// followed by index, length and strain columns. Data blocks not present in
+/// the given print format are left empty.
+///
+class Frame {
+
+ public:
+  ///
+  /// @brief Frame number in the file (starting at 0)
+  ///
+  size_t index;
+  DataMatrix vertexPosition;
+  DataMatrix cellData;
+  std::vector< std::vector<size_t> > cellVertex;
+  DataMatrix wallData;
+  std::vector< std::vector<size_t> > wallVertex;
+  ///
+  /// @brief Sets the neighbors of each cell, defined as cells sharing a pair
+  /// of consecutive vertices
+  ///
+  /// Only the cell -> vertex lists are used, such that this also works for
+  /// printFlag 3 output without walls.
+  ///
+  void cellNeighbor(std::vector< std::vector<size_t> > &neighbor) const;
+};
+
+///
+/// @brief Reads simulator output one frame at a time
+///
+/// @details Reads the output streams written by BaseSolver::print() for
+/// printFlag 0 (vertices, cells and walls), 3 (vertices and cells), 4
+/// (vertices and walls) and 11 (as 0, with topology deltas). Only the frame
+/// being read is kept in memory, and
+/// the containers of the Frame given to read() are reused, such that a full
+/// simulation output can be processed in constant memory:
+/// @verbatim
+/// FrameReader reader(IN,0);
+/// Frame frame;
+/// while( reader.read(frame) )
+///   ...
+/// @endverbatim
+///
+/// In printFlag 11 output each frame starts with 'revision changed'. If
+/// changed is 1 the cell vertex lists ('numCell' followed by 'numCellVertex
+/// v_0 ...' rows) and wall vertex pairs ('numWall' followed by 'v_1 v_2'
+/// rows) follow, otherwise the frame uses the last printed lists. Vertex
+/// positions, cell rows and wall rows follow as in printFlag 0 but without
+/// the vertex indices, and the Frame is filled in as for printFlag 0.
+///
+class FrameReader {
+
+ private:
+
+  std::istream *IN_;
+  int printFlag_;
+  size_t numFrame_;
+  size_t frameCount_;
+  // Last connectivity read from printFlag 11 output
+  size_t revision_;
+  bool topologyRead_;
+  std::vector< std::vector<size_t> > cellVertex_;
+  std::vector< std::vector<size_t> > wallVertex_;
+
+  bool readTopologyDelta(Frame &frame);
+
+ public:
+  ///
+  /// @brief Reads the file header (number of print points) from IN
+  ///
+  FrameReader(std::istream &IN, int printFlag=0);
+  ///
+  /// @brief Number of frames given in the header of the file
+  ///
+  /// The simulator writes the requested number of print points, and the
+  /// number of frames actually present may differ (e.g. interrupted runs).
+  ///
+  inline size_t numFrame() const;
+  ///
+  /// @brief Number of frames read so far
+  ///
+  inline size_t frameCount() const;
+  ///
+  /// @brief Reads the next frame, returns false at the end of the stream
+  ///
+  bool read(Frame &frame);
+};
+
+inline size_t FrameReader::numFrame() const
+{
+  return numFrame_;
+}
+
+inline size_t FrameReader::frameCount() const
+{
+  return frameCount_;
+}
+
+///
+/// @brief Base class for analyses applied to each frame of an output stream
+///
+/// @details The process() function is called concurrently for different
+/// frames and should only read the frame and the filter parameters and write
+/// its result to os. The outputs are written to the final stream in frame
+/// order by processFrames().
+///
+class FrameFilter {
+
+ public:
+  virtual ~FrameFilter();
+  virtual void process(const Frame &frame, std::ostream &os) const = 0;
+};
+
+///
+/// @brief Prints the given cell columns for each cell and frame
+///
+/// Each row is 'frame cell value_0 ... value_N-1'.
+///
+class CellVariableFilter : public FrameFilter {
+
+ private:
+
+  std::vector<size_t> column_;
+
+ public:
+  CellVariableFilter(const std::vector<size_t> &column);
+  void process(const Frame &frame, std::ostream &os) const;
+};
+
+///
+/// @brief Prints statistics over the cells of the given columns per frame
+///
+/// Each row is 'frame numCell' followed by 'mean std min max' for each
+/// column.
+///
+class CellStatisticsFilter : public FrameFilter {
+
+ private:
+
+  std::vector<size_t> column_;
+
+ public:
+  CellStatisticsFilter(const std::vector<size_t> &column);
+  void process(const Frame &frame, std::ostream &os) const;
+};
+
+///
+/// @brief Finds the cells with local maxima in a cell column per frame
+///
+/// Uses the same greedy gradient ascent as
+/// Tissue::findPeaksGradientAscent() (without building a Tissue), with cell
+/// neighbors from Frame::cellNeighbor(). Each row is 'frame numPeak
+/// cell_0 ... cell_numPeak-1'.
+///
+class CellPeakFilter : public FrameFilter {
+
+ private:
+
+  size_t column_;
+
+ public:
+  CellPeakFilter(size_t column);
+  void process(const Frame &frame, std::ostream &os) const;
+};
+
+///
+/// @brief Reads all frames from reader and applies the filters to each
+///
+/// @details Frames are read in batches of myParallel::numThread() frames,
+/// the filters are applied to the frames in a batch in parallel, and the
+/// outputs are written to os in frame order before the next batch is read.
+/// Memory use is hence independent of the number of frames. Returns the
+/// number of frames processed.
+///
+size_t processFrames(FrameReader &reader,
+		     const std::vector<FrameFilter*> &filter,
+		     std::ostream &os);
+
+#endif
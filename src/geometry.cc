@@ -0,0 +1,189 @@
+//
+// Filename     : geometry.cc
+// Description  : Index based surface mesh (faces, edges, vertices) and a contiguous state store
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <utility>
+#include "geometry.h"
+#include "tissueTopology.h"
+
+const size_t Geometry::boundary;
+
+Geometry::Geometry() :
+  revision_(0), numVertex_(0), faceStart_(1,0)
+{
+}
+
+void Geometry::build(const TissueTopology &topology)
+{
+  for( size_t i=0 ; i<topology.numCell() ; ++i )
+    if( topology.numCellWall(i)!=topology.numCellVertex(i) ) {
+      std::cerr << "Geometry::build() Cell " << i << " has "
+		<< topology.numCellVertex(i) << " vertices and "
+		<< topology.numCellWall(i) << " walls." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  revision_ = topology.revision();
+  numVertex_ = topology.numVertex();
+  faceStart_ = topology.cellVertexStart();
+  faceVertex_ = topology.cellVertex();
+  faceEdge_ = topology.cellWall();
+  edgeVertex_ = topology.wallVertex();
+  edgeFace_ = topology.wallCell();
+}
+
+void Geometry::build(const std::vector< std::vector<size_t> > &faceVertex,
+		     size_t numVertexVal)
+{
+  revision_ = 0;
+  numVertex_ = numVertexVal;
+  faceStart_.assign(1,0);
+  faceVertex_.clear();
+  faceEdge_.clear();
+  edgeVertex_.clear();
+  edgeFace_.clear();
+  std::map<std::pair<size_t,size_t>,size_t> edgeIndex;
+  for( size_t i=0 ; i<faceVertex.size() ; ++i ) {
+    size_t numFaceVertexVal = faceVertex[i].size();
+    if( numFaceVertexVal<3 ) {
+      std::cerr << "Geometry::build() Face " << i << " has less than three"
+		<< " vertices." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    for( size_t k=0 ; k<numFaceVertexVal ; ++k ) {
+      size_t v1 = faceVertex[i][k];
+      size_t v2 = faceVertex[i][(k+1)%numFaceVertexVal];
+      if( v1>=numVertex_ || v2>=numVertex_ ) {
+	std::cerr << "Geometry::build() Vertex index out of range in face "
+		  << i << "." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      std::pair<size_t,size_t> key(std::min(v1,v2),std::max(v1,v2));
+      std::map<std::pair<size_t,size_t>,size_t>::iterator it =
+	edgeIndex.find(key);
+      size_t e;
+      if( it==edgeIndex.end() ) {
+	e = edgeVertex_.size()/2;
+	edgeIndex[key] = e;
+	edgeVertex_.push_back(v1);
+	edgeVertex_.push_back(v2);
+	edgeFace_.push_back(i);
+	edgeFace_.push_back(boundary);
+      }
+      else {
+	e = it->second;
+	if( edgeFace_[2*e+1]!=boundary ) {
+	  std::cerr << "Geometry::build() Edge " << v1 << "-" << v2
+		    << " shared by more than two faces." << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+	edgeFace_[2*e+1] = i;
+      }
+      faceVertex_.push_back(v1);
+      faceEdge_.push_back(e);
+    }
+    faceStart_.push_back(faceVertex_.size());
+  }
+}
+
+GeometryState::GeometryState() :
+  dimension_(0), numEdgeVariable_(0), numFaceVariable_(0),
+  vertexData_(0), wallData_(0), cellData_(0)
+{
+}
+
+void GeometryState::resize(size_t numVertex,size_t dimension,size_t numEdge,
+			   size_t numEdgeVariable,size_t numFace,
+			   size_t numFaceVariable)
+{
+  dimension_ = dimension;
+  numEdgeVariable_ = numEdgeVariable;
+  numFaceVariable_ = numFaceVariable;
+  vertexData_ = wallData_ = cellData_ = 0;
+  vertex_.assign(numVertex*dimension,0.0);
+  edge_.assign(numEdge*numEdgeVariable,0.0);
+  face_.assign(numFace*numFaceVariable,0.0);
+}
+
+void GeometryState::setZero()
+{
+  std::fill(vertex_.begin(),vertex_.end(),0.0);
+  std::fill(edge_.begin(),edge_.end(),0.0);
+  std::fill(face_.begin(),face_.end(),0.0);
+}
+
+void GeometryState::gather(const DataMatrix &cellData,
+			   const DataMatrix &wallData,
+			   const DataMatrix &vertexData)
+{
+  size_t dimension = vertexData.size() ? vertexData[0].size() : 0;
+  size_t numEdgeVariable=0, numFaceVariable=0;
+  for( size_t i=0 ; i<wallData.size() ; ++i )
+    numEdgeVariable = std::max(numEdgeVariable,wallData[i].size());
+  for( size_t i=0 ; i<cellData.size() ; ++i )
+    numFaceVariable = std::max(numFaceVariable,cellData[i].size());
+  if( dimension!=dimension_ || numEdgeVariable!=numEdgeVariable_ ||
+      numFaceVariable!=numFaceVariable_ ||
+      vertex_.size()!=vertexData.size()*dimension ||
+      edge_.size()!=wallData.size()*numEdgeVariable ||
+      face_.size()!=cellData.size()*numFaceVariable )
+    resize(vertexData.size(),dimension,wallData.size(),numEdgeVariable,
+	   cellData.size(),numFaceVariable);
+
+  vertexData_ = wallData_ = cellData_ = 0;
+  for( size_t i=0 ; i<vertexData.size() ; ++i ) {
+    assert( vertexData[i].size()==dimension );
+    std::copy(vertexData[i].begin(),vertexData[i].end(),vertex(i));
+  }
+  for( size_t i=0 ; i<wallData.size() ; ++i )
+    std::copy(wallData[i].begin(),wallData[i].end(),edge(i));
+  for( size_t i=0 ; i<cellData.size() ; ++i )
+    std::copy(cellData[i].begin(),cellData[i].end(),face(i));
+}
+
+void GeometryState::view(const DataMatrix &cellData,
+			 const DataMatrix &wallData,
+			 const DataMatrix &vertexData)
+{
+  dimension_ = vertexData.size() ? vertexData[0].size() : 0;
+  numEdgeVariable_ = numFaceVariable_ = 0;
+  for( size_t i=0 ; i<wallData.size() ; ++i )
+    numEdgeVariable_ = std::max(numEdgeVariable_,wallData[i].size());
+  for( size_t i=0 ; i<cellData.size() ; ++i )
+    numFaceVariable_ = std::max(numFaceVariable_,cellData[i].size());
+  vertex_.clear();
+  edge_.clear();
+  face_.clear();
+  vertexData_ = &vertexData;
+  wallData_ = &wallData;
+  cellData_ = &cellData;
+}
+
+void GeometryState::addTo(DataMatrix &cellData,DataMatrix &wallData,
+			  DataMatrix &vertexData) const
+{
+  assert( vertex_.size()==vertexData.size()*dimension_ );
+  assert( edge_.size()==wallData.size()*numEdgeVariable_ );
+  assert( face_.size()==cellData.size()*numFaceVariable_ );
+  for( size_t i=0 ; i<vertexData.size() ; ++i ) {
+    const double *x = vertex(i);
+    for( size_t d=0 ; d<vertexData[i].size() ; ++d )
+      vertexData[i][d] += x[d];
+  }
+  for( size_t i=0 ; i<wallData.size() ; ++i ) {
+    const double *x = edge(i);
+    for( size_t k=0 ; k<wallData[i].size() ; ++k )
+      wallData[i][k] += x[k];
+  }
+  for( size_t i=0 ; i<cellData.size() ; ++i ) {
+    const double *x = face(i);
+    for( size_t k=0 ; k<cellData[i].size() ; ++k )
+      cellData[i][k] += x[k];
+  }
+}
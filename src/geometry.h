@@ -0,0 +1,242 @@
+//
+// Filename     : geometry.h
+// Description  : Index based surface mesh (faces, edges, vertices) and a contiguous state store
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <assert.h>
+#include <cstddef>
+#include <vector>
+#include "myTypedefs.h"
+
+class TissueTopology;
+
+///
+/// @brief Index based mesh of faces, edges and vertices
+///
+/// @details The Geometry holds only the connectivity of a (surface) mesh,
+/// stored in contiguous index arrays:
+/// @verbatim
+/// face -> vertex (cyclic order)
+/// face -> edge   (edge k connects face vertices k and k+1)
+/// edge -> vertex (two per edge)
+/// edge -> face   (two per edge, Geometry::boundary if missing)
+/// @endverbatim
+/// For a Tissue the faces are the cells and the edges the walls, and the
+/// Geometry is created from the TissueTopology. It can also be built directly
+/// from face -> vertex lists (e.g. for triangulated 3D shells), in which case
+/// the edges are generated. All state (positions, edge and face variables)
+/// is kept separately in a GeometryState, such that kernels only work on
+/// index arrays and flat data without following Cell/Wall/Vertex pointers.
+///
+/// @see GeometryState
+/// @see BaseReaction::geometryDerivs()
+///
+class Geometry {
+
+ private:
+
+  size_t revision_;
+  size_t numVertex_;
+  std::vector<size_t> faceStart_;
+  std::vector<size_t> faceVertex_;
+  std::vector<size_t> faceEdge_;
+  std::vector<size_t> edgeVertex_;
+  std::vector<size_t> edgeFace_;
+
+ public:
+
+  ///
+  /// @brief Index used for a missing face (the background) of an edge
+  ///
+  static const size_t boundary = static_cast<size_t>(-1);
+  ///
+  /// @brief Empty constructor, creates an empty mesh
+  ///
+  Geometry();
+  ///
+  /// @brief Copies the cell/wall/vertex connectivity of a tissue snapshot
+  ///
+  void build(const TissueTopology &topology);
+  ///
+  /// @brief Builds the mesh from face -> vertex lists and generates the edges
+  ///
+  /// Edges are numbered in the order they are first found when looping over
+  /// the faces and their vertices. An edge shared by more than two faces is
+  /// reported as an error.
+  ///
+  void build(const std::vector< std::vector<size_t> > &faceVertex,
+	     size_t numVertexVal);
+  ///
+  /// @brief Returns the tissue topology revision the mesh was built from
+  ///
+  /// Meshes built from face lists have revision 0.
+  ///
+  inline size_t revision() const;
+  inline void setRevision(size_t value);
+
+  inline size_t numFace() const;
+  inline size_t numEdge() const;
+  inline size_t numVertex() const;
+  ///
+  /// @brief Number of vertices (and edges) of face i
+  ///
+  inline size_t numFaceVertex(size_t i) const;
+  inline size_t faceVertex(size_t i,size_t k) const;
+  inline size_t faceEdge(size_t i,size_t k) const;
+  inline size_t edgeVertex(size_t e,size_t k) const;
+  inline size_t edgeFace(size_t e,size_t k) const;
+};
+
+///
+/// @brief Contiguous storage of the state on a Geometry
+///
+/// @details Vertex positions, edge variables and face variables are stored
+/// in one flat array each, with a fixed number of values (stride) per
+/// element. The layout matches the Tissue data, i.e. edge variables are the
+/// rows of wallData (starting with the resting length) and face variables
+/// the rows of cellData. The stride is set by the longest row, and values
+/// beyond the end of shorter rows are not used. A state can also view the
+/// tissue data in place (view()), in which case the (const) pointers are
+/// the rows of the data.
+///
+class GeometryState {
+
+ private:
+
+  size_t dimension_;
+  size_t numEdgeVariable_;
+  size_t numFaceVariable_;
+  std::vector<double> vertex_;
+  std::vector<double> edge_;
+  std::vector<double> face_;
+  const DataMatrix *vertexData_;
+  const DataMatrix *wallData_;
+  const DataMatrix *cellData_;
+
+ public:
+
+  GeometryState();
+  ///
+  /// @brief Sets the sizes and zeroes all values
+  ///
+  void resize(size_t numVertex,size_t dimension,size_t numEdge,
+	      size_t numEdgeVariable,size_t numFace,size_t numFaceVariable);
+  ///
+  /// @brief Sets all values to zero
+  ///
+  void setZero();
+  ///
+  /// @brief Copies the tissue data into the flat arrays (resizing if needed)
+  ///
+  void gather(const DataMatrix &cellData,const DataMatrix &wallData,
+	      const DataMatrix &vertexData);
+  ///
+  /// @brief Reads the tissue data in place instead of copying it
+  ///
+  /// The data has to be kept (and not resized) while the state is used, and
+  /// the view is ended by resize() or gather(). Only the const pointers can
+  /// be used for a view.
+  ///
+  void view(const DataMatrix &cellData,const DataMatrix &wallData,
+	    const DataMatrix &vertexData);
+  ///
+  /// @brief Adds the values to the tissue (derivative) data
+  ///
+  void addTo(DataMatrix &cellData,DataMatrix &wallData,
+	     DataMatrix &vertexData) const;
+
+  inline size_t dimension() const;
+  inline size_t numEdgeVariable() const;
+  inline size_t numFaceVariable() const;
+  ///
+  /// @brief Pointers to the first value of vertex, edge or face i
+  ///
+  inline double* vertex(size_t i);
+  inline const double* vertex(size_t i) const;
+  inline double* edge(size_t i);
+  inline const double* edge(size_t i) const;
+  inline double* face(size_t i);
+  inline const double* face(size_t i) const;
+};
+
+inline size_t Geometry::revision() const { return revision_; }
+
+inline void Geometry::setRevision(size_t value) { revision_ = value; }
+
+inline size_t Geometry::numFace() const { return faceStart_.size()-1; }
+
+inline size_t Geometry::numEdge() const { return edgeVertex_.size()/2; }
+
+inline size_t Geometry::numVertex() const { return numVertex_; }
+
+inline size_t Geometry::numFaceVertex(size_t i) const
+{
+  return faceStart_[i+1]-faceStart_[i];
+}
+
+inline size_t Geometry::faceVertex(size_t i,size_t k) const
+{
+  assert( k<numFaceVertex(i) );
+  return faceVertex_[faceStart_[i]+k];
+}
+
+inline size_t Geometry::faceEdge(size_t i,size_t k) const
+{
+  assert( k<numFaceVertex(i) );
+  return faceEdge_[faceStart_[i]+k];
+}
+
+inline size_t Geometry::edgeVertex(size_t e,size_t k) const
+{
+  assert( k<2 );
+  return edgeVertex_[2*e+k];
+}
+
+inline size_t Geometry::edgeFace(size_t e,size_t k) const
+{
+  assert( k<2 );
+  return edgeFace_[2*e+k];
+}
+
+inline size_t GeometryState::dimension() const { return dimension_; }
+
+inline size_t GeometryState::numEdgeVariable() const { return numEdgeVariable_; }
+
+inline size_t GeometryState::numFaceVariable() const { return numFaceVariable_; }
+
+inline double* GeometryState::vertex(size_t i)
+{
+  return vertex_.data()+i*dimension_;
+}
+
+inline const double* GeometryState::vertex(size_t i) const
+{
+  return vertexData_ ? (*vertexData_)[i].data() : vertex_.data()+i*dimension_;
+}
+
+inline double* GeometryState::edge(size_t i)
+{
+  return edge_.data()+i*numEdgeVariable_;
+}
+
+inline const double* GeometryState::edge(size_t i) const
+{
+  return wallData_ ? (*wallData_)[i].data() : edge_.data()+i*numEdgeVariable_;
+}
+
+inline double* GeometryState::face(size_t i)
+{
+  return face_.data()+i*numFaceVariable_;
+}
+
+inline const double* GeometryState::face(size_t i) const
+{
+  return cellData_ ? (*cellData_)[i].data() : face_.data()+i*numFaceVariable_;
+}
+
+#endif
@@ -56,7 +56,7 @@
 /// R_index
 /// @endverbatim
 ///
-class Hill : public BaseReaction {
+class Hill : public BaseChemicalReaction {
   
  public:
   
@@ -123,7 +123,7 @@ class Hill : public BaseReaction {
 /// k (activator/repressor_index)
 /// @endverbatim
 ///
-class HillGeneralOne : public BaseReaction {
+class HillGeneralOne : public BaseChemicalReaction {
   
  public:
   
@@ -190,7 +190,7 @@ class HillGeneralOne : public BaseReaction {
 /// k' (activator/repressor_index)
 /// @endverbatim
 ///
-class HillGeneralOne_TwoInputs : public BaseReaction {
+class HillGeneralOne_TwoInputs : public BaseChemicalReaction {
   
  public:
   
@@ -259,7 +259,7 @@ class HillGeneralOne_TwoInputs : public BaseReaction {
 /// k l
 /// @endverbatim
 ///
-class HillGeneralTwo : public BaseReaction {
+class HillGeneralTwo : public BaseChemicalReaction {
   
  public:
   
@@ -322,7 +322,7 @@ class HillGeneralTwo : public BaseReaction {
 /// k l m
 /// @endverbatim
 ///
-class HillGeneralThree : public BaseReaction {
+class HillGeneralThree : public BaseChemicalReaction {
   
  public:
   
@@ -372,7 +372,7 @@ class HillGeneralThree : public BaseReaction {
 ///
 /// @see Grn::sigmoid(double x) for implementation of sigmoid function.
 ///
-class Grn : public BaseReaction {
+class Grn : public BaseChemicalReaction {
   
  public:
   
@@ -421,7 +421,7 @@ class Grn : public BaseReaction {
 /// @brief The class Grn use a neural network inspired mathematics for gene
 /// regulation where neighbor input is accounted for.
 ///
-class Gsrn2 : public BaseReaction {
+class Gsrn2 : public BaseChemicalReaction {
   
 public:
   
@@ -9,6 +9,7 @@
 #include <cmath>
 #include"growth.h"
 #include"baseReaction.h"
+#include"reactionSchedule.h"
 
 namespace WallGrowth {
   Constant::
@@ -2494,6 +2495,12 @@ derivs(Tissue &T,
   }
 }
 
+void WaterVolumeFromTurgor::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 DilutionFromVertexDerivs::
 DilutionFromVertexDerivs(std::vector<double> &paraValue,
 			 std::vector< std::vector<size_t> > &indValue)
@@ -2519,6 +2526,17 @@ DilutionFromVertexDerivs(std::vector<double> &paraValue,
   setParameterId(tmp);
 }
 
+void DilutionFromVertexDerivs::
+access(ReactionAccess &A) const
+{
+  A.read(ReactionAccess::vertexData);
+  A.read(ReactionAccess::vertexDerivs);
+  for (size_t k=0; k<numVariableIndex(0); ++k) {
+    A.read(ReactionAccess::cellData,variableIndex(0,k));
+    A.write(ReactionAccess::cellDerivs,variableIndex(0,k));
+  }
+}
+
 void DilutionFromVertexDerivs::
 derivs(Tissue &T,
        DataMatrix &cellData,
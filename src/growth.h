@@ -1085,6 +1085,12 @@ public:
                 DataMatrix &cellDerivs,
                 DataMatrix &wallDerivs,
                 DataMatrix &vertexDerivs);
+    ///
+    /// @brief Declares exclusive access since tissue data is updated in derivs()
+    ///
+    /// @see BaseReaction::access()
+    ///
+    void access(ReactionAccess &A) const;
 };
 
 ///
@@ -1119,6 +1125,13 @@ public:
     DilutionFromVertexDerivs(std::vector<double> &paraValue,
                              std::vector< std::vector<size_t> > &indValue);
     ///
+    /// @brief Declares the vertex derivatives as read, which puts the
+    /// reaction after the vertex reactions and in their splitting group
+    ///
+    /// @see BaseReaction::access()
+    ///
+    void access(ReactionAccess &A) const;
+    ///
     /// @brief Derivative function for this reaction class
     ///
     /// @see BaseReaction::derivs(Tissue &T,...)
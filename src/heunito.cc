@@ -5,7 +5,9 @@
 // Created      : December 2014
 // Revision     : $Id:$
 //
+#include <algorithm>
 #include <cmath>
+#include <map>
 #include "heunito.h"
 #include "myRandom.h"
 
@@ -132,12 +134,16 @@ void HeunIto::simulate(size_t verbose)
   while( t_<endTime_ ) {
 
     if (debugFlag()) {
-      cellDataCopy_[debugCount()] = cellData_;
+      recordDebug();
     } 
     //Update the derivatives
     T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
 	       vertexDerivs_);
 
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+
     //Print if applicable 
     if( doPrint && t_ >= printTime ) {
       printTime += printDeltaTime;
@@ -158,12 +164,14 @@ void HeunIto::simulate(size_t verbose)
     //
     T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
 			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
     T_->updateReactions(cellData_,wallData_,vertexData_,h_);
     T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
 			       cellDerivs_,wallDerivs_,vertexDerivs_ );
     
     // Check the tissue connectivity in each step
     T_->checkConnectivity(1);
+    checkRenumber();
    
     // Resize temporary containers as well
     if(cellData_.size() != sdydtCell.size() ) {
@@ -286,3 +294,378 @@ void HeunIto::heunito(DataMatrix &sdydtCell,
   }
 }
 
+
+HeunItoAdaptive::HeunItoAdaptive(Tissue *T,std::ifstream &IN)
+  : BaseSolver(T,IN), topologyRevision_(0)
+{
+  readParameterFile(IN);
+}
+
+HeunItoAdaptive::~HeunItoAdaptive()
+{
+  for( size_t k=0 ; k<future_.size() ; ++k )
+    delete future_[k];
+  for( size_t k=0 ; k<spare_.size() ; ++k )
+    delete spare_[k];
+}
+
+void HeunItoAdaptive::readParameterFile(std::ifstream &IN)
+{
+  //Read in the needed parameters
+  IN >> startTime_;
+  t_=startTime_;
+  IN >> endTime_;
+  
+  IN >> printFlag_; // output format
+  IN >> numPrint_;  // number of time points printed to output
+  
+  IN >> h1_;       // initial time step
+  IN >> vol_;      // effective volume
+  IN >> volFlag_;  //setting for knowing how to calculate volume of individual cells
+  IN >> epsAbs_;   // absolute error tolerance
+  IN >> epsRel_;   // relative error tolerance
+  
+  if( volFlag_!=0 && volFlag_!=1 ) {
+    std::cerr << "HeunItoAdaptive::readParameterFile() Wrong volume flag given,"
+	      << " only 0 (no cell volume dependence) or 1 (volume calculated)"
+	      << " allowed." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if( !(epsAbs_>0.0 || epsRel_>0.0) ) {
+    std::cerr << "HeunItoAdaptive::readParameterFile() At least one of the"
+	      << " tolerances epsAbs and epsRel has to be positive." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void HeunItoAdaptive::simulate(size_t verbose) 
+{
+  //
+  // Check that h1 and endTime-startTime are > 0
+  //
+  if( !(h1_>0. && (endTime_-startTime_)>0.) ) {
+    std::cerr << "HeunItoAdaptive::simulate() Wrong time borders or time step for "
+	      << "simulation. No simulation performed.\n";
+    return;
+  }
+  std::cerr << "Simulating using an adaptive HeunIto solver\n";
+
+  //
+  // Check that sizes of permanent data is ok
+  //
+  if( cellData_.size() && cellData_.size() != cellDerivs_.size() ) {
+    cellDerivs_.resize( cellData_.size(),cellData_[0]);
+  }
+  if( wallData_.size() && wallData_.size() != wallDerivs_.size() ) {
+    wallDerivs_.resize( wallData_.size(),wallData_[0]);
+  }
+  if( vertexData_.size() && vertexData_.size() != vertexDerivs_.size() ) {
+    vertexDerivs_.resize( vertexData_.size(),vertexData_[0]);
+  }
+  
+  // Initiate reactions and direction for those where it is applicable
+  T_->initiateReactions(cellData_, wallData_, vertexData_, cellDerivs_, 
+			wallDerivs_, vertexDerivs_);
+  if (cellData_.size()!=cellDerivs_.size())
+    cellDerivs_.resize(cellData_.size(),cellDerivs_[0]);
+  if (wallData_.size()!=wallDerivs_.size())
+    wallDerivs_.resize(wallData_.size(),wallDerivs_[0]);
+  if (vertexData_.size()!=vertexDerivs_.size())
+    vertexDerivs_.resize(vertexData_.size(),vertexDerivs_[0]);
+  T_->initiateDirection(cellData_, wallData_, vertexData_, cellDerivs_, 
+			wallDerivs_, vertexDerivs_);
+  
+  assert( cellData_.size() == T_->numCell() && 
+	  cellData_.size()==cellDerivs_.size() );
+  assert( wallData_.size() == T_->numWall() && 
+	  wallData_.size()==wallDerivs_.size() );
+  assert( vertexData_.size() == T_->numVertex() && 
+	  vertexData_.size()==vertexDerivs_.size() );
+
+  //
+  // Create all temporary states needed by the algorithm
+  //
+  SolverState y(cellData_,wallData_,vertexData_);
+  topologyRevision_ = T_->topologyRevision();
+  resizeTemporaries();
+  
+  // Initiate print times
+  //
+  double tiny = 1e-10;
+  double printTime=endTime_+tiny;
+  double printDeltaTime=endTime_+2.*tiny;
+  int doPrint=1;
+  if( numPrint_<=0 )//No printing
+    doPrint=0;
+  else if( numPrint_==1 ) {//Print last point (default)
+  }
+  else if( numPrint_==2 ) {//Print first/last point
+    printTime=startTime_-tiny;
+  } 
+  else {//Print first/last points and spread the rest uniformly
+    printTime=startTime_-tiny;
+    printDeltaTime=(endTime_-startTime_)/double(numPrint_-1);
+  }
+  
+  //
+  // Go
+  //
+  const double safety=0.9, minScale=0.2, maxScale=5.0;
+  double h=h1_;
+  t_=startTime_;
+  numOk_ = numBad_ = 0;
+  while( t_<endTime_ ) {
+
+    if (debugFlag()) {
+      recordDebug();
+    } 
+    //Update the derivatives and the noise amplitudes (the derivatives from
+    //derivsWithAbs are used also for the convergence check and printing)
+    T_->derivsWithAbs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+		      vertexDerivs_,sdydt_.cell(),sdydt_.wall(),sdydt_.vertex());
+    noiseAmplitude(y,sdydt_,noise_);
+    
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+
+    //Print if applicable 
+    if( doPrint && t_ >= printTime ) {
+      printTime += printDeltaTime;
+      print();
+    }
+
+    //Check if step is larger than max allowed
+    //max step end is min of endTime_ and printTime
+    double tMin= endTime_<printTime ? endTime_ : printTime;
+    if( t_+h>tMin ) h=tMin-t_;
+    
+    //Update (the increment of a rejected step is kept as the future of the
+    //path and split in the following tries)
+    double err;
+    for(;;) {
+      err = trialStep(h);
+      if( err<=1.0 )
+	break;
+      ++numBad_;
+      storeIncrement(h);
+      h *= std::max(minScale,safety/std::sqrt(err));
+      if( (t_+h)==t_ ) {
+	std::cerr << "HeunItoAdaptive::simulate() Step size too small.\n";
+	exit(EXIT_FAILURE);
+      }
+    }
+    y.assign(yNew_);
+    t_ += h;
+    numOk_++;
+    //
+    // Check for discrete and reaction updates
+    //
+    T_->updateDirection(h,cellData_,wallData_,vertexData_,cellDerivs_,
+			wallDerivs_,vertexDerivs_);
+    updateHybrid(h);
+    T_->updateReactions(cellData_,wallData_,vertexData_,h);
+    T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
+			       cellDerivs_,wallDerivs_,vertexDerivs_ );
+    
+    // Check the tissue connectivity in each step
+    T_->checkConnectivity(1);
+    checkRenumber();
+   
+    // Resize temporary states (and the stored increments) as well
+    resizeTemporaries();
+    
+    // Next step from the error of the accepted one (strong order one half
+    // error estimate, hence the square root)
+    h *= err>0.0 ? std::min(maxScale,std::max(minScale,safety/std::sqrt(err))) :
+      maxScale;
+  } //  end of the integration loop 
+  if( doPrint ) {
+    //  Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    print();
+  }
+  std::cerr << "Simulation done (" << numOk_ << " steps, " << numBad_
+	    << " rejected).\n"; 
+  return;
+}
+
+void HeunItoAdaptive::resizeTemporaries()
+{
+  SolverState y(cellData_,wallData_,vertexData_);
+  noise_.resizeLike(y);
+  y1_.resizeLike(y);
+  dydt2_.resizeLike(y);
+  sdydt_.resizeLike(y);
+  sdydt2_.resizeLike(y);
+  noise2_.resizeLike(y);
+  dW_.resizeLike(y);
+  yNew_.resizeLike(y);
+  
+  // The stored increments are moved to the new rows of their elements
+  if( T_->topologyRevision()!=topologyRevision_ && future_.size() ) {
+    std::vector<size_t> newRow;
+    for( size_t b=0 ; b<3 ; ++b ) {
+      std::map<size_t,size_t> oldRow;
+      for( size_t i=0 ; i<rowId_[b].size() ; ++i )
+	oldRow[rowId_[b][i]] = i;
+      size_t N = y.block(b).size();
+      newRow.assign(N,rowId_[b].size());
+      for( size_t i=0 ; i<N ; ++i ) {
+	size_t id = b==0 ? T_->cellStableId(i) :
+	  (b==1 ? T_->wallStableId(i) : T_->vertexStableId(i));
+	std::map<size_t,size_t>::const_iterator it = oldRow.find(id);
+	if( it!=oldRow.end() )
+	  newRow[i] = it->second;
+      }
+      DataMatrix tmp(N);
+      for( size_t k=0 ; k<future_.size() ; ++k ) {
+	DataMatrix &w = future_[k]->block(b);
+	double sigma = std::sqrt(futureDt_[k]);
+	for( size_t i=0 ; i<N ; ++i ) {
+	  if( newRow[i]<w.size() && w[newRow[i]].size()==y.block(b)[i].size() )
+	    tmp[i].swap(w[newRow[i]]);
+	  else {
+	    tmp[i].resize(y.block(b)[i].size());
+	    for( size_t j=0 ; j<tmp[i].size() ; ++j )
+	      tmp[i][j] = sigma*myRandom::Grand();
+	  }
+	}
+	w.swap(tmp);
+	tmp.resize(N);
+      }
+    }
+  }
+  if( T_->topologyRevision()!=topologyRevision_ || rowId_[0].size()!=y.cell().size() ) {
+    rowId_[0].resize(y.cell().size());
+    for( size_t i=0 ; i<rowId_[0].size() ; ++i )
+      rowId_[0][i] = T_->cellStableId(i);
+    rowId_[1].resize(y.wall().size());
+    for( size_t i=0 ; i<rowId_[1].size() ; ++i )
+      rowId_[1][i] = T_->wallStableId(i);
+    rowId_[2].resize(y.vertex().size());
+    for( size_t i=0 ; i<rowId_[2].size() ; ++i )
+      rowId_[2][i] = T_->vertexStableId(i);
+    topologyRevision_ = T_->topologyRevision();
+  }
+}
+
+void HeunItoAdaptive::noiseAmplitude(const SolverState &y,
+				     const SolverState &sdydt,
+				     SolverState &noise)
+{
+  for( size_t b=0 ; b<3 ; ++b )
+    for( size_t i=0 ; i<sdydt.block(b).size() ; ++i ) {
+      double volume = vol_;
+      if( b==0 && volFlag_==1 )
+	volume *= T_->cell(i).calculateVolume(y.vertex());
+      const std::vector<double> &s = sdydt.block(b)[i];
+      std::vector<double> &g = noise.block(b)[i];
+      for( size_t j=0 ; j<s.size() ; ++j )
+	g[j] = s[j]>0.0 ? std::sqrt(s[j]/volume) : 0.0;
+    }
+}
+
+void HeunItoAdaptive::brownianIncrement(double h)
+{
+  dW_.fill(0.0);
+  double remaining = h;
+  while( remaining>0.0 && future_.size() ) {
+    SolverState &w = *future_.back();
+    double dt = futureDt_.back();
+    if( dt<=remaining*(1.0+1e-12) ) {
+      // The full stored increment is used
+      dW_.axpy(1.0,w);
+      remaining = dt<remaining ? remaining-dt : 0.0;
+      if( remaining<1e-12*h )
+	remaining = 0.0;
+      spare_.push_back(&w);
+      future_.pop_back();
+      futureDt_.pop_back();
+      continue;
+    }
+    // Brownian bridge, the part over remaining given the increment over dt
+    double r = remaining/dt, sigma = std::sqrt(r*(1.0-r)*dt);
+    for( size_t b=0 ; b<3 ; ++b )
+      for( size_t i=0 ; i<w.block(b).size() ; ++i ) {
+	std::vector<double> &wi = w.block(b)[i];
+	std::vector<double> &dWi = dW_.block(b)[i];
+	for( size_t j=0 ; j<wi.size() ; ++j ) {
+	  double part = r*wi[j] + sigma*myRandom::Grand();
+	  dWi[j] += part;
+	  wi[j] -= part;
+	}
+      }
+    futureDt_.back() = dt-remaining;
+    remaining = 0.0;
+  }
+  if( remaining>0.0 ) {
+    double sigma = std::sqrt(remaining);
+    for( size_t b=0 ; b<3 ; ++b )
+      for( size_t i=0 ; i<dW_.block(b).size() ; ++i ) {
+	std::vector<double> &dWi = dW_.block(b)[i];
+	for( size_t j=0 ; j<dWi.size() ; ++j )
+	  dWi[j] += sigma*myRandom::Grand();
+      }
+  }
+}
+
+void HeunItoAdaptive::storeIncrement(double h)
+{
+  SolverState *w;
+  if( spare_.size() ) {
+    w = spare_.back();
+    spare_.pop_back();
+  }
+  else
+    w = new SolverState();
+  w->resizeLike(dW_);
+  w->assign(dW_);
+  future_.push_back(w);
+  futureDt_.push_back(h);
+}
+
+double HeunItoAdaptive::trialStep(double h)
+{
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  brownianIncrement(h);
+  
+  // Euler-Maruyama predictor (absorbing barrier at 0 for cells and walls)
+  for( size_t b=0 ; b<3 ; ++b )
+    for( size_t i=0 ; i<y.block(b).size() ; ++i ) {
+      const std::vector<double> &yi = y.block(b)[i], &fi = dydt.block(b)[i],
+	&gi = noise_.block(b)[i], &dWi = dW_.block(b)[i];
+      std::vector<double> &y1i = y1_.block(b)[i];
+      for( size_t j=0 ; j<yi.size() ; ++j ) {
+	y1i[j] = yi[j] + h*fi[j] + gi[j]*dWi[j];
+	if( b<2 && y1i[j]<0.0 )
+	  y1i[j] = 0.0;
+      }
+    }
+  T_->derivsWithAbs(y1_.cell(),y1_.wall(),y1_.vertex(),
+		    dydt2_.cell(),dydt2_.wall(),dydt2_.vertex(),
+		    sdydt2_.cell(),sdydt2_.wall(),sdydt2_.vertex());
+  noiseAmplitude(y1_,sdydt2_,noise2_);
+  
+  // Heun corrector and the error estimate
+  double hh = 0.5*h, errMax = 0.0;
+  for( size_t b=0 ; b<3 ; ++b )
+    for( size_t i=0 ; i<y.block(b).size() ; ++i ) {
+      const std::vector<double> &yi = y.block(b)[i], &fi = dydt.block(b)[i],
+	&f2i = dydt2_.block(b)[i], &gi = noise_.block(b)[i],
+	&g2i = noise2_.block(b)[i], &dWi = dW_.block(b)[i];
+      std::vector<double> &yNewi = yNew_.block(b)[i];
+      for( size_t j=0 ; j<yi.size() ; ++j ) {
+	yNewi[j] = yi[j] + hh*(fi[j]+f2i[j]) + gi[j]*dWi[j];
+	if( b<2 && yNewi[j]<0.0 )
+	  yNewi[j] = 0.0;
+	double err = std::fabs(hh*(f2i[j]-fi[j]) + 0.5*(g2i[j]-gi[j])*dWi[j]);
+	err /= epsAbs_ + epsRel_*std::max(std::fabs(yi[j]),std::fabs(yNewi[j]));
+	if( err>errMax )
+	  errMax = err;
+      }
+    }
+  return errMax;
+}
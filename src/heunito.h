@@ -8,7 +8,9 @@
 // Revision     : $Id:$
 //
 
+#include <vector>
 #include "baseSolver.h"
+#include "solverState.h"
 
 ///
 /// @brief Heun numerical solver in the Ito interpretation. 
@@ -85,6 +87,120 @@ class HeunIto : public BaseSolver {
 	       DataMatrix &dydt2Vertex);
 };
 
+///
+/// @brief Heun solver in the Ito interpretation with adaptive step size
+///
+/// @details Each step uses the same update as HeunIto (Euler-Maruyama
+/// predictor followed by the Heun drift correction and the Ito noise term),
+/// where the noise amplitude of each variable is given by the sum of
+/// absolute reaction rates from Tissue::derivsWithAbs(). The local error is
+/// estimated by the terms separating the update from lower order ones, the
+/// drift correction h/2(f(y1)-f(y)), and the change of the noise amplitude
+/// over the step times the increment (g(y1)-g(y))dW/2 (the leading term
+/// dropped by Euler-Maruyama for multiplicative noise). Steps with a scaled
+/// error above one are rejected and the step is decreased.
+///
+/// To keep the sampled path consistent when a step is rejected, the
+/// Brownian increment of the rejected step is stored as the future of the
+/// path, and the increment of the shorter step is drawn from the Brownian
+/// bridge given the stored one (the rest is kept for the following steps).
+/// Increments beyond the stored future are drawn as new Gaussians. The
+/// stored increments follow the cells, walls and vertices through topology
+/// changes by their stable ids, and new elements get new increments.
+///
+/// @see HeunIto
+///
+class HeunItoAdaptive : public BaseSolver {
+
+ private:
+  
+  double h1_;
+  double vol_;
+  int volFlag_;
+  double epsAbs_;
+  double epsRel_;
+  
+  SolverState noise_, y1_, dydt2_, sdydt_, sdydt2_, noise2_, dW_, yNew_;
+  ///
+  /// @brief The stored future of the Brownian path, with the increment
+  /// closest in time at the back
+  ///
+  std::vector<SolverState*> future_;
+  std::vector<double> futureDt_;
+  std::vector<SolverState*> spare_;
+  ///
+  /// @brief Stable ids of the rows of the stored increments
+  ///
+  std::vector<size_t> rowId_[3];
+  size_t topologyRevision_;
+  
+  HeunItoAdaptive(const HeunItoAdaptive &);
+  HeunItoAdaptive & operator=(const HeunItoAdaptive &);
+
+ public:
+  ///
+  /// @brief Main constructor
+  ///
+  HeunItoAdaptive(Tissue *T,std::ifstream &IN);
+  
+  ~HeunItoAdaptive();
+  
+  ///
+  /// @brief Reads the parameters used by the HeunItoAdaptive solver
+  ///
+  /// The parameter file sent to the simulator binary looks like:
+  ///
+  /// <pre> 
+  /// HeunItoAdaptive
+  /// T_start T_end 
+  /// printFlag printNum 
+  /// h1 vol volFlag epsAbs epsRel
+  /// </pre> 
+  ///
+  /// where h1 is the initial step size, vol and volFlag are as for HeunIto
+  /// (see HeunIto::readParameterFile()), and a step is accepted if the
+  /// estimated error of each variable is below epsAbs+epsRel*|y|.
+  ///
+  /// @see BaseSolver::getSolver()
+  /// @see BaseSolver::print()
+  ///
+  void readParameterFile(std::ifstream &IN);
+	
+  ///
+  /// @brief Runs a simulation of an organism model
+  ///
+  void simulate(size_t verbose=0);
+
+  ///
+  /// @brief Adapts the sizes of the temporary states (and the stored
+  /// Brownian increments) to the current tissue
+  ///
+  void resizeTemporaries();
+  
+  ///
+  /// @brief Sets the noise amplitude sqrt(sdydt/vol) of each variable for the
+  /// absolute rates sdydt at the state y
+  ///
+  void noiseAmplitude(const SolverState &y, const SolverState &sdydt,
+		      SolverState &noise);
+  
+  ///
+  /// @brief Sets dW_ to the Brownian increment over the next h, taken from
+  /// the stored future of the path when available
+  ///
+  void brownianIncrement(double h);
+  
+  ///
+  /// @brief Stores dW_ as the increment over the next h of the path
+  ///
+  void storeIncrement(double h);
+  
+  ///
+  /// @brief Tries a step h from the current state, sets yNew_ and returns
+  /// the maximal scaled error estimate
+  ///
+  double trialStep(double h);
+};
 
 #endif /* HEUNITO_H */
 
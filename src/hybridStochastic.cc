@@ -0,0 +1,232 @@
+//
+// Filename     : hybridStochastic.cc
+// Description  : Next reaction method for low copy number cell variables coupled to the ODE solvers
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include "baseReaction.h"
+#include "hybridStochastic.h"
+#include "myRandom.h"
+#include "tissue.h"
+
+ReactionChannel::ReactionChannel() :
+  rate_(0.0)
+{
+}
+
+void ReactionChannel::clear()
+{
+  rate_ = 0.0;
+  factor_.clear();
+  column_.clear();
+  change_.clear();
+}
+
+void ReactionChannel::addFactor(size_t column)
+{
+  factor_.push_back(column);
+}
+
+void ReactionChannel::addChange(size_t column,double value)
+{
+  column_.push_back(column);
+  change_.push_back(value);
+}
+
+HybridStochastic::HybridStochastic(Tissue &T,double startTime,std::istream &IN) :
+  t_(startTime), numEvent_(0), numCell_(0), topologyRevision_(0)
+{
+  size_t numColumn=0;
+  if( !(IN >> numColumn) || !numColumn ) {
+    std::cerr << "HybridStochastic::HybridStochastic() Expected 'Hybrid"
+	      << " numColumn column ...' with at least one column." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  column_.resize(numColumn);
+  for( size_t k=0 ; k<numColumn ; ++k )
+    IN >> column_[k];
+  if( !IN ) {
+    std::cerr << "HybridStochastic::HybridStochastic() Error reading the "
+	      << numColumn << " tagged columns." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::sort(column_.begin(),column_.end());
+
+  //The reactions providing a channel changing a tagged column are taken over
+  ReactionChannel C;
+  for( size_t r=0 ; r<T.numReaction() ; ++r ) {
+    C.clear();
+    if( !T.reaction(r)->channel(C) )
+      continue;
+    int tagged=0;
+    for( size_t k=0 ; k<C.column().size() ; ++k )
+      if( std::binary_search(column_.begin(),column_.end(),C.column()[k]) )
+	tagged=1;
+    if( !tagged )
+      continue;
+    reaction_.push_back(r);
+    channel_.push_back(C);
+    T.setStochasticReaction(r,1);
+  }
+  if( channel_.empty() ) {
+    std::cerr << "HybridStochastic::HybridStochastic() No reaction providing a"
+	      << " stochastic channel changes the tagged columns." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  size_t N = channel_.size();
+  dependent_.resize(N);
+  for( size_t c=0 ; c<N ; ++c ) {
+    for( size_t d=0 ; d<N ; ++d ) {
+      int depend = d==c;
+      for( size_t k=0 ; k<channel_[c].column().size() ; ++k )
+	if( std::find(channel_[d].factor().begin(),channel_[d].factor().end(),
+		      channel_[c].column()[k])!=channel_[d].factor().end() )
+	  depend=1;
+      if( depend )
+	dependent_[c].push_back(d);
+    }
+    for( size_t k=0 ; k<channel_[c].factor().size() ; ++k )
+      if( !std::binary_search(column_.begin(),column_.end(),
+			      channel_[c].factor()[k]) ) {
+	continuous_.push_back(c);
+	break;
+      }
+  }
+}
+
+void HybridStochastic::initiate(const DataMatrix &cellData)
+{
+  size_t N = channel_.size();
+  numCell_ = cellData.size();
+  propensity_.resize(numCell_*N);
+  time_.resize(numCell_*N);
+  heap_.resize(numCell_*N);
+  heapPosition_.resize(numCell_*N);
+  double inf = std::numeric_limits<double>::infinity();
+  for( size_t i=0 ; i<numCell_ ; ++i )
+    for( size_t c=0 ; c<N ; ++c ) {
+      size_t k = i*N+c;
+      propensity_[k] = channel_[c].propensity(cellData[i]);
+      time_[k] = propensity_[k]>0.0 ?
+	t_-std::log(1.0-myRandom::Rnd())/propensity_[k] : inf;
+      heap_[k] = k;
+      heapPosition_[k] = k;
+    }
+  for( size_t pos=heap_.size()/2 ; pos>0 ; --pos )
+    heapDown(pos-1);
+}
+
+void HybridStochastic::setPropensity(size_t k,double value)
+{
+  //Rescaled firing time (Gibson and Bruck 2000), or a new one if the
+  //channel was off
+  double old = propensity_[k];
+  propensity_[k] = value;
+  if( value<=0.0 )
+    time_[k] = std::numeric_limits<double>::infinity();
+  else if( old>0.0 )
+    time_[k] = t_+(old/value)*(time_[k]-t_);
+  else
+    time_[k] = t_-std::log(1.0-myRandom::Rnd())/value;
+  heapUp(heapPosition_[k]);
+  heapDown(heapPosition_[k]);
+}
+
+void HybridStochastic::heapSwap(size_t a,size_t b)
+{
+  std::swap(heap_[a],heap_[b]);
+  heapPosition_[heap_[a]] = a;
+  heapPosition_[heap_[b]] = b;
+}
+
+void HybridStochastic::heapUp(size_t pos)
+{
+  while( pos>0 ) {
+    size_t parent = (pos-1)/2;
+    if( !(time_[heap_[pos]]<time_[heap_[parent]]) )
+      return;
+    heapSwap(pos,parent);
+    pos = parent;
+  }
+}
+
+void HybridStochastic::heapDown(size_t pos)
+{
+  size_t n = heap_.size();
+  for(;;) {
+    size_t smallest=pos, left=2*pos+1, right=2*pos+2;
+    if( left<n && time_[heap_[left]]<time_[heap_[smallest]] )
+      smallest = left;
+    if( right<n && time_[heap_[right]]<time_[heap_[smallest]] )
+      smallest = right;
+    if( smallest==pos )
+      return;
+    heapSwap(pos,smallest);
+    pos = smallest;
+  }
+}
+
+void HybridStochastic::advance(Tissue &T,DataMatrix &cellData,double h)
+{
+  size_t N = channel_.size();
+  if( cellData.size()!=numCell_ || T.topologyRevision()!=topologyRevision_ ) {
+    topologyRevision_ = T.topologyRevision();
+    initiate(cellData);
+  }
+  else
+    for( size_t i=0 ; i<numCell_ ; ++i )
+      for( size_t l=0 ; l<continuous_.size() ; ++l ) {
+	size_t c = continuous_[l];
+	setPropensity(i*N+c,channel_[c].propensity(cellData[i]));
+      }
+
+  double tEnd = t_+h;
+  while( heap_.size() && time_[heap_[0]]<=tEnd ) {
+    size_t k = heap_[0];
+    size_t i = k/N, c = k%N;
+    t_ = time_[k];
+    const ReactionChannel &C = channel_[c];
+    for( size_t l=0 ; l<C.column().size() ; ++l )
+      cellData[i][C.column()[l]] += C.change()[l];
+    ++numEvent_;
+    //A new firing time for the fired channel, rescaled times for the
+    //channels depending on the changed variables in the same cell
+    propensity_[k] = 0.0;
+    for( size_t l=0 ; l<dependent_[c].size() ; ++l ) {
+      size_t d = dependent_[c][l];
+      setPropensity(i*N+d,channel_[d].propensity(cellData[i]));
+    }
+  }
+  t_ = tEnd;
+}
+
+void HybridStochastic::divide(size_t i,size_t j,DataMatrix &cellData) const
+{
+  for( size_t l=0 ; l<column_.size() ; ++l ) {
+    size_t c = column_[l];
+    double n = std::floor(cellData[i][c]+0.5);
+    double m = 0.0;
+    for( double k=0.0 ; k<n ; k+=1.0 )
+      if( myRandom::Rnd()<0.5 )
+	m += 1.0;
+    cellData[i][c] = m;
+    cellData[j][c] = n>0.0 ? n-m : 0.0;
+  }
+}
+
+void HybridStochastic::print(const Tissue &T,std::ostream &os) const
+{
+  os << channel_.size() << " stochastic reactions (";
+  for( size_t k=0 ; k<reaction_.size() ; ++k )
+    os << (k ? " " : "") << reaction_[k] << ":" << T.reaction(reaction_[k])->id();
+  os << ") in the tagged cell columns";
+  for( size_t k=0 ; k<column_.size() ; ++k )
+    os << " " << column_[k];
+  os << ".";
+}
@@ -0,0 +1,194 @@
+//
+// Filename     : hybridStochastic.h
+// Description  : Next reaction method for low copy number cell variables coupled to the ODE solvers
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef HYBRIDSTOCHASTIC_H
+#define HYBRIDSTOCHASTIC_H
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include "myTypedefs.h"
+
+class Tissue;
+
+///
+/// @brief A reaction given as a stochastic channel acting within each cell
+///
+/// @details The propensity in cell i is rate times the product of the cell
+/// variables in the factor columns (a column given twice is squared), and
+/// each event adds change[k] to the cell variable in column[k]. The cell
+/// variables are then copy numbers, and the channel is the stochastic
+/// version of the (mass action) reaction rate used in derivs().
+///
+/// @see BaseReaction::channel()
+/// @see HybridStochastic
+///
+class ReactionChannel {
+
+ private:
+
+  double rate_;
+  std::vector<size_t> factor_;
+  std::vector<size_t> column_;
+  std::vector<double> change_;
+
+ public:
+
+  ReactionChannel();
+  ///
+  /// @brief Removes all factors and changes and sets the rate to zero
+  ///
+  void clear();
+  inline void setRate(double value);
+  ///
+  /// @brief Multiplies the propensity with the cell variable in column
+  ///
+  void addFactor(size_t column);
+  ///
+  /// @brief Adds value to the cell variable in column at each event
+  ///
+  void addChange(size_t column,double value);
+  inline double rate() const;
+  inline const std::vector<size_t> & factor() const;
+  inline const std::vector<size_t> & column() const;
+  inline const std::vector<double> & change() const;
+  ///
+  /// @brief Returns the propensity for the cell variables in row
+  ///
+  inline double propensity(const std::vector<double> &row) const;
+};
+
+///
+/// @brief Simulates reactions changing tagged (low copy number) cell
+/// variables with the next reaction method, while the rest of the model is
+/// integrated by the ODE solver
+///
+/// @details The engine is declared in a block following the solver
+/// parameters in the solver file (see BaseSolver::getSolver()):
+/// @verbatim
+/// Hybrid numColumn column ...
+/// @endverbatim
+/// All reactions providing a ReactionChannel (BaseReaction::channel()) that
+/// changes at least one of the tagged cell columns are removed from the
+/// derivatives (Tissue::setStochasticReaction()), and are instead fired as
+/// discrete events in each cell. The tagged variables hold copy numbers and
+/// should only be changed by these channels.
+///
+/// Each (cell, channel) pair has a firing time in an indexed priority queue
+/// (Gibson and Bruck 2000). After an event, only the channels of the same
+/// cell depending on a changed column get new propensities (with the firing
+/// times rescaled), such that the cost per event is logarithmic in the
+/// number of cells. Channels with factors in untagged columns follow the ODE
+/// variables, and are updated after each solver step (the propensities are
+/// kept constant within a step). After topology changes (divisions,
+/// removals, renumbering) all firing times are drawn again, which is exact
+/// for the exponential waiting times. At a cell division the copy numbers
+/// in the tagged columns are partitioned binomially between the two
+/// daughters (see divide()).
+///
+/// @see BaseSolver::updateHybrid()
+///
+class HybridStochastic {
+
+ private:
+
+  std::vector<size_t> column_;
+  std::vector<size_t> reaction_;
+  std::vector<ReactionChannel> channel_;
+  ///
+  /// @brief For each channel the channels (in the same cell) depending on
+  /// the columns it changes
+  ///
+  std::vector< std::vector<size_t> > dependent_;
+  ///
+  /// @brief Channels with factors in untagged columns
+  ///
+  std::vector<size_t> continuous_;
+
+  double t_;
+  size_t numEvent_;
+  size_t numCell_;
+  size_t topologyRevision_;
+  ///
+  /// @brief Propensity and firing time of entry k=cell*numChannel+channel
+  ///
+  std::vector<double> propensity_;
+  std::vector<double> time_;
+  ///
+  /// @brief Binary heap of the entries ordered by firing time, and the heap
+  /// position of each entry
+  ///
+  std::vector<size_t> heap_;
+  std::vector<size_t> heapPosition_;
+
+  void initiate(const DataMatrix &cellData);
+  void setPropensity(size_t k,double value);
+  void heapUp(size_t pos);
+  void heapDown(size_t pos);
+  void heapSwap(size_t a,size_t b);
+
+ public:
+  ///
+  /// @brief Reads the block (after the 'Hybrid' keyword) and takes over the
+  /// reactions changing the tagged columns from T
+  ///
+  HybridStochastic(Tissue &T,double startTime,std::istream &IN);
+  ///
+  /// @brief Fires the events within the next h and advances the internal time
+  ///
+  void advance(Tissue &T,DataMatrix &cellData,double h);
+  ///
+  /// @brief Partitions the tagged copy numbers of a divided cell between
+  /// the daughters
+  ///
+  /// @details Cell i has been divided into itself and cell j, where the
+  /// variables of j are copied from i. Each molecule is placed in either
+  /// daughter with probability 1/2, such that the tagged variable of i is
+  /// drawn from Binomial(n,1/2) and j gets the remaining copies. Called by
+  /// the Tissue at divisions (Tissue::setHybrid()).
+  ///
+  void divide(size_t i,size_t j,DataMatrix &cellData) const;
+  ///
+  /// @brief Prints the stochastic reactions and the tagged columns
+  ///
+  void print(const Tissue &T,std::ostream &os) const;
+  inline size_t numChannel() const;
+  inline size_t numEvent() const;
+};
+
+inline void ReactionChannel::setRate(double value) { rate_ = value; }
+
+inline double ReactionChannel::rate() const { return rate_; }
+
+inline const std::vector<size_t> & ReactionChannel::factor() const
+{
+  return factor_;
+}
+
+inline const std::vector<size_t> & ReactionChannel::column() const
+{
+  return column_;
+}
+
+inline const std::vector<double> & ReactionChannel::change() const
+{
+  return change_;
+}
+
+inline double ReactionChannel::propensity(const std::vector<double> &row) const
+{
+  double a = rate_;
+  for( size_t k=0 ; k<factor_.size() ; ++k )
+    a *= row[factor_[k]];
+  return a>0.0 ? a : 0.0;
+}
+
+inline size_t HybridStochastic::numChannel() const { return channel_.size(); }
+
+inline size_t HybridStochastic::numEvent() const { return numEvent_; }
+
+#endif
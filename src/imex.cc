@@ -0,0 +1,419 @@
+//
+// Filename     : imex.cc
+// Description  : Implicit-explicit solver with implicit cell-to-cell transport
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cmath>
+#include "imex.h"
+
+IMEX::IMEX(Tissue *T,std::ifstream &IN)
+  : BaseSolver(T,IN)
+{
+  patternRevision_ = size_t(-1);
+  numFactorization_ = numIteration_ = numSolve_ = 0;
+  readParameterFile(IN);
+}
+
+void IMEX::readParameterFile(std::ifstream &IN)
+{
+  IN >> startTime_;
+  t_= startTime_;
+  IN >> endTime_;
+
+  IN >> printFlag_;
+  IN >> numPrint_;
+
+  IN >> h_;
+  IN >> tolerance_;
+  IN >> maxIteration_;
+}
+
+void IMEX::setReactionGroups()
+{
+  explicitReaction_.clear();
+  implicitReaction_.clear();
+  std::vector<size_t> species;
+  DataMatrix coefficient;
+  for( size_t r=0 ; r<T_->numReaction() ; ++r )
+    if( T_->reaction(r)->linearCellTransport(*T_,cellData_,wallData_,vertexData_,
+					     species,coefficient) )
+      implicitReaction_.push_back(r);
+    else
+      explicitReaction_.push_back(r);
+  std::cerr << "IMEX: implicit reactions";
+  for( size_t k=0 ; k<implicitReaction_.size() ; ++k )
+    std::cerr << " " << T_->reaction(implicitReaction_[k])->id();
+  std::cerr << std::endl << "IMEX: explicit reactions";
+  for( size_t k=0 ; k<explicitReaction_.size() ; ++k )
+    std::cerr << " " << T_->reaction(explicitReaction_[k])->id();
+  std::cerr << std::endl;
+}
+
+void IMEX::simulate(size_t verbose)
+{
+  //
+  // Check that parameters are ok
+  //
+  if( !(h_>0. && (endTime_-startTime_)>0.) ) {
+    std::cerr << "IMEX::simulate() Wrong time borders or time step for "
+	      << "simulation. No simulation performed." << std::endl;
+    return;
+  }
+  if( !(tolerance_>0. && maxIteration_>0) ) {
+    std::cerr << "IMEX::simulate() Linear solver tolerance and maximal number "
+	      << "of iterations must be positive. No simulation performed."
+	      << std::endl;
+    return;
+  }
+  std::cerr << "Simulating using IMEX Euler (implicit linear transport)."
+	    << std::endl;
+
+  //
+  // Check that sizes of permanent data is ok
+  //
+  if( cellData_.size() && cellData_.size() != cellDerivs_.size() ) {
+    cellDerivs_.resize( cellData_.size(),cellData_[0]);
+  }
+  if( wallData_.size() && wallData_.size() != wallDerivs_.size() ) {
+    wallDerivs_.resize( wallData_.size(),wallData_[0]);
+  }
+  if( vertexData_.size() && vertexData_.size() != vertexDerivs_.size() ) {
+    vertexDerivs_.resize( vertexData_.size(),vertexData_[0]);
+  }
+
+  // Initiate reactions and direction for those where it is applicable
+  T_->initiateReactions(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+  if (cellData_.size()!=cellDerivs_.size())
+    cellDerivs_.resize(cellData_.size(),cellDerivs_[0]);
+  if (wallData_.size()!=wallDerivs_.size())
+    wallDerivs_.resize(wallData_.size(),wallDerivs_[0]);
+  if (vertexData_.size()!=vertexDerivs_.size())
+    vertexDerivs_.resize(vertexData_.size(),vertexDerivs_[0]);
+  T_->initiateDirection(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+
+  assert( cellData_.size() == T_->numCell() &&
+	  cellData_.size()==cellDerivs_.size() );
+  assert( wallData_.size() == T_->numWall() &&
+	  wallData_.size()==wallDerivs_.size() );
+  assert( vertexData_.size() == T_->numVertex() &&
+	  vertexData_.size()==vertexDerivs_.size() );
+
+  setReactionGroups();
+
+  // Initiate print times
+  //
+  double tiny = 1e-10;
+  double printTime=endTime_+tiny;
+  double printDeltaTime=endTime_+2.*tiny;
+  int doPrint=1;
+  if( numPrint_<=0 )//No printing
+    doPrint=0;
+  else if( numPrint_==1 ) {//Print last point (default)
+  }
+  else if( numPrint_==2 ) {//Print first/last point
+    printTime=startTime_-tiny;
+  }
+  else {//Print first/last points and spread the rest uniformly
+    printTime=startTime_-tiny;
+    printDeltaTime=(endTime_-startTime_)/double(numPrint_-1);
+  }
+  // Go
+  //
+  t_=startTime_;
+  numOk_ = numBad_ = 0;
+  while( t_<endTime_ ) {
+    if (debugFlag()) {
+      recordDebug();
+    }
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+
+    //Print if applicable
+    if( doPrint && t_ >= printTime ) {
+      printTime += printDeltaTime;
+      print();
+    }
+
+    //Update
+    imexStep();
+    numOk_++;
+
+    //
+    // Check for discrete and reaction updates
+    //
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
+			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
+    T_->updateReactions(cellData_,wallData_,vertexData_,h_);
+    T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
+			       cellDerivs_,wallDerivs_,vertexDerivs_ );
+
+    // Check the tissue connectivity in each step
+    T_->checkConnectivity(1);
+    checkRenumber();
+
+    //update time variable
+    if( (t_+h_)==t_ ) {
+      std::cerr << "IMEX::simulate() Step size too small.";
+      exit(-1);
+    }
+    t_ += h_;
+  }
+  if( doPrint ) {
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    print();
+  }
+  std::cerr << "Simulation done (" << numFactorization_ << " factorizations, "
+	    << numIteration_ << " BiCGSTAB iterations in " << numSolve_
+	    << " solves).\n";
+  return;
+}
+
+void IMEX::imexStep()
+{
+  // Transport coefficients at the start of the step (linearly implicit)
+  if( implicitReaction_.size() )
+    collectCoefficients();
+
+  // Explicit Euler step for all other reactions
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	     vertexDerivs_,explicitReaction_);
+  y.axpy(h_,dydt);
+
+  // Implicit Euler step for the transport, one sparse solve per variable
+  size_t numCell = cellData_.size();
+  for( size_t s=0 ; s<species_.size() ; ++s ) {
+    assemble(s);
+    b_.resize(numCell);
+    for( size_t i=0 ; i<numCell ; ++i )
+      b_[i] = cellData_[i][species_[s]];
+    size_t numIter = solve(s);
+    ++numSolve_;
+    if( numIter>maxIteration_ ) {
+      std::cerr << "IMEX::imexStep() BiCGSTAB did not converge in "
+		<< maxIteration_ << " iterations for cell variable "
+		<< species_[s] << " at t=" << t_ << " (use a smaller step size,"
+		<< " a larger tolerance or more iterations)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    numIteration_ += numIter;
+    for( size_t i=0 ; i<numCell ; ++i )
+      cellData_[i][species_[s]] = x_[i];
+  }
+}
+
+void IMEX::collectCoefficients()
+{
+  const TissueTopology &topology = T_->topology();
+  if( topology.revision() != patternRevision_ )
+    buildPattern(topology);
+  size_t numEntry = topology.cellNeighbor().size();
+  for( size_t s=0 ; s<coefficient_.size() ; ++s )
+    coefficient_[s].assign(numEntry,0.0);
+
+  std::vector<size_t> species;
+  DataMatrix coefficient;
+  for( size_t k=0 ; k<implicitReaction_.size() ; ++k ) {
+    T_->reaction(implicitReaction_[k])->
+      linearCellTransport(*T_,cellData_,wallData_,vertexData_,species,coefficient);
+    for( size_t l=0 ; l<species.size() ; ++l ) {
+      size_t s = std::find(species_.begin(),species_.end(),species[l])-
+	species_.begin();
+      if( s==species_.size() ) {
+	species_.push_back(species[l]);
+	coefficient_.push_back(std::vector<double>(numEntry,0.0));
+	matrix_.push_back(std::vector<double>());
+	factor_.push_back(std::vector<double>());
+	factorFlag_.push_back(0);
+      }
+      assert( coefficient[l].size()==numEntry );
+      for( size_t e=0 ; e<numEntry ; ++e )
+	coefficient_[s][e] += coefficient[l][e];
+    }
+  }
+}
+
+void IMEX::buildPattern(const TissueTopology &topology)
+{
+  size_t numCell = topology.numCell();
+  const std::vector<size_t> &start = topology.cellNeighborStart();
+  const std::vector<size_t> &neighbor = topology.cellNeighbor();
+
+  // Rows with sorted unique columns (several walls between two cells share
+  // an entry)
+  rowStart_.resize(numCell+1);
+  column_.clear();
+  diagonal_.resize(numCell);
+  entryPosition_.resize(neighbor.size());
+  rowStart_[0] = 0;
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    column_.push_back(i);
+    column_.insert(column_.end(),neighbor.begin()+start[i],
+		   neighbor.begin()+start[i+1]);
+    std::vector<size_t>::iterator first = column_.begin()+rowStart_[i];
+    std::sort(first,column_.end());
+    column_.erase(std::unique(first,column_.end()),column_.end());
+    rowStart_[i+1] = column_.size();
+    first = column_.begin()+rowStart_[i];
+    diagonal_[i] = std::lower_bound(first,column_.end(),i)-column_.begin();
+    for( size_t k=start[i] ; k<start[i+1] ; ++k )
+      entryPosition_[k] = std::lower_bound(first,column_.end(),neighbor[k])-
+	column_.begin();
+  }
+  patternRevision_ = topology.revision();
+  std::fill(factorFlag_.begin(),factorFlag_.end(),0);
+}
+
+void IMEX::assemble(size_t s)
+{
+  size_t numCell = diagonal_.size();
+  std::vector<double> value(column_.size(),0.0);
+  const std::vector<double> &a = coefficient_[s];
+  const std::vector<size_t> &start = T_->topology().cellNeighborStart();
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    value[diagonal_[i]] += 1.0;
+    for( size_t k=start[i] ; k<start[i+1] ; ++k ) {
+      value[diagonal_[i]] += h_*a[k];
+      value[entryPosition_[k]] -= h_*a[k];
+    }
+  }
+  // Reuse the factorization if the matrix is unchanged
+  if( factorFlag_[s] && value==matrix_[s] )
+    return;
+  matrix_[s].swap(value);
+  factorize(s);
+  factorFlag_[s] = 1;
+  ++numFactorization_;
+}
+
+void IMEX::factorize(size_t s)
+{
+  size_t numCell = diagonal_.size();
+  std::vector<double> &f = factor_[s];
+  f = matrix_[s];
+  marker_.assign(numCell,size_t(-1));
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    for( size_t p=rowStart_[i] ; p<rowStart_[i+1] ; ++p )
+      marker_[column_[p]] = p;
+    for( size_t p=rowStart_[i] ; p<diagonal_[i] ; ++p ) {
+      size_t c = column_[p];
+      f[p] /= f[diagonal_[c]];
+      for( size_t q=diagonal_[c]+1 ; q<rowStart_[c+1] ; ++q ) {
+	size_t m = marker_[column_[q]];
+	if( m!=size_t(-1) )
+	  f[m] -= f[p]*f[q];
+      }
+    }
+    for( size_t p=rowStart_[i] ; p<rowStart_[i+1] ; ++p )
+      marker_[column_[p]] = size_t(-1);
+  }
+}
+
+void IMEX::multiply(size_t s, const std::vector<double> &x,
+		    std::vector<double> &y) const
+{
+  const std::vector<double> &a = matrix_[s];
+  for( size_t i=0 ; i<diagonal_.size() ; ++i ) {
+    double sum = 0.0;
+    for( size_t p=rowStart_[i] ; p<rowStart_[i+1] ; ++p )
+      sum += a[p]*x[column_[p]];
+    y[i] = sum;
+  }
+}
+
+void IMEX::precondition(size_t s, const std::vector<double> &x,
+			std::vector<double> &y) const
+{
+  const std::vector<double> &f = factor_[s];
+  size_t numCell = diagonal_.size();
+  // Forward (unit lower) and backward (upper) substitution
+  for( size_t i=0 ; i<numCell ; ++i ) {
+    double sum = x[i];
+    for( size_t p=rowStart_[i] ; p<diagonal_[i] ; ++p )
+      sum -= f[p]*y[column_[p]];
+    y[i] = sum;
+  }
+  for( size_t i=numCell ; i-->0 ; ) {
+    double sum = y[i];
+    for( size_t p=diagonal_[i]+1 ; p<rowStart_[i+1] ; ++p )
+      sum -= f[p]*y[column_[p]];
+    y[i] = sum/f[diagonal_[i]];
+  }
+}
+
+namespace {
+  double dot(const std::vector<double> &x, const std::vector<double> &y)
+  {
+    double sum = 0.0;
+    for( size_t i=0 ; i<x.size() ; ++i )
+      sum += x[i]*y[i];
+    return sum;
+  }
+}
+
+size_t IMEX::solve(size_t s)
+{
+  size_t n = b_.size();
+  x_ = b_;
+  r_.resize(n); r0_.resize(n); p_.assign(n,0.0); v_.assign(n,0.0);
+  s_.resize(n); w_.resize(n); pHat_.resize(n); sHat_.resize(n);
+
+  double bNorm = std::sqrt(dot(b_,b_));
+  if( bNorm==0.0 ) {
+    std::fill(x_.begin(),x_.end(),0.0);
+    return 0;
+  }
+  double tol = tolerance_*bNorm;
+  multiply(s,x_,r_);
+  for( size_t i=0 ; i<n ; ++i )
+    r_[i] = b_[i]-r_[i];
+  if( std::sqrt(dot(r_,r_))<tol )
+    return 0;
+  r0_ = r_;
+  double rho=1.0, alpha=1.0, omega=1.0;
+  for( size_t iter=1 ; iter<=maxIteration_ ; ++iter ) {
+    double rhoNew = dot(r0_,r_);
+    if( rhoNew==0.0 )
+      return maxIteration_+1;
+    double beta = (rhoNew/rho)*(alpha/omega);
+    for( size_t i=0 ; i<n ; ++i )
+      p_[i] = r_[i] + beta*(p_[i]-omega*v_[i]);
+    precondition(s,p_,pHat_);
+    multiply(s,pHat_,v_);
+    alpha = rhoNew/dot(r0_,v_);
+    for( size_t i=0 ; i<n ; ++i )
+      s_[i] = r_[i] - alpha*v_[i];
+    if( std::sqrt(dot(s_,s_))<tol ) {
+      for( size_t i=0 ; i<n ; ++i )
+	x_[i] += alpha*pHat_[i];
+      return iter;
+    }
+    precondition(s,s_,sHat_);
+    multiply(s,sHat_,w_);
+    omega = dot(w_,s_)/dot(w_,w_);
+    for( size_t i=0 ; i<n ; ++i ) {
+      x_[i] += alpha*pHat_[i] + omega*sHat_[i];
+      r_[i] = s_[i] - omega*w_[i];
+    }
+    if( std::sqrt(dot(r_,r_))<tol )
+      return iter;
+    rho = rhoNew;
+  }
+  return maxIteration_+1;
+}
@@ -0,0 +1,136 @@
+#ifndef IMEX_H
+#define IMEX_H
+//
+// Filename     : imex.h
+// Description  : Implicit-explicit solver with implicit cell-to-cell transport
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include "baseSolver.h"
+#include "solverState.h"
+
+///
+/// @brief Implicit-explicit (IMEX) Euler solver where linear cell-to-cell
+/// transport is integrated implicitly and all other reactions explicitly
+///
+/// @details Reactions declaring themselves as linear transport (via
+/// BaseReaction::linearCellTransport(), e.g. DiffusionSimple and
+/// Diffusion2d) are collected into one graph Laplacian L_s per transported
+/// variable s. All other reactions (f_E) are integrated with an explicit
+/// Euler step, followed by an implicit Euler step for the transport:
+///
+/// @f[ y^* = y_n + h f_E(y_n),\ \ (I - h L_s(y_n)) y_{n+1,s} = y^*_s @f]
+///
+/// such that the step size is limited by the reaction dynamics and not by
+/// fast diffusion. The sparse systems (one row per cell, one entry per
+/// neighbor) are solved with BiCGSTAB (Diffusion2d gives non-symmetric
+/// matrices) preconditioned with an incomplete LU factorization, ILU(0). The
+/// sparsity pattern is rebuilt only when the tissue topology revision
+/// changes, and the factorization is reused as long as the matrix is
+/// unchanged, i.e. for constant coefficients (DiffusionSimple) until the
+/// next division or removal.
+///
+class IMEX : public BaseSolver {
+
+ private:
+
+  double h_;
+  double tolerance_;
+  size_t maxIteration_;
+  std::vector<size_t> explicitReaction_;
+  std::vector<size_t> implicitReaction_;
+
+  // Transported variables and summed coefficients (per topology CSR entry)
+  std::vector<size_t> species_;
+  DataMatrix coefficient_;
+  // Sparsity pattern of I-hL (rows with sorted columns)
+  size_t patternRevision_;
+  std::vector<size_t> rowStart_;
+  std::vector<size_t> column_;
+  std::vector<size_t> diagonal_;
+  std::vector<size_t> entryPosition_;
+  // Matrix and ILU(0) factors per transported variable
+  DataMatrix matrix_;
+  DataMatrix factor_;
+  std::vector<int> factorFlag_;
+  // Work vectors for the linear solver
+  std::vector<double> b_, x_, r_, r0_, p_, v_, s_, w_, pHat_, sHat_;
+  std::vector<size_t> marker_;
+
+  size_t numFactorization_;
+  size_t numIteration_;
+  size_t numSolve_;
+
+ public:
+  ///
+  /// @brief Main constructor
+  ///
+  IMEX(Tissue *T,std::ifstream &IN);
+
+  ///
+  /// @brief Reads the parameters used by the IMEX solver
+  ///
+  /// @details The parameter file sent to the simulator binary looks like:
+  ///
+  /// <pre>
+  /// IMEX
+  /// T_start T_end
+  /// printFlag printNum
+  /// h tolerance maxIteration
+  /// </pre>
+  ///
+  /// where IMEX is the identity string used by BaseSolver::getSolver to
+  /// identify that this algorithm should be used. T_start (T_end) is the
+  /// start (end) time for the simulation, printFlag is an integer which sets
+  /// the output format (read by BaseSolver::print()), printNum is the number
+  /// of equally spread time points to be printed. h is the (fixed) time
+  /// step, tolerance the relative residual used for the linear solves, and
+  /// maxIteration the maximal number of BiCGSTAB iterations per solve. The
+  /// simulation is stopped with an error if a solve does not converge.
+  ///
+  /// @see BaseSolver::getSolver()
+  /// @see BaseSolver::print()
+  ///
+  void readParameterFile(std::ifstream &IN);
+
+  void simulate(size_t verbose=0);
+  ///
+  /// @brief Divides the reactions into implicit (linear transport) and
+  /// explicit ones
+  ///
+  void setReactionGroups();
+  ///
+  /// @brief Takes an IMEX Euler step of size h_
+  ///
+  void imexStep();
+
+ private:
+  ///
+  /// @brief Collects the transport coefficients from the implicit reactions
+  ///
+  void collectCoefficients();
+  ///
+  /// @brief Builds the sparsity pattern of I-hL from the tissue topology
+  ///
+  void buildPattern(const TissueTopology &topology);
+  ///
+  /// @brief Assembles I-hL for variable s and refactorizes if it has changed
+  ///
+  void assemble(size_t s);
+  ///
+  /// @brief Computes the ILU(0) factors of matrix_[s] into factor_[s]
+  ///
+  void factorize(size_t s);
+  ///
+  /// @brief Solves (I-hL_s) x = b with preconditioned BiCGSTAB
+  ///
+  /// Returns the number of iterations used (maxIteration_+1 if not converged).
+  ///
+  size_t solve(size_t s);
+  void multiply(size_t s, const std::vector<double> &x, std::vector<double> &y) const;
+  void precondition(size_t s, const std::vector<double> &x, std::vector<double> &y) const;
+};
+
+#endif
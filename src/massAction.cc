@@ -7,6 +7,7 @@
 //
 #include "massAction.h"
 #include "baseReaction.h"
+#include "hybridStochastic.h"
 
 
 namespace MassAction {
@@ -288,6 +289,17 @@ namespace MassAction {
       
     }
   }
+
+  int OneToTwo::
+  channel(ReactionChannel &C) const
+  {
+    C.setRate(parameter(0));
+    C.addFactor(variableIndex(0,0));
+    C.addChange(variableIndex(0,0),-1.0);
+    C.addChange(variableIndex(0,1),1.0);
+    C.addChange(variableIndex(0,2),1.0);
+    return 1;
+  }
   
   TwoToOne::
   TwoToOne(std::vector<double> &paraValue, 
@@ -354,6 +366,18 @@ namespace MassAction {
     }
   }
 
+  int TwoToOne::
+  channel(ReactionChannel &C) const
+  {
+    C.setRate(parameter(0));
+    C.addFactor(variableIndex(0,0));
+    C.addFactor(variableIndex(0,1));
+    C.addChange(variableIndex(0,0),-1.0);
+    C.addChange(variableIndex(0,1),-1.0);
+    C.addChange(variableIndex(0,2),1.0);
+    return 1;
+  }
+
   GeneralWall::
   GeneralWall(std::vector<double> &paraValue, 
 	  std::vector< std::vector<size_t> > &indValue ) 
@@ -44,7 +44,7 @@ namespace MassAction {
   /// P_1 ... P_{N_P}
   /// @endverbatim
   ///
-  class General : public BaseReaction {
+  class General : public BaseChemicalReaction {
     
   public:
     
@@ -119,7 +119,7 @@ namespace MassAction {
   /// E_1 ... E_{N_E}
   /// @endverbatim
   ///
-  class GeneralEnzymatic : public BaseReaction {
+  class GeneralEnzymatic : public BaseChemicalReaction {
     
   public:
     
@@ -188,7 +188,7 @@ namespace MassAction {
 /// r_cell p1_cell P2_cell 
 /// @endverbatim
 ///
-class OneToTwo : public BaseReaction {
+class OneToTwo : public BaseChemicalReaction {
   
  public:
   
@@ -203,6 +203,12 @@ class OneToTwo : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Describes the reaction as a stochastic channel (copy numbers)
+  ///
+  /// @see BaseReaction::channel()
+  ///
+  int channel(ReactionChannel &C) const;
 };
 
 
@@ -226,7 +232,7 @@ class OneToTwo : public BaseReaction {
 /// r1_cell r2_cell P_cell 
 /// @endverbatim
 ///
-class TwoToOne : public BaseReaction {
+class TwoToOne : public BaseChemicalReaction {
   
  public:
   
@@ -241,6 +247,12 @@ class TwoToOne : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Describes the reaction as a stochastic channel (copy numbers)
+  ///
+  /// @see BaseReaction::channel()
+  ///
+  int channel(ReactionChannel &C) const;
 };
 
   ///
@@ -264,7 +276,7 @@ class TwoToOne : public BaseReaction {
   /// P_1 ... P_{N_P}
   /// @endverbatim
   ///
-  class GeneralWall : public BaseReaction {
+  class GeneralWall : public BaseChemicalReaction {
     
   public:
     
@@ -334,7 +346,7 @@ class TwoToOne : public BaseReaction {
     /// r_wall p1_wall P2_wall
     /// @endverbatim
     ///
-    class OneToTwoWall : public BaseReaction {
+    class OneToTwoWall : public BaseChemicalReaction {
         
     public:
         
@@ -372,7 +384,7 @@ class TwoToOne : public BaseReaction {
     /// r1_wall r2_wall P_wall
     /// @endverbatim
     ///
-    class TwoToOneWall : public BaseReaction {
+    class TwoToOneWall : public BaseChemicalReaction {
         
     public:
         
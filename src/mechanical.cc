@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 #include "baseReaction.h"
+#include "reactionSchedule.h"
 #include "mechanical.h"
 #include "tissue.h"
 
@@ -61,23 +62,27 @@ derivs(Tissue &T,
   //Assumming vertices and walls are sorted and 2 dimensions
   //
   assert( dimension ==2 );
+  //Use the index based connectivity (cyclic vertex order per cell)
+  const TissueTopology &topology = T.topology();
+  const size_t *cellVertexStart = &topology.cellVertexStart()[0];
+  const size_t *cellVertex = topology.cellVertex().empty() ? NULL : 
+    &topology.cellVertex()[0];
   //For each cell
   for (size_t cellI = 0; cellI < numCells; ++cellI) {
-    Cell &tmpCell = T.cell(cellI);
-    
     double factor = 0.5 * parameter(0);
     
     if (parameter(1) == 1)
       {
-	double cellVolume = tmpCell.calculateVolume(vertexData);
+	double cellVolume = T.cell(cellI).calculateVolume(vertexData);
 	factor /= std::fabs(cellVolume);
       }
     
-    for (size_t k = 0; k < tmpCell.numVertex(); ++k) {
-      size_t v1I = tmpCell.vertex(k)->index();
-      size_t v1PlusI = tmpCell.vertex((k + 1) % (tmpCell.numVertex()))->index();
-      size_t v1MinusK = k > 0 ? k - 1 : tmpCell.numVertex() - 1;
-      size_t v1MinusI = tmpCell.vertex(v1MinusK)->index();
+    const size_t *cv = cellVertex + cellVertexStart[cellI];
+    size_t numCellVertex = cellVertexStart[cellI+1]-cellVertexStart[cellI];
+    for (size_t k = 0; k < numCellVertex; ++k) {
+      size_t v1I = cv[k];
+      size_t v1PlusI = cv[(k + 1) % numCellVertex];
+      size_t v1MinusI = cv[k > 0 ? k - 1 : numCellVertex - 1];
       
       vertexDerivs[v1I][0] += factor * (vertexData[v1PlusI][1] - vertexData[v1MinusI][1]);
       vertexDerivs[v1I][1] += factor * (vertexData[v1MinusI][0]- vertexData[v1PlusI][0]);
@@ -1541,6 +1546,12 @@ derivs(Tissue &T,
   }
 }
 
+void CellVolumeExperimental::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 EpidermalRadialForce::EpidermalRadialForce(std::vector<double> &paraValue,
 					   std::vector< std::vector<size_t> > &indValue)
 {
@@ -4146,6 +4157,12 @@ derivs(Tissue &T,
   //std:: cerr << VolumeChange<<" "<<deltaVolumeChange<<" "<<VolumeChangeDerT<<std::endl;
 }
 
+void TemplateVolumeChange::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 void TemplateVolumeChange:: update(Tissue &T,
                                    DataMatrix &cellData,
                                    DataMatrix &wallData,
@@ -4245,6 +4262,12 @@ derivs(Tissue &T,
     }
 }
 
+void CalculateAngleVectors::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 
 
 CalculateAngleVectorXYplane::CalculateAngleVectorXYplane(std::vector<double> &paraValue,
@@ -4301,6 +4324,12 @@ derivs(Tissue &T,
     }
 }
 
+void CalculateAngleVectorXYplane::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 
 
 AngleVector::AngleVector(std::vector<double> &paraValue,
@@ -4398,6 +4427,12 @@ derivs(Tissue &T,
     }
 }
 
+void AngleVector::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 VertexFromHypocotylGrowth::
 VertexFromHypocotylGrowth(std::vector<double> &paraValue, 
 			  std::vector< std::vector<size_t> > 
@@ -4662,6 +4697,12 @@ derivs(Tissue &T,
   }
 }
 
+void maxVelocity::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 
 
 DebugReaction::DebugReaction(std::vector<double> &paraValue,
@@ -457,6 +457,12 @@ class CellVolumeExperimental : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs);
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 class EpidermalRadialForce : public BaseReaction
@@ -1164,6 +1170,12 @@ class TemplateVolumeChange : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   ///
   /// @brief Reaction initiation applied before simulation starts
@@ -1241,6 +1253,12 @@ class CalculateAngleVectors : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   
 };
@@ -1298,6 +1316,12 @@ class CalculateAngleVectorXYplane : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );  
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -1354,6 +1378,12 @@ class AngleVector : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -1464,6 +1494,12 @@ class maxVelocity : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   
 };
@@ -9,8 +9,10 @@
 #include <vector>
 #include <algorithm>
 #include "baseReaction.h"
+#include "reactionSchedule.h"
 #include "mechanicalSpring.h"
 #include "tissue.h"
+#include "vertexJacobian.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -139,9 +141,11 @@ derivs(Tissue &T,
   // std::cerr<<".............end ................."<<std::endl;
 
 
+  //Use the index based (wall -> vertex) connectivity
+  const TissueTopology &topology = T.topology();
   for( size_t i=0 ; i<numWalls ; ++i ) {
-    size_t v1 = T.wall(i).vertex1()->index();
-    size_t v2 = T.wall(i).vertex2()->index();
+    size_t v1 = topology.wallVertex(i,0);
+    size_t v2 = topology.wallVertex(i,1);
     size_t dimension = vertexData[v1].size();
     assert( vertexData[v2].size()==dimension );
     //Calculate shared factors
@@ -228,6 +232,123 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpring::
+access(ReactionAccess &A) const
+{
+  size_t wallLengthIndex = variableIndex(0,0);
+  A.read(ReactionAccess::wallData,wallLengthIndex);
+  if( numParameter()==4 && parameter(3)==1 )
+    A.read(ReactionAccess::wallData,wallLengthIndex+1);
+  if( numParameter()==3 )
+    A.read(ReactionAccess::wallData,variableIndex(2,0));
+  //Saved force
+  if( numVariableIndexLevel()==2 ||
+      (numParameter()==3 && numVariableIndex(1)==1) )
+    A.write(ReactionAccess::wallData,variableIndex(1,0));
+  A.read(ReactionAccess::vertexData);
+  A.write(ReactionAccess::vertexDerivs);
+}
+
+
+int VertexFromWallSpring::
+geometryDerivs(const Geometry &G,
+	       const GeometryState &state,
+	       GeometryState &derivs) {
+  
+  // Force saving and wall types update/read more than the resting length
+  if( numVariableIndexLevel()!=1 || numParameter()==3 )
+    return 0;
+  size_t numEdges = G.numEdge();
+  size_t wallLengthIndex = variableIndex(0,0);
+  size_t dimension = state.dimension();
+  bool doubleLength = numParameter()==4 && parameter(3)==1;
+  
+  for( size_t i=0 ; i<numEdges ; ++i ) {
+    size_t v1 = G.edgeVertex(i,0);
+    size_t v2 = G.edgeVertex(i,1);
+    const double *x1 = state.vertex(v1);
+    const double *x2 = state.vertex(v2);
+    //Calculate shared factors
+    double distance=0.0;
+    for( size_t d=0 ; d<dimension ; d++ )
+      distance += (x1[d]-x2[d])*(x1[d]-x2[d]);
+    distance = std::sqrt(distance);
+    const double *edgeData = state.edge(i);
+    double wallLength = edgeData[wallLengthIndex];
+    double coeff = parameter(0)*((1.0/wallLength)-(1.0/distance));
+    if( doubleLength )
+      wallLength = edgeData[wallLengthIndex+1];
+    if( distance <= 0.0 && wallLength <=0.0 )
+      coeff = 0.0;
+    if( distance>wallLength )
+      coeff *=parameter(1);
+    
+    //Update both vertices for each dimension
+    double *d1 = derivs.vertex(v1);
+    double *d2 = derivs.vertex(v2);
+    for( size_t d=0 ; d<dimension ; d++ ) {
+      double div = (x1[d]-x2[d])*coeff;
+      d1[d] -= div;
+      d2[d] += div;
+    }
+  }
+  return 1;
+}
+
+int VertexFromWallSpring::
+vertexJacobian(Tissue &T,
+	       DataMatrix &cellData,
+	       DataMatrix &wallData,
+	       DataMatrix &vertexData,
+	       VertexJacobian &J) {
+  
+  size_t numWalls = T.numWall();
+  size_t wallLengthIndex = variableIndex(0,0);
+  bool doubleLength = numParameter()==4 && parameter(3)==1;
+  const TissueTopology &topology = T.topology();
+  for( size_t i=0 ; i<numWalls ; ++i ) {
+    size_t v1 = topology.wallVertex(i,0);
+    size_t v2 = topology.wallVertex(i,1);
+    size_t dimension = vertexData[v1].size();
+    double distance=0.0;
+    for( size_t d=0 ; d<dimension ; d++ )
+      distance += (vertexData[v1][d]-vertexData[v2][d])*
+	(vertexData[v1][d]-vertexData[v2][d]);
+    distance = std::sqrt(distance);
+    //Same spring constant and resting lengths as in derivs()
+    double wallLength = wallData[i][wallLengthIndex];
+    double K = parameter(0);
+    if( numParameter()==3 && wallData[i][variableIndex(2,0)]==1 )
+      K = parameter(2);
+    double coeff = K*((1.0/wallLength)-(1.0/distance));
+    double compareLength = doubleLength ? wallData[i][wallLengthIndex+1] :
+      wallLength;
+    if( distance <= 0.0 ) {
+      //No direction defined for coinciding vertices
+      continue;
+    }
+    if( distance>compareLength ) {
+      K *= parameter(1);
+      coeff *= parameter(1);
+    }
+    double radial = K/(distance*distance*distance);
+    std::vector<double> value(dimension*dimension);
+    for( size_t d=0 ; d<dimension ; d++ )
+      for( size_t dd=0 ; dd<dimension ; dd++ )
+	value[d*dimension+dd] = -radial*(vertexData[v1][d]-vertexData[v2][d])*
+	  (vertexData[v1][dd]-vertexData[v2][dd]) - (d==dd ? coeff : 0.0);
+    //Each block pointer is used before the next block is added
+    size_t row[4] = {v1,v2,v1,v2}, column[4] = {v1,v2,v2,v1};
+    for( size_t k=0 ; k<4 ; ++k ) {
+      double *block = J.block(row[k],column[k]);
+      double sign = k<2 ? 1.0 : -1.0;
+      for( size_t l=0 ; l<value.size() ; ++l )
+	block[l] += sign*value[l];
+    }
+  }
+  return 1;
+}
+
 
 void VertexFromWallSpring::
 derivsWithAbs(Tissue &T,
@@ -553,6 +674,13 @@ derivs(Tissue &T,
     }
 }
 
+void VertexFromWallSpringMTnew::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallBoundarySpring::
 VertexFromWallBoundarySpring(std::vector<double> &paraValue, 
 		     std::vector< std::vector<size_t> > 
@@ -655,6 +783,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallBoundarySpring::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 
 namespace CenterTriangulation {
@@ -828,6 +963,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromDoubleWallSpring::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringSpatial::
 VertexFromWallSpringSpatial(std::vector<double> &paraValue, 
 														std::vector< std::vector<size_t> > 
@@ -939,6 +1081,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringSpatial::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringMT::
 VertexFromWallSpringMT(std::vector<double> &paraValue, 
 													std::vector< std::vector<size_t> > 
@@ -1059,6 +1208,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringMT::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringMTSpatial::
 VertexFromWallSpringMTSpatial(std::vector<double> &paraValue, 
 			      std::vector< std::vector<size_t> > 
@@ -1213,6 +1369,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringMTSpatial::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringMTHistory::
 VertexFromWallSpringMTHistory(std::vector<double> &paraValue, 
 															std::vector< std::vector<size_t> > 
@@ -1335,6 +1498,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringMTHistory::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 void VertexFromWallSpringMTHistory::
 initiate(Tissue &T,
 	 DataMatrix &cellData,
@@ -1487,6 +1657,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromEpidermalWallSpring::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromEpidermalCellWallSpring::
 VertexFromEpidermalCellWallSpring(std::vector<double> &paraValue, 
 																						std::vector< std::vector<size_t> > 
@@ -1577,6 +1754,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromEpidermalCellWallSpring::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringExperimental::
 VertexFromWallSpringExperimental(std::vector<double> &paraValue,
 																 std::vector< std::vector<size_t> > &indValue)
@@ -1643,6 +1827,13 @@ derivs(Tissue &T,
  	}
 }
 
+void VertexFromWallSpringExperimental::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringConcentrationHill::
 VertexFromWallSpringConcentrationHill(std::vector<double> &paraValue, 
 															 std::vector< std::vector<size_t> > 
@@ -1743,6 +1934,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringConcentrationHill::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromWallSpringMTConcentrationHill::
 VertexFromWallSpringMTConcentrationHill(std::vector<double> &paraValue, 
 					std::vector< std::vector<size_t> > 
@@ -1872,6 +2070,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromWallSpringMTConcentrationHill::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 VertexFromDoubleWallSpringMTConcentrationHill::
 VertexFromDoubleWallSpringMTConcentrationHill(std::vector<double> &paraValue,											 std::vector< std::vector<size_t> > &indValue ) 
 {  
@@ -2009,6 +2214,13 @@ derivs(Tissue &T,
   }
 }
 
+void VertexFromDoubleWallSpringMTConcentrationHill::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 
 VertexFromExternalSpring::
@@ -97,6 +97,40 @@ class VertexFromWallSpring : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares the wall (resting length, saved force and type) and
+  /// vertex columns accessed
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
+  ///
+  /// @brief Derivative function on the index based Geometry
+  ///
+  /// Provided for the versions with a single index level (no force saving
+  /// or wall types), otherwise 0 is returned and derivs(Tissue&,...) is
+  /// used.
+  ///
+  /// @see BaseReaction::geometryDerivs()
+  ///
+  int geometryDerivs(const Geometry &G,
+		     const GeometryState &state,
+		     GeometryState &derivs);
+  ///
+  /// @brief Adds the analytic Jacobian of the vertex update
+  ///
+  /// With @f$ u = x_1-x_2 @f$, @f$ d=|u| @f$ and the update
+  /// @f$ -c(d)u @f$ for vertex 1, where @f$ c=K(1/L-1/d) @f$, the block
+  /// @f$ \partial \dot{x}_1/\partial x_1 = -cI - (K/d^3)uu^T @f$ is added to
+  /// (1,1) and (2,2), and its negative to (1,2) and (2,1).
+  ///
+  /// @see BaseReaction::vertexJacobian()
+  ///
+  int vertexJacobian(Tissue &T,
+		     DataMatrix &cellData,
+		     DataMatrix &wallData,
+		     DataMatrix &vertexData,
+		     VertexJacobian &J);
 
   void derivsWithAbs(Tissue &T,
          DataMatrix &cellData,
@@ -175,6 +209,12 @@ class VertexFromWallSpringMTnew : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 
@@ -216,6 +256,12 @@ class VertexFromWallBoundarySpring : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 namespace CenterTriangulation {
@@ -320,6 +366,12 @@ class VertexFromDoubleWallSpring : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -359,6 +411,12 @@ class VertexFromWallSpringSpatial : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -408,6 +466,12 @@ class VertexFromWallSpringMTSpatial : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -467,6 +531,12 @@ class VertexFromWallSpringMT : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -504,6 +574,12 @@ class VertexFromWallSpringMTHistory : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
   void initiate(Tissue &T,
 		DataMatrix &cellData,
 		DataMatrix &wallData,
@@ -544,6 +620,12 @@ class VertexFromEpidermalWallSpring : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 //!Updates vertices from an asymmetric epidermal wall spring potential
@@ -577,6 +659,12 @@ class VertexFromEpidermalCellWallSpring : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 class VertexFromWallSpringExperimental : public BaseReaction
@@ -608,6 +696,12 @@ class VertexFromWallSpringExperimental : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs);
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -644,6 +738,12 @@ class VertexFromWallSpringConcentrationHill : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 class VertexFromWallSpringMTConcentrationHill : public BaseReaction {
@@ -676,6 +776,12 @@ class VertexFromWallSpringMTConcentrationHill : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -717,6 +823,12 @@ class VertexFromDoubleWallSpringMTConcentrationHill : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 
@@ -8,8 +8,11 @@
 #include <utility>
 #include <vector>
 #include "baseReaction.h"
+#include "reactionSchedule.h"
 #include "mechanicalTRBS.h"
 #include "tissue.h"
+#include "trbsKernel.h"
+#include "vertexJacobian.h"
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -60,149 +63,221 @@ derivs(Tissue &T,
   size_t numCells = T.numCell();
   size_t wallLengthIndex = variableIndex(0,0);
   size_t numWalls = 3; // defined only for triangles at the moment
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
+  double young = parameter(0);
+  double poisson =parameter(1);
+  // Lame coefficients
+  double lambda=young*poisson/(1-poisson*poisson);
+  double mio=young/(1+poisson);
+  TRBS::Element E;
   
   for( size_t i=0 ; i<numCells ; ++i ) {
-    if( T.cell(i).numWall() != numWalls ) {
+    if( topology.numCellWall(i) != numWalls ) {
       std::cerr << "VertexFromTRBS::derivs() only defined for triangular cells."
-		<< " Not for cells with " << T.cell(i).numWall() << " walls!"
+		<< " Not for cells with " << topology.numCellWall(i) << " walls!"
 		<< std::endl;
       exit(-1);
     }
-    
-    double young = parameter(0);
-    double poisson =parameter(1);                
-    size_t v1 = T.cell(i).vertex(0)->index();
-    size_t v2 = T.cell(i).vertex(1)->index();
-    size_t v3 = T.cell(i).vertex(2)->index();
-    size_t w1 = T.cell(i).wall(0)->index();
-    size_t w2 = T.cell(i).wall(1)->index();
-    size_t w3 = T.cell(i).wall(2)->index();
-    std::vector<double> restingLength(numWalls);
-    restingLength[0] = wallData[w1][wallLengthIndex];
-    restingLength[1] = wallData[w2][wallLengthIndex];
-    restingLength[2] = wallData[w3][wallLengthIndex];
-
-    DataMatrix position(3,vertexData[v1]);
-    position[1] = vertexData[v2];
-    position[2] = vertexData[v3];
-    //position[0][2] z for vertex 1 (of the cell)
-   
-    std::vector<double> length(numWalls);
-    length[0] = T.wall(w1).lengthFromVertexPosition(vertexData);
-    length[1] = T.wall(w2).lengthFromVertexPosition(vertexData);
-    length[2] = T.wall(w3).lengthFromVertexPosition(vertexData);
-    
-    // Lame coefficients (can be defined out of loop)
-    double lambda=young*poisson/(1-poisson*poisson);
-    double mio=young/(1+poisson);
-    
-    // Area of the element (using Heron's formula)                                      
-    double Area=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-                           (-restingLength[0]+restingLength[1]+restingLength[2])*
-                           ( restingLength[0]-restingLength[1]+restingLength[2])*
-                           ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-    
-    //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
-    std::vector<double> Angle(3);
-    Angle[0]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]-restingLength[1]*restingLength[1])/
-                         (restingLength[0]*restingLength[2]*2)    );
-    Angle[1]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
-                         (restingLength[0]*restingLength[1]*2)    );
-    Angle[2]=std::acos(  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]-restingLength[0]*restingLength[0])/
-                         (restingLength[1]*restingLength[2]*2)    );
-    // can be ommited by cotan(A)=.25*sqrt(4*b*b*c*c/K-1)
-    
-    //Tensile Stiffness
-    double tensileStiffness[3];
-    double const temp = 1.0/(Area*16);                                      
-    double cotan[3] = {1.0/std::tan(Angle[0]),1.0/std::tan(Angle[1]),1.0/std::tan(Angle[2])};    
-    tensileStiffness[0]=(2*cotan[2]*cotan[2]*(lambda+mio)+mio)*temp;
-    tensileStiffness[1]=(2*cotan[0]*cotan[0]*(lambda+mio)+mio)*temp;
-    tensileStiffness[2]=(2*cotan[1]*cotan[1]*(lambda+mio)+mio)*temp;
-    
-    //std::cerr <<"young, parameter0, poisson, parameter1, lambda and mio :  " 
-    //          << young <<" , " << parameter(0) <<" "<< poisson <<" , " << parameter(1)<< " "<< lambda <<" , "<< mio << std::endl;
-    
-    //std::cerr <<" angles, element " << i << std::endl;                                   
-    //std::cerr <<"[0] "<< Angle[0] << std::endl
-    //          <<"[1] "<< Angle[1] << std::endl
-    //          <<"[2] "<< Angle[2] << std::endl << std::endl;
-    
-    
-    //std::cerr <<"cotan of angles, element " << i << std::endl;     
-    //std::cerr <<"[0] "<< cotan[0] << std::endl
-    //          <<"[1] "<< cotan[1] << std::endl
-    //          <<"[2] "<< cotan[2] << std::endl << std::endl;
-
-    //std::cerr <<"tan of angles, element " << i << std::endl;                                    
-    //std::cerr <<"[0] "<< std::tan(Angle[0]) << std::endl
-    //          <<"[1] "<< std::tan(Angle[1]) << std::endl
-    //          <<"[2] "<< std::tan(Angle[2]) << std::endl << std::endl;
-
+    size_t v[3], w[3];
+    double length[3], Delta[3];
+    size_t dimension = vertexData[topology.cellVertex(i,0)].size();
+    for( size_t k=0 ; k<numWalls ; ++k ) {
+      v[k] = topology.cellVertex(i,k);
+      w[k] = topology.cellWall(i,k);
+      E.restingLength[k] = wallData[w[k]][wallLengthIndex];
+      size_t wv1 = topology.wallVertex(w[k],0);
+      size_t wv2 = topology.wallVertex(w[k],1);
+      double distance=0.0;
+      for( size_t d=0 ; d<dimension ; ++d )
+	distance += ( vertexData[wv1][d]-vertexData[wv2][d] ) *
+	  ( vertexData[wv1][d]-vertexData[wv2][d] );
+      length[k] = std::sqrt(distance);
+    }
+    TRBS::stiffness(lambda,mio,E);
+    //Calculate biquadratic strains
+    for( size_t k=0 ; k<numWalls ; ++k )
+      Delta[k]=length[k]*length[k]-E.restingLength[k]*E.restingLength[k];
+    // adding TRBS forces to the total vertexDerivs
+    TRBS::force(E,Delta,&vertexData[v[0]][0],&vertexData[v[1]][0],
+		&vertexData[v[2]][0],dimension,&vertexDerivs[v[0]][0],
+		&vertexDerivs[v[1]][0],&vertexDerivs[v[2]][0]);
+  }
+}
 
-    //std::cerr <<"Tensile stiffness, element " << i << std::endl;                                   
-    //std::cerr <<"[0] "<< tensileStiffness[0] << std::endl
-    //	        <<"[1] "<< tensileStiffness[1] << std::endl
-    // 	        <<"[2] "<< tensileStiffness[2] << std::endl << std::endl;
 
-    //Angular Stiffness
-    double angularStiffness[3];
-    angularStiffness[0]=(2*cotan[1]*cotan[2]*(lambda+mio)-mio)*temp;
-    angularStiffness[1]=(2*cotan[0]*cotan[2]*(lambda+mio)-mio)*temp;
-    angularStiffness[2]=(2*cotan[0]*cotan[1]*(lambda+mio)-mio)*temp;
+void VertexFromTRBS::
+access(ReactionAccess &A) const
+{
+  A.read(ReactionAccess::wallData,variableIndex(0,0));
+  A.read(ReactionAccess::vertexData);
+  A.write(ReactionAccess::vertexDerivs);
+}
 
-    
 
-    
-    //Calculate biquadratic strains  
-    std::vector<double> Delta(3);
-    Delta[0]=(length[0])*(length[0])-(restingLength[0])*(restingLength[0]);
-    Delta[1]=(length[1])*(length[1])-(restingLength[1])*(restingLength[1]);
-    Delta[2]=(length[2])*(length[2])-(restingLength[2])*(restingLength[2]);
-    //Forces of vertices
-    double Force[3][3];                                           
-          
-    Force[0][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][0]-position[0][0])
-                +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][0]-position[0][0]); 
-    Force[0][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][1]-position[0][1])
-                +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][1]-position[0][1]); 
-    Force[0][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][2]-position[0][2])
-                +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][2]-position[0][2]); 
-
-    Force[1][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][0]-position[1][0])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][0]-position[1][0]); 
-    Force[1][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][1]-position[1][1])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][1]-position[1][1]); 
-    Force[1][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][2]-position[1][2])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][2]-position[1][2]); 
-
-    Force[2][0]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][0]-position[2][0])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][0]-position[2][0]); 
-    Force[2][1]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][1]-position[2][1])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][1]-position[2][1]); 
-    Force[2][2]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][2]-position[2][2])
-                +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][2]-position[2][2]); 
-
-    //std::cerr <<"Forces on Vertices , Element  "<< i << std::endl;                                                  //<<<<<<<<<<
-    //std::cerr <<"vertex [0] "<< Force[0][0] <<" "<<Force[0][1] <<" "<<Force[0][2] << std::endl
-    //          <<"vertex [1] "<< Force[1][0] <<" "<<Force[1][1] <<" "<<Force[1][2] << std::endl
-    //          <<"vertex [2] "<< Force[2][0] <<" "<<Force[2][1] <<" "<<Force[2][2] << std::endl<< std::endl;
-   
+int VertexFromTRBS::
+geometryDerivs(const Geometry &G,
+	       const GeometryState &state,
+	       GeometryState &derivs) {
+  
+  size_t numFaces = G.numFace();
+  size_t wallLengthIndex = variableIndex(0,0);
+  size_t dimension = state.dimension();
+  double young = parameter(0);
+  double poisson = parameter(1);
+  // Lame coefficients
+  double lambda=young*poisson/(1-poisson*poisson);
+  double mio=young/(1+poisson);
+  TRBS::Element E;
+  
+  // Current edge lengths
+  std::vector<double> edgeLength(G.numEdge());
+  for( size_t e=0 ; e<G.numEdge() ; ++e ) {
+    const double *x1 = state.vertex(G.edgeVertex(e,0));
+    const double *x2 = state.vertex(G.edgeVertex(e,1));
+    double distance=0.0;
+    for( size_t d=0 ; d<dimension ; ++d )
+      distance += (x1[d]-x2[d])*(x1[d]-x2[d]);
+    edgeLength[e] = std::sqrt(distance);
+  }
+  
+  for( size_t i=0 ; i<numFaces ; ++i ) {
+    if( G.numFaceVertex(i) != 3 ) {
+      std::cerr << "VertexFromTRBS::geometryDerivs() only defined for"
+		<< " triangular cells. Not for cells with "
+		<< G.numFaceVertex(i) << " walls!" << std::endl;
+      exit(-1);
+    }
+    size_t v[3], w[3];
+    double length[3], Delta[3];
+    for( size_t k=0 ; k<3 ; ++k ) {
+      v[k] = G.faceVertex(i,k);
+      w[k] = G.faceEdge(i,k);
+      E.restingLength[k] = state.edge(w[k])[wallLengthIndex];
+      length[k] = edgeLength[w[k]];
+    }
+    TRBS::stiffness(lambda,mio,E);
+    //Calculate biquadratic strains
+    for( size_t k=0 ; k<3 ; ++k )
+      Delta[k]=length[k]*length[k]-E.restingLength[k]*E.restingLength[k];
+    // adding TRBS forces to the total vertex derivatives
+    TRBS::force(E,Delta,state.vertex(v[0]),state.vertex(v[1]),
+		state.vertex(v[2]),dimension,derivs.vertex(v[0]),
+		derivs.vertex(v[1]),derivs.vertex(v[2]));
+  }
+  return 1;
+}
 
-    // adding TRBS forces to the total vertexDerivs
-    
-    vertexDerivs[v1][0]+= Force[0][0];
-    vertexDerivs[v1][1]+= Force[0][1];
-    vertexDerivs[v1][2]+= Force[0][2];
+int VertexFromTRBS::
+vertexJacobian(Tissue &T,
+	       DataMatrix &cellData,
+	       DataMatrix &wallData,
+	       DataMatrix &vertexData,
+	       VertexJacobian &J) {
+  
+  size_t numCells = T.numCell();
+  size_t wallLengthIndex = variableIndex(0,0);
+  double young = parameter(0);
+  double poisson = parameter(1);
+  // Lame coefficients
+  double lambda=young*poisson/(1-poisson*poisson);
+  double mio=young/(1+poisson);
+  const TissueTopology &topology = T.topology();
+  TRBS::Element E;
+  
+  for( size_t i=0 ; i<numCells ; ++i ) {
+    if( topology.numCellWall(i) != 3 ) {
+      std::cerr << "VertexFromTRBS::vertexJacobian() only defined for"
+		<< " triangular cells. Not for cells with "
+		<< topology.numCellWall(i) << " walls!" << std::endl;
+      exit(-1);
+    }
+    size_t v[3], wallEnd[3][2];
+    double restingLength[3], length[3];
+    size_t dimension = vertexData[topology.cellVertex(i,0)].size();
+    for( size_t k=0 ; k<3 ; ++k )
+      v[k] = topology.cellVertex(i,k);
+    for( size_t k=0 ; k<3 ; ++k ) {
+      size_t w = topology.cellWall(i,k);
+      restingLength[k] = wallData[w][wallLengthIndex];
+      //Wall end points as element (local) vertex indices
+      for( size_t end=0 ; end<2 ; ++end ) {
+	size_t wv = topology.wallVertex(w,end);
+	wallEnd[k][end] = wv==v[0] ? 0 : ( wv==v[1] ? 1 : 2 );
+      }
+      double distance=0.0;
+      for( size_t d=0 ; d<dimension ; ++d )
+	distance += ( vertexData[topology.wallVertex(w,0)][d]-
+		      vertexData[topology.wallVertex(w,1)][d] ) *
+	  ( vertexData[topology.wallVertex(w,0)][d]-
+	    vertexData[topology.wallVertex(w,1)][d] );
+      length[k] = std::sqrt(distance);
+    }
     
-    vertexDerivs[v2][0]+= Force[1][0];
-    vertexDerivs[v2][1]+= Force[1][1];
-    vertexDerivs[v2][2]+= Force[1][2];
+    for( size_t k=0 ; k<3 ; ++k )
+      E.restingLength[k] = restingLength[k];
+    TRBS::stiffness(lambda,mio,E);
+    const double *tensileStiffness = E.tensileStiffness;
+    const double *angularStiffness = E.angularStiffness;
+    
+    //Calculate biquadratic strains
+    double Delta[3];
+    for( size_t k=0 ; k<3 ; ++k )
+      Delta[k]=length[k]*length[k]-restingLength[k]*restingLength[k];
+    
+    //Edge coefficients c_ab = sum_k K_ab[k]*Delta[k] (symmetric in a,b)
+    double K[3][3][3];
+    for( size_t k=0 ; k<3 ; ++k )
+      K[0][0][k] = K[1][1][k] = K[2][2][k] = 0.0;
+    K[0][1][0]=tensileStiffness[0]; K[0][1][1]=angularStiffness[1]; K[0][1][2]=angularStiffness[0];
+    K[0][2][0]=angularStiffness[0]; K[0][2][1]=angularStiffness[2]; K[0][2][2]=tensileStiffness[2];
+    K[1][2][0]=angularStiffness[1]; K[1][2][1]=tensileStiffness[1]; K[1][2][2]=angularStiffness[2];
+    for( size_t k=0 ; k<3 ; ++k ) {
+      K[1][0][k] = K[0][1][k];
+      K[2][0][k] = K[0][2][k];
+      K[2][1][k] = K[1][2][k];
+    }
+    double c[3][3];
+    for( size_t a=0 ; a<3 ; ++a )
+      for( size_t b=0 ; b<3 ; ++b )
+	c[a][b] = K[a][b][0]*Delta[0]+K[a][b][1]*Delta[1]+K[a][b][2]*Delta[2];
+    
+    //d(Delta_k)/dx_p = 2(x_p-x_q) and d(Delta_k)/dx_q = -2(x_p-x_q)
+    std::vector<double> grad(3*3*dimension,0.0);
+    for( size_t k=0 ; k<3 ; ++k ) {
+      size_t p = wallEnd[k][0], q = wallEnd[k][1];
+      for( size_t d=0 ; d<dimension ; ++d ) {
+	double value = 2.0*(vertexData[v[p]][d]-vertexData[v[q]][d]);
+	grad[(k*3+p)*dimension+d] += value;
+	grad[(k*3+q)*dimension+d] -= value;
+      }
+    }
     
-    vertexDerivs[v3][0]+= Force[2][0];
-    vertexDerivs[v3][1]+= Force[2][1];
-    vertexDerivs[v3][2]+= Force[2][2];
+    // d F_a/d x_e = sum_b (x_b-x_a) (x) dc_ab/dx_e + sum_b c_ab (d_be-d_ae) I
+    std::vector<double> value(dimension*dimension);
+    for( size_t a=0 ; a<3 ; ++a )
+      for( size_t e=0 ; e<3 ; ++e ) {
+	std::fill(value.begin(),value.end(),0.0);
+	for( size_t b=0 ; b<3 ; ++b ) {
+	  if( b==a )
+	    continue;
+	  for( size_t dd=0 ; dd<dimension ; ++dd ) {
+	    double dc = 0.0;
+	    for( size_t k=0 ; k<3 ; ++k )
+	      dc += K[a][b][k]*grad[(k*3+e)*dimension+dd];
+	    for( size_t d=0 ; d<dimension ; ++d )
+	      value[d*dimension+dd] += (vertexData[v[b]][d]-vertexData[v[a]][d])*dc;
+	  }
+	  double diagonal = (b==e ? c[a][b] : 0.0) - (a==e ? c[a][b] : 0.0);
+	  for( size_t d=0 ; d<dimension ; ++d )
+	    value[d*dimension+d] += diagonal;
+	}
+	double *block = J.block(v[a],v[e]);
+	for( size_t l=0 ; l<value.size() ; ++l )
+	  block[l] += value[l];
+      }
   }
+  return 1;
 }
 
 
@@ -219,667 +294,72 @@ VertexFromTRBScenterTriangulation(std::vector<double> &paraValue,
     exit(0);
   }
   if( (indValue.size()!=2 && indValue.size()!=4) || 
-      indValue[0].size()!=1 || indValue[1].size()!=1 ||
-      (indValue.size()==4 && (indValue[2].size()!=0 && indValue[2].size()!=1)) ||
-      (indValue.size()==4 && (indValue[3].size()!=0 && indValue[3].size()!=1)) 
-      ){
-    std::cerr << "VertexFromTRBScenterTriangulation::"
-	      << "VertexFromTRBScenterTriangulation() "
-	      << "Wall length index is given in first level." 
-	      << "Start of additional Cell variable indices (center(x,y,z) "
-	      << "L_1,...,L_n, n=num vertex) is given in second level (typically at end)." 
-              << "Optionally two additional levels can be given where the strain and stress "
-	      << "directions can be stored at given indices. If index given at third level, "
-	      << "strain direction will be stored starting at this (cell) variable index, "
-	      << "and for fourth level stress will be stored."
-	      << std::endl;
-    exit(0);
-  }
-  
-  // Set the variable values
-  setId("VertexFromTRBScenterTriangulation");
-  setParameter(paraValue);  
-  setVariableIndex(indValue);
-  
-  // Set the parameter identities
-  std::vector<std::string> tmp( numParameter() );
-  tmp[0] = "Y_mod";
-  tmp[1] = "P_ratio";
-  setParameterId( tmp );
-}
-
-
-void VertexFromTRBScenterTriangulation::
-derivs(Tissue &T,
-       DataMatrix &cellData,
-       DataMatrix &wallData,
-       DataMatrix &vertexData,
-       DataMatrix &cellDerivs,
-       DataMatrix &wallDerivs,
-       DataMatrix &vertexDerivs ) {
-  
-  //Do the update for each cell
-  size_t dimension = 3;
-  assert (dimension==vertexData[0].size());
-  size_t numCells = T.numCell();
-  size_t wallLengthIndex = variableIndex(0,0);
-  size_t comIndex = variableIndex(1,0);
-  size_t lengthInternalIndex = comIndex+dimension;
-  
-  
-  for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall(); 
-    
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
-      std::cerr << "VertexFromTRBScenterTriangulation::derivs() same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
-		<< std::endl;
-      exit(-1);
-    }
-    
-    double young = parameter(0);
-    double poisson =parameter(1);
-    
-    double StrainCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
-    double StressCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
-    double TotalCellRestingArea=0;
-
-    // One triangle per 'vertex' in cyclic order
-    for (size_t k=0; k<numWalls; ++k) { 
-      size_t kPlusOneMod = (k+1)%numWalls;
-      //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(k)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
-      //size_t w1 = internal k
-      size_t w2 = T.cell(cellIndex).wall(k)->index();
-      //size_t w3 = internal k+1
-
-      // Position matrix holds in rows positions for com, vertex(k), vertex(k+1)
-      DataMatrix position(3,vertexData[v2]);
-      for (size_t d=0; d<dimension; ++d)
-	position[0][d] = cellData[cellIndex][comIndex+d]; // com position
-      //position[1] = vertexData[v2]; // given by initiation
-      position[2] = vertexData[v3];
-      
-      // Resting lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
-      std::vector<double> restingLength(numWalls);
-      restingLength[0] = cellData[cellIndex][lengthInternalIndex + k];
-      restingLength[1] = wallData[w2][wallLengthIndex];
-      restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
-      
-      // Lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
-      std::vector<double> length(numWalls);
-      length[0] = std::sqrt( (position[0][0]-position[1][0])*(position[0][0]-position[1][0]) +
-			     (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
-			     (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) );
-      
-      length[1] = T.wall(w2).lengthFromVertexPosition(vertexData);
-        
-      length[2] = std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
-			     (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
-			     (position[0][2]-position[2][2])*(position[0][2]-position[2][2]) );
-
-            
-      // Lame coefficients (can be defined out of loop)
-      double lambda=young*poisson/(1-poisson*poisson);
-      double mio=young/(1+poisson);
-      
-      // resting Area of the element (using Heron's formula)                                      
-      double restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-                                    (-restingLength[0]+restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]-restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-            
-
-      //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
-      std::vector<double> Angle(3);
-       // can be ommited by cotan(A)=.25*sqrt(4*b*b*c*c/K-1)
-      Angle[0]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]-restingLength[1]*restingLength[1])/
-                           (restingLength[0]*restingLength[2]*2)    );
-      Angle[1]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
-                           (restingLength[0]*restingLength[1]*2)    );
-      Angle[2]=std::acos(  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]-restingLength[0]*restingLength[0])/
-                           (restingLength[1]*restingLength[2]*2)    );
-      
-      //Tensile Stiffness
-      double tensileStiffness[3];
-      double temp = 1.0/(restingArea*16);                                      
-      double cotan[3] = {1.0/std::tan(Angle[0]),1.0/std::tan(Angle[1]),1.0/std::tan(Angle[2])};    
-      tensileStiffness[0]=(2*cotan[2]*cotan[2]*(lambda+mio)+mio)*temp;
-      tensileStiffness[1]=(2*cotan[0]*cotan[0]*(lambda+mio)+mio)*temp;
-      tensileStiffness[2]=(2*cotan[1]*cotan[1]*(lambda+mio)+mio)*temp;
-      
-      //Angular Stiffness
-      double angularStiffness[3];
-      angularStiffness[0]=(2*cotan[1]*cotan[2]*(lambda+mio)-mio)*temp;
-      angularStiffness[1]=(2*cotan[0]*cotan[2]*(lambda+mio)-mio)*temp;
-      angularStiffness[2]=(2*cotan[0]*cotan[1]*(lambda+mio)-mio)*temp;
-      
-      //Calculate biquadratic strains  
-      std::vector<double> Delta(3);
-      Delta[0]=(length[0])*(length[0])-(restingLength[0])*(restingLength[0]);
-      Delta[1]=(length[1])*(length[1])-(restingLength[1])*(restingLength[1]);
-      Delta[2]=(length[2])*(length[2])-(restingLength[2])*(restingLength[2]);
-  
-      //Area of the element (using Heron's formula)                                      
-      double Area=std::sqrt( ( length[0]+length[1]+length[2])*
-                             (-length[0]+length[1]+length[2])*
-                             ( length[0]-length[1]+length[2])*
-                             ( length[0]+length[1]-length[2])  )*0.25;
-        
-
-      //Current shape local coordinate of the element  (counterclockwise ordering of nodes/edges)
-      double CurrentAngle1=std::acos(  (length[0]*length[0]+length[1]*length[1]-length[2]*length[2])/
-                                       (length[0]*length[1]*2)    );
-
-      double Qa=std::cos(CurrentAngle1)*length[0];
-      double Qc=std::sin(CurrentAngle1)*length[0];
-      double Qb=length[1];
-      // shape vector matrix = inverse of coordinate matrix ( only first two elements i.e. ShapeVector[3][2] )      
-      // double ShapeVectorCurrent[3][3]={ {  0   ,       1/Qc      , 0 }, 
-      //                                   {-1/Qb , (Qa-Qb)/(Qb*Qc) , 1 },       
-      //                                   { 1/Qb ,     -Qa/(Qb*Qc) , 0 }  };
-            
-            
-      //Shape vectors in current (clockwise ordering of nodes/edges)
-      // double CurrentAngle2=std::acos(  (length[1]*length[1]+length[2]*length[2]-length[0]*length[0])/
-      //                                  (length[1]*length[2]*2)    );
-
-      // double Qa=std::cos(CurrentAngle2)*length[2];
-      // double Qb=length[1];
-      // double Qc=std::sin(CurrentAngle2)*length[2];
-      
-      // double ShapeVectorCurrent[3][2]={ {  0   ,       1/Qc      }, 
-      //                                   { 1/Qb ,     -Qa/(Qb*Qc) },       
-      //                                   {-1/Qb , (Qa-Qb)/(Qb*Qc) }  };
-
-      // Local coordinates of the resting shape ( counterclockwise )
-      double RestingAngle1=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
-                                       (restingLength[0]*restingLength[1]*2)    );
-
-      double Pa=std::cos(RestingAngle1)*restingLength[0];
-      double Pc=std::sin(RestingAngle1)*restingLength[0];
-      double Pb=restingLength[1];
-
-      // shape vector matrix in resting shape in local coordinate system  = inverse of coordinate matrix ( only first two elements i.e. ShapeVectorResting[3][2] )      
-      double ShapeVectorResting[3][3]={ {  0   ,       1/Pc      , 0 }, 
-                                        {-1/Pb , (Pa-Pb)/(Pb*Pc) , 1 },       
-                                        { 1/Pb ,     -Pa/(Pb*Pc) , 0 }  };
-
-      // Local coordinates of the resting shape (clockwise )
-      //....
-      //....
-
-      //square of radius of circumstancing circle in resting shape
-      //double Rcirc2=(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area)*(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area);  
-      
-
- // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> STRAIN and STRESS TENSOR (BEGIN) <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-      
-      // deformation gradiant tensor F =Sigma i=1,2,3 Qi x Di
-      // strain tensor in resting shape E=0.5(FtF-I)
-      // trE
-      // B=FFt
-      double trE=( Delta[1]*cotan[0]+ Delta[2]*cotan[1]+Delta[0]*cotan[2])/(4*restingArea);
-            
-      double positionLocal[3][2]={ {Qa , Qc}, 
-                                   {0  , 0 },  
-                                   {Qb , 0 }  };
-      
-      double DeformGrad[2][2]={{0,0},{0,0}}; // F= Qi x Di
-      for ( int i=0 ; i<3 ; ++i ) {
-        DeformGrad[0][0]=DeformGrad[0][0]+positionLocal[i][0]*ShapeVectorResting[i][0];
-        DeformGrad[1][0]=DeformGrad[1][0]+positionLocal[i][1]*ShapeVectorResting[i][0];
-        DeformGrad[0][1]=DeformGrad[0][1]+positionLocal[i][0]*ShapeVectorResting[i][1];
-        DeformGrad[1][1]=DeformGrad[1][1]+positionLocal[i][1]*ShapeVectorResting[i][1];
-      } 
-
-      double LeftCauchy[2][2]; // B=FFt
-      LeftCauchy[0][0]=DeformGrad[0][0]*DeformGrad[0][0]+DeformGrad[0][1]*DeformGrad[0][1];
-      LeftCauchy[1][0]=DeformGrad[1][0]*DeformGrad[0][0]+DeformGrad[1][1]*DeformGrad[0][1];
-      LeftCauchy[0][1]=DeformGrad[0][0]*DeformGrad[1][0]+DeformGrad[0][1]*DeformGrad[1][1];
-      LeftCauchy[1][1]=DeformGrad[1][0]*DeformGrad[1][0]+DeformGrad[1][1]*DeformGrad[1][1];
-
-
-      double Egreen[2][2];//E=0.5(C-I)
-      Egreen[0][0]=0.5*(DeformGrad[0][0]*DeformGrad[0][0]+DeformGrad[1][0]*DeformGrad[1][0]-1);
-      Egreen[1][0]=0.5*(DeformGrad[0][1]*DeformGrad[0][0]+DeformGrad[1][1]*DeformGrad[1][0]);
-      Egreen[0][1]=0.5*(DeformGrad[0][0]*DeformGrad[0][1]+DeformGrad[1][0]*DeformGrad[1][1]);
-      Egreen[1][1]=0.5*(DeformGrad[0][1]*DeformGrad[0][1]+DeformGrad[1][1]*DeformGrad[1][1]-1);
-
-      
-      double StrainAlmansi[2][2]; // e=0.5(1-B^-1)  True strain tensor
-      temp=LeftCauchy[0][0]*LeftCauchy[1][1]-LeftCauchy[1][0]*LeftCauchy[0][1]; // det(B)
-      StrainAlmansi[0][0]=0.5*(1-(LeftCauchy[1][1]/temp));
-      StrainAlmansi[1][0]=0.5*LeftCauchy[1][0]/temp;
-      StrainAlmansi[0][1]=0.5*LeftCauchy[0][1]/temp;  
-      StrainAlmansi[1][1]=0.5*(1-(LeftCauchy[0][0]/temp));
-      
-      
-      
-      double B2[2][2];// LeftCauchy^2
-      B2[0][0]=LeftCauchy[0][0]*LeftCauchy[0][0]+LeftCauchy[0][1]*LeftCauchy[1][0];
-      B2[1][0]=LeftCauchy[1][0]*LeftCauchy[0][0]+LeftCauchy[1][1]*LeftCauchy[1][0];
-      B2[0][1]=LeftCauchy[0][0]*LeftCauchy[0][1]+LeftCauchy[0][1]*LeftCauchy[1][1];
-      B2[1][1]=LeftCauchy[1][0]*LeftCauchy[0][1]+LeftCauchy[1][1]*LeftCauchy[1][1];
-
-      double StressTensor[3][3]; // true stress tensor (isotropic term) based on lambdaT and mioT
-      StressTensor[0][0]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[0][0]+(mio/2)*B2[0][0]);
-      StressTensor[1][0]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[1][0]+(mio/2)*B2[1][0]);
-      StressTensor[0][1]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[0][1]+(mio/2)*B2[0][1]);
-      StressTensor[1][1]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[1][1]+(mio/2)*B2[1][1]);
-
-
-      // std::cerr <<"stress tensor " << std::endl;
-      // std::cerr <<" Sxx  "<< StressTensor[0][0] <<" Sxy  "<< StressTensor[0][1] <<" Sxz  "<< StressTensor[0][2] << std::endl
-      //           <<" Syx  "<< StressTensor[1][0] <<" Syy  "<< StressTensor[1][1] <<" Syz  "<< StressTensor[1][2] << std::endl
-      //           <<" Szx  "<< StressTensor[2][0] <<" Szy  "<< StressTensor[2][1] <<" Szz  "<< StressTensor[2][2] << std::endl <<std::endl;
-
-
-      //Shape vectors in Current shape (counterclockwise ordering of nodes/edges)     ShapeVectorCurrent[3][3]  calculated above   
-    
-          
-
-      //square of radius of circumstancing circle in resting shape
-      //double Rcirc2Resting=(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area)*(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area);  
-      
-      double StrainTensor[3][3]; // there are other alternatives than StrainAlmansi for strain tensor
-      StrainTensor[0][0]=StrainAlmansi[0][0];
-      StrainTensor[1][0]=StrainAlmansi[1][0];
-      StrainTensor[0][1]=StrainAlmansi[0][1];
-      StrainTensor[1][1]=StrainAlmansi[1][1];
-
-
-      StrainTensor[0][2]=0;  // adding 3rd dimension which is zero, the tensor is still in element plane
-      StrainTensor[1][2]=0;
-      StrainTensor[2][2]=0;
-      StrainTensor[2][0]=0;
-      StrainTensor[2][1]=0;
-      
-      StressTensor[0][2]=0;  // adding 3rd dimension which is zero, the tensor is still in element plane
-      StressTensor[1][2]=0;
-      StressTensor[2][2]=0;
-      StressTensor[2][0]=0;
-      StressTensor[2][1]=0;
-
-      //rotation matrix for going from local to global coordinate system based on counterclockwise ordering
-      double rotation[3][3];  
-
-      double tempA=std::sqrt((position[2][0]-position[1][0])*(position[2][0]-position[1][0])+
-                             (position[2][1]-position[1][1])*(position[2][1]-position[1][1])+
-                             (position[2][2]-position[1][2])*(position[2][2]-position[1][2])  );
-
-      double tempB=std::sqrt((position[0][0]-position[1][0])*(position[0][0]-position[1][0])+
-                             (position[0][1]-position[1][1])*(position[0][1]-position[1][1])+
-                             (position[0][2]-position[1][2])*(position[0][2]-position[1][2])  );
-
-      double Xcurrent[3];      
-      Xcurrent[0]= (position[2][0]-position[1][0])/tempA;
-      Xcurrent[1]= (position[2][1]-position[1][1])/tempA;
-      Xcurrent[2]= (position[2][2]-position[1][2])/tempA;
-      
-      double Bcurrent[3];      
-      Bcurrent[0]= (position[0][0]-position[1][0])/tempB;
-      Bcurrent[1]= (position[0][1]-position[1][1])/tempB;
-      Bcurrent[2]= (position[0][2]-position[1][2])/tempB;
-
-      double Zcurrent[3];      
-      Zcurrent[0]= Xcurrent[1]*Bcurrent[2]-Xcurrent[2]*Bcurrent[1];
-      Zcurrent[1]= Xcurrent[2]*Bcurrent[0]-Xcurrent[0]*Bcurrent[2];
-      Zcurrent[2]= Xcurrent[0]*Bcurrent[1]-Xcurrent[1]*Bcurrent[0];
-      
-      tempA=std:: sqrt(Zcurrent[0]*Zcurrent[0]+Zcurrent[1]*Zcurrent[1]+Zcurrent[2]*Zcurrent[2]);
-      Zcurrent[0]=Zcurrent[0]/tempA;
-      Zcurrent[1]=Zcurrent[1]/tempA;
-      Zcurrent[2]=Zcurrent[2]/tempA;
-
-      double Ycurrent[3];      
-      Ycurrent[0]= Zcurrent[1]*Xcurrent[2]-Zcurrent[2]*Xcurrent[1];
-      Ycurrent[1]= Zcurrent[2]*Xcurrent[0]-Zcurrent[0]*Xcurrent[2];
-      Ycurrent[2]= Zcurrent[0]*Xcurrent[1]-Zcurrent[1]*Xcurrent[0];
-
-
-      rotation[0][0]=Xcurrent[0];
-      rotation[1][0]=Xcurrent[1];
-      rotation[2][0]=Xcurrent[2];
-
-      rotation[0][1]=Ycurrent[0];
-      rotation[1][1]=Ycurrent[1];
-      rotation[2][1]=Ycurrent[2];
-
-      rotation[0][2]=Zcurrent[0];
-      rotation[1][2]=Zcurrent[1];
-      rotation[2][2]=Zcurrent[2];      
-
-      // rotariong strain tensor to the global coordinate system
-      double tempR[3][3]={{0,0,0},{0,0,0},{0,0,0}};
-      for (int r=0 ; r<3 ; r++) {
-        for (int s=0 ; s<3 ; s++) {
-          for(int w=0 ; w<3 ; w++) {
-            tempR[r][s]=tempR[r][s]+rotation[r][w]*StrainTensor[w][s];
-          }
-        }
-      }
-      for (int r=0 ; r<3 ; r++) {
-        for (int s=0 ; s<3 ; s++) {
-          StrainTensor[r][s]=0;
-          for(int w=0 ; w<3 ; w++) {
-            StrainTensor[r][s]=StrainTensor[r][s]+tempR[r][w]*rotation[s][w];
-          }
-        }
-      }
-
-      // rotating stress tensor to the global coordinate system
-      for (int r=0 ; r<3 ; r++) 
-        for (int s=0 ; s<3 ; s++) 
-          tempR[r][s]=0;
-        
-      for (int r=0 ; r<3 ; r++) 
-        for (int s=0 ; s<3 ; s++) 
-          for(int w=0 ; w<3 ; w++) 
-            tempR[r][s]=tempR[r][s]+rotation[r][w]*StressTensor[w][s];
-          
-      for (int r=0 ; r<3 ; r++) 
-        for (int s=0 ; s<3 ; s++) {
-          StressTensor[r][s]=0;
-          for(int w=0 ; w<3 ; w++) 
-            StressTensor[r][s]=StressTensor[r][s]+tempR[r][w]*rotation[s][w]; 
-        }
-
-
-      // std::cerr <<" Sxx  "<< StrainTensor[0][0] <<" Sxy  "<< StrainTensor[0][1] << std::endl
-      //           <<" Syx  "<< StrainTensor[1][0] <<" Syy  "<< StrainTensor[1][1] << std::endl<<std::endl;
-     
-      for (int r=0 ; r<3 ; r++) {
-        for (int s=0 ; s<3 ; s++) {   
-          StrainCellGlobal[r][s]= StrainCellGlobal[r][s]+restingArea*StrainTensor[r][s];
-        }
-      }
-      
-      for (int r=0 ; r<3 ; r++) 
-        for (int s=0 ; s<3 ; s++)    
-          StressCellGlobal[r][s]= StressCellGlobal[r][s]+restingArea*StressTensor[r][s];
-      
-      TotalCellRestingArea=TotalCellRestingArea+restingArea;
-    
-      // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> STRAIN and STRESS TENSORS (END) <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-      //Forces of vertices
-      double Force[3][3];                                           
-      
-      Force[0][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][0]-position[0][0])
-               	  +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][0]-position[0][0]); 
-      Force[0][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][1]-position[0][1])
-	          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][1]-position[0][1]); 
-      Force[0][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][2]-position[0][2])
-	          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][2]-position[0][2]); 
-      
-      Force[1][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][0]-position[1][0])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][0]-position[1][0]); 
-      Force[1][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][1]-position[1][1])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][1]-position[1][1]); 
-      Force[1][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][2]-position[1][2])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][2]-position[1][2]); 
-      
-      Force[2][0]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][0]-position[2][0])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][0]-position[2][0]); 
-      Force[2][1]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][1]-position[2][1])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][1]-position[2][1]); 
-      Force[2][2]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][2]-position[2][2])
-	          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][2]-position[2][2]); 
-      
-      // adding forces to the total vertexDerivs
-      
-      cellDerivs[cellIndex][comIndex  ] += Force[0][0];
-      cellDerivs[cellIndex][comIndex+1] += Force[0][1];
-      cellDerivs[cellIndex][comIndex+2] += Force[0][2];
-      
-      vertexDerivs[v2][0] += Force[1][0];
-      vertexDerivs[v2][1] += Force[1][1];
-      vertexDerivs[v2][2] += Force[1][2];
-      
-      vertexDerivs[v3][0] += Force[2][0];
-      vertexDerivs[v3][1] += Force[2][1];
-      vertexDerivs[v3][2] += Force[2][2];
-    }
-
-    for (int r=0 ; r<3 ; r++) 
-      for (int s=0 ; s<3 ; s++)    
-        StrainCellGlobal[r][s]= StrainCellGlobal[r][s]/TotalCellRestingArea;
-
-    for (int r=0 ; r<3 ; r++) 
-      for (int s=0 ; s<3 ; s++)    
-        StressCellGlobal[r][s]= StressCellGlobal[r][s]/TotalCellRestingArea; 
-   
-    
-    // eigenvalue/eigenvectors of averaged STRAIN and STRESS tensors in global coordinate system. (Jacobi method)
-
-    // STRAIN:
-
-    double eigenVectorStrain[3][3]={{1,0,0},{0,1,0},{0,0,1}};
-    double pivot=1;
-    double pi=3.1415;
-    int I,J;
-    double RotAngle,Si,Co;
-    while (pivot>0.00001) {
-      pivot=std::fabs(StrainCellGlobal[1][0]);
-      I=1;
-      J=0;
-      if (std::fabs(StrainCellGlobal[2][0])>pivot) {
-        pivot=std::fabs(StrainCellGlobal[2][0]);
-        I=2;
-        J=0;
-      }
-      if (std::fabs(StrainCellGlobal[2][1])>pivot) {
-        pivot=std::fabs(StrainCellGlobal[2][1]);
-        I=2;
-        J=1;
-      }
-      if (std::fabs(StrainCellGlobal[I][I]-StrainCellGlobal[J][J])<0.00001) {
-          RotAngle=pi/4;
-      }            
-      else {
-        RotAngle=0.5*std::atan((2*StrainCellGlobal[I][J])/(StrainCellGlobal[J][J]-StrainCellGlobal[I][I]));
-      }
-        Si=std::sin(RotAngle);
-        Co=std::cos(RotAngle);
-        double tempRot[3][3]={{1,0,0},{0,1,0},{0,0,1}};
-        tempRot[I][I]=Co;
-        tempRot[J][J]=Co;
-        tempRot[I][J]=Si;
-        tempRot[J][I]=-Si;
-        double tempStrain[3][3]={{0,0,0},{0,0,0},{0,0,0}};
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              tempStrain[r][s]=tempStrain[r][s]+StrainCellGlobal[r][w]*tempRot[w][s];
-        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            StrainCellGlobal[r][s]=0;
-         
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              StrainCellGlobal[r][s]=StrainCellGlobal[r][s]+tempRot[w][r]*tempStrain[w][s];
-                
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            tempStrain[r][s]=eigenVectorStrain[r][s];
-        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            eigenVectorStrain[r][s]=0;
-        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              eigenVectorStrain[r][s]=eigenVectorStrain[r][s]+tempStrain[r][w]*tempRot[w][s];
-            
-    }
-       
-      
-      // maximal strain direction
-      double maximalStrainValue=StrainCellGlobal[0][0];
-      int Istrain=0;
-      if (StrainCellGlobal[1][1]>maximalStrainValue) 
-        {
-          maximalStrainValue=StrainCellGlobal[1][1];
-          Istrain=1;
-        }
-      if (StrainCellGlobal[2][2]>maximalStrainValue) 
-        {
-          maximalStrainValue=StrainCellGlobal[2][2];
-          Istrain=2;
-        }
-      // std::cerr<<"maximal Strain direction "<< eigenVectorStrain[0][Istrain] <<" "<< eigenVectorStrain[1][Istrain] <<" "<< eigenVectorStrain[2][Istrain] <<std::endl;  
-      // std::cerr<<"maximal Strain value "<< maximalStrainValue <<std::endl;  
-      
-      // STRESS:
-      
-      double eigenVectorStress[3][3]={{1,0,0},{0,1,0},{0,0,1}};
-      pivot=1;
-      //double RotAngle,Si,Co;
-      while (pivot>0.00001) {
-        pivot=std::fabs(StressCellGlobal[1][0]);
-        I=1;
-        J=0;
-        if (std::fabs(StressCellGlobal[2][0])>pivot) {
-          pivot=std::fabs(StressCellGlobal[2][0]);
-          I=2;
-          J=0;
-          }
-        if (std::fabs(StressCellGlobal[2][1])>pivot) {
-          pivot=std::fabs(StressCellGlobal[2][1]);
-          I=2;
-          J=1;
-        }
-        if (std::fabs(StressCellGlobal[I][I]-StressCellGlobal[J][J])<0.00001) {
-          RotAngle=pi/4;
-        }            
-        else {
-          RotAngle=0.5*std::atan((2*StressCellGlobal[I][J])/(StressCellGlobal[J][J]-StressCellGlobal[I][I]));
-        }
-        Si=std::sin(RotAngle);
-        Co=std::cos(RotAngle);
-        double tempRot[3][3]={{1,0,0},{0,1,0},{0,0,1}};
-        tempRot[I][I]=Co;
-        tempRot[J][J]=Co;
-        tempRot[I][J]=Si;
-        tempRot[J][I]=-Si;
-
-        double tempStress[3][3]={{0,0,0},{0,0,0},{0,0,0}};
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              tempStress[r][s]=tempStress[r][s]+StressCellGlobal[r][w]*tempRot[w][s];
-                        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            StressCellGlobal[r][s]=0;
-          
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              StressCellGlobal[r][s]=StressCellGlobal[r][s]+tempRot[w][r]*tempStress[w][s];
-        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            tempStress[r][s]=eigenVectorStress[r][s];
-          
-	for (size_t ii=0; ii<3; ++ii) {
-	  for (size_t jj=0; jj<3; ++jj) {
-	    eigenVectorStress[ii][jj] = 0.0;
-	  }
-	}
-        
-        for (int r=0 ; r<3 ; r++) 
-          for (int s=0 ; s<3 ; s++) 
-            for(int w=0 ; w<3 ; w++) 
-              eigenVectorStress[r][s]=eigenVectorStress[r][s]+tempStress[r][w]*tempRot[w][s];
-      }
-      
-      
-      // maximal stress direction
-      double maximalStressValue=StressCellGlobal[0][0];
-      int Istress=0;
-      if (StressCellGlobal[1][1]>maximalStressValue) 
-        {
-          maximalStressValue=StressCellGlobal[1][1];
-          Istress=1;
-        }
-      if (StressCellGlobal[2][2]>maximalStressValue) 
-        {
-          maximalStressValue=StressCellGlobal[2][2];
-          Istress=2;
-        }
-      // std::cerr<<"maximal Stress direction "<< eigenVectorStress[0][Istress] <<" "<< eigenVectorStress[1][Istress] <<" "<< eigenVectorStress[2][Istress] <<std::endl;  
-      // std::cerr<<"maximal Stress value "<< maximalStressValue <<std::endl;  
-      
-    
-
-
-      // storing normal dirrection to  strain in cellData  
-     
-      // normal to the cell plane in global direction is Zcurrent[], vector product gives the perpendicular strain direction
-     
-      // double PerpStrain[3];
-      // PerpStrain[0]=NormalCurrent[1]*eigenVectorStrain[2][Istrain]-NormalCurrent[2]*eigenVectorStrain[1][Istrain];
-      // PerpStrain[1]=NormalCurrent[2]*eigenVectorStrain[0][Istrain]-NormalCurrent[0]*eigenVectorStrain[2][Istrain];
-      // PerpStrain[2]=NormalCurrent[0]*eigenVectorStrain[1][Istrain]-NormalCurrent[1]*eigenVectorStrain[0][Istrain];
-      // temp=std::sqrt(PerpStrain[0]*PerpStrain[0]+PerpStrain[1]*PerpStrain[1]+PerpStrain[2]*PerpStrain[2]);     
-
-      // if(std::fabs(temp)>0.001)
-      //   { // if aniso vector is not perpendicular to the cell plane
-      //   if (dimension==2)
-      //     { cellData[cellIndex][0]=PerpStrain[0];        
-      //       cellData[cellIndex][1]=PerpStrain[1];
-      //     }
-      //   if (dimension==3)
-      //     { cellData[cellIndex][0]=PerpStrain[0];
-      //       cellData[cellIndex][1]=PerpStrain[1];
-      //       cellData[cellIndex][2]=PerpStrain[2];
-      //       // cellData[cellIndex][3]=10*maximalStrainValue;  //NOTE maximal Strain and Stress Values can be used this is an option
-      //     }
-      // }
-      
-
-      if (numVariableIndexLevel()==4 && numVariableIndex(2) ) {// storing maximal strain
-        if (dimension==2)
-          {
-            cellData[cellIndex][variableIndex(2,0)]  =eigenVectorStrain[0][Istrain];
-            cellData[cellIndex][variableIndex(2,0)+1]=eigenVectorStrain[1][Istrain];
-            cellData[cellIndex][variableIndex(2,0)+2]=maximalStrainValue;  //maximal Strain Value is stored after its eigenvector
-          }
-        if (dimension==3)
-          {
-            cellData[cellIndex][variableIndex(2,0)]  =eigenVectorStrain[0][Istrain];
-            cellData[cellIndex][variableIndex(2,0)+1]=eigenVectorStrain[1][Istrain];
-            cellData[cellIndex][variableIndex(2,0)+2]=eigenVectorStrain[2][Istrain];
-            cellData[cellIndex][variableIndex(2,0)+3]=maximalStrainValue;  //maximal Strain Value is stored after its eigenvector
-          }
-      }
+      indValue[0].size()!=1 || indValue[1].size()!=1 ||
+      (indValue.size()==4 && (indValue[2].size()!=0 && indValue[2].size()!=1)) ||
+      (indValue.size()==4 && (indValue[3].size()!=0 && indValue[3].size()!=1)) 
+      ){
+    std::cerr << "VertexFromTRBScenterTriangulation::"
+	      << "VertexFromTRBScenterTriangulation() "
+	      << "Wall length index is given in first level." 
+	      << "Start of additional Cell variable indices (center(x,y,z) "
+	      << "L_1,...,L_n, n=num vertex) is given in second level (typically at end)." 
+              << "Optionally two additional levels can be given where the strain and stress "
+	      << "directions can be stored at given indices. If index given at third level, "
+	      << "strain direction will be stored starting at this (cell) variable index, "
+	      << "and for fourth level stress will be stored."
+	      << std::endl;
+    exit(0);
+  }
+  
+  // Set the variable values
+  setId("VertexFromTRBScenterTriangulation");
+  setParameter(paraValue);  
+  setVariableIndex(indValue);
+  
+  // Set the parameter identities
+  std::vector<std::string> tmp( numParameter() );
+  tmp[0] = "Y_mod";
+  tmp[1] = "P_ratio";
+  setParameterId( tmp );
+}
 
 
-      if (numVariableIndexLevel()==4 && numVariableIndex(3) ) { // storing maximal stress
-	if (dimension==2)
-	  {
-	    cellData[cellIndex][variableIndex(3,0)]  =eigenVectorStress[0][Istress];
-	    cellData[cellIndex][variableIndex(3,0)+1]=eigenVectorStress[1][Istress];
-            cellData[cellIndex][variableIndex(3,0)+2]=maximalStressValue;  //maximal Stress Value is stored after its eigenvector
-	  }
-	if (dimension==3)
-	  {
-	    cellData[cellIndex][variableIndex(3,0)]  =eigenVectorStress[0][Istress];
-	    cellData[cellIndex][variableIndex(3,0)+1]=eigenVectorStress[1][Istress];
-	    cellData[cellIndex][variableIndex(3,0)+2]=eigenVectorStress[2][Istress];
-            cellData[cellIndex][variableIndex(3,0)+3]=maximalStressValue;  //maximal Stress Value is stored after its eigenvector
-	  }
-      }
-  }      
+void VertexFromTRBScenterTriangulation::
+derivs(Tissue &T,
+       DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       DataMatrix &cellDerivs,
+       DataMatrix &wallDerivs,
+       DataMatrix &vertexDerivs ) {
+  
+  TRBS::ConstantModulus material(parameter(0),parameter(1));
+  size_t none = static_cast<size_t>(-1);
+  size_t strainIndex = numVariableIndexLevel()==4 && numVariableIndex(2) ?
+    variableIndex(2,0) : none;
+  size_t stressIndex = numVariableIndexLevel()==4 && numVariableIndex(3) ?
+    variableIndex(3,0) : none;
+  if( strainIndex==none && stressIndex==none ) {
+    TRBS::NoOutput output;
+    TRBS::centerTriangulationDerivs(T,cellData,wallData,vertexData,cellDerivs,
+				    vertexDerivs,variableIndex(0,0),
+				    variableIndex(1,0),material,output,id().c_str());
+  }
+  else {
+    TRBS::PrincipalOutput output(strainIndex,stressIndex);
+    TRBS::centerTriangulationDerivs(T,cellData,wallData,vertexData,cellDerivs,
+				    vertexDerivs,variableIndex(0,0),
+				    variableIndex(1,0),material,output,id().c_str());
+  }
 }     
 
+void VertexFromTRBScenterTriangulation::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 
 
@@ -977,149 +457,12 @@ derivs(Tissue &T,
        DataMatrix &wallDerivs,
        DataMatrix &vertexDerivs ) {
   
-  //Do the update for each cell
-  size_t dimension = 3;
-  assert (dimension==vertexData[0].size());
-  size_t numCells = T.numCell();
-  size_t wallLengthIndex = variableIndex(0,0);
-  size_t concIndex = variableIndex(0,1);
-  size_t comIndex = variableIndex(1,0);
-  size_t lengthInternalIndex = comIndex+dimension;
-  double Kpow = std::pow(parameter(3),parameter(4));
-  
-  for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall(); 
-    
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
-      std::cerr << "VertexFromTRBScenterTriangulationConcentrationHill::derivs() "
-		<< "same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
-		<< std::endl;
-      exit(-1);
-    }
-    
-    double young = parameter(0) + 
-      parameter(1)*Kpow/( Kpow+std::pow(cellData[cellIndex][concIndex],parameter(4)) );
-    double poisson =parameter(1);
-    
-    // One triangle per 'vertex' in cyclic order
-    for (size_t k=0; k<numWalls; ++k) { 
-      size_t kPlusOneMod = (k+1)%numWalls;
-      //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(k)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
-      //size_t w1 = internal k
-      size_t w2 = T.cell(cellIndex).wall(k)->index();
-      //size_t w3 = internal k+1
-      
-      // Position matrix holds in rows positions for com, vertex(k), vertex(k+1)
-      DataMatrix position(3,vertexData[v2]);
-      for (size_t d=0; d<dimension; ++d)
-	position[0][d] = cellData[cellIndex][comIndex+d]; // com position
-      //position[1] = vertexData[v2]; // given by initiation
-      position[2] = vertexData[v3];
-      
-      // Resting lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
-      std::vector<double> restingLength(numWalls);
-      restingLength[0] = cellData[cellIndex][lengthInternalIndex + k];
-      restingLength[1] = wallData[w2][wallLengthIndex];
-      restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
-      
-      // Lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
-      std::vector<double> length(numWalls);
-      length[0] = std::sqrt( (position[0][0]-position[1][0])*
-			     (position[0][0]-position[1][0]) +
-			     (position[0][1]-position[1][1])*
-			     (position[0][1]-position[1][1]) +
-			     (position[0][2]-position[1][2])*
-			     (position[0][2]-position[1][2]) );
-      length[1] = T.wall(w2).lengthFromVertexPosition(vertexData);
-      length[2] = std::sqrt( (position[0][0]-position[2][0])*
-			     (position[0][0]-position[2][0]) +
-			     (position[0][1]-position[2][1])*
-			     (position[0][1]-position[2][1]) +
-			     (position[0][2]-position[2][2])*
-			     (position[0][2]-position[2][2]) );
-      
-      // Lame coefficients (can be defined out of loop)
-      double lambda=young*poisson/(1-poisson*poisson);
-      double mio=young/(1+poisson);
-      
-      // Area of the element (using Heron's formula)                                      
-      double Area=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-			     (-restingLength[0]+restingLength[1]+restingLength[2])*
-			     ( restingLength[0]-restingLength[1]+restingLength[2])*
-			     ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-      
-      //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
-      std::vector<double> Angle(3);
-      // can be ommited by cotan(A)=.25*sqrt(4*b*b*c*c/K-1)
-      Angle[0]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]-restingLength[1]*restingLength[1])/
-                           (restingLength[0]*restingLength[2]*2)    );
-      Angle[1]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
-                           (restingLength[0]*restingLength[1]*2)    );
-      Angle[2]=std::acos(  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]-restingLength[0]*restingLength[0])/
-                           (restingLength[1]*restingLength[2]*2)    );
-      
-      //Tensile Stiffness
-      double tensileStiffness[3];
-      double const temp = 1.0/(Area*16);                                      
-      double cotan[3] = {1.0/std::tan(Angle[0]),1.0/std::tan(Angle[1]),1.0/std::tan(Angle[2])};    
-      tensileStiffness[0]=(2*cotan[2]*cotan[2]*(lambda+mio)+mio)*temp;
-      tensileStiffness[1]=(2*cotan[0]*cotan[0]*(lambda+mio)+mio)*temp;
-      tensileStiffness[2]=(2*cotan[1]*cotan[1]*(lambda+mio)+mio)*temp;
-      
-      //Angular Stiffness
-      double angularStiffness[3];
-      angularStiffness[0]=(2*cotan[1]*cotan[2]*(lambda+mio)-mio)*temp;
-      angularStiffness[1]=(2*cotan[0]*cotan[2]*(lambda+mio)-mio)*temp;
-      angularStiffness[2]=(2*cotan[0]*cotan[1]*(lambda+mio)-mio)*temp;
-      
-      //Calculate biquadratic strains  
-      std::vector<double> Delta(3);
-      Delta[0]=(length[0])*(length[0])-(restingLength[0])*(restingLength[0]);
-      Delta[1]=(length[1])*(length[1])-(restingLength[1])*(restingLength[1]);
-      Delta[2]=(length[2])*(length[2])-(restingLength[2])*(restingLength[2]);
-      //Forces of vertices
-      double Force[3][3];                                           
-      
-      Force[0][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][0]-position[0][0])
-	+(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][0]-position[0][0]); 
-      Force[0][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][1]-position[0][1])
-	+(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][1]-position[0][1]); 
-      Force[0][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][2]-position[0][2])
-	+(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][2]-position[0][2]); 
-      
-      Force[1][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][0]-position[1][0])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][0]-position[1][0]); 
-      Force[1][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][1]-position[1][1])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][1]-position[1][1]); 
-      Force[1][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][2]-position[1][2])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][2]-position[1][2]); 
-      
-      Force[2][0]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][0]-position[2][0])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][0]-position[2][0]); 
-      Force[2][1]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][1]-position[2][1])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][1]-position[2][1]); 
-      Force[2][2]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][2]-position[2][2])
-	+(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][2]-position[2][2]); 
-      
-      // adding forces to the total vertexDerivs
-      
-      cellDerivs[cellIndex][comIndex]+= Force[0][0];
-      cellDerivs[cellIndex][comIndex+1]+= Force[0][1];
-      cellDerivs[cellIndex][comIndex+2]+= Force[0][2];
-      
-      vertexDerivs[v2][0]+= Force[1][0];
-      vertexDerivs[v2][1]+= Force[1][1];
-      vertexDerivs[v2][2]+= Force[1][2];
-      
-      vertexDerivs[v3][0]+= Force[2][0];
-      vertexDerivs[v3][1]+= Force[2][1];
-      vertexDerivs[v3][2]+= Force[2][2];
-    }
-  }
+  TRBS::HillModulus material(parameter(0),parameter(1),parameter(2),
+			     parameter(3),parameter(4),variableIndex(0,1));
+  TRBS::NoOutput output;
+  TRBS::centerTriangulationDerivs(T,cellData,wallData,vertexData,cellDerivs,
+				  vertexDerivs,variableIndex(0,0),
+				  variableIndex(1,0),material,output,id().c_str());
 }
 
 void VertexFromTRBScenterTriangulationConcentrationHill::
@@ -1312,10 +655,12 @@ derivs(Tissue &T,
  
 
 
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for( size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex ) {
-    if( T.cell(cellIndex).numWall() != numWalls ) {
+    if( topology.numCellWall(cellIndex) != numWalls ) {
       std::cerr << "VertexFromTRBSMT::derivs() only defined for triangular cells."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls!"
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls!"
 		<< std::endl;
       exit(-1);
     }
@@ -1327,12 +672,12 @@ derivs(Tissue &T,
     double TETA= parameter(8); 
 
 
-    size_t v1 = T.cell(cellIndex).vertex(0)->index();
-    size_t v2 = T.cell(cellIndex).vertex(1)->index();
-    size_t v3 = T.cell(cellIndex).vertex(2)->index();
-    size_t w1 = T.cell(cellIndex).wall(0)->index();
-    size_t w2 = T.cell(cellIndex).wall(1)->index();
-    size_t w3 = T.cell(cellIndex).wall(2)->index();
+    size_t v1 = topology.cellVertex(cellIndex,0);
+    size_t v2 = topology.cellVertex(cellIndex,1);
+    size_t v3 = topology.cellVertex(cellIndex,2);
+    size_t w1 = topology.cellWall(cellIndex,0);
+    size_t w2 = topology.cellWall(cellIndex,1);
+    size_t w3 = topology.cellWall(cellIndex,2);
 
 
 
@@ -1421,9 +766,9 @@ derivs(Tissue &T,
     //position[0][2] z for vertex 1 (of the cell)
    
     std::vector<double> length(numWalls);
-    length[0] = T.wall(w1).lengthFromVertexPosition(vertexData);
-    length[1] = T.wall(w2).lengthFromVertexPosition(vertexData);
-    length[2] = T.wall(w3).lengthFromVertexPosition(vertexData);
+    length[0] = topology.wallLength(w1,vertexData);
+    length[1] = topology.wallLength(w2,vertexData);
+    length[2] = topology.wallLength(w3,vertexData);
     
     //Anisotropic Correction is based on difference between Lam Coefficients of Longitudinal and Transverse dirrections:
     double deltaLam=lambdaL-lambdaT;
@@ -2296,12 +1641,11 @@ derivs(Tissue &T,
     totalEnergyIso +=cellData[cellIndex][variableIndex(0,5)];
     totalEnergyAniso +=cellData[cellIndex][variableIndex(0,6)];
 
-    Cell *  cell1=&(T.cell(cellIndex));
 	
     std::vector<size_t>  neighbor(3);  
-    neighbor[0]=(cell1->cellNeighbor(0))->index();
-    neighbor[1]=(cell1->cellNeighbor(1))->index();
-    neighbor[2]=(cell1->cellNeighbor(2))->index();
+    neighbor[0]=topology.cellWallNeighbor(cellIndex,0);
+    neighbor[1]=topology.cellWallNeighbor(cellIndex,1);
+    neighbor[2]=topology.cellWallNeighbor(cellIndex,2);
 
     double neighborweight=parameter(5);
 
@@ -2507,6 +1851,14 @@ derivs(Tissue &T,
     cellData[0][variableIndex(0,6)]=totalEnergyAniso ;
 
 }
+
+void VertexFromTRBSMT::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
  
     
 
@@ -2531,7 +1883,7 @@ VertexFromTRBScenterTriangulationMT(std::vector<double> &paraValue,
               << "                    1:for MT direction from 7th parameter TETA, 2:force to Stress,  "
               << "                    3: force to Strain ,4:force to perp-strain "
 	      << "10 : 1:independent resting length for the elements, otherwise: common length "
-              <<" also see line 2835 where an ad-hoc thing is implemented for parameter(9)==1 "
+              <<" for parameter(9)==1 cells 1 and 3 get the MT angle parameter(10) unless it is 100 "
               << std::endl;
     
     exit(0);
@@ -2622,10 +1974,74 @@ VertexFromTRBScenterTriangulationMT(std::vector<double> &paraValue,
               << " 4: force to perp-strain " << std::endl;
     exit(0);
   }
+
+  // Instantiations of derivs() and update() for the MT direction, resting
+  // lengths and fiber model
+  if( parameter(9)==1 ) { // MT direction from TETA
+    if( parameter(10)==1 )
+      selectFiber<TRBS::AngleDirection,TRBS::DoubleRestingLength>();
+    else
+      selectFiber<TRBS::AngleDirection,TRBS::SingleRestingLength>();
+  }
+  else {
+    if( parameter(10)==1 )
+      selectFiber<TRBS::CellDirection,TRBS::DoubleRestingLength>();
+    else
+      selectFiber<TRBS::CellDirection,TRBS::SingleRestingLength>();
+  }
+}
+
+template<class Direction,class RestingLength>
+void VertexFromTRBScenterTriangulationMT::
+selectFiber()
+{
+  typedef VertexFromTRBScenterTriangulationMT MT;
+  if( parameter(4)==0 ) { // constant anisotropic material
+    derivs_ = &MT::derivsPolicy<TRBS::MarkedConstantFiber,Direction,RestingLength>;
+    update_ = &MT::updatePolicy<TRBS::ConstantFiber,Direction,RestingLength>;
+  }
+  else if( parameter(4)==1 ) // material anisotropy via FiberModel
+    selectPolicy<TRBS::ModelFiber,Direction,RestingLength>();
+  else if( parameter(4)==2 ) // constant overall stiffness for energy landscape
+    selectPolicy<TRBS::TotalStiffnessFiber,Direction,RestingLength>();
+  else if( parameter(4)==3 ) // constant overall stiffness for energy landscape
+    selectPolicy<TRBS::AnisotropyFiber,Direction,RestingLength>();
+  else if( parameter(4)==5 ) // pavement cell resolution addaptive stiffness
+    selectPolicy<TRBS::AdaptiveFiber,Direction,RestingLength>();
+  else if( parameter(4)==6 ) // FiberModel and loosening adhoc based on auxin
+    selectPolicy<TRBS::AuxinLooseningFiber,Direction,RestingLength>();
+  else if( parameter(4)==7 ) // FiberModel and destroying fibers based on auxin
+    selectPolicy<TRBS::AuxinFiberRemoval,Direction,RestingLength>();
+  else if( parameter(4)==8 ) // and a fraction of matrix based on auxin
+    selectPolicy<TRBS::AuxinMatrixRemoval,Direction,RestingLength>();
+  else
+    selectPolicy<TRBS::UnitFiber,Direction,RestingLength>();
+}
+
+template<class Fiber,class Direction,class RestingLength>
+void VertexFromTRBScenterTriangulationMT::
+selectPolicy()
+{
+  typedef VertexFromTRBScenterTriangulationMT MT;
+  derivs_ = &MT::derivsPolicy<Fiber,Direction,RestingLength>;
+  update_ = &MT::updatePolicy<Fiber,Direction,RestingLength>;
 }
 
 void VertexFromTRBScenterTriangulationMT::
 derivs(Tissue &T,
+       DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       DataMatrix &cellDerivs,
+       DataMatrix &wallDerivs,
+       DataMatrix &vertexDerivs )
+{
+  (this->*derivs_)(T,cellData,wallData,vertexData,cellDerivs,wallDerivs,vertexDerivs);
+}
+
+template<class Fiber,class Direction,class RestingLength>
+void VertexFromTRBScenterTriangulationMT::
+derivsPolicy(Tissue &T,
        DataMatrix &cellData,
        DataMatrix &wallData,
        DataMatrix &vertexData,
@@ -2664,15 +2080,18 @@ derivs(Tissue &T,
   //HJ: removed due to unused variable warning
   //size_t MTindex           =variableIndex(0,1);	 
   //size_t isoEnergyIndex    =variableIndex(0,5);	
-  size_t anisoEnergyIndex  =variableIndex(0,6);	
-  size_t youngLIndex       =variableIndex(0,7);	
    
 
-  double youngMatrix= parameter(0);    
-  double youngFiber = parameter(1); 
   double poissonL   = parameter(2);    
   double poissonT   = parameter(3);
   double TETA       = parameter(8);  
+  bool planeStrain  = parameter(7)==0;
+  Fiber fiber(parameter(0),parameter(1),variableIndex(0,7),variableIndex(0,6));
+  // cells 1 and 3 have the MT angle parameter(10) unless it is 100
+  Direction direction(TETA,parameter(10)!=100 ? parameter(10) : TETA,
+                      variableIndex(0,1));
+  RestingLength restingLengths(lengthInternalIndex,wallLengthIndex);
+  TRBS::Element E;
   
   // static double tTotal=0, tDiag=0;
   // static double tRest=0, tRest2=0, tRest3=0, tRest4=0;
@@ -2680,16 +2099,18 @@ derivs(Tissue &T,
   // clock_t cpuTime0 ,cpuTimef, cpuTime1 ,cpuTime2, cpuTime3 ,cpuTime4;
   // cpuTime0=clock();
 
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall();
+    size_t numWalls = topology.numCellWall(cellIndex);
     
   
 
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
+    if(  topology.numCellVertex(cellIndex)!= numWalls ) {
      
       std::cerr << "VertexFromTRBScenterTriangulationMT::derivs() same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls and "
+		<< topology.numCellVertex(cellIndex) << " vertices!"	
 		<< std::endl;
       exit(-1);
     }
@@ -2707,243 +2128,8 @@ derivs(Tissue &T,
 
    
 
-    double youngL=1;
-    double youngT=1;
-    
-
-
-    if( parameter(4)==1){  // material anisotropy via FiberModel
-      youngL = cellData[cellIndex][youngLIndex]; 
-      youngT = 2*youngMatrix+youngFiber-youngL; 
-    }
-    else {
-      if( parameter(4)==0 ){ // constant anisotropic material
-
-        youngL = youngMatrix+youngFiber;
-        youngT = youngMatrix; 
-        
-        if(cellData[cellIndex][40]==100){
-        youngL = youngMatrix+youngFiber/2;
-        youngT = youngMatrix+youngFiber/2;
-        
-        }
-        // youngL *=0.4+1.1*cellData[cellIndex][11];
-        // youngT *=0.4+1.1*cellData[cellIndex][11];
-
-        
-
-        // // hypocotyl Siobhan
-        // if(cellData[cellIndex][37]==-1){ // epidermis
-        //   youngL *=1.3;
-        //   youngT *=1.3;
-          
-        // }
-        // if(cellData[cellIndex][37]==-2){ // inner
-        //   youngL *=1;
-        //   youngT *=1;
-        //   //youngL *=1;
-        //   //youngT *=1;
-          
-        // }
-        // if(cellData[cellIndex][37]==-3){  // anti. axial
-          
-        //   youngL *=0.5; //1, 0.5
-        //   youngT *=0.5; //1, 0.5
-          
-          
-        // }
-        // //if(cellData[cellIndex][37]==-4 && cellData[cellIndex][38]==0){  // anti transverse
-        // if(cellData[cellIndex][37]==-4){  // anti transverse
-        //   youngL *=1; //2, 1
-        //   youngT *=1; //2, 1
-         
-        // }
-
-        // hypocotyl Siobhan   Old
-        // if(cellData[cellIndex][37]==-1){ // epidermis
-        //   youngL *=0.1;
-        //   youngT *=0.1;
-          
-        // }
-        // if(cellData[cellIndex][37]==-2){ // inner
-        //   youngL *=0.1;
-        //   youngT *=0.1;
-        
-        // }
-        // if(cellData[cellIndex][37]==-3){  // anti. axial
-        //   youngL *=0.1;
-        //   youngT *=0.1;
-          
-        // }
-        // if(cellData[cellIndex][37]==-4){  // anti transverse
-        //   youngL *=0.1;
-        //   youngT *=0.1;
-        
-        // }
-        // if(timeC>40){
-        //   // hypocotyl Siobhan
-        //   if(cellData[cellIndex][37]==-1){ // epidermis
-        //     youngL *=3;
-        //     youngT *=3;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-2){ // inner
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-3){  // anti. axial
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-4){  // anti transverse
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        // }
-        
-
-
-      }
-      
-      if( parameter(4)==2){  // for varrying material anisotropy with constant overall stiffness for energy landscape
-        youngL =youngFiber; 
-        youngT =youngMatrix-youngL;  // here youngMatrix is total stiffness
-      }
-      if( parameter(4)==3){  // for varrying material anisotropy with constant overall stiffness for energy landscape       
-        double totalElast=youngMatrix;
-        double Maniso=youngFiber;
-        youngT =((1-Maniso)/(2-Maniso))*totalElast; 
-        youngL=totalElast-youngT;
-       
-        //youngL =youngMatrix+youngFiber; 
-        // youngT =youngMatrix+std::sqrt(
-        //                               ((youngFiber-totalElast)*4*totalElast)
-        //                               /
-        //                               ((2-3.1415)*3.1415)
-        //                               );  // here youngMatrix is total stiffness
-        //youngT =youngMatrix+totalElast*std::sqrt(
-        //                                         -(std::log((youngFiber/totalElast)-0.55))
-        //                                         /6
-        //                                         );
-        //youngT =youngMatrix+2*(totalElast-youngFiber)/(3.1415-2);
-        
-        // youngL=youngMatrix+youngFiber; 
-        // youngT =youngMatrix+(youngFiber-slope*totalElast)/(1-2*slope); 
-      }
-
-      // if( parameter(4)==5){  // for domain dependent material properties - Hypocotyl bending 3d (internal tissue softer)    
-      //   if (cellData[cellIndex][38]==-1){
-      //     youngL =youngMatrix+youngFiber; 
-      //     youngT =youngMatrix;  
-          
-      //   }
-      //   else{
-      //     youngL =0.2*(youngMatrix+youngFiber); 
-      //     youngT =0.2*youngMatrix;  
-      //   }
-
-      //   if (cellData[cellIndex][5]==5){
-      //     youngL =0.01*(youngMatrix+youngFiber); 
-      //     youngT =0.01*youngMatrix;  
-      //   }
-      // }
-
-      if( parameter(4)==5){// for pavement cell resolution addaptive stiffness
-        youngFiber=cellData[cellIndex][anisoEnergyIndex];
-        double fiberL=cellData[cellIndex][youngLIndex];
-        youngL = youngMatrix+fiberL;
-        youngT = youngMatrix+youngFiber-fiberL;
-       
-        // if(cellData[cellIndex][30]==1){
-        //   youngL = 20;
-        //   youngT = 20;
-        
-        // }
-      }
-      
-      if( parameter(4)==6){  // material anisotropy via FiberModel and loosening adhoc based on auxin
-        youngL = cellData[cellIndex][youngLIndex]; 
-        youngT = 2*youngMatrix+youngFiber-youngL; 
-        
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=0.25+0.75*frac;
-        youngT*=0.25+0.75*frac;
-        //if(cellIndex==0) std::cerr<<cellData[cellIndex][13]<<"  "<<youngL<<"  " <<youngT<<std::endl;
-      }
-      
-       if( parameter(4)==7){  // material anisotropy via FiberModel and destroying fibers based on auxin
-         youngL = cellData[cellIndex][youngLIndex]-youngMatrix;
-         youngT = 2*youngMatrix+youngFiber-youngL-2*youngMatrix;  
-         
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=frac;
-        youngT*=frac;
-        youngL+=youngMatrix;
-        youngT+=youngMatrix;
-        //cellData[cellIndex][youngLIndex]=youngL; 
-     
-      }
-       if( parameter(4)==8){  // material anisotropy via FiberModel and destroying fibers and a fraction of matrix based on auxin
-         youngL = cellData[cellIndex][youngLIndex]-youngMatrix;
-         youngT = 2*youngMatrix+youngFiber-youngL-2*youngMatrix;  
-         
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=frac;
-        youngT*=frac;
-        youngL+=youngMatrix*(0.2+0.8*frac);
-        youngT+=youngMatrix*(0.2+0.8*frac);
-        //cellData[cellIndex][youngLIndex]=youngL; 
-     
-      }
-
-
-                     
-      // If( parameter(4)<0){  // for heterogeneous stiffness(adhoc)
-      //   double hFactor=0;
-      //   double Hthreshold=0.01;
-      //   if (std::fabs(cellData[cellIndex][youngLIndex])>Hthreshold){
-      //     hFactor=Hthreshold;
-      //   }
-      //   else{
-      //     hFactor=std::fabs(cellData[cellIndex][youngLIndex]); // take the heterogeneous info from this index
-      //   }
-      //   hFactor *=std::fabs(parameter(4)); // factor for heterogeneity      
-      
-      //   youngL = youngMatrix+youngFiber-hFactor*(youngMatrix+youngFiber); 
-      //   youngT = youngMatrix-hFactor*(youngMatrix); 
-      // }
-      
-      // if (cellData[cellIndex][31]==10){
-      //   youngL = 150;
-      //   youngT = 10;
-      // }
-     
-      
-      // if( parameter(4)<0){  // for spatial elasticity (ad-hoc)
-      //   double x0=90;
-      //   double y0=120;
-        
-      //   double xx=cellData[cellIndex][comIndex]-x0;
-      //   double yy=cellData[cellIndex][comIndex+1]-y0;
-        
-      //   youngL = youngMatrix+youngFiber*(1-std::exp(parameter(4)*(xx*xx+yy*yy)));
-      //   youngT = youngMatrix; 
-      //   cellData[cellIndex][13]=youngL;
-      // }
-      
-    }
+    double youngL, youngT;
+    fiber.modulus(cellData,cellIndex,youngL,youngT);
 
 
     // ad-hoc for 3d marcus
@@ -3023,27 +2209,11 @@ derivs(Tissue &T,
     
     // }
       
-    double lambdaL, mioL, lambdaT, mioT; // ,lambdaTmatrix, mioTmatrix;
-    
-    if (parameter(7)==0){      
-      // Lame coefficients based on plane strain (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/((1+poissonL)*(1-2*poissonL));
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/((1+poissonT)*(1-2*poissonT));
-      mioT=youngT/(2*(1+poissonT));
-
-   
-    } 
-    else{      
-      // Lame coefficients based on plane stress (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/(1-poissonL*poissonL);
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/(1-poissonT*poissonT);
-      mioT=youngT/(2*(1+poissonT));
-     
-      // lambdaTmatrix=youngMatrixA*poissonT/(1-poissonT*poissonT);
-      // mioTmatrix=youngMatrixA/(2*(1+poissonT));
-    }
+    // Lame coefficients based on plane strain or plane
+    // stress (for 3D 0<poisson<0.5)
+    double lambdaL, mioL, lambdaT, mioT;
+    TRBS::shearLame(youngL,poissonL,planeStrain,lambdaL,mioL);
+    TRBS::shearLame(youngT,poissonT,planeStrain,lambdaT,mioT);
     
     // Lame coefficients based on delin. paper (for 2D 0<poisson<1)
     // double lambdaL=youngL*poissonL/(1-poissonL*poissonL);
@@ -3065,26 +2235,7 @@ derivs(Tissue &T,
     double EnergyAniso=0;
     double strainZ=0;
 
-    if ( parameter(9)==1 ) {  // aniso direction from TETA 
-      
-      cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-      cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-      cellData[cellIndex][variableIndex(0,1)+2]=0;
-      if(parameter(10)!=100){
-	if(cellIndex==0 || cellIndex==2 ){
-	  cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-	  cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-	  cellData[cellIndex][variableIndex(0,1)+2]=0;
-	}
-	if(cellIndex==1 || cellIndex==3 ){
-	  cellData[cellIndex][variableIndex(0,1)]=std::cos(parameter(10));    
-	  cellData[cellIndex][variableIndex(0,1)+1]=std::sin(parameter(10));
-	  cellData[cellIndex][variableIndex(0,1)+2]=0;
-	}
-      }
-    }
-    
-  
+    direction.set(cellData,cellIndex);
 
     // Aniso vector in current shape in global coordinate system
     double  AnisoCurrGlob[3]=
@@ -3100,10 +2251,10 @@ derivs(Tissue &T,
         
       size_t kPlusOneMod = (wallindex+1)%numWalls;
       //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(wallindex)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
+      size_t v2 = topology.cellVertex(cellIndex,wallindex);
+      size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
       //size_t w1 = internal wallindex
-      size_t w2 = T.cell(cellIndex).wall(wallindex)->index();
+      size_t w2 = topology.cellWall(cellIndex,wallindex);
       //size_t w3 = internal wallindex+1
 
       // Position matrix holds in rows positions for com, vertex(wallindex), vertex(wallindex+1)
@@ -3127,19 +2278,9 @@ derivs(Tissue &T,
       //   exit(-1);
       // }
 
-      double restingLength[3];
-      if(parameter(10)==1) { // double resting length  
-        restingLength[0] =cellData[cellIndex][lengthInternalIndex + 2*wallindex+1];
-        //restingLength[1] = wallData[w2][wallLengthIndex]+wallData[w2][wallLengthIndex+restAddIndex];
-        restingLength[1] =wallData[w2][wallLengthIndex]+
-          cellData[cellIndex][lengthInternalIndex+2*numWalls+wallindex];
-        restingLength[2] =cellData[cellIndex][lengthInternalIndex + 2*kPlusOneMod];
-      }      
-      else{                 // single resting length
-        restingLength[0] = cellData[cellIndex][lengthInternalIndex + wallindex];
-        restingLength[1] = wallData[w2][wallLengthIndex];
-        restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
-      }
+      double *restingLength = E.restingLength;
+      restingLengths.set(cellData,wallData,cellIndex,numWalls,wallindex,w2,
+                         restingLength);
       
       // Lengths are from com-vertex(wallindex), vertex(wallindex)-vertex(wallindex+1) (wall(wallindex)), com-vertex(wallindex+1)
       double length[3]=
@@ -3147,89 +2288,20 @@ derivs(Tissue &T,
                      (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
                      (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) ),
           
-          T.wall(w2).lengthFromVertexPosition(vertexData),
+          topology.wallLength(w2,vertexData),
           
           std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
-                     (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
-                     (position[0][2]-position[2][2])*(position[0][2]-position[2][2]) )
-        };
-      
-      
-      // Area of the element (using Heron's formula)                                      
-      double restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-                                    (-restingLength[0]+restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]-restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-      
-      //double currentArea=std::sqrt( ( length[0]+length[1]+length[2])*
-      //                              (-length[0]+length[1]+length[2])*
-      //                              ( length[0]-length[1]+length[2])*
-      //                              ( length[0]+length[1]-length[2])  )*0.25;
-
-      //cpuTime3=clock();
-     
-      
-      //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
-      //std::vector<double> Angle(3);
-      // can be changed by cotan(A)=.25*sqrt(4*b*b*c*c/K-1)
-      // Angle[0]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]
-      //                       -restingLength[1]*restingLength[1])/
-      //                      (restingLength[0]*restingLength[2]*2)    );
-      // Angle[1]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]
-      //                       -restingLength[2]*restingLength[2])/
-      //                      (restingLength[0]*restingLength[1]*2)    );
-      // Angle[2]=std::acos(  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]
-      //                       -restingLength[0]*restingLength[0])/
-      //                      (restingLength[1]*restingLength[2]*2)    );
-      
-      // //Tensile Stiffness
-      // std::vector<double>  tensileStiffness(3);
-      // //double tensileStiffness[3];
-      // double temp = 1.0/(restingArea*16);                                      
-      // std::vector<double> cotan(3);
-      // cotan[0] = 1.0/std::tan(Angle[0]);
-      // cotan[1] = 1.0/std::tan(Angle[1]);
-      // cotan[2] = 1.0/std::tan(Angle[2]);
-
-
-      double cosAngle[3]=
-        { (  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]
-              -restingLength[1]*restingLength[1])/
-             (restingLength[0]*restingLength[2]*2)    ),
-
-          (  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]
-              -restingLength[2]*restingLength[2])/
-             (restingLength[0]*restingLength[1]*2)    ),
-
-          (  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]
-              -restingLength[0]*restingLength[0])/
-             (restingLength[1]*restingLength[2]*2)    )
-        };
-      
-      double temp = 1.0/(restingArea*16);                                      
-      double cotan[3]=
-        { cosAngle[0]/std::sqrt(1-cosAngle[0]*cosAngle[0]),
-          cosAngle[1]/std::sqrt(1-cosAngle[1]*cosAngle[1]),
-          cosAngle[2]/std::sqrt(1-cosAngle[2]*cosAngle[2])
+                     (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
+                     (position[0][2]-position[2][2])*(position[0][2]-position[2][2]) )
         };
       
       
       //the force is calculated based on Transverse coefficients
       //Longitudinal coefficients are considered in deltaF
-      //Tensile Stiffness
-      
-      double tensileStiffness[3]=
-        { (2*cotan[2]*cotan[2]*(lambdaT+2*mioT)+2*mioT)*temp,
-          (2*cotan[0]*cotan[0]*(lambdaT+2*mioT)+2*mioT)*temp,
-          (2*cotan[1]*cotan[1]*(lambdaT+2*mioT)+2*mioT)*temp
-        };
-      
-      //Angular Stiffness
-      double angularStiffness[3]=
-        { (2*cotan[1]*cotan[2]*(lambdaT+2*mioT)-2*mioT)*temp,
-          (2*cotan[0]*cotan[2]*(lambdaT+2*mioT)-2*mioT)*temp,
-          (2*cotan[0]*cotan[1]*(lambdaT+2*mioT)-2*mioT)*temp
-        };
+      TRBS::cosineStiffness(lambdaT,2*mioT,E);
+      double restingArea = E.restingArea;
+      const double *cosAngle = E.cosAngle;
+      double temp;
       
       //Calculate biquadratic strains  
       double Delta[3]=
@@ -3671,70 +2743,10 @@ derivs(Tissue &T,
       // deltaFTPK[0][2]= rotation[2][0]*deltaFTPKlocal[0][0]+rotation[2][1]*deltaFTPKlocal[0][1];
       //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-      double TPK[2][2];// 2nd Piola Kirchhoff stress tensor 
-      TPK[0][0]=restingArea*(DeformGrad[0][0]*deltaS[0][0]+DeformGrad[0][1]*deltaS[1][0]);
-      TPK[1][0]=restingArea*(DeformGrad[1][0]*deltaS[0][0]+DeformGrad[1][1]*deltaS[1][0]);
-      TPK[0][1]=restingArea*(DeformGrad[0][0]*deltaS[0][1]+DeformGrad[0][1]*deltaS[1][1]);
-      TPK[1][1]=restingArea*(DeformGrad[1][0]*deltaS[0][1]+DeformGrad[1][1]*deltaS[1][1]);
-
-      //deltaFTPKlocal[i][0]= TPK[0][0]*ShapeVectorResting[i][0]+TPK[0][1]*ShapeVectorResting[i][1];
-      //deltaFTPKlocal[i][1]= TPK[1][0]*ShapeVectorResting[i][0]+TPK[1][1]*ShapeVectorResting[i][1];
-     
-      double deltaFTPKlocal[3][2];
-      deltaFTPKlocal[0][0]= TPK[0][0]*ShapeVectorResting[0][0]+TPK[0][1]*ShapeVectorResting[0][1];
-      deltaFTPKlocal[0][1]= TPK[1][0]*ShapeVectorResting[0][0]+TPK[1][1]*ShapeVectorResting[0][1];
-     
-      deltaFTPKlocal[1][0]= TPK[0][0]*ShapeVectorResting[1][0]+TPK[0][1]*ShapeVectorResting[1][1];
-      deltaFTPKlocal[1][1]= TPK[1][0]*ShapeVectorResting[1][0]+TPK[1][1]*ShapeVectorResting[1][1];
-
-      deltaFTPKlocal[2][0]= TPK[0][0]*ShapeVectorResting[2][0]+TPK[0][1]*ShapeVectorResting[2][1];
-      deltaFTPKlocal[2][1]= TPK[1][0]*ShapeVectorResting[2][0]+TPK[1][1]*ShapeVectorResting[2][1];
-
-
-      double deltaFTPK[3][3]; 
-      deltaFTPK[0][0]= rotation[0][0]*deltaFTPKlocal[0][0]+rotation[0][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][1]= rotation[1][0]*deltaFTPKlocal[0][0]+rotation[1][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][2]= rotation[2][0]*deltaFTPKlocal[0][0]+rotation[2][1]*deltaFTPKlocal[0][1];
-
-      deltaFTPK[1][0]= rotation[0][0]*deltaFTPKlocal[1][0]+rotation[0][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][1]= rotation[1][0]*deltaFTPKlocal[1][0]+rotation[1][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][2]= rotation[2][0]*deltaFTPKlocal[1][0]+rotation[2][1]*deltaFTPKlocal[1][1];
-      
-      deltaFTPK[2][0]= rotation[0][0]*deltaFTPKlocal[2][0]+rotation[0][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][1]= rotation[1][0]*deltaFTPKlocal[2][0]+rotation[1][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][2]= rotation[2][0]*deltaFTPKlocal[2][0]+rotation[2][1]*deltaFTPKlocal[2][1];
-
-
-      // //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
-      
-
-
-      //Shape vectors in Current shape (counterclockwise ordering of nodes/edges)     ShapeVectorCurrent[3][3]  calculated above   
-      //......................Rstrain here........ ( or clockwise ordering of nodes/edges)
-          
-
-      //square of radius of circumstancing circle in resting shape
-      //double Rcirc2Resting=(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area)*(0.25*restingLength[0]*restingLength[1]*restingLength[2]/Area);  
-
-
-      // for (int r=0 ; r<2 ; r++) 
-      //   for (int s=0 ; s<2 ; s++) 
-      //     std::cerr<<" almansi  "<<StrainAlmansi[r][s]<<std::endl;      
-
-
-   
-    //---- Anisotropic Correction Force-------------------------------
-       double deltaF[3][3];
-
-
-
-
-        for ( int i=0 ; i<3 ; ++i )  // from stress tensor(equipartitioning energy)
-          for ( int j=0 ; j<3 ; ++j )
-            deltaF[i][j]=(-deltaFTPK[i][j]);
+      //---- Anisotropic Correction Force-------------------------------
+      double deltaF[3][3];
+      TRBS::stressForce(restingArea,DeformGrad,deltaS,ShapeVectorResting,rotation,
+                        deltaF);
       
         double  I1=trE;
 
@@ -3746,39 +2758,8 @@ derivs(Tissue &T,
         
         
         //Forces of vertices   
-        double Force[3][3]={{0,0,0},{0,0,0},{0,0,0}};                                          
-        
-
-
-        Force[0][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][0]-position[0][0])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][0]-position[0][0])
-          + deltaF[0][0]; 
-        Force[0][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][1]-position[0][1])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][1]-position[0][1])
-          + deltaF[0][1];  
-        Force[0][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][2]-position[0][2])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][2]-position[0][2])
-          + deltaF[0][2]; 
-
-        Force[1][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][0]-position[1][0])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][0]-position[1][0])
-          + deltaF[1][0];  
-        Force[1][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][1]-position[1][1])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][1]-position[1][1])
-          + deltaF[1][1];  
-        Force[1][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][2]-position[1][2])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][2]-position[1][2])
-          + deltaF[1][2];  
-        
-        Force[2][0]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][0]-position[2][0])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][0]-position[2][0])
-          + deltaF[2][0];  
-        Force[2][1]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][1]-position[2][1])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][1]-position[2][1])
-          + deltaF[2][1];  
-        Force[2][2]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][2]-position[2][2])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][2]-position[2][2])
-          + deltaF[2][2];
+        double Force[3][3];
+        TRBS::force(E,Delta,position,deltaF,Force);
         
         
         bool isSliver=false;
@@ -3841,10 +2822,28 @@ derivs(Tissue &T,
     
 }
 
+void VertexFromTRBScenterTriangulationMT::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 
 void VertexFromTRBScenterTriangulationMT::
 update(Tissue &T,
+       DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       double h)
+{
+  (this->*update_)(T,cellData,wallData,vertexData,h);
+}
+
+template<class Fiber,class Direction,class RestingLength>
+void VertexFromTRBScenterTriangulationMT::
+updatePolicy(Tissue &T,
        DataMatrix &cellData,
        DataMatrix &wallData,
        DataMatrix &vertexData, 
@@ -3886,26 +2885,31 @@ update(Tissue &T,
   size_t stressTensorIndex =variableIndex(0,9);	
   size_t normalVectorIndex =variableIndex(0,10);
 
-  double youngMatrix= parameter(0);    
-  double youngFiber = parameter(1); 
   double poissonL   = parameter(2);    
   double poissonT   = parameter(3);
   double TETA       = parameter(8);  
+  double stressMax  = parameter(6);
+  bool planeStrain  = parameter(7)==0;
+  Fiber fiber(parameter(0),parameter(1),youngLIndex,anisoEnergyIndex);
+  Direction direction(TETA,TETA,MTindex);
+  RestingLength restingLengths(lengthInternalIndex,wallLengthIndex);
   
  
 
   //std::cerr<<" here is update "<<std::endl;
   //std::cout<<"begin:"<<std::endl;
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall();
+    size_t numWalls = topology.numCellWall(cellIndex);
     
   
 
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
+    if(  topology.numCellVertex(cellIndex)!= numWalls ) {
      
       std::cerr << "VertexFromTRBScenterTriangulationMT::update() same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls and "
+		<< topology.numCellVertex(cellIndex) << " vertices!"	
 		<< std::endl;
       exit(-1);
     }
@@ -3917,217 +2921,8 @@ update(Tissue &T,
 
    
 
-    double youngL=1;
-    double youngT=1;
-    
-
-
-    if( parameter(4)==1){  // material anisotropy via FiberModel
-      youngL = cellData[cellIndex][youngLIndex]; 
-      youngT = 2*youngMatrix+youngFiber-youngL; 
-    }
-    else {
-      if( parameter(4)==0 ){ // constant anisotropic material
-        youngL = youngMatrix+youngFiber;
-        youngT = youngMatrix;
-
-        
-
-        // youngL *=0.4+1.1*cellData[cellIndex][11];
-        // youngT *=0.4+1.1*cellData[cellIndex][11];
-
-        // // hypocotyl Siobhan
-        // if(cellData[cellIndex][37]==-1){ // epidermis
-        //   youngL *=1.3;
-        //   youngT *=1.3;
-          
-        // }
-        // if(cellData[cellIndex][37]==-2){ // inner
-        //   youngL *=1;
-        //   youngT *=1;
-        //   // youngL *=1;
-        //   // youngT *=1;
-
-                
-        // }
-        // if(cellData[cellIndex][37]==-3){  // anti. axial
-          
-        //   youngL *=0.5; //1, 0.5
-        //   youngT *=0.5; //1, 0.5
-          
-          
-        // }
-        // //if(cellData[cellIndex][37]==-4 && cellData[cellIndex][38]==0){  // anti transverse
-        // if(cellData[cellIndex][37]==-4 ){  // anti transverse
-        //   youngL *=1; //2, 1
-        //   youngT *=1; //2, 1
-        
-        // }
-
-
-        // if(timeC>4000){
-        //   // hypocotyl Siobhan
-        //   if(cellData[cellIndex][37]==-1){ // epidermis
-        //     youngL *=3;
-        //     youngT *=3;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-2){ // inner
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-3){  // anti. axial
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        //   if(cellData[cellIndex][37]==-4){  // anti transverse
-        //     youngL *=1;
-        //     youngT *=1;
-            
-        //   }
-        // }
-        
-      }
-      if( parameter(4)==2){  // for varrying material anisotropy with constant overall stiffness for energy landscape
-        youngL =youngFiber; 
-        youngT =youngMatrix-youngL;  // here youngMatrix is total stiffness
-      }
-
-      if( parameter(4)==3){  // for varrying material anisotropy with constant overall stiffness for energy landscape
-        double totalElast=youngMatrix;
-        double Maniso=youngFiber;
-        youngT =((1-Maniso)/(2-Maniso))*totalElast; 
-        youngL=totalElast-youngT;
-       
-        //youngL =youngMatrix+youngFiber; 
-        // youngT =youngMatrix+std::sqrt(
-        //                               ((youngFiber-totalElast)*4*totalElast)
-        //                               /
-        //                               ((2-3.1415)*3.1415)
-        //                               );  // here youngMatrix is total stiffness
-        //youngT =youngMatrix+totalElast*std::sqrt(
-        //                                         -(std::log((youngFiber/totalElast)-0.55))
-        //                                         /6
-        //                                         );
-        //youngT =youngMatrix+2*(totalElast-youngFiber)/(3.1415-2);
-        
-        // youngL=youngMatrix+youngFiber; 
-        // youngT =youngMatrix+(youngFiber-slope*totalElast)/(1-2*slope); 
-
-      }
-      
-      // if( parameter(4)==5){  // for domain dependent material properties - Hypocotyl bending 3d (internal tissue softer)    
-      //   if (cellData[cellIndex][38]==-1){
-      //     youngL =youngMatrix+youngFiber; 
-      //     youngT =youngMatrix;  
-          
-      //   }
-      //   else{
-      //     youngL =0.2*(youngMatrix+youngFiber); 
-      //     youngT =0.2*youngMatrix;  
-      //   }
-
-      //   if (cellData[cellIndex][5]==5){
-      //     youngL =0.01*(youngMatrix+youngFiber); 
-      //     youngT =0.01*youngMatrix;  
-      //   }
-      // }
-
-      if( parameter(4)==5){// for pavement cell resolution addaptive stiffness
-        youngFiber=cellData[cellIndex][anisoEnergyIndex];
-        double fiberL=cellData[cellIndex][youngLIndex];
-        youngL = youngMatrix+fiberL;
-        youngT = youngMatrix+youngFiber-fiberL;
-
-        // if(cellData[cellIndex][30]==1){
-        //   youngL = 20;
-        //   youngT = 20;
-        
-        // }
-      }
-     
-           
-      if( parameter(4)==6){  // material anisotropy via FiberModel and loosening adhoc based on auxin
-        youngL = cellData[cellIndex][youngLIndex]; 
-        youngT = 2*youngMatrix+youngFiber-youngL; 
-        
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=0.25+0.75*frac;
-        youngT*=0.25+0.75*frac;
-        //if(cellIndex==0) std::cerr<<cellData[cellIndex][13]<<"  "<<youngL<<"  " <<youngT<<std::endl;
-      }
-
-       if( parameter(4)==7){  // material anisotropy via FiberModel and destroying fibers based on auxin
-         youngL = cellData[cellIndex][youngLIndex]-youngMatrix;
-         youngT = 2*youngMatrix+youngFiber-youngL-2*youngMatrix;  
-         
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=frac;
-        youngT*=frac;
-        youngL+=youngMatrix;
-        youngT+=youngMatrix;
-        //cellData[cellIndex][youngLIndex]=youngL; 
-     
-      }
-       if( parameter(4)==8){  // material anisotropy via FiberModel and destroying fibers and a fraction of matrix based on auxin
-         youngL = cellData[cellIndex][youngLIndex]-youngMatrix;
-         youngT = 2*youngMatrix+youngFiber-youngL-2*youngMatrix;  
-         
-        double Kconc=0.005;
-        double Nc1=2;
-        double conc=cellData[cellIndex][13];
-        double frac=(1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
-        youngL*=frac;
-        youngT*=frac;
-        youngL+=youngMatrix*(0.2+0.8*frac);
-        youngT+=youngMatrix*(0.2+0.8*frac);
-        //cellData[cellIndex][youngLIndex]=youngL; 
-     
-      }
-     
-      // if( parameter(4)<0){  // for heterogeneous stiffness(adhoc)
-      //   double hFactor=0;
-      //   double Hthreshold=0.01;
-      //   if (std::fabs(cellData[cellIndex][youngLIndex])>Hthreshold){
-      //     hFactor=Hthreshold;
-      //   }
-      //   else{
-      //     hFactor=std::fabs(cellData[cellIndex][youngLIndex]); // take the heterogeneous info from this index
-      //   }
-      //   hFactor *=std::fabs(parameter(4)); // factor for heterogeneity      
-      
-      //   youngL = youngMatrix+youngFiber-hFactor*(youngMatrix+youngFiber); 
-      //   youngT = youngMatrix-hFactor*(youngMatrix); 
-      // }
-      
-      // if (cellData[cellIndex][31]==10){
-      //   youngL = 150;
-      //   youngT = 10;
-      // }
-     
-      
-      // if( parameter(4)<0){  // for spatial elasticity (ad-hoc)
-      //   double x0=90;
-      //   double y0=120;
-        
-      //   double xx=cellData[cellIndex][comIndex]-x0;
-      //   double yy=cellData[cellIndex][comIndex+1]-y0;
-        
-      //   youngL = youngMatrix+youngFiber*(1-std::exp(parameter(4)*(xx*xx+yy*yy)));
-      //   youngT = youngMatrix; 
-      //   cellData[cellIndex][13]=youngL;
-      // }
-
-      
-    }
+    double youngL, youngT;
+    fiber.modulus(cellData,cellIndex,youngL,youngT);
 
     // ad-hoc for 3d marcus
     
@@ -4186,27 +2981,11 @@ update(Tissue &T,
     // }
 
 
-    double lambdaL, mioL, lambdaT, mioT; // ,lambdaTmatrix, mioTmatrix;
-    
-    if (parameter(7)==0){      
-      // Lame coefficients based on plane strain (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/((1+poissonL)*(1-2*poissonL));
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/((1+poissonT)*(1-2*poissonT));
-      mioT=youngT/(2*(1+poissonT));
-
-   
-    } 
-    else{      
-      // Lame coefficients based on plane stress (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/(1-poissonL*poissonL);
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/(1-poissonT*poissonT);
-      mioT=youngT/(2*(1+poissonT));
-     
-      // lambdaTmatrix=youngMatrixA*poissonT/(1-poissonT*poissonT);
-      // mioTmatrix=youngMatrixA/(2*(1+poissonT));
-    }
+    // Lame coefficients based on plane strain or plane
+    // stress (for 3D 0<poisson<0.5)
+    double lambdaL, mioL, lambdaT, mioT;
+    TRBS::shearLame(youngL,poissonL,planeStrain,lambdaL,mioL);
+    TRBS::shearLame(youngT,poissonT,planeStrain,lambdaT,mioT);
     
 
     //std::cerr<<"youngL  "<<youngL<<", youngT"<<youngT<<std::endl;
@@ -4230,38 +3009,17 @@ update(Tissue &T,
     double EnergyAniso=0;
     double strainZ=0;
 
-    if ( parameter(9)==1 ) {  // aniso direction from TETA 
-      
-      cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-      cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-      cellData[cellIndex][variableIndex(0,1)+2]=0;
-      // if(parameter(10)!=100){
-      //   if(cellIndex==0 || cellIndex==2 ){
-      //     cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-      //     cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-      //     cellData[cellIndex][variableIndex(0,1)+2]=0;
-      //   }
-      //   if(cellIndex==1 || cellIndex==3 ){
-      //     cellData[cellIndex][variableIndex(0,1)]=std::cos(parameter(10));    
-      //     cellData[cellIndex][variableIndex(0,1)+1]=std::sin(parameter(10));
-      //     cellData[cellIndex][variableIndex(0,1)+2]=0;
-      //   }
-      // }
-    }
-    
-  
+    direction.set(cellData,cellIndex);
 
-    
-  
       // One triangle per 'vertex' in cyclic order
       for (size_t wallindex=0; wallindex<numWalls; ++wallindex) {
         
       size_t kPlusOneMod = (wallindex+1)%numWalls;
       //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(wallindex)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
+      size_t v2 = topology.cellVertex(cellIndex,wallindex);
+      size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
       //size_t w1 = internal wallindex
-      size_t w2 = T.cell(cellIndex).wall(wallindex)->index();
+      size_t w2 = topology.cellWall(cellIndex,wallindex);
       //size_t w3 = internal wallindex+1
 
       // Position matrix holds in rows positions for com, vertex(wallindex), vertex(wallindex+1)
@@ -4286,21 +3044,8 @@ update(Tissue &T,
       // }
 
       double restingLength[3];
-      if(parameter(10)==1) { // double resting length  
-        restingLength[0] =cellData[cellIndex][lengthInternalIndex + 2*wallindex+1];
-        //restingLength[1] = wallData[w2][wallLengthIndex]+wallData[w2][wallLengthIndex+restAddIndex];
-        restingLength[1] =wallData[w2][wallLengthIndex]+
-          cellData[cellIndex][lengthInternalIndex+2*numWalls+wallindex];
-        restingLength[2] =cellData[cellIndex][lengthInternalIndex + 2*kPlusOneMod];
-        //cellData[cellIndex][31]=cellIndex;        
-        // if(cellIndex==408 && wallindex==0) 
-        //   std::cout<<restingLength[0]<<" "<<restingLength[1]<<" "<<restingLength[2]<<std::endl;
-      }      
-      else{                 // single resting length
-        restingLength[0] = cellData[cellIndex][lengthInternalIndex + wallindex];
-        restingLength[1] = wallData[w2][wallLengthIndex];
-        restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
-      }
+      restingLengths.set(cellData,wallData,cellIndex,numWalls,wallindex,w2,
+                         restingLength);
       
       // Lengths are from com-vertex(wallindex), vertex(wallindex)-vertex(wallindex+1) (wall(wallindex)), com-vertex(wallindex+1)
       double length[3]=
@@ -4308,7 +3053,7 @@ update(Tissue &T,
                      (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
                      (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) ),
           
-          T.wall(w2).lengthFromVertexPosition(vertexData),
+          topology.wallLength(w2,vertexData),
           
           std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
                      (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
@@ -4713,44 +3458,6 @@ update(Tissue &T,
       // deltaFTPK[0][2]= rotation[2][0]*deltaFTPKlocal[0][0]+rotation[2][1]*deltaFTPKlocal[0][1];
       //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-      double TPK[2][2];// 2nd Piola Kirchhoff stress tensor 
-      TPK[0][0]=restingArea*(DeformGrad[0][0]*deltaS[0][0]+DeformGrad[0][1]*deltaS[1][0]);
-      TPK[1][0]=restingArea*(DeformGrad[1][0]*deltaS[0][0]+DeformGrad[1][1]*deltaS[1][0]);
-      TPK[0][1]=restingArea*(DeformGrad[0][0]*deltaS[0][1]+DeformGrad[0][1]*deltaS[1][1]);
-      TPK[1][1]=restingArea*(DeformGrad[1][0]*deltaS[0][1]+DeformGrad[1][1]*deltaS[1][1]);
-
-      //deltaFTPKlocal[i][0]= TPK[0][0]*ShapeVectorResting[i][0]+TPK[0][1]*ShapeVectorResting[i][1];
-      //deltaFTPKlocal[i][1]= TPK[1][0]*ShapeVectorResting[i][0]+TPK[1][1]*ShapeVectorResting[i][1];
-     
-      double deltaFTPKlocal[3][2];
-      deltaFTPKlocal[0][0]= TPK[0][0]*ShapeVectorResting[0][0]+TPK[0][1]*ShapeVectorResting[0][1];
-      deltaFTPKlocal[0][1]= TPK[1][0]*ShapeVectorResting[0][0]+TPK[1][1]*ShapeVectorResting[0][1];
-     
-      deltaFTPKlocal[1][0]= TPK[0][0]*ShapeVectorResting[1][0]+TPK[0][1]*ShapeVectorResting[1][1];
-      deltaFTPKlocal[1][1]= TPK[1][0]*ShapeVectorResting[1][0]+TPK[1][1]*ShapeVectorResting[1][1];
-
-      deltaFTPKlocal[2][0]= TPK[0][0]*ShapeVectorResting[2][0]+TPK[0][1]*ShapeVectorResting[2][1];
-      deltaFTPKlocal[2][1]= TPK[1][0]*ShapeVectorResting[2][0]+TPK[1][1]*ShapeVectorResting[2][1];
-
-
-      double deltaFTPK[3][3]; 
-      deltaFTPK[0][0]= rotation[0][0]*deltaFTPKlocal[0][0]+rotation[0][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][1]= rotation[1][0]*deltaFTPKlocal[0][0]+rotation[1][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][2]= rotation[2][0]*deltaFTPKlocal[0][0]+rotation[2][1]*deltaFTPKlocal[0][1];
-
-      deltaFTPK[1][0]= rotation[0][0]*deltaFTPKlocal[1][0]+rotation[0][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][1]= rotation[1][0]*deltaFTPKlocal[1][0]+rotation[1][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][2]= rotation[2][0]*deltaFTPKlocal[1][0]+rotation[2][1]*deltaFTPKlocal[1][1];
-      
-      deltaFTPK[2][0]= rotation[0][0]*deltaFTPKlocal[2][0]+rotation[0][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][1]= rotation[1][0]*deltaFTPKlocal[2][0]+rotation[1][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][2]= rotation[2][0]*deltaFTPKlocal[2][0]+rotation[2][1]*deltaFTPKlocal[2][1];
-
-
-      // //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-
-
       double deltaSFt[2][2];
       deltaSFt[0][0]=deltaS[0][0]*DeformGrad[0][0]+deltaS[0][1]*DeformGrad[0][1];
       deltaSFt[1][0]=deltaS[1][0]*DeformGrad[0][0]+deltaS[1][1]*DeformGrad[0][1];
@@ -4862,19 +3569,11 @@ update(Tissue &T,
         normalGlob[r] += Area*Zcurrent[r];
 
       TotalCellRestingArea=TotalCellRestingArea+restingArea;
-      TotalCellArea=TotalCellArea+Area;
-      // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> STRAIN and STRESS TENSORS (END) <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-
-   
-    //---- Anisotropic Correction Force-------------------------------
-       double deltaF[3][3];
-
-
-
+      TotalCellArea=TotalCellArea+Area;
+      // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> STRAIN and STRESS TENSORS (END) <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
-        for ( int i=0 ; i<3 ; ++i )  // from stress tensor(equipartitioning energy)
-          for ( int j=0 ; j<3 ; ++j )
-            deltaF[i][j]=(-deltaFTPK[i][j]);
+   
+    //---- Anisotropic Correction Force-------------------------------
       
         double  I1=trE;
 
@@ -5114,10 +3813,10 @@ update(Tissue &T,
       if (std::fabs(maximalStressValue)<  0.000001) cellData[cellIndex][stressAnIndex]=0;
       
       if (std::fabs(maximalStressValue)>= 0.000001) {
-        if(parameter(6)==0)
+        if(stressMax==0)
           cellData[cellIndex][stressAnIndex]=1-std::fabs(maximalStressValue2/maximalStressValue);
         else
-          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/parameter(6));
+          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/stressMax);
       }    
       
       
@@ -5603,16 +4302,15 @@ update(Tissue &T,
   if(neighborweight>0)
     for( size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex ) {
       
-      const size_t numWalls = T.cell(cellIndex).numWall();
+      const size_t numWalls = topology.numCellWall(cellIndex);
       
       
       
-      Cell *  cell1=&(T.cell(cellIndex));
       
       //std::vector<int> neighbor(numWalls);
       std::vector<size_t> neighbor(numWalls);
       for   ( size_t wallIndex=0 ; wallIndex<numWalls ; ++wallIndex ){
-        neighbor[wallIndex]=(cell1->cellNeighbor(wallIndex))->index();
+        neighbor[wallIndex]=topology.cellWallNeighbor(cellIndex,wallIndex);
       }
       
       // std::cerr<<" cell   "<<cellIndex << "cell neighbors    ";
@@ -5836,10 +4534,10 @@ update(Tissue &T,
       if (std::fabs(maximalStressValue)<  0.000001) cellData[cellIndex][stressAnIndex]=0;
       
       if (std::fabs(maximalStressValue)>= 0.000001) {
-        if(parameter(6)==0)
+        if(stressMax==0)
           cellData[cellIndex][stressAnIndex]=1-std::fabs(maximalStressValue2/maximalStressValue);
         else
-          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/parameter(6));
+          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/stressMax);
       }    
       
       
@@ -7083,7 +5781,7 @@ VertexFromTRLScenterTriangulationMT(std::vector<double> &paraValue,
               << "                    1:for MT direction from 7th parameter TETA, 2:force to Stress,  "
               << "                    3: force to Strain ,4:force to perp-strain "
 	      << "10 : 1:independent resting length for the elements, otherwise: common length "
-              <<" also see line 2835 where an ad-hoc thing is implemented for parameter(9)==1 "
+              <<" for parameter(9)==1 cells 1 and 3 get the MT angle parameter(10) unless it is 100 "
               << std::endl;
     
     exit(0);
@@ -7174,11 +5872,44 @@ VertexFromTRLScenterTriangulationMT(std::vector<double> &paraValue,
               << " 4: force to perp-strain " << std::endl;
     exit(0);
   }
+
+  // Instantiation of derivs() for the MT direction, resting lengths and
+  // fiber model
+  if( parameter(9)==1 ) { // MT direction from TETA
+    if( parameter(10)==1 )
+      selectFiber<TRBS::AngleDirection,TRBS::DoubleRestingLength>();
+    else
+      selectFiber<TRBS::AngleDirection,TRBS::SingleRestingLength>();
+  }
+  else {
+    if( parameter(10)==1 )
+      selectFiber<TRBS::CellDirection,TRBS::DoubleRestingLength>();
+    else
+      selectFiber<TRBS::CellDirection,TRBS::SingleRestingLength>();
+  }
+}
+
+template<class Direction,class RestingLength>
+void VertexFromTRLScenterTriangulationMT::
+selectFiber()
+{
+  typedef VertexFromTRLScenterTriangulationMT MT;
+  if( parameter(4)==0 ) // constant anisotropic material
+    derivs_ = &MT::derivsPolicy<TRBS::ConstantFiber,Direction,RestingLength>;
+  else if( parameter(4)==1 ) // material anisotropy via FiberModel
+    derivs_ = &MT::derivsPolicy<TRBS::ModelFiber,Direction,RestingLength>;
+  else if( parameter(4)==2 ) // constant overall stiffness for energy landscape
+    derivs_ = &MT::derivsPolicy<TRBS::TotalStiffnessFiber,Direction,RestingLength>;
+  else if( parameter(4)==5 ) // unit moduli, stores resting area and stress
+    derivs_ = &MT::derivsPolicy<TRBS::AdaptiveUnitFiber,Direction,RestingLength>;
+  else
+    derivs_ = &MT::derivsPolicy<TRBS::UnitFiber,Direction,RestingLength>;
 }
 
 
+template<class Fiber,class Direction,class RestingLength>
 void VertexFromTRLScenterTriangulationMT::
-derivs(Tissue &T,
+derivsPolicy(Tissue &T,
        DataMatrix &cellData,
        DataMatrix &wallData,
        DataMatrix &vertexData,
@@ -7210,11 +5941,17 @@ derivs(Tissue &T,
   size_t stressTensorIndex =variableIndex(0,9);	
   size_t normalVectorIndex =variableIndex(0,10);
 
-  double youngMatrix= parameter(0);    
-  double youngFiber = parameter(1); 
   double poissonL   = parameter(2);    
   double poissonT   = parameter(3);
   double TETA       = parameter(8);  
+  double stressMax  = parameter(6);
+  bool planeStrain  = parameter(7)==0;
+  Fiber fiber(parameter(0),parameter(1),youngLIndex,anisoEnergyIndex);
+  // cells 1 and 3 have the MT angle parameter(10) unless it is 100
+  Direction direction(TETA,parameter(10)!=100 ? parameter(10) : TETA,
+                      variableIndex(0,1));
+  RestingLength restingLengths(lengthInternalIndex,wallLengthIndex);
+  TRBS::Element E;
   
   //HJ: removed due to unused variable warning
   //static double tTotal=0, tDiag=0;
@@ -7224,60 +5961,31 @@ derivs(Tissue &T,
   clock_t cpuTime0, cpuTime1 ,cpuTime2; //, cpuTimef, cpuTime3 ,cpuTime4;
   cpuTime0=clock();
 
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall();
+    size_t numWalls = topology.numCellWall(cellIndex);
     
   
 
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
+    if(  topology.numCellVertex(cellIndex)!= numWalls ) {
      
       std::cerr << "VertexFromTRLScenterTriangulationMT::derivs() same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls and "
+		<< topology.numCellVertex(cellIndex) << " vertices!"	
 		<< std::endl;
       exit(-1);
     }
     
   
  
-    double youngL=1;
-    double youngT=1;
-    double GG=1;
-
-
-    if( parameter(4)==1){  // material anisotropy via FiberModel
-      youngL = cellData[cellIndex][youngLIndex]; 
-      youngT = 2*youngMatrix+youngFiber-youngL; 
-    }
-    else {
-      if( parameter(4)==0 ){ // constant anisotropic material
-        youngL = youngMatrix+youngFiber;
-        youngT = youngMatrix; 
-      }
-      if( parameter(4)==2){  // for varrying material anisotropy with constant overall stiffness for energy landscape
-        youngL =youngFiber; 
-        youngT =youngMatrix-youngL;  // here youngMatrix is total stiffness
-      }
-    }
-    GG=(youngL+youngT)/2;  
-    double lambdaL, mioL, lambdaT, mioT; // ,lambdaTmatrix, mioTmatrix;
-    
-    if (parameter(7)==0){      
-      // Lame coefficients based on plane strain (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/((1+poissonL)*(1-2*poissonL));
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/((1+poissonT)*(1-2*poissonT));
-      mioT=youngT/(2*(1+poissonT));
-
-   
-    } 
-    else{      
-      // Lame coefficients based on plane stress (for 3D 0<poisson<0.5)
-      lambdaL=youngL*poissonL/(1-poissonL*poissonL);
-      mioL=youngL/(2*(1+poissonL));
-      lambdaT=youngT*poissonT/(1-poissonT*poissonT);
-      mioT=youngT/(2*(1+poissonT));
-    }
+    double youngL, youngT;
+    fiber.modulus(cellData,cellIndex,youngL,youngT);
+    // Lame coefficients based on plane strain or plane
+    // stress (for 3D 0<poisson<0.5)
+    double lambdaL, mioL, lambdaT, mioT;
+    TRBS::shearLame(youngL,poissonL,planeStrain,lambdaL,mioL);
+    TRBS::shearLame(youngT,poissonT,planeStrain,lambdaT,mioT);
     
     double StrainCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
     double StressCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
@@ -7289,39 +5997,18 @@ derivs(Tissue &T,
     double EnergyAniso=0;
     double strainZ=0;
 
-    if ( parameter(9)==1 ) {  // aniso direction from TETA 
-      
-      cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-      cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-      cellData[cellIndex][variableIndex(0,1)+2]=0;
-      if(parameter(10)!=100){
-	if(cellIndex==0 || cellIndex==2 ){
-	  cellData[cellIndex][variableIndex(0,1)]=std::cos(TETA);    
-	  cellData[cellIndex][variableIndex(0,1)+1]=std::sin(TETA);
-	  cellData[cellIndex][variableIndex(0,1)+2]=0;
-	}
-	if(cellIndex==1 || cellIndex==3 ){
-	  cellData[cellIndex][variableIndex(0,1)]=std::cos(parameter(10));    
-	  cellData[cellIndex][variableIndex(0,1)+1]=std::sin(parameter(10));
-	  cellData[cellIndex][variableIndex(0,1)+2]=0;
-	}
-      }
-    }
-    
-  
+    direction.set(cellData,cellIndex);
 
-    
-     
       // One triangle per 'vertex' in cyclic order
       for (size_t wallindex=0; wallindex<numWalls; ++wallindex) {
         
         
       size_t kPlusOneMod = (wallindex+1)%numWalls;
       //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(wallindex)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
+      size_t v2 = topology.cellVertex(cellIndex,wallindex);
+      size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
       //size_t w1 = internal wallindex
-      size_t w2 = T.cell(cellIndex).wall(wallindex)->index();
+      size_t w2 = topology.cellWall(cellIndex,wallindex);
       //size_t w3 = internal wallindex+1
 
       // Position matrix holds in rows positions for com, vertex(wallindex), vertex(wallindex+1)
@@ -7334,19 +6021,9 @@ derivs(Tissue &T,
       
 
     
-      double restingLength[3];
-      if(parameter(10)==1) { // double resting length  
-        restingLength[0] =cellData[cellIndex][lengthInternalIndex + 2*wallindex+1];
-        //restingLength[1] = wallData[w2][wallLengthIndex]+wallData[w2][wallLengthIndex+restAddIndex];
-        restingLength[1] =wallData[w2][wallLengthIndex]+
-          cellData[cellIndex][lengthInternalIndex+2*numWalls+wallindex];
-        restingLength[2] =cellData[cellIndex][lengthInternalIndex + 2*kPlusOneMod];
-      }      
-      else{                 // single resting length
-        restingLength[0] = cellData[cellIndex][lengthInternalIndex + wallindex];
-        restingLength[1] = wallData[w2][wallLengthIndex];
-        restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
-      }
+      double *restingLength = E.restingLength;
+      restingLengths.set(cellData,wallData,cellIndex,numWalls,wallindex,w2,
+                         restingLength);
       
       // Lengths are from com-vertex(wallindex), vertex(wallindex)-vertex(wallindex+1) (wall(wallindex)), com-vertex(wallindex+1)
       double length[3]=
@@ -7354,7 +6031,7 @@ derivs(Tissue &T,
                      (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
                      (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) ),
           
-          T.wall(w2).lengthFromVertexPosition(vertexData),
+          topology.wallLength(w2,vertexData),
           
           std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
                      (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
@@ -7362,29 +6039,10 @@ derivs(Tissue &T,
         };
       
       
-      // Area of the element (using Heron's formula)                                      
-      double restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-                                    (-restingLength[0]+restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]-restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-      
-     
-    
-      double cosAngle[3]=
-        { (  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]
-              -restingLength[1]*restingLength[1])/
-             (restingLength[0]*restingLength[2]*2)    ),
-
-          (  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]
-              -restingLength[2]*restingLength[2])/
-             (restingLength[0]*restingLength[1]*2)    ),
-
-          (  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]
-              -restingLength[0]*restingLength[0])/
-             (restingLength[1]*restingLength[2]*2)    )
-        };
-      
-      double temp = 1.0/(restingArea*16);                                      
+      TRBS::restingShape(E);
+      double restingArea = E.restingArea;
+      const double *cosAngle = E.cosAngle;
+      double temp;
 
       
       //Area of the element (using Heron's formula)                                      
@@ -7706,39 +6364,6 @@ double StRot[2][2]=
       //std::cerr<< "cell "<< cellIndex<< " thickness :  " << strainZ << std::endl;
       
 
-      double TPK[2][2];// 2nd Piola Kirchhoff stress tensor 
-      TPK[0][0]=restingArea*(DeformGrad[0][0]*deltaS[0][0]+DeformGrad[0][1]*deltaS[1][0]);
-      TPK[1][0]=restingArea*(DeformGrad[1][0]*deltaS[0][0]+DeformGrad[1][1]*deltaS[1][0]);
-      TPK[0][1]=restingArea*(DeformGrad[0][0]*deltaS[0][1]+DeformGrad[0][1]*deltaS[1][1]);
-      TPK[1][1]=restingArea*(DeformGrad[1][0]*deltaS[0][1]+DeformGrad[1][1]*deltaS[1][1]);
-
-
-     
-      double deltaFTPKlocal[3][2];
-      deltaFTPKlocal[0][0]= TPK[0][0]*ShapeVectorResting[0][0]+TPK[0][1]*ShapeVectorResting[0][1];
-      deltaFTPKlocal[0][1]= TPK[1][0]*ShapeVectorResting[0][0]+TPK[1][1]*ShapeVectorResting[0][1];
-     
-      deltaFTPKlocal[1][0]= TPK[0][0]*ShapeVectorResting[1][0]+TPK[0][1]*ShapeVectorResting[1][1];
-      deltaFTPKlocal[1][1]= TPK[1][0]*ShapeVectorResting[1][0]+TPK[1][1]*ShapeVectorResting[1][1];
-
-      deltaFTPKlocal[2][0]= TPK[0][0]*ShapeVectorResting[2][0]+TPK[0][1]*ShapeVectorResting[2][1];
-      deltaFTPKlocal[2][1]= TPK[1][0]*ShapeVectorResting[2][0]+TPK[1][1]*ShapeVectorResting[2][1];
-
-
-      double deltaFTPK[3][3]; 
-      deltaFTPK[0][0]= rotation[0][0]*deltaFTPKlocal[0][0]+rotation[0][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][1]= rotation[1][0]*deltaFTPKlocal[0][0]+rotation[1][1]*deltaFTPKlocal[0][1];
-      deltaFTPK[0][2]= rotation[2][0]*deltaFTPKlocal[0][0]+rotation[2][1]*deltaFTPKlocal[0][1];
-
-      deltaFTPK[1][0]= rotation[0][0]*deltaFTPKlocal[1][0]+rotation[0][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][1]= rotation[1][0]*deltaFTPKlocal[1][0]+rotation[1][1]*deltaFTPKlocal[1][1];
-      deltaFTPK[1][2]= rotation[2][0]*deltaFTPKlocal[1][0]+rotation[2][1]*deltaFTPKlocal[1][1];
-      
-      deltaFTPK[2][0]= rotation[0][0]*deltaFTPKlocal[2][0]+rotation[0][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][1]= rotation[1][0]*deltaFTPKlocal[2][0]+rotation[1][1]*deltaFTPKlocal[2][1];
-      deltaFTPK[2][2]= rotation[2][0]*deltaFTPKlocal[2][0]+rotation[2][1]*deltaFTPKlocal[2][1];
-
-
       // //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 
@@ -7837,14 +6462,9 @@ double StRot[2][2]=
 
    
     //---- Anisotropic Correction Force-------------------------------
-       double deltaF[3][3];
-
-
-
-
-        for ( int i=0 ; i<3 ; ++i )  // from stress tensor(equipartitioning energy)
-          for ( int j=0 ; j<3 ; ++j )
-            deltaF[i][j]=(-deltaFTPK[i][j]);
+      double deltaF[3][3];
+      TRBS::stressForce(restingArea,DeformGrad,deltaS,ShapeVectorResting,rotation,
+                        deltaF);
       
         //double  I1=trE;
 
@@ -7941,7 +6561,7 @@ double StRot[2][2]=
     double areaRatio=TotalCellArea/ TotalCellRestingArea; 
     
     strainZ=strainZ/TotalCellRestingArea; 
-    if( parameter(4)==5){
+    if( Fiber::adaptive ){
       cellData[cellIndex][areaRatioIndex]=TotalCellRestingArea;
     }  
       
@@ -8131,10 +6751,10 @@ double StRot[2][2]=
       if (std::fabs(maximalStressValue)<  0.000001) cellData[cellIndex][stressAnIndex]=0;
       
       if (std::fabs(maximalStressValue)>= 0.000001) {
-        if(parameter(6)==0)
+        if(stressMax==0)
           cellData[cellIndex][stressAnIndex]=1-std::fabs(maximalStressValue2/maximalStressValue);
         else
-          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/parameter(6));
+          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/stressMax);
       }    
       
       
@@ -8175,7 +6795,7 @@ double StRot[2][2]=
           }
       }
       
-      if( parameter(4)==5){// misses stress is stored instead of iso energy
+      if( Fiber::adaptive ){// misses stress is stored instead of iso energy
         cellData[cellIndex][isoEnergyIndex]=std::sqrt(maximalStressValue*maximalStressValue+
                                                        maximalStressValue2*maximalStressValue2);      
       }  
@@ -8466,7 +7086,7 @@ double StRot[2][2]=
         
     //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
   
-    if(parameter(4)!=5){
+    if( !Fiber::adaptive ){
       cellData[cellIndex][areaRatioIndex  ]= areaRatio;
       //cellData[cellIndex][areaRatioIndex  ]= youngL/youngT;
       cellData[cellIndex][isoEnergyIndex  ]= EnergyIso;    //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -8482,16 +7102,15 @@ double StRot[2][2]=
   if(neighborweight>0)
     for( size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex ) {
       
-      const size_t numWalls = T.cell(cellIndex).numWall();
+      const size_t numWalls = topology.numCellWall(cellIndex);
       
       
       
-      Cell *  cell1=&(T.cell(cellIndex));
       
       //std::vector<int> neighbor(numWalls);
       std::vector<size_t> neighbor(numWalls);
       for   ( size_t wallIndex=0 ; wallIndex<numWalls ; ++wallIndex ){
-        neighbor[wallIndex]=(cell1->cellNeighbor(wallIndex))->index();
+        neighbor[wallIndex]=topology.cellWallNeighbor(cellIndex,wallIndex);
       }
       
       // std::cerr<<" cell   "<<cellIndex << "cell neighbors    ";
@@ -8714,10 +7333,10 @@ double StRot[2][2]=
       if (std::fabs(maximalStressValue)<  0.000001) cellData[cellIndex][stressAnIndex]=0;
       
       if (std::fabs(maximalStressValue)>= 0.000001) {
-        if(parameter(6)==0)
+        if(stressMax==0)
           cellData[cellIndex][stressAnIndex]=1-std::fabs(maximalStressValue2/maximalStressValue);
         else
-          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/parameter(6));
+          cellData[cellIndex][stressAnIndex]=(1-std::fabs(maximalStressValue2/maximalStressValue))*(maximalStressValue/stressMax);
       }    
       
       
@@ -8772,6 +7391,25 @@ double StRot[2][2]=
     
 }
 
+void VertexFromTRLScenterTriangulationMT::
+derivs(Tissue &T,
+       DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       DataMatrix &cellDerivs,
+       DataMatrix &wallDerivs,
+       DataMatrix &vertexDerivs )
+{
+  (this->*derivs_)(T,cellData,wallData,vertexData,cellDerivs,wallDerivs,vertexDerivs);
+}
+
+void VertexFromTRLScenterTriangulationMT::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 VertexFromTRBScenterTriangulationConcentrationHillMT::
 VertexFromTRBScenterTriangulationConcentrationHillMT(std::vector<double> &paraValue, 
@@ -8844,26 +7482,29 @@ derivs(Tissue &T,
   //variableIndex(0,2) index for MT direction
   size_t comIndex = variableIndex(1,0);
   size_t lengthInternalIndex = comIndex+dimension;
-  double Kpow = std::pow(parameter(6),parameter(7));                    //<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-  
+  TRBS::HillModulus materialL(parameter(0),parameter(1),parameter(2),
+                              parameter(6),parameter(7),concIndex);
+  TRBS::HillModulus materialT(parameter(3),parameter(4),parameter(5),
+                              parameter(6),parameter(7),concIndex);
+  TRBS::Element E;
+  
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall(); 
+    size_t numWalls = topology.numCellWall(cellIndex); 
     
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
+    if(  topology.numCellVertex(cellIndex)!= numWalls ) {
       std::cerr << "VertexFromTRBScenterTriangulationConcentrationHillMT::derivs() "
 		<< "same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls and "
+		<< topology.numCellVertex(cellIndex) << " vertices!"	
 		<< std::endl;
       exit(-1);
     }
     
-    double youngL = parameter(0) + 
-      parameter(1)*Kpow/( Kpow+std::pow(cellData[cellIndex][concIndex],parameter(7)) );
-    double poissonL =parameter(2);
-    double youngT = parameter(3) + 
-      parameter(4)*Kpow/( Kpow+std::pow(cellData[cellIndex][concIndex],parameter(7)) );
-    double poissonT =parameter(5);
+    double youngL,poissonL,youngT,poissonT;
+    materialL.modulus(cellData,cellIndex,youngL,poissonL);
+    materialT.modulus(cellData,cellIndex,youngT,poissonT);
     
     double StrainCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
     double StressCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
@@ -8874,10 +7515,10 @@ derivs(Tissue &T,
     for (size_t k=0; k<numWalls; ++k) { 
       size_t kPlusOneMod = (k+1)%numWalls;
       //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(k)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
+      size_t v2 = topology.cellVertex(cellIndex,k);
+      size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
       //size_t w1 = internal k
-      size_t w2 = T.cell(cellIndex).wall(k)->index();
+      size_t w2 = topology.cellWall(cellIndex,k);
       //size_t w3 = internal k+1
       
       // Position matrix holds in rows positions for com, vertex(k), vertex(k+1)
@@ -8888,7 +7529,7 @@ derivs(Tissue &T,
       position[2] = vertexData[v3];
       
       // Resting lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
-      std::vector<double> restingLength(3);
+      double *restingLength = E.restingLength;
       restingLength[0] = cellData[cellIndex][lengthInternalIndex + k];
       restingLength[1] = wallData[w2][wallLengthIndex];
       restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
@@ -8899,7 +7540,7 @@ derivs(Tissue &T,
 			     (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
 			     (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) );
       
-      length[1] = T.wall(w2).lengthFromVertexPosition(vertexData);
+      length[1] = topology.wallLength(w2,vertexData);
 
       length[2] = std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
 			     (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
@@ -8911,41 +7552,10 @@ derivs(Tissue &T,
       double lambdaT=youngT*poissonT/(1-poissonT*poissonT);
       double mioT=youngT/(1+poissonT);
       
-      // Area of the element (using Heron's formula)                                      
-      double restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-			     (-restingLength[0]+restingLength[1]+restingLength[2])*
-			     ( restingLength[0]-restingLength[1]+restingLength[2])*
-			     ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-     
-      //double currentArea=std::sqrt( ( length[0]+length[1]+length[2])*
-      //                              (-length[0]+length[1]+length[2])*
-      //                              ( length[0]-length[1]+length[2])*
-      //                              ( length[0]+length[1]-length[2])  )*0.25;
-      
-      
-      //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
-      std::vector<double> Angle(3);
-      // can be ommited by cotan(A)=.25*sqrt(4*b*b*c*c/K-1)
-      Angle[0]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]-restingLength[1]*restingLength[1])/
-                           (restingLength[0]*restingLength[2]*2)    );
-      Angle[1]=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
-                           (restingLength[0]*restingLength[1]*2)    );
-      Angle[2]=std::acos(  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]-restingLength[0]*restingLength[0])/
-                           (restingLength[1]*restingLength[2]*2)    );
-      
-      //Tensile Stiffness
-      double tensileStiffness[3];
-      double temp = 1.0/(restingArea*16);                                      
-      double cotan[3] = {1.0/std::tan(Angle[0]),1.0/std::tan(Angle[1]),1.0/std::tan(Angle[2])};    
-      tensileStiffness[0]=(2*cotan[2]*cotan[2]*(lambdaT+mioT)+mioT)*temp;
-      tensileStiffness[1]=(2*cotan[0]*cotan[0]*(lambdaT+mioT)+mioT)*temp;
-      tensileStiffness[2]=(2*cotan[1]*cotan[1]*(lambdaT+mioT)+mioT)*temp;
-      
-      //Angular Stiffness
-      double angularStiffness[3];
-      angularStiffness[0]=(2*cotan[1]*cotan[2]*(lambdaT+mioT)-mioT)*temp;
-      angularStiffness[1]=(2*cotan[0]*cotan[2]*(lambdaT+mioT)-mioT)*temp;
-      angularStiffness[2]=(2*cotan[0]*cotan[1]*(lambdaT+mioT)-mioT)*temp;
+      TRBS::stiffness(lambdaT,mioT,E);
+      double restingArea = E.restingArea;
+      const double *cotan = E.cotan;
+      double temp;
       
       //Calculate biquadratic strains  
       std::vector<double> Delta(3);
@@ -9329,177 +7939,12 @@ derivs(Tissue &T,
    
     //---- Anisotropic Correction Force-------------------------------
       double deltaF[3][3];
-      double  Rcirc2=(0.25*length[0]*length[1]*length[2]/Area)*(0.25*length[0]*length[1]*length[2]/Area);  // square of radius of circumscribed circle in current shape
-      
-      double derIprim1[3][3];         // Invariants and their derivatives
-      double derIprim4[3][3];
-      double derIprim5[3][3];
-      
-      double DiDm;                    // inner products between shape vectors
-      double DnDr;
-      double DsDp;
-      
-      double QiQj;                    // inner products between position vectors of vertices
-      double QrQs;
-      
-      double aDi;                     // inner products between shape vectors and anisotropy vector(direction)
-      double aDj;
-      double aDm;
-      double aDp;
-      double aDr;
-      double aDs;
-      double aDn;
-      
-      temp=restingLength[0];
-      restingLength[0]=restingLength[1];
-      restingLength[1]=restingLength[2];
-      restingLength[2]=temp;
-      
-      temp=length[0];
-      length[0]=length[1];
-      length[1]=length[2];
-      length[2]=temp;
-      
-      
-      int kPerm;
-      for ( int m=0 ; m<3 ; ++m )
-        {
-          for ( int coor=0 ; coor<3 ; ++coor ) 
-            derIprim1[m][coor]=0;
-          for ( int i=0 ; i<3 ; ++i )
-            {            
-              if ((i==0 && m==1)||(i==1 && m==0)) kPerm=2;
-              if ((i==0 && m==2)||(i==2 && m==0)) kPerm=1;
-              if ((i==1 && m==2)||(i==2 && m==1)) kPerm=0; 
-              //else {
-              //std::cerr << "mechanicalTRBS::derivs() kPerm not given a value..." << std::endl;
-              //exit(-1);
-              //}
-              if (i!=m) DiDm=-0.5*cotan[kPerm]/restingArea;
-              if (i==m) DiDm=0.25*restingLength[i]*restingLength[i] / (restingArea*restingArea);
-              for ( int coor=0 ; coor<3 ; ++coor ) 
-                derIprim1[m][coor]=derIprim1[m][coor]+2*DiDm*position[m][coor];
-            }
-        }
-      
-      double Iprim4=0;
-      for ( int i=0 ; i<3 ; ++i )
-        { 
-          for ( int j=0 ; j<3 ; ++j )
-            {
-              if ((i==0 && j==1)||(i==1 && j==0)) kPerm=2; 
-              if ((i==0 && j==2)||(i==2 && j==0)) kPerm=1; 
-              if ((i==1 && j==2)||(i==2 && j==1)) kPerm=0;  
-              if (i!=j) QiQj=Rcirc2-(length[kPerm]*length[kPerm])*0.5; 
-              if (i==j) QiQj=Rcirc2;              
-              aDi=0.5*cos(teta[i])*restingLength[i]/restingArea;
-              aDj=0.5*cos(teta[j])*restingLength[j]/restingArea;
-              Iprim4=Iprim4+ QiQj*aDi*aDj;
-            }
-        }
-      
-        for ( int p=0 ; p<3 ; ++p )
-          {
-            for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=0;
-            
-            for ( int m=0 ; m<3 ; ++m )
-              {
-                aDm=0.5*cos(teta[m])*restingLength[m]/restingArea;
-                for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=derIprim4[p][coor]+aDm*position[m][coor];
-              }
-            aDp=0.5*cos(teta[p])*restingLength[p]/restingArea;
-            for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=2*aDp*derIprim4[p][coor];
-          }
-        
-        
-        for ( int p=0 ; p<3 ; ++p )                                                                             
-          { 
-            for ( int coor=0 ; coor<3 ; ++coor ) derIprim5[p][coor]=0;
-            for ( int n=0 ; n<3 ; ++n )
-              { 
-                for ( int r=0 ; r<3 ; ++r )
-                  { for ( int s=0 ; s<3 ; ++s )
-                      {     
-                        if ((r==0 && s==1)||(r==1 && s==0)) kPerm=2;
-                        if ((r==0 && s==2)||(r==2 && s==0)) kPerm=1;
-                        if ((r==1 && s==2)||(r==2 && s==1)) kPerm=0; 
-                        //if ( s!=r ) QrQs=Rcirc2-(length[kPerm]*length[kPerm])*0.5;
-                        //if ( s==r ) QrQs=Rcirc2;
-                        QrQs=position[r][0]*position[s][0]+position[r][1]*position[s][1]+position[r][2]*position[s][2];
-                        
-                        if ((n==0 && r==1)||(n==1 && r==0)) kPerm=2; 
-                        if ((n==0 && r==2)||(n==2 && r==0)) kPerm=1; 
-                        if ((n==1 && r==2)||(n==2 && r==1)) kPerm=0;    
-                        if ( n!=r )  DnDr=-0.5*cotan[kPerm]/restingArea;
-                        if ( n==r )  DnDr=0.25*restingLength[n]*restingLength[n] / (restingArea*restingArea);
-                        
-                        if ((s==0 && p==1)||(s==1 && p==0)) kPerm=2; 
-                        if ((s==0 && p==2)||(s==2 && p==0)) kPerm=1; 
-                        if ((s==1 && p==2)||(s==2 && p==1)) kPerm=0;   
-                        if ( s!=p ) DsDp=-0.5*cotan[kPerm]/restingArea;
-                        if ( s==p ) DsDp=0.25*restingLength[s]*restingLength[s] / (restingArea*restingArea);
-                        
-                        aDs=0.5*cos(teta[s])*restingLength[s]/restingArea;
-                        aDp=0.5*cos(teta[p])*restingLength[p]/restingArea;
-                        aDr=0.5*cos(teta[r])*restingLength[r]/restingArea;
-                        aDn=0.5*cos(teta[n])*restingLength[n]/restingArea;
-                        
-                        for ( int coor=0 ; coor<3 ; ++coor ) 
-                          derIprim5[p][coor] = derIprim5[p][coor] +
-                            2*(DnDr*aDs*aDp+DsDp*aDr*aDn)*QrQs*position[n][coor];
-                      }
-                  }
-              }
-          }		      
-        
-        double derI1[3][3];             // Invariants and their derivatives
-        double derI4[3][3];
-        double derI5[3][3];
-        
-        double I1=( Delta[1]*cotan[0]+ Delta[2]*cotan[1]+Delta[0]*cotan[2])/(4*restingArea);
-        double I4=0.5*Iprim4-0.5;
-        
-        for ( int i=0 ; i<3 ; ++i ) 
-          for ( int j=0 ; j<3 ; ++j ) {
-            derI1[i][j]=0.5*derIprim1[i][j];
-            derI4[i][j]=0.5*derIprim4[i][j];
-            derI5[i][j]=0.25*derIprim5[i][j]-0.5*derIprim4[i][j];
-          }   
-        for ( int i=0 ; i<3 ; ++i ) 
-          for ( int j=0 ; j<3 ; ++j )
-            deltaF[i][j]=(-deltaLam*(I4*derI1[i][j]+I1*derI4[i][j])-deltaMio*derI5[i][j]+(deltaMio+deltaLam)*I4*derI4[i][j])*restingArea;
+      TRBS::invariantForce(E,&length[0],Area,&teta[0],position,&Delta[0],
+                           deltaLam,deltaMio,deltaF);
    
         //Forces of vertices   
-        double Force[3][3];                                           
-    
-        Force[0][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][0]-position[0][0])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][0]-position[0][0])
-          + deltaF[0][0]; 
-        Force[0][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][1]-position[0][1])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][1]-position[0][1])
-          + deltaF[0][1];  
-        Force[0][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2])*(position[1][2]-position[0][2])
-          +(tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0])*(position[2][2]-position[0][2])
-          + deltaF[0][2]; 
-        Force[1][0]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][0]-position[1][0])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][0]-position[1][0])
-          + deltaF[1][0];  
-        Force[1][1]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][1]-position[1][1])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][1]-position[1][1])
-          + deltaF[1][1];  
-        Force[1][2]= (tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1])*(position[0][2]-position[1][2])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0])*(position[2][2]-position[1][2])
-          + deltaF[1][2];  
-        
-        Force[2][0]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][0]-position[2][0])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][0]-position[2][0])
-          + deltaF[2][0];  
-        Force[2][1]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][1]-position[2][1])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][1]-position[2][1])
-          + deltaF[2][1];  
-        Force[2][2]= (tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1])*(position[0][2]-position[2][2])
-          +(tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2])*(position[1][2]-position[2][2])
-          + deltaF[2][2];  
+        double Force[3][3];
+        TRBS::force(E,&Delta[0],position,deltaF,Force);
         
         // std::cerr << "Forces (cell " << cellIndex << "):" << std::endl 
         // 	      << Force[0][0] << " " << Force[0][1] << " " << Force[0][2] << std::endl
@@ -9841,6 +8286,13 @@ derivs(Tissue &T,
   }      
 }     
 
+void VertexFromTRBScenterTriangulationConcentrationHillMT::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+  A.write(ReactionAccess::vertexDerivs);
+}
+
 
 void VertexFromTRBScenterTriangulationConcentrationHillMT::
 initiate(Tissue &T,
@@ -10057,6 +8509,12 @@ void FiberModel::update(Tissue &T,
   }
 }
 
+void FiberModel::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 FiberDeposition::FiberDeposition(std::vector<double> &paraValue,
 				     std::vector< std::vector<size_t> > &indValue)
 {
@@ -10272,6 +8730,12 @@ void FiberDeposition::update(Tissue &T,
 
 }
 
+void FiberDeposition::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 VertexFromTRBScenterTriangulationMTOpt::
 VertexFromTRBScenterTriangulationMTOpt(std::vector<double> &paraValue, 
                                     std::vector< std::vector<size_t> > 
@@ -10362,8 +8826,16 @@ VertexFromTRBScenterTriangulationMTOpt(std::vector<double> &paraValue,
               << " poisson ratio must be 0 <= p < 0.5 " << std::endl;
     exit(0);
   }
-  
-  
+
+  // Instantiation of derivs() for the material anisotropy
+  typedef VertexFromTRBScenterTriangulationMTOpt MTOpt;
+  size_t anisoFlag = parameter(5);
+  if( anisoFlag==1 ) // from fiber model
+    derivs_ = &MTOpt::derivsPolicy<TRBS::ModelFiber>;
+  else if( anisoFlag==0 ) // constant anisotropy
+    derivs_ = &MTOpt::derivsPolicy<TRBS::ConstantFiber>;
+  else
+    derivs_ = &MTOpt::derivsPolicy<TRBS::UnitFiber>;
 }
 
 
@@ -10415,8 +8887,9 @@ void VertexFromTRBScenterTriangulationMTOpt::initiate(Tissue &T,
 
 
 
+template<class Fiber>
 void VertexFromTRBScenterTriangulationMTOpt::
-derivs(Tissue &T,
+derivsPolicy(Tissue &T,
        DataMatrix &cellData,
        DataMatrix &wallData,
        DataMatrix &vertexData,
@@ -10448,15 +8921,14 @@ derivs(Tissue &T,
 
   
 
-  double youngMatrix= parameter(0);    
-  double youngFiber = parameter(1); 
   double poissonL   = parameter(2);    
   double poissonT   = parameter(3);
   double pressure   = parameter(4);  
   double posStep    = 0;
-  size_t anisoFlag  = parameter(5);  
   double anStep     = parameter(6);  
   double tetStep    = parameter(7);  
+  Fiber fiber(parameter(0),parameter(1),youngLIndex,youngLIndex);
+  TRBS::Element E;
   //double temp0      = parameter(8);  
   //double tempRate   = parameter(9);  
   //double stepRate   = parameter(10);  
@@ -10496,16 +8968,18 @@ derivs(Tissue &T,
   // evaluate the overal energy
   double TMPtotalEnergy=0;
   double anEn=0,isEn=0,pressEn=0;
+  // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+  const TissueTopology &topology = T.topology();
   for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
-    size_t numWalls = T.cell(cellIndex).numWall();
+    size_t numWalls = topology.numCellWall(cellIndex);
   
   
 
-    if(  T.cell(cellIndex).numVertex()!= numWalls ) {
+    if(  topology.numCellVertex(cellIndex)!= numWalls ) {
       
       std::cerr << "VertexFromTRBScenterTriangulationMTOpt::derivs() same number of vertices and walls."
-		<< " Not for cells with " << T.cell(cellIndex).numWall() << " walls and "
-		<< T.cell(cellIndex).numVertex() << " vertices!"	
+		<< " Not for cells with " << topology.numCellWall(cellIndex) << " walls and "
+		<< topology.numCellVertex(cellIndex) << " vertices!"	
 		<< std::endl;
       exit(-1);
     }
@@ -10513,33 +8987,13 @@ derivs(Tissue &T,
   
    
 
-    double youngL=1;
-    double youngT=1;
-    
-    if(anisoFlag==1){
-      youngL = cellData[cellIndex][youngLIndex]; // from fiber model 
-      youngT = 2*youngMatrix+youngFiber-youngL;
-    } 
-
-
-    if(anisoFlag==0){// constant anisotropy
-      youngL = youngMatrix+youngFiber;
-      youngT = youngMatrix;
-      //cellData[cellIndex][youngLIndex]=youngL;
-
-    } 
-
-
-      
-  
+    double youngL, youngT;
+    fiber.modulus(cellData,cellIndex,youngL,youngT);
 
-    double lambdaL, mioL, lambdaT, mioT; // ,lambdaTmatrix, mioTmatrix;
-    
     // Lame coefficients based on plane stress (for 3D 0<poisson<0.5)
-    lambdaL=youngL*poissonL/(1-poissonL*poissonL);
-    mioL=youngL/(2*(1+poissonL));
-    lambdaT=youngT*poissonT/(1-poissonT*poissonT);
-    mioT=youngT/(2*(1+poissonT));
+    double lambdaL, mioL, lambdaT, mioT;
+    TRBS::shearLame(youngL,poissonL,false,lambdaL,mioL);
+    TRBS::shearLame(youngT,poissonT,false,lambdaT,mioT);
     
     //HJ: removed due to unused variable 
     //double StrainCellGlobal[3][3]={{0,0,0},{0,0,0},{0,0,0}};
@@ -10571,10 +9025,10 @@ derivs(Tissue &T,
         
       size_t kPlusOneMod = (wallindex+1)%numWalls;
       //size_t v1 = com;
-      size_t v2 = T.cell(cellIndex).vertex(wallindex)->index();
-      size_t v3 = T.cell(cellIndex).vertex(kPlusOneMod)->index();
+      size_t v2 = topology.cellVertex(cellIndex,wallindex);
+      size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
       //size_t w1 = internal wallindex
-      size_t w2 = T.cell(cellIndex).wall(wallindex)->index();
+      size_t w2 = topology.cellWall(cellIndex,wallindex);
       //size_t w3 = internal wallindex+1
 
 
@@ -10621,7 +9075,7 @@ derivs(Tissue &T,
                      
       pressEnergy=-pressure*std::abs(volume);
 
-      double restingLength[3];
+      double *restingLength = E.restingLength;
       
       
       // single resting length
@@ -10636,7 +9090,7 @@ derivs(Tissue &T,
                      (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
                      (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) ),
           
-          T.wall(w2).lengthFromVertexPosition(vertexData),
+          topology.wallLength(w2,vertexData),
           
           std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
                      (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
@@ -10644,40 +9098,10 @@ derivs(Tissue &T,
         };
       
       
-      // Area of the element (using Heron's formula)                                      
-      double restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
-                                    (-restingLength[0]+restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]-restingLength[1]+restingLength[2])*
-                                    ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
-      
-      //double currentArea=std::sqrt( ( length[0]+length[1]+length[2])*
-      //                              (-length[0]+length[1]+length[2])*
-      //                              ( length[0]-length[1]+length[2])*
-      //                              ( length[0]+length[1]-length[2])  )*0.25;
-
-      
-
-      double cosAngle[3]=
-        { (  (restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]
-              -restingLength[1]*restingLength[1])/
-             (restingLength[0]*restingLength[2]*2)    ),
-
-          (  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]
-              -restingLength[2]*restingLength[2])/
-             (restingLength[0]*restingLength[1]*2)    ),
-
-          (  (restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]
-              -restingLength[0]*restingLength[0])/
-             (restingLength[1]*restingLength[2]*2)    )
-        };
-      
-      //HJ: removed due to unused variable
-      //double temp = 1.0/(restingArea*16);                                      
-      double cotan[3]=
-        { cosAngle[0]/std::sqrt(1-cosAngle[0]*cosAngle[0]),
-          cosAngle[1]/std::sqrt(1-cosAngle[1]*cosAngle[1]),
-          cosAngle[2]/std::sqrt(1-cosAngle[2]*cosAngle[2])
-        };
+      TRBS::restingShape(E);
+      TRBS::cosineCotan(E);
+      double restingArea = E.restingArea;
+      const double *cotan = E.cotan;
       
       
       //the force is calculated based on Transverse coefficients
@@ -11008,6 +9432,18 @@ derivs(Tissue &T,
 
 
 
+void VertexFromTRBScenterTriangulationMTOpt::
+derivs(Tissue &T,
+       DataMatrix &cellData,
+       DataMatrix &wallData,
+       DataMatrix &vertexData,
+       DataMatrix &cellDerivs,
+       DataMatrix &wallDerivs,
+       DataMatrix &vertexDerivs )
+{
+  (this->*derivs_)(T,cellData,wallData,vertexData,cellDerivs,wallDerivs,vertexDerivs);
+}
+
 void VertexFromTRBScenterTriangulationMTOpt::update(Tissue &T,
                         DataMatrix &cellData,
                         DataMatrix &wallData,
@@ -63,6 +63,40 @@ class VertexFromTRBS : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares the wall resting lengths and vertex columns accessed
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
+  ///
+  /// @brief Derivative function on the index based Geometry
+  ///
+  /// Same update as derivs(Tissue&,...), with the wall (edge) lengths
+  /// calculated once per edge.
+  ///
+  /// @see BaseReaction::geometryDerivs()
+  ///
+  int geometryDerivs(const Geometry &G,
+		     const GeometryState &state,
+		     GeometryState &derivs);
+  ///
+  /// @brief Adds the analytic Jacobian of the vertex update
+  ///
+  /// The update of vertex a is @f$ \sum_b c_{ab}(x_b-x_a) @f$, where the
+  /// coefficients are linear in the biquadratic strains
+  /// @f$ \Delta_k = l_k^2-L_k^2 @f$ with stiffnesses only depending on the
+  /// resting lengths, such that the element blocks follow from
+  /// @f$ \partial \Delta_k/\partial x_p = 2(x_p-x_q) @f$ for the wall
+  /// k=(p,q).
+  ///
+  /// @see BaseReaction::vertexJacobian()
+  ///
+  int vertexJacobian(Tissue &T,
+		     DataMatrix &cellData,
+		     DataMatrix &wallData,
+		     DataMatrix &vertexData,
+		     VertexJacobian &J);
 };
 
 ///
@@ -124,6 +158,12 @@ class VertexFromTRBScenterTriangulation : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   ///
   /// @brief Reaction initiation applied before simulation starts
@@ -317,6 +357,12 @@ class VertexFromTRBSMT : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 
@@ -414,6 +460,36 @@ private:
   
   double timeC=0;
   bool lengthout=false;
+  typedef void (VertexFromTRBScenterTriangulationMT::*DerivsFunction)
+    (Tissue &,DataMatrix &,DataMatrix &,DataMatrix &,
+     DataMatrix &,DataMatrix &,DataMatrix &);
+  typedef void (VertexFromTRBScenterTriangulationMT::*UpdateFunction)
+    (Tissue &,DataMatrix &,DataMatrix &,DataMatrix &,double);
+  ///
+  /// @brief Instantiations for the fiber model (parameter(4)), MT direction
+  /// (parameter(9)) and resting lengths (parameter(10)) set in the constructor
+  ///
+  DerivsFunction derivs_;
+  UpdateFunction update_;
+
+  template<class Direction,class RestingLength>
+  void selectFiber();
+  template<class Fiber,class Direction,class RestingLength>
+  void selectPolicy();
+  template<class Fiber,class Direction,class RestingLength>
+  void derivsPolicy(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    DataMatrix &cellDerivs,
+		    DataMatrix &wallDerivs,
+		    DataMatrix &vertexDerivs );
+  template<class Fiber,class Direction,class RestingLength>
+  void updatePolicy(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    double h);
 
  public:
   ///
@@ -443,6 +519,12 @@ private:
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   ///
   /// @brief Reaction initiation applied before simulation starts
@@ -556,7 +638,25 @@ private:
 class VertexFromTRLScenterTriangulationMT : public BaseReaction {
 private:
   
-  
+  typedef void (VertexFromTRLScenterTriangulationMT::*DerivsFunction)
+    (Tissue &,DataMatrix &,DataMatrix &,DataMatrix &,
+     DataMatrix &,DataMatrix &,DataMatrix &);
+  ///
+  /// @brief Instantiation for the fiber model (parameter(4)), MT direction
+  /// (parameter(9)) and resting lengths (parameter(10)) set in the constructor
+  ///
+  DerivsFunction derivs_;
+
+  template<class Direction,class RestingLength>
+  void selectFiber();
+  template<class Fiber,class Direction,class RestingLength>
+  void derivsPolicy(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    DataMatrix &cellDerivs,
+		    DataMatrix &wallDerivs,
+		    DataMatrix &vertexDerivs );
   
  public:
   ///
@@ -586,6 +686,12 @@ private:
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   ///
   /// @brief Reaction initiation applied before simulation starts
@@ -675,6 +781,12 @@ class VertexFromTRBScenterTriangulationConcentrationHillMT : public BaseReaction
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 
   ///
   /// @brief Reaction initiation applied before simulation starts
@@ -760,6 +872,12 @@ public:
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
   ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
+  ///
   /// @brief Update function for this reaction class
   ///
   /// @see BaseReaction::update(Tissue &T,...)
@@ -845,6 +963,12 @@ public:
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
   ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
+  ///
   /// @brief Update function for this reaction class
   ///
   /// @see BaseReaction::update(Tissue &T,...)
@@ -892,6 +1016,23 @@ private:
   std::vector<std::vector<std::vector<double> > > stateVector;
   double totalEnergy;
   double mechIsEn, mechAnEn, PEn;
+  typedef void (VertexFromTRBScenterTriangulationMTOpt::*DerivsFunction)
+    (Tissue &,DataMatrix &,DataMatrix &,DataMatrix &,
+     DataMatrix &,DataMatrix &,DataMatrix &);
+  ///
+  /// @brief Instantiation for the material anisotropy (parameter(5)) set in
+  /// the constructor
+  ///
+  DerivsFunction derivs_;
+
+  template<class Fiber>
+  void derivsPolicy(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    DataMatrix &cellDerivs,
+		    DataMatrix &wallDerivs,
+		    DataMatrix &vertexDerivs );
 public:
   ///
   /// @brief Main constructor
@@ -38,7 +38,7 @@ namespace MembraneCycling {
 /// wi_PIN 
 /// @endverbatim
 ///
-class Constant : public BaseReaction {
+class Constant : public BaseChemicalReaction {
   
  public:
   
@@ -79,7 +79,7 @@ class Constant : public BaseReaction {
 /// wi_PIN 
 /// @endverbatim
 ///
-class CrossMembraneNonLinear : public BaseReaction {
+class CrossMembraneNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -117,7 +117,7 @@ class CrossMembraneNonLinear : public BaseReaction {
 ///  wi_PIN 
 /// @endverbatim
 ///
-class CrossMembraneLinear : public BaseReaction {
+class CrossMembraneLinear : public BaseChemicalReaction {
   
  public:
   
@@ -155,7 +155,7 @@ class CrossMembraneLinear : public BaseReaction {
 /// wi_X  Wi_PIN 
 /// @endverbatim
 ///
-class LocalWallFeedbackNonLinear : public BaseReaction {
+class LocalWallFeedbackNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -192,7 +192,7 @@ class LocalWallFeedbackNonLinear : public BaseReaction {
 /// wi_X  wi_PIN
 /// @endverbatim
 ///
-class LocalWallFeedbackLinear : public BaseReaction {
+class LocalWallFeedbackLinear : public BaseChemicalReaction {
   
  public:
   
@@ -232,7 +232,7 @@ class LocalWallFeedbackLinear : public BaseReaction {
 /// wi_PIN 
 /// @endverbatim
 ///
-class CellUpTheGradientNonLinear : public BaseReaction {
+class CellUpTheGradientNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -271,7 +271,7 @@ class CellUpTheGradientNonLinear : public BaseReaction {
 /// wi_PIN 
 /// @endverbatim
 ///
-class CellUpTheGradientLinear : public BaseReaction {
+class CellUpTheGradientLinear : public BaseChemicalReaction {
   
  public:
   
@@ -321,7 +321,7 @@ class CellUpTheGradientLinear : public BaseReaction {
 /// wi_PIN 
 /// @endverbatim
 ///
-class InternalCellNonLinear : public BaseReaction {
+class InternalCellNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -360,7 +360,7 @@ class InternalCellNonLinear : public BaseReaction {
 /// wi_PIN 
 /// @endverbatim
 ///
-class InternalCellLinear : public BaseReaction {
+class InternalCellLinear : public BaseChemicalReaction {
   
  public:
   
@@ -404,7 +404,7 @@ class InternalCellLinear : public BaseReaction {
 ///  wi_PIN 
 /// @endverbatim
 ///
-class CellFluxExocytosis : public BaseReaction {
+class CellFluxExocytosis : public BaseChemicalReaction {
   
  public:
   
@@ -447,7 +447,7 @@ class CellFluxExocytosis : public BaseReaction {
 /// wi_PIN  
 /// @endverbatim
 ///
-class PINFeedbackNonLinear : public BaseReaction {
+class PINFeedbackNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -485,7 +485,7 @@ class PINFeedbackNonLinear : public BaseReaction {
 /// wi_PIN
 /// @endverbatim
 ///
-class PINFeedbackLinear : public BaseReaction {
+class PINFeedbackLinear : public BaseChemicalReaction {
   
  public:
   
@@ -42,7 +42,7 @@ namespace MembraneCyclingAll {
 /// wi_PIN 
 /// @endverbatim
 ///
-class Constant : public BaseReaction {
+class Constant : public BaseChemicalReaction {
   
  public:
   
@@ -77,7 +77,7 @@ class Constant : public BaseReaction {
 /// wi_X  Wi_PIN 
 /// @endverbatim
 ///
-class LocalWallFeedbackNonLinear : public BaseReaction {
+class LocalWallFeedbackNonLinear : public BaseChemicalReaction {
   
  public:
   
@@ -114,7 +114,7 @@ class LocalWallFeedbackNonLinear : public BaseReaction {
 /// @endverbatim
 ///
 
-class LocalWallFeedbackNonLinearInhibition : public BaseReaction {
+class LocalWallFeedbackNonLinearInhibition : public BaseChemicalReaction {
   
  public:
   
@@ -36,6 +36,9 @@ typedef struct {
 /// before exiting (note you have to exit with mySignal::myExit() in
 /// order for this to work)
 ///
+/// <li> @b -debug_steps num - Number of configurations kept for
+/// -debug_output (see StateHistory).
+///
 /// <li> @b -parameter_input file - Reads parameter values from file replacing
 /// those values read in the model file.
 ///
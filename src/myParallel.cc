@@ -0,0 +1,144 @@
+//
+// Filename     : myParallel.cc
+// Description  : Defining functions for simple thread parallel loops
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "myParallel.h"
+
+namespace {
+  size_t numThreadValue = 1;
+  
+  ///
+  /// @brief Threads waiting for the tasks of runTasks()
+  ///
+  class WorkerPool {
+  public:
+    void run(size_t numTask, const std::function<void(size_t)> &task);
+    
+  private:
+    void start(size_t numWorker);
+    void stop();
+    void work();
+    
+    std::vector<std::thread> worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    const std::function<void(size_t)> *task_ = 0;
+    size_t numTask_ = 0, nextTask_ = 0, numDone_ = 0;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+  };
+  
+  // Set in the threads while running tasks (nested loops are run serially)
+  thread_local bool inTask = false;
+  std::mutex runMutex;
+  
+  WorkerPool &pool()
+  {
+    // Never destroyed, such that exit() from a task does not join threads
+    static WorkerPool *p = new WorkerPool;
+    return *p;
+  }
+  
+  void WorkerPool::run(size_t numTask, const std::function<void(size_t)> &task)
+  {
+    std::unique_lock<std::mutex> runLock(runMutex,std::try_to_lock);
+    if( inTask || !runLock.owns_lock() ) {
+      for( size_t t=0 ; t<numTask ; ++t )
+	task(t);
+      return;
+    }
+    if( worker_.size()+1!=numThreadValue ) {
+      stop();
+      start(numThreadValue-1);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      numTask_ = numTask;
+      nextTask_ = numDone_ = 0;
+      ++generation_;
+    }
+    wake_.notify_all();
+    // The calling thread takes tasks as well
+    inTask = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while( nextTask_<numTask_ ) {
+      size_t t = nextTask_++;
+      lock.unlock();
+      task(t);
+      lock.lock();
+      ++numDone_;
+    }
+    inTask = false;
+    done_.wait(lock,[this]() { return numDone_==numTask_; });
+    task_ = 0;
+  }
+  
+  void WorkerPool::start(size_t numWorker)
+  {
+    for( size_t w=0 ; w<numWorker ; ++w )
+      worker_.push_back( std::thread( [this]() { work(); } ) );
+  }
+  
+  void WorkerPool::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for( size_t w=0 ; w<worker_.size() ; ++w )
+      worker_[w].join();
+    worker_.clear();
+    stop_ = false;
+  }
+  
+  void WorkerPool::work()
+  {
+    inTask = true;
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(;;) {
+      wake_.wait(lock,[this,&seen]() { return stop_ || generation_!=seen; });
+      if( stop_ )
+	return;
+      seen = generation_;
+      while( nextTask_<numTask_ ) {
+	size_t t = nextTask_++;
+	lock.unlock();
+	(*task_)(t);
+	lock.lock();
+	if( ++numDone_==numTask_ )
+	  done_.notify_one();
+      }
+    }
+  }
+}
+
+size_t myParallel::numThread()
+{
+  return numThreadValue;
+}
+
+void myParallel::setNumThread(size_t value)
+{
+  if( !value ) {
+    value = std::thread::hardware_concurrency();
+    if( !value )
+      value = 1;
+  }
+  numThreadValue = value;
+}
+
+void myParallel::runTasks(size_t numTask, const std::function<void(size_t)> &task)
+{
+  pool().run(numTask,task);
+}
@@ -0,0 +1,73 @@
+//
+// Filename     : myParallel.h
+// Description  : Defining namespace for simple thread parallel loops
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef MYPARALLEL_H
+#define MYPARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+///
+/// @brief Namespace with functions for running loops over threads
+///
+/// The number of threads is set once (e.g. from the -threads option of the
+/// simulator) and defaults to one, in which case all loops are run serially
+/// in the calling thread. Otherwise the loops are run by a pool of worker
+/// threads that is started at the first parallel loop and kept for the
+/// rest of the run.
+///
+namespace myParallel {
+  
+  ///
+  /// @brief Returns the number of threads used by forEach()
+  ///
+  size_t numThread();
+  
+  ///
+  /// @brief Sets the number of threads used by forEach() (0 uses the number
+  /// of hardware threads)
+  ///
+  void setNumThread(size_t value);
+  
+  ///
+  /// @brief Runs task(t) for all t in [0,numTask) on the worker pool and the
+  /// calling thread, and returns when all are finished
+  ///
+  /// Calls from within a task, or while another thread uses the pool, are
+  /// run serially in the calling thread.
+  ///
+  void runTasks(size_t numTask, const std::function<void(size_t)> &task);
+  
+  ///
+  /// @brief Calls f(i) for all i in [begin,end) divided in contiguous
+  /// chunks over numThread() threads
+  ///
+  /// The calls for different i have to be independent. The function returns
+  /// when all calls are finished.
+  ///
+  template<class Function>
+  void forEach(size_t begin, size_t end, Function f)
+  {
+    size_t n = end>begin ? end-begin : 0;
+    size_t numT = numThread();
+    if( numT>n )
+      numT = n;
+    if( numT<=1 ) {
+      for( size_t i=begin ; i<end ; ++i )
+	f(i);
+      return;
+    }
+    size_t chunk = n/numT, rest = n%numT;
+    runTasks(numT, [begin,chunk,rest,&f](size_t t) {
+	size_t start = begin+t*chunk+(t<rest ? t : rest);
+	size_t stop = start+chunk+(t<rest ? 1 : 0);
+	for( size_t i=start ; i<stop ; ++i )
+	  f(i); } );
+  }
+}
+
+#endif /* MYPARALLEL_H */
@@ -17,6 +17,20 @@ void mySignal::addSolver(BaseSolver *S)
   signal(SIGHUP,  solverSignalHandler); // Close terminal window
   //  signal(SIGQUIT, solverSignalHandler);
   signal(SIGTERM, solverSignalHandler); // kill  
+  // Crashes (to write the debug states, only with -debug_output). The
+  // default action is restored when the handler is entered, and the signal
+  // is raised again after the output, such that core dumps and the exit
+  // status are kept. Note that the output is not async-signal-safe and is
+  // only a best effort.
+  if (S->debugFlag()) {
+    struct sigaction action;
+    action.sa_handler = solverSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND | SA_NODEFER;
+    sigaction(SIGSEGV, &action, 0);
+    sigaction(SIGFPE,  &action, 0);
+    sigaction(SIGABRT, &action, 0); // failed assertions
+  }
   solvers.push_back(S); 
 }
 
@@ -39,15 +53,26 @@ void mySignal::solverSignalHandler(int signal)
 		case SIGTERM:
 			std::cerr << "SIGTERM";
 			break;
+		case SIGSEGV:
+			std::cerr << "SIGSEGV";
+			break;
+		case SIGFPE:
+			std::cerr << "SIGFPE";
+			break;
+		case SIGABRT:
+			std::cerr << "SIGABRT";
+			break;
 		default:
 			std::cerr << "default";	
   }
   std::cerr << std::endl;
 	// Bad design. You can add more than one solver, but they will all
 	// overwrite the same file.
+	bool fatal = signal==SIGSEGV || signal==SIGFPE || signal==SIGABRT;
   for (i=0; i<solvers.size(); i++) {
 		std::string fileName;
-		fileName = myConfig::getValue("init_output", 0);
+		// The state may be corrupted after a crash, and the init file is kept
+		fileName = fatal ? std::string() : myConfig::getValue("init_output", 0);
 		if(!fileName.empty()) {
 			std::ofstream OUT(fileName.c_str());
 			if (!OUT) {
@@ -71,5 +96,7 @@ void mySignal::solverSignalHandler(int signal)
 			}
 		}
 	}
+	if (fatal)
+		raise(signal); // default action (SA_RESETHAND, not blocked by SA_NODEFER)
 	exit(EXIT_FAILURE);
 }
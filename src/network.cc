@@ -7,6 +7,7 @@
 //
 #include "network.h"
 #include "baseReaction.h"
+#include "reactionSchedule.h"
 
 AuxinModelSimple1::
 AuxinModelSimple1(std::vector<double> &paraValue, 
@@ -150,6 +151,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModelSimple1::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 AuxinModel1::
 AuxinModel1(std::vector<double> &paraValue, 
 	    std::vector< std::vector<size_t> > 
@@ -297,6 +304,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModel1::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 AuxinModel1S::
 AuxinModel1S(std::vector<double> &paraValue, 
 	    std::vector< std::vector<size_t> > 
@@ -473,6 +486,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModel1S::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 AuxinModelStress::
 AuxinModelStress(std::vector<double> &paraValue, 
 		       std::vector< std::vector<size_t> > 
@@ -767,6 +786,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModelSimpleStress::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 AuxinModelSimple1Wall::
 AuxinModelSimple1Wall(std::vector<double> &paraValue, 
 		      std::vector< std::vector<size_t> > 
@@ -3934,6 +3959,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModelSimple4::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 AuxinModelSimple5::
 AuxinModelSimple5(std::vector<double> &paraValue, 
 		  std::vector< std::vector<size_t> > 
@@ -4066,6 +4097,12 @@ derivs(Tissue &T,
   }
 }
 
+void AuxinModelSimple5::
+access(ReactionAccess &A) const
+{
+  A.setExclusive();
+}
+
 
 
 
@@ -16,7 +16,7 @@
 ///
 /// @brief A stress-based PIN1 and MT polarization model
 ///
-class AuxinModelStress : public BaseReaction {
+class AuxinModelStress : public BaseChemicalReaction {
   
  public:
   
@@ -80,6 +80,12 @@ class AuxinModelSimple1 : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -139,6 +145,12 @@ class AuxinModel1 : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -202,6 +214,12 @@ class AuxinModel1S : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -226,7 +244,7 @@ class AuxinModel1S : public BaseReaction {
 /// to come...
 /// @endverbatim
 ///
-class AuxinModelSimple1Wall : public BaseReaction {
+class AuxinModelSimple1Wall : public BaseChemicalReaction {
   
  public:
   
@@ -287,6 +305,12 @@ class AuxinModelSimpleStress : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -307,7 +331,7 @@ class AuxinModelSimpleStress : public BaseReaction {
 /// In addition, the column index for auxin, PIN, AUX1, PID, X, 
 /// and M should be given in a model file.
 ///
-class AuxinModelSimple2 : public BaseReaction {
+class AuxinModelSimple2 : public BaseChemicalReaction {
   
  public:
   
@@ -342,7 +366,7 @@ class AuxinModelSimple2 : public BaseReaction {
 /// In addition to the parameter values, the column index for auxin, PIN, AUX1, PID, X, 
 /// and M should be given in the model file.
 ///
-class AuxinModelSimple3 : public BaseReaction {
+class AuxinModelSimple3 : public BaseChemicalReaction {
   
  public:
   
@@ -359,7 +383,7 @@ class AuxinModelSimple3 : public BaseReaction {
 	      DataMatrix &vertexDerivs );
 };
 
-class AuxinModel4 : public BaseReaction {
+class AuxinModel4 : public BaseChemicalReaction {
   
  public:
   
@@ -376,7 +400,7 @@ class AuxinModel4 : public BaseReaction {
 	      DataMatrix &vertexDerivs );
 };
 
-class AuxinModel5 : public BaseReaction {
+class AuxinModel5 : public BaseChemicalReaction {
   
  public:
   
@@ -393,7 +417,7 @@ class AuxinModel5 : public BaseReaction {
 	      DataMatrix &vertexDerivs );
 };
 
-class AuxinModel6 : public BaseReaction {
+class AuxinModel6 : public BaseChemicalReaction {
   
  public:
   
@@ -410,7 +434,7 @@ class AuxinModel6 : public BaseReaction {
 	      DataMatrix &vertexDerivs );
 };
 
-class AuxinModel7 : public BaseReaction {
+class AuxinModel7 : public BaseChemicalReaction {
   
  public:
   
@@ -427,7 +451,7 @@ class AuxinModel7 : public BaseReaction {
 	      DataMatrix &vertexDerivs );
 };
 
-class AuxinTransportCellCellNoGeometry : public BaseReaction {
+class AuxinTransportCellCellNoGeometry : public BaseChemicalReaction {
   
  public:
   
@@ -473,7 +497,7 @@ class AuxinTransportCellCellNoGeometry : public BaseReaction {
 /// wi_auxin wi_PIN
 /// @endverbatim
 ///
-class AuxinWallModel : public BaseReaction {
+class AuxinWallModel : public BaseChemicalReaction {
   
  public:
   
@@ -523,7 +547,7 @@ class AuxinWallModel : public BaseReaction {
 /// wi_auxin wi_PIN wi_ROP
 /// @endverbatim
 ///
-class AuxinROPModel : public BaseReaction {
+class AuxinROPModel : public BaseChemicalReaction {
   
  public:
   
@@ -571,7 +595,7 @@ class AuxinROPModel : public BaseReaction {
 /// wi_auxin wi_PIN wi_ROP
 /// @endverbatim
 ///
-class AuxinROPModel2 : public BaseReaction {
+class AuxinROPModel2 : public BaseChemicalReaction {
 
   public:
 
@@ -619,7 +643,7 @@ class AuxinROPModel2 : public BaseReaction {
 /// wi_auxin wi_PIN wi_ROP
 /// @endverbatim
 ///
-class AuxinROPModel3 : public BaseReaction {
+class AuxinROPModel3 : public BaseChemicalReaction {
   
  public:
   
@@ -661,7 +685,7 @@ class AuxinROPModel3 : public BaseReaction {
 /// wi_auxin wi_PIN
 /// @endverbatim
 ///
-class AuxinPINBistabilityModel : public BaseReaction {
+class AuxinPINBistabilityModel : public BaseChemicalReaction {
   
  public:
   
@@ -701,7 +725,7 @@ class AuxinPINBistabilityModel : public BaseReaction {
 /// wi_PIN
 /// @endverbatim
 ///
-class AuxinPINBistabilityModelCell : public BaseReaction {
+class AuxinPINBistabilityModelCell : public BaseChemicalReaction {
   
  public:
   
@@ -748,7 +772,7 @@ class AuxinPINBistabilityModelCell : public BaseReaction {
 ///
 /// @note PIN is allowed to diffuse in the membrane.
 ///
-class AuxinExoBistability : public BaseReaction {
+class AuxinExoBistability : public BaseChemicalReaction {
   
  public:
   
@@ -873,7 +897,7 @@ class AuxinPINBistabilityInfluxModel : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel : public BaseReaction {
+class SimpleROPModel : public BaseChemicalReaction {
   
  public:
   
@@ -917,7 +941,7 @@ class SimpleROPModel : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel2 : public BaseReaction {
+class SimpleROPModel2 : public BaseChemicalReaction {
   
  public:
   
@@ -961,7 +985,7 @@ class SimpleROPModel2 : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel3 : public BaseReaction {
+class SimpleROPModel3 : public BaseChemicalReaction {
   
  public:
   
@@ -1008,7 +1032,7 @@ class SimpleROPModel3 : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel4 : public BaseReaction {
+class SimpleROPModel4 : public BaseChemicalReaction {
   
  public:
   
@@ -1057,7 +1081,7 @@ class SimpleROPModel4 : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel5 : public BaseReaction {
+class SimpleROPModel5 : public BaseChemicalReaction {
   
  public:
   
@@ -1105,7 +1129,7 @@ class SimpleROPModel5 : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel6 : public BaseReaction {
+class SimpleROPModel6 : public BaseChemicalReaction {
   
  public:
   
@@ -1152,7 +1176,7 @@ class SimpleROPModel6 : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class SimpleROPModel7 : public BaseReaction {
+class SimpleROPModel7 : public BaseChemicalReaction {
   
  public:
   
@@ -1220,6 +1244,12 @@ class AuxinModelSimple4 : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 
 ///
@@ -1266,12 +1296,18 @@ class AuxinModelSimple5 : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Declares exclusive access since tissue data is updated in derivs()
+  ///
+  /// @see BaseReaction::access()
+  ///
+  void access(ReactionAccess &A) const;
 };
 ///
 /// @brief A cell-wall based auxin transport model including PINs with down the inernal gradient. Here PIN exocytosis does depend on auxin in neighbouring wall compartment.
 /// Documantation to follow
 
-class UpInternalGradientModel : public BaseReaction {
+class UpInternalGradientModel : public BaseChemicalReaction {
   
  public:
   
@@ -1293,7 +1329,7 @@ class UpInternalGradientModel : public BaseReaction {
 /// @brief A cell-wall based auxin transport model including PINs with down the inernal gradient. Here PIN exocytosis does depend on auxin in neighbouring wall compartment.
 /// Documantation to follow
 
-class DownInternalGradientModel : public BaseReaction {
+class DownInternalGradientModel : public BaseChemicalReaction {
   
  public:
   
@@ -1316,7 +1352,7 @@ class DownInternalGradientModel : public BaseReaction {
 /// @brief A cell-wall based auxin transport model including PINs with down the inernal gradient. Here PIN exocytosis does depend on auxin in neighbouring wall compartment.
 /// Documantation to follow
 
-class UpExternalGradientModel : public BaseReaction {
+class UpExternalGradientModel : public BaseChemicalReaction {
   
  public:
   
@@ -1340,7 +1376,7 @@ class UpExternalGradientModel : public BaseReaction {
 /// @brief A cell-wall based auxin transport model including PINs with down the inernal gradient. Here PIN exocytosis does depend on auxin in neighbouring wall compartment.
 /// Documantation to follow
 
-class DownInternalGradientModelSingleCell : public BaseReaction {
+class DownInternalGradientModelSingleCell : public BaseChemicalReaction {
   
  public:
   
@@ -1385,7 +1421,7 @@ class DownInternalGradientModelSingleCell : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class AuxinFluxModel : public BaseReaction {
+class AuxinFluxModel : public BaseChemicalReaction {
   
  public:
   
@@ -1429,7 +1465,7 @@ class AuxinFluxModel : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class IntracellularPartitioning : public BaseReaction {
+class IntracellularPartitioning : public BaseChemicalReaction {
   
  public:
   
@@ -1472,7 +1508,7 @@ class IntracellularPartitioning : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class IntracellularCoupling : public BaseReaction {
+class IntracellularCoupling : public BaseChemicalReaction {
   
  public:
   
@@ -1515,7 +1551,7 @@ class IntracellularCoupling : public BaseReaction {
 /// wi_auxin wi_PIN 
 /// @endverbatim
 ///
-class IntracellularIndirectCoupling : public BaseReaction {
+class IntracellularIndirectCoupling : public BaseChemicalReaction {
   
  public:
   
@@ -1539,7 +1575,7 @@ class IntracellularIndirectCoupling : public BaseReaction {
 /// @brief A cell-wall based auxin transport model including PINs with down the internal gradient. Here PIN exocytosis does depend on auxin in neighbouring wall compartment. includes gemoetric considerations
 /// Documantation to follow
 
-class DownInternalGradientModelGeometric : public BaseReaction {
+class DownInternalGradientModelGeometric : public BaseChemicalReaction {
   
  public:
   
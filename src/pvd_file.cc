@@ -5,6 +5,9 @@
 //
 #include "pvd_file.h"
 #include "VTUostream.h"
+#include "tissue.h"
+#include "myParallel.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <stdio.h>
@@ -135,6 +138,178 @@ void PVD_file::writeTwoWall ( Tissue const& t, const std::string vtu_filename1,
     out.close();
 }
 //----------------------------------------------------------------------------
+namespace
+{
+// Name of piece 'p' of a vtu file, e.g. VTK_cells000001.vtu -> VTK_cells000001_2.vtu
+std::string pieceFilename ( std::string const& filename, size_t p )
+{
+    std::ostringstream name;
+    size_t pos = filename.find_last_of ( "." );
+    name << filename.substr ( 0, pos ) << "_" << p << filename.substr ( pos );
+    return name.str();
+}
+// Recursive coordinate bisection: splits [begin,end) along the direction of
+// largest extent of the cell centers with sizes proportional to the number
+// of pieces on each side
+void bisectCells ( std::vector< std::vector<double> > const& center, std::vector<size_t>::iterator begin,
+                   std::vector<size_t>::iterator end, size_t n_piece, std::vector< std::vector<size_t> >& pieces )
+{
+    if ( n_piece == 1 )
+    {
+        pieces.push_back ( std::vector<size_t> ( begin, end ) );
+        std::sort ( pieces.back().begin(), pieces.back().end() );
+        return;
+    }
+    size_t dimension = center[*begin].size(), dim = 0;
+    double max_extent = -1.0;
+    for ( size_t d = 0; d < dimension; ++d )
+    {
+        double min = center[*begin][d], max = min;
+        for ( std::vector<size_t>::iterator it = begin; it != end; ++it )
+        {
+            min = std::min ( min, center[*it][d] );
+            max = std::max ( max, center[*it][d] );
+        }
+        if ( max - min > max_extent )
+        {
+            max_extent = max - min;
+            dim = d;
+        }
+    }
+    size_t n_left = n_piece / 2;
+    std::vector<size_t>::iterator mid = begin + ( end - begin ) * n_left / n_piece;
+    std::nth_element ( begin, mid, end, [&center, dim] ( size_t i, size_t j )
+    {
+        return center[i][dim] < center[j][dim];
+    } );
+    bisectCells ( center, begin, mid, n_left, pieces );
+    bisectCells ( center, mid, end, n_piece - n_left, pieces );
+}
+}
+//----------------------------------------------------------------------------
+void PVD_file::partitionCells ( Tissue const& t, size_t n_piece, int partition, std::vector< std::vector<size_t> >& pieces )
+{
+    size_t n_cell = t.numCell();
+    if ( n_piece > n_cell )
+        n_piece = n_cell;
+    if ( n_piece < 1 )
+        n_piece = 1;
+    pieces.clear();
+    if ( partition == INDEX || n_piece == 1 )
+    {
+        pieces.resize ( n_piece );
+        for ( size_t p = 0; p < n_piece; ++p )
+            for ( size_t i = p * n_cell / n_piece; i < ( p + 1 ) * n_cell / n_piece; ++i )
+                pieces[p].push_back ( i );
+    }
+    else if ( partition == SPATIAL )
+    {
+        std::vector< std::vector<double> > center ( n_cell );
+        std::vector<size_t> cells ( n_cell );
+        for ( size_t i = 0; i < n_cell; ++i )
+        {
+            center[i] = const_cast<Cell&> ( t.cell ( i ) ).positionFromVertex();
+            cells[i] = i;
+        }
+        bisectCells ( center, cells.begin(), cells.end(), n_piece, pieces );
+    }
+    else
+    {
+        std::cerr << "PVD_file::partitionCells(); Partition " << partition
+                  << " not recognized (0 index, 1 spatial allowed)\n";
+        exit ( EXIT_FAILURE );
+    }
+}
+//----------------------------------------------------------------------------
+void PVD_file::writePieces ( Tissue const& t, const std::string vtu_filename1, const std::string vtu_filename2,
+                             size_t count, size_t n_piece, int partition, bool two_wall )
+{
+    std::vector<std::string> basenames ( 2 ), filenames ( 2 );
+    basenames[0] = vtu_filename1;
+    basenames[1] = vtu_filename2;
+    // Update vtu file name
+    vtuNameUpdate ( count, basenames, filenames );
+    std::vector< std::vector<size_t> > pieces;
+    partitionCells ( t, n_piece, partition, pieces );
+    size_t n = pieces.size();
+    std::vector< std::vector<std::string> > piece_filenames ( 2, std::vector<std::string> ( n ) );
+    for ( size_t p = 0; p < n; ++p )
+        for ( size_t j = 0; j < 2; ++j )
+            piece_filenames[j][p] = pieceFilename ( filenames[j], p );
+    // Cell and wall files of all pieces are written concurrently, the first
+    // pieces are kept for declaring the data arrays in the master files
+    std::vector<std::string> first_piece ( 2 );
+    myParallel::forEach ( 0, 2 * n, [&] ( size_t k )
+    {
+        size_t p = k / 2, j = k % 2;
+        std::ostringstream buffer;
+        VTUostream out ( buffer );
+        out.set_cells ( pieces[p] );
+        if ( j == 0 )
+            out.write_cells2 ( t );
+        else if ( two_wall )
+            out.write_walls3 ( t );
+        else
+            out.write_walls2 ( t );
+        out.close();
+        std::ofstream file ( piece_filenames[j][p].c_str() );
+        file << buffer.str();
+        if ( p == 0 )
+            first_piece[j] = buffer.str();
+    } );
+    for ( size_t j = 0; j < 2; ++j )
+    {
+        std::string pvtu_filename = filenames[j].substr ( 0, filenames[j].find_last_of ( "." ) ) + ".pvtu";
+        pvtuFileWrite ( pvtu_filename, piece_filenames[j], first_piece[j] );
+    }
+}
+//----------------------------------------------------------------------------
+void PVD_file::pvtuFileWrite ( const std::string filename, std::vector<std::string> const& piece_filenames, std::string const& first_piece )
+{
+    std::ofstream pvtuFile ( filename.c_str() );
+    pvtuFile << "<?xml version=\"1.0\"?>\n"
+             << "<VTKFile type=\"PUnstructuredGrid\" version=\"0.1\">\n"
+             << "<PUnstructuredGrid GhostLevel=\"0\">\n"
+             << "<PPoints>\n"
+             << "<PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n"
+             << "</PPoints>\n";
+    // Declare the cell data arrays as written in the first piece
+    std::istringstream in ( first_piece );
+    std::string line, format = " format=\"ascii\"";
+    bool cell_data = false;
+    while ( std::getline ( in, line ) )
+    {
+        if ( line.compare ( 0, 9, "<CellData" ) == 0 )
+        {
+            cell_data = true;
+            pvtuFile << "<PCellData" << line.substr ( 9 ) << "\n";
+        }
+        else if ( line.compare ( 0, 11, "</CellData>" ) == 0 )
+        {
+            cell_data = false;
+            pvtuFile << "</PCellData>\n";
+        }
+        else if ( cell_data && line.compare ( 0, 10, "<DataArray" ) == 0 )
+        {
+            std::string attributes = line.substr ( 10, line.find_last_of ( ">" ) - 10 );
+            size_t pos = attributes.find ( format );
+            if ( pos != std::string::npos )
+                attributes.erase ( pos, format.size() );
+            pvtuFile << "<PDataArray" << attributes << "/>\n";
+        }
+    }
+    for ( size_t p = 0; p < piece_filenames.size(); ++p )
+    {
+        // Remove directory path from name for pvtu file
+        std::string fname;
+        fname.assign ( piece_filenames[p], piece_filenames[p].find_last_of ( "/" ) + 1, piece_filenames[p].size() );
+        pvtuFile << "<Piece Source=\"" << fname << "\"/>\n";
+    }
+    pvtuFile << "</PUnstructuredGrid>\n"
+             << "</VTKFile>\n";
+    pvtuFile.close();
+}
+//----------------------------------------------------------------------------
 
 void PVD_file::pvdFileWrite ( size_t num, double time )
 {
@@ -6,6 +6,7 @@
 #ifndef _PVD_FILE_H_
 #define _PVD_FILE_H_
 #include <fstream>
+#include <string>
 #include <vector>
 
 class Tissue;
@@ -46,6 +47,14 @@ public:
     void static writeLineWall ( Tissue const& t, const std::string vtu_filename1, const std::string vtu_filename2, size_t count );
     /// @brief write pvd file in full for 'n' steps 
     void static writeFullPvd ( const std::string filename, std::vector<std::string>& filenames,  size_t n );
+    /// @brief Partitioning of the cells into pieces used by writePieces
+    enum Partition { INDEX = 0, SPATIAL = 1 };
+    /// @brief Write the cells and walls split into 'n_piece' VTU pieces (written in parallel) together with
+    /// one PVTU master file per output, named as the vtu files but with a .pvtu extension, for a supplied counter
+    void static writePieces ( Tissue const& t, const std::string vtu_filename1, const std::string vtu_filename2, size_t count, size_t n_piece, int partition = INDEX, bool two_wall = false );
+    /// @brief Split the cells into 'n_piece' (non-empty) pieces, by index ranges or by recursive coordinate
+    /// bisection of the cell centers
+    void static partitionCells ( Tissue const& t, size_t n_piece, int partition, std::vector< std::vector<size_t> >& pieces );
     /// @brief Write just VTU_files for a supplied counter without touching PVD file separating cell walls to inner and outer based on a flag in those walls
     void static writeInnerOuterWalls ( Tissue const& t, const std::string vtu_filename1, const std::string vtu_filename2, const std::string vtu_filename3, size_t count );
     /// @brief Write just VTU_files for a supplied counter without touching PVD file separating cell walls to inner and outer based on a flag in those walls for pavement-cells
@@ -68,6 +77,8 @@ private:
     void pvdFileWrite ( size_t num, double time = -1.0 );
 //   /// @brief Write full pvd file for 'num' steps
 //   void pvdFileWriteFull(size_t num);
+    /// @brief Write a PVTU master file referencing the piece files, with the data arrays declared as in the first piece
+    void static pvtuFileWrite ( const std::string filename, std::vector<std::string> const& piece_filenames, std::string const& first_piece );
     /// @brief Update names of vtu files for a given step
     void static vtuNameUpdate ( const int counter, std::vector<std::string>const& basenames, std::vector<std::string>& filenames );
     void vtuNameUpdate ( const int counter )
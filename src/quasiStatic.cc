@@ -0,0 +1,251 @@
+//
+// Filename     : quasiStatic.cc
+// Description  : Quasi-static solver relaxing vertex mechanics between ODE steps
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <cmath>
+#include "quasiStatic.h"
+
+QuasiStatic::QuasiStatic(Tissue *T,std::ifstream &IN)
+  : BaseSolver(T,IN)
+{
+  numRelaxStep_=0;
+  readParameterFile(IN);
+}
+
+void QuasiStatic::readParameterFile(std::ifstream &IN)
+{
+  IN >> startTime_;
+  t_= startTime_;
+  IN >> endTime_;
+
+  IN >> printFlag_;
+  IN >> numPrint_;
+
+  IN >> h_;
+  IN >> forceTolerance_;
+  IN >> maxRelaxStep_;
+  IN >> dtFire_;
+  IN >> dtMaxFire_;
+}
+
+void QuasiStatic::simulate(size_t verbose)
+{
+  //
+  // Check that parameters are ok
+  //
+  if( !(h_>0. && (endTime_-startTime_)>0.) ) {
+    std::cerr << "QuasiStatic::simulate() Wrong time borders or time step for "
+	      << "simulation. No simulation performed." << std::endl;
+    return;
+  }
+  if( !(forceTolerance_>0. && dtFire_>0. && dtMaxFire_>=dtFire_) ) {
+    std::cerr << "QuasiStatic::simulate() Force tolerance and FIRE time steps "
+	      << "must be positive (and dt_maxFIRE>=dt_FIRE). No simulation "
+	      << "performed." << std::endl;
+    return;
+  }
+  std::cerr << "Simulating using quasi-static (FIRE relaxed) vertex mechanics "
+	    << "and explicit Euler for cell and wall variables." << std::endl;
+
+  //
+  // Check that sizes of permanent data is ok
+  //
+  if( cellData_.size() && cellData_.size() != cellDerivs_.size() ) {
+    cellDerivs_.resize( cellData_.size(),cellData_[0]);
+  }
+  if( wallData_.size() && wallData_.size() != wallDerivs_.size() ) {
+    wallDerivs_.resize( wallData_.size(),wallData_[0]);
+  }
+  if( vertexData_.size() && vertexData_.size() != vertexDerivs_.size() ) {
+    vertexDerivs_.resize( vertexData_.size(),vertexData_[0]);
+  }
+
+  // Initiate reactions and direction for those where it is applicable
+  T_->initiateReactions(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+  if (cellData_.size()!=cellDerivs_.size())
+    cellDerivs_.resize(cellData_.size(),cellDerivs_[0]);
+  if (wallData_.size()!=wallDerivs_.size())
+    wallDerivs_.resize(wallData_.size(),wallDerivs_[0]);
+  if (vertexData_.size()!=vertexDerivs_.size())
+    vertexDerivs_.resize(vertexData_.size(),vertexDerivs_[0]);
+  T_->initiateDirection(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+
+  assert( cellData_.size() == T_->numCell() &&
+	  cellData_.size()==cellDerivs_.size() );
+  assert( wallData_.size() == T_->numWall() &&
+	  wallData_.size()==wallDerivs_.size() );
+  assert( vertexData_.size() == T_->numVertex() &&
+	  vertexData_.size()==vertexDerivs_.size() );
+
+  // FIRE velocities (same layout as the vertex data)
+  DataMatrix velocity(vertexData_);
+
+  // Initiate print times
+  //
+  double tiny = 1e-10;
+  double printTime=endTime_+tiny;
+  double printDeltaTime=endTime_+2.*tiny;
+  int doPrint=1;
+  if( numPrint_<=0 )//No printing
+    doPrint=0;
+  else if( numPrint_==1 ) {//Print last point (default)
+  }
+  else if( numPrint_==2 ) {//Print first/last point
+    printTime=startTime_-tiny;
+  }
+  else {//Print first/last points and spread the rest uniformly
+    printTime=startTime_-tiny;
+    printDeltaTime=(endTime_-startTime_)/double(numPrint_-1);
+  }
+  // Go
+  //
+  t_=startTime_;
+  numOk_ = numBad_ = 0;
+  numRelaxStep_ = 0;
+  while( t_<endTime_ ) {
+    if (debugFlag()) {
+      recordDebug();
+    }
+    //Bring the vertices to mechanical equilibrium
+    size_t numStep = relax(velocity);
+    numRelaxStep_ += numStep;
+    if( numStep>=maxRelaxStep_ )
+      ++numBad_;
+
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+
+    //Print if applicable
+    if( doPrint && t_ >= printTime ) {
+      printTime += printDeltaTime;
+      print();
+    }
+
+    //Update cell and wall variables
+    eulerStep();
+    numOk_++;
+
+    //
+    // Check for discrete and reaction updates
+    //
+    T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
+			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
+    T_->updateReactions(cellData_,wallData_,vertexData_,h_);
+    T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
+			       cellDerivs_,wallDerivs_,vertexDerivs_ );
+
+    // Check the tissue connectivity in each step
+    T_->checkConnectivity(1);
+    checkRenumber();
+
+    // Resize temporary containers as well
+    if( vertexData_.size() != velocity.size() )
+      velocity.resize(vertexData_.size(),vertexData_[0]);
+
+    //update time variable
+    if( (t_+h_)==t_ ) {
+      std::cerr << "QuasiStatic::simulate() Step size too small.";
+      exit(-1);
+    }
+    t_ += h_;
+  }
+  if( doPrint ) {
+    relax(velocity);
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    print();
+  }
+  std::cerr << "Simulation done (" << numRelaxStep_ << " FIRE iterations, "
+	    << numBad_ << " relaxations not converged).\n";
+  return;
+}
+
+size_t QuasiStatic::relax(DataMatrix &velocity)
+{
+  // FIRE parameters (Bitzek et al. 2006 PRL)
+  const size_t nMin = 5;
+  const double fInc = 1.1;
+  const double fDec = 0.5;
+  const double alphaStart = 0.1;
+  const double fAlpha = 0.99;
+
+  double dt = dtFire_;
+  double alpha = alphaStart;
+  size_t numPositive = 0;
+  size_t Nv = vertexData_.size();
+
+  for( size_t i=0 ; i<Nv ; ++i )
+    for( size_t d=0 ; d<velocity[i].size() ; ++d )
+      velocity[i][d] = 0.0;
+
+  size_t step=0;
+  for( ; step<maxRelaxStep_ ; ++step ) {
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    //Check convergence (maximal vertex force) and collect norms
+    double maxForce2=0.0, power=0.0, vNorm2=0.0, fNorm2=0.0;
+    for( size_t i=0 ; i<Nv ; ++i ) {
+      double force2=0.0;
+      for( size_t d=0 ; d<vertexDerivs_[i].size() ; ++d ) {
+	force2 += vertexDerivs_[i][d]*vertexDerivs_[i][d];
+	power += vertexDerivs_[i][d]*velocity[i][d];
+	vNorm2 += velocity[i][d]*velocity[i][d];
+      }
+      fNorm2 += force2;
+      if( force2>maxForce2 )
+	maxForce2 = force2;
+    }
+    if( std::sqrt(maxForce2)<forceTolerance_ )
+      break;
+    //FIRE velocity mixing and time step adaption
+    if( power>0.0 ) {
+      double mix = fNorm2>0.0 ? alpha*std::sqrt(vNorm2/fNorm2) : 0.0;
+      for( size_t i=0 ; i<Nv ; ++i )
+	for( size_t d=0 ; d<velocity[i].size() ; ++d )
+	  velocity[i][d] = (1.0-alpha)*velocity[i][d] + mix*vertexDerivs_[i][d];
+      if( numPositive>nMin ) {
+	dt = dt*fInc<dtMaxFire_ ? dt*fInc : dtMaxFire_;
+	alpha *= fAlpha;
+      }
+      ++numPositive;
+    }
+    else {
+      for( size_t i=0 ; i<Nv ; ++i )
+	for( size_t d=0 ; d<velocity[i].size() ; ++d )
+	  velocity[i][d] = 0.0;
+      dt *= fDec;
+      alpha = alphaStart;
+      numPositive = 0;
+    }
+    //Semi-implicit Euler update of velocities and positions
+    for( size_t i=0 ; i<Nv ; ++i )
+      for( size_t d=0 ; d<velocity[i].size() ; ++d ) {
+	velocity[i][d] += dt*vertexDerivs_[i][d];
+	vertexData_[i][d] += dt*velocity[i][d];
+      }
+  }
+  return step;
+}
+
+void QuasiStatic::eulerStep()
+{
+  // Vertex positions are kept fixed (relaxed), i.e. vertexDerivs are not used
+  for( size_t i=0 ; i<cellData_.size() ; ++i )
+    for( size_t j=0 ; j<cellData_[i].size() ; ++j )
+      cellData_[i][j] = cellData_[i][j] + h_*cellDerivs_[i][j];
+  for( size_t i=0 ; i<wallData_.size() ; ++i )
+    for( size_t j=0 ; j<wallData_[i].size() ; ++j )
+      wallData_[i][j] = wallData_[i][j] + h_*wallDerivs_[i][j];
+}
@@ -0,0 +1,93 @@
+#ifndef QUASISTATIC_H
+#define QUASISTATIC_H
+//
+// Filename     : quasiStatic.h
+// Description  : Quasi-static solver relaxing vertex mechanics between ODE steps
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include "baseSolver.h"
+
+///
+/// @brief Quasi-static solver where the vertex positions are kept in
+/// mechanical equilibrium while the cell and wall variables are integrated
+///
+/// @details In each time step the vertex positions are first relaxed until
+/// the maximal vertex force (the vertex derivatives given by the
+/// reactions, e.g. VertexFromWallSpring, VertexFromCellPressure and
+/// VertexFromTRBS) is below a tolerance, using the FIRE algorithm (Bitzek et
+/// al. 2006 PRL). Then the cell and wall variables are updated with an
+/// explicit Euler step with the vertex positions kept fixed:
+///
+/// @f[ c_{n+1} = c_n + dcdt(c_n,w_n,x^*) h,\ \ w_{n+1} = w_n + dwdt(c_n,w_n,x^*) h @f]
+///
+/// where @f$x^*@f$ are the relaxed vertex positions. This replaces
+/// integrating the overdamped vertex dynamics to equilibrium with small steps
+/// when mechanics is fast compared to growth and patterning. FIRE is used
+/// (rather than an energy minimizer such as L-BFGS) since it only needs the
+/// forces, and not all vertex reactions are derived from an energy.
+///
+class QuasiStatic : public BaseSolver {
+
+ private:
+
+  double h_;
+  double forceTolerance_;
+  size_t maxRelaxStep_;
+  double dtFire_;
+  double dtMaxFire_;
+  size_t numRelaxStep_;
+
+ public:
+  ///
+  /// @brief Main constructor
+  ///
+  QuasiStatic(Tissue *T,std::ifstream &IN);
+
+  ///
+  /// @brief Reads the parameters used by the QuasiStatic solver
+  ///
+  /// @details This function is responsible for reading parameters used by
+  /// the QuasiStatic algorithm. The parameter file sent to the simulator
+  /// binary looks like:
+  ///
+  /// <pre>
+  /// QuasiStatic
+  /// T_start T_end
+  /// printFlag printNum
+  /// h F_tol maxRelaxStep dt_FIRE dt_maxFIRE
+  /// </pre>
+  ///
+  /// where QuasiStatic is the identity string used by
+  /// BaseSolver::getSolver to identify that this algorithm should be
+  /// used. T_start (T_end) is the start (end) time for the simulation,
+  /// printFlag is an integer which sets the output format (read by
+  /// BaseSolver::print()), printNum is the number of equally spread time
+  /// points to be printed. h is the (Euler) step size for the cell and wall
+  /// variables, F_tol is the maximal vertex force (norm) accepted as
+  /// equilibrium, maxRelaxStep the maximal number of FIRE iterations in each
+  /// relaxation, and dt_FIRE (dt_maxFIRE) the initial (maximal) FIRE time
+  /// step.
+  ///
+  /// @see BaseSolver::getSolver()
+  /// @see BaseSolver::print()
+  ///
+  void readParameterFile(std::ifstream &IN);
+
+  void simulate(size_t verbose=0);
+  ///
+  /// @brief Relaxes the vertex positions towards zero force using FIRE
+  ///
+  /// @details Returns the number of iterations used. On return
+  /// vertexDerivs_ holds the (residual) forces.
+  ///
+  size_t relax(DataMatrix &velocity);
+  ///
+  /// @brief Explicit Euler step of cell and wall variables for fixed vertices
+  ///
+  void eulerStep();
+};
+
+#endif
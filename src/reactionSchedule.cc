@@ -0,0 +1,189 @@
+//
+// Filename     : reactionSchedule.cc
+// Description  : Read/write sets of reactions and a dependency schedule for running them in parallel
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include "baseReaction.h"
+#include "reactionSchedule.h"
+
+const size_t ReactionAccess::all;
+
+ReactionAccess::ReactionAccess() :
+  exclusive_(0)
+{
+}
+
+void ReactionAccess::clear()
+{
+  exclusive_ = 0;
+  for( size_t b=0 ; b<numBlock ; ++b ) {
+    read_[b].clear();
+    write_[b].clear();
+  }
+}
+
+void ReactionAccess::add(std::vector<size_t> &columns,size_t column)
+{
+  //The columns are kept sorted, and all (the largest value) replaces them
+  if( columns.size() && columns.back()==all )
+    return;
+  if( column==all ) {
+    columns.assign(1,all);
+    return;
+  }
+  std::vector<size_t>::iterator it =
+    std::lower_bound(columns.begin(),columns.end(),column);
+  if( it==columns.end() || *it!=column )
+    columns.insert(it,column);
+}
+
+int ReactionAccess::overlap(const std::vector<size_t> &a,
+			    const std::vector<size_t> &b)
+{
+  if( a.empty() || b.empty() )
+    return 0;
+  if( a.back()==all || b.back()==all )
+    return 1;
+  size_t i=0, j=0;
+  while( i<a.size() && j<b.size() ) {
+    if( a[i]==b[j] )
+      return 1;
+    if( a[i]<b[j] )
+      ++i;
+    else
+      ++j;
+  }
+  return 0;
+}
+
+void ReactionAccess::read(Block block,size_t column)
+{
+  add(read_[block],column);
+}
+
+void ReactionAccess::write(Block block,size_t column)
+{
+  add(write_[block],column);
+}
+
+void ReactionAccess::setExclusive()
+{
+  exclusive_ = 1;
+}
+
+void ReactionAccess::addVariableIndex(const BaseReaction &reaction,
+				      size_t numCellComponent,
+				      size_t numWallComponent)
+{
+  for( size_t level=0 ; level<reaction.numVariableIndexLevel() ; ++level )
+    for( size_t k=0 ; k<reaction.numVariableIndex(level) ; ++k ) {
+      size_t column = reaction.variableIndex(level,k);
+      for( size_t c=column ; c<column+numCellComponent ; ++c ) {
+	read(cellData,c);
+	write(cellDerivs,c);
+      }
+      for( size_t c=column ; c<column+numWallComponent ; ++c ) {
+	read(wallData,c);
+	write(wallDerivs,c);
+      }
+    }
+}
+
+int ReactionAccess::dependsOn(const ReactionAccess &other) const
+{
+  if( exclusive_ || other.exclusive_ )
+    return 1;
+  for( size_t b=0 ; b<numBlock ; ++b )
+    if( overlap(write_[b],other.write_[b]) ||
+	overlap(write_[b],other.read_[b]) ||
+	overlap(read_[b],other.write_[b]) )
+      return 1;
+  return 0;
+}
+
+int ReactionAccess::readsWritten(Block block,const ReactionAccess &writer) const
+{
+  return overlap(read_[block],writer.write_[block]);
+}
+
+void ReactionAccess::print(std::ostream &os) const
+{
+  if( exclusive_ ) {
+    os << "exclusive";
+    return;
+  }
+  const char *blockName[numBlock] = {"cellData","wallData","vertexData",
+				     "cellDerivs","wallDerivs","vertexDerivs"};
+  for( size_t rw=0 ; rw<2 ; ++rw ) {
+    const std::vector<size_t> *columns = rw ? write_ : read_;
+    os << (rw ? " write" : "read");
+    for( size_t b=0 ; b<numBlock ; ++b ) {
+      if( columns[b].empty() )
+	continue;
+      os << " " << blockName[b] << "(";
+      for( size_t k=0 ; k<columns[b].size() ; ++k ) {
+	if( k )
+	  os << ",";
+	if( columns[b][k]==all )
+	  os << "all";
+	else
+	  os << columns[b][k];
+      }
+      os << ")";
+    }
+  }
+}
+
+ReactionSchedule::ReactionSchedule() :
+  numDependency_(0)
+{
+}
+
+void ReactionSchedule::build(const std::vector<BaseReaction*> &reaction,
+			     const std::vector<size_t> &reactionList)
+{
+  size_t N = reactionList.size();
+  reactionList_ = reactionList;
+  level_.clear();
+  numDependency_ = 0;
+
+  std::vector<ReactionAccess> access(N);
+  for( size_t k=0 ; k<N ; ++k )
+    reaction[reactionList[k]]->access(access[k]);
+
+  //Each reaction is placed in the level after the last earlier reaction it
+  //depends on
+  std::vector<size_t> reactionLevel(N,0);
+  for( size_t k=0 ; k<N ; ++k ) {
+    for( size_t j=0 ; j<k ; ++j )
+      if( access[k].dependsOn(access[j]) ) {
+	++numDependency_;
+	reactionLevel[k] = std::max(reactionLevel[k],reactionLevel[j]+1);
+      }
+    if( reactionLevel[k]>=level_.size() )
+      level_.resize(reactionLevel[k]+1);
+    level_[reactionLevel[k]].push_back(reactionList[k]);
+  }
+}
+
+void ReactionSchedule::print(const std::vector<BaseReaction*> &reaction,
+			     std::ostream &os) const
+{
+  os << reactionList_.size() << " reactions in " << numLevel()
+     << " levels (" << numDependency() << " dependencies)." << std::endl;
+  for( size_t i=0 ; i<numLevel() ; ++i ) {
+    os << "Level " << i << ":";
+    for( size_t k=0 ; k<level_[i].size() ; ++k ) {
+      ReactionAccess access;
+      reaction[level_[i][k]]->access(access);
+      os << "\n  " << level_[i][k] << " " << reaction[level_[i][k]]->id()
+	 << " [";
+      access.print(os);
+      os << "]";
+    }
+    os << std::endl;
+  }
+}
@@ -0,0 +1,193 @@
+//
+// Filename     : reactionSchedule.h
+// Description  : Read/write sets of reactions and a dependency schedule for running them in parallel
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef REACTIONSCHEDULE_H
+#define REACTIONSCHEDULE_H
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+class BaseReaction;
+
+///
+/// @brief The tissue variable columns a reaction reads and writes in derivs()
+///
+/// @details The columns are given per block (cell, wall and vertex data and
+/// the corresponding derivatives), where ReactionAccess::all marks that the
+/// full block is accessed. Two reactions depend on each other if one of them
+/// writes a column the other reads or writes, or if one of them is
+/// exclusive. An exclusive reaction is ordered with respect to all other
+/// reactions, and is used for reactions that update the tissue data (e.g.
+/// saving forces or stresses) or read derivatives written by other
+/// reactions in non-declared columns. An exclusive reaction may still
+/// declare the blocks it writes, which is used when grouping reactions
+/// (e.g. by StrangSplitting).
+///
+/// @see BaseReaction::access()
+/// @see ReactionSchedule
+///
+class ReactionAccess {
+
+ public:
+
+  enum Block {
+    cellData=0,
+    wallData,
+    vertexData,
+    cellDerivs,
+    wallDerivs,
+    vertexDerivs,
+    numBlock
+  };
+  ///
+  /// @brief Column index marking that the full block is accessed
+  ///
+  static const size_t all = static_cast<size_t>(-1);
+
+ private:
+
+  int exclusive_;
+  std::vector<size_t> read_[numBlock];
+  std::vector<size_t> write_[numBlock];
+
+  static void add(std::vector<size_t> &columns,size_t column);
+  static int overlap(const std::vector<size_t> &a,
+		     const std::vector<size_t> &b);
+
+ public:
+
+  ReactionAccess();
+  ///
+  /// @brief Removes all declared columns
+  ///
+  void clear();
+  ///
+  /// @brief Declares that a column (or the full block) is read
+  ///
+  void read(Block block,size_t column=all);
+  ///
+  /// @brief Declares that a column (or the full block) is written
+  ///
+  void write(Block block,size_t column=all);
+  ///
+  /// @brief Declares the reaction to be ordered with respect to all other
+  /// reactions
+  ///
+  void setExclusive();
+  inline int exclusive() const;
+  ///
+  /// @brief Returns 1 if any column of the block is written
+  ///
+  inline int writes(Block block) const;
+  ///
+  /// @brief Returns 1 if any column of the block is read
+  ///
+  inline int reads(Block block) const;
+  ///
+  /// @brief Returns 1 if a column of the block written by writer is read
+  ///
+  int readsWritten(Block block,const ReactionAccess &writer) const;
+  ///
+  /// @brief Adds the cell and wall columns given by the variable indices of
+  /// the reaction
+  ///
+  /// All variable indices (in all levels) are read in the cell and wall data
+  /// and written in the cell and wall derivatives. Since variables may be
+  /// vectors (e.g. the two sides of a wall variable), numCellComponent
+  /// (numWallComponent) columns starting at each index are included.
+  ///
+  void addVariableIndex(const BaseReaction &reaction,
+			size_t numCellComponent,size_t numWallComponent);
+  ///
+  /// @brief Returns 1 if the two reactions have to be run in order
+  ///
+  int dependsOn(const ReactionAccess &other) const;
+  ///
+  /// @brief Prints the declared columns to os
+  ///
+  void print(std::ostream &os) const;
+};
+
+///
+/// @brief Dependency schedule of a list of reactions
+///
+/// @details The schedule is built from the ReactionAccess declared by each
+/// reaction. A reaction depends on all earlier reactions (in model file
+/// order) it conflicts with, and is placed in the level after the last of
+/// them. Reactions within a level are independent and can be run
+/// concurrently, while the levels are run in order, such that conflicting
+/// reactions keep their model file order.
+///
+/// @see Tissue::setScheduleFlag()
+///
+class ReactionSchedule {
+
+ private:
+
+  std::vector<size_t> reactionList_;
+  std::vector< std::vector<size_t> > level_;
+  size_t numDependency_;
+
+ public:
+
+  ReactionSchedule();
+  ///
+  /// @brief Builds the levels for the listed reactions
+  ///
+  void build(const std::vector<BaseReaction*> &reaction,
+	     const std::vector<size_t> &reactionList);
+  ///
+  /// @brief Returns the reaction list the schedule was built for
+  ///
+  inline const std::vector<size_t> & reactionList() const;
+  inline size_t numLevel() const;
+  ///
+  /// @brief Returns the (reaction) indices in level i
+  ///
+  inline const std::vector<size_t> & level(size_t i) const;
+  ///
+  /// @brief Returns the number of dependencies (edges) between reactions
+  ///
+  inline size_t numDependency() const;
+  ///
+  /// @brief Prints the levels with the reaction ids to os
+  ///
+  void print(const std::vector<BaseReaction*> &reaction,
+	     std::ostream &os) const;
+};
+
+inline int ReactionAccess::exclusive() const { return exclusive_; }
+
+inline int ReactionAccess::writes(Block block) const
+{
+  return !write_[block].empty();
+}
+
+inline int ReactionAccess::reads(Block block) const
+{
+  return !read_[block].empty();
+}
+
+inline const std::vector<size_t> & ReactionSchedule::reactionList() const
+{
+  return reactionList_;
+}
+
+inline size_t ReactionSchedule::numLevel() const { return level_.size(); }
+
+inline const std::vector<size_t> & ReactionSchedule::level(size_t i) const
+{
+  return level_[i];
+}
+
+inline size_t ReactionSchedule::numDependency() const
+{
+  return numDependency_;
+}
+
+#endif
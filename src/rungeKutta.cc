@@ -6,11 +6,14 @@
 // Created      : June 2007
 // Revision     : $Id:$
 //
+#include <algorithm>
 #include <cmath>
+#include <map>
 #include "rungeKutta.h"
 
 RK5Adaptive::RK5Adaptive(Tissue *T,std::ifstream &IN)
-  : BaseSolver(T,IN)
+  : BaseSolver(T,IN), topologyRevision_(0),
+    rowIdRevision_(static_cast<size_t>(-1)), probeStep_(0.0)
 {
   readParameterFile(IN);
 }
@@ -98,58 +101,12 @@ void RK5Adaptive::simulate(size_t verbose)
 	  vertexData_.size()==vertexDerivs_.size() );
   
   //
-  // Create all vectors that will be needed here and by rkqs and rkck!
+  // Create all temporary states that will be needed here and by rkqs and rkck
   //
-  size_t Nc=T_->numCell(),Nw=T_->numWall(),Nv=T_->numVertex();
-  //Used here
-  DataMatrix yScalC(Nc),yScalW(Nw),yScalV(Nv);
-  //Used by rkqs
-  DataMatrix yTempC(Nc),yTempW(Nw),yTempV(Nv),
-    yErrC(Nc),yErrW(Nw),yErrV(Nv);
-  //used by rkck
-  DataMatrix ak2C(Nc),ak2W(Nw),ak2V(Nv),
-    ak3C(Nc),ak3W(Nw),ak3V(Nv),
-    ak4C(Nc),ak4W(Nw),ak4V(Nv),
-    ak5C(Nc),ak5W(Nw),ak5V(Nv),
-    ak6C(Nc),ak6W(Nw),ak6V(Nv),
-    yTempRkckC(Nc),yTempRkckW(Nw),yTempRkckV(Nv);
-  //Resize each vector
-  size_t Ncvar=T_->cell(0).numVariable();
-  for (size_t i=0; i<Nc; ++i) {
-    yScalC[i].resize(cellData_[i].size());
-    yErrC[i].resize(cellData_[i].size());
-    yTempC[i].resize(cellData_[i].size());
-    ak2C[i].resize(cellData_[i].size());
-    ak3C[i].resize(cellData_[i].size());
-    ak4C[i].resize(cellData_[i].size());
-    ak5C[i].resize(cellData_[i].size());
-    ak6C[i].resize(cellData_[i].size());
-    yTempRkckC[i].resize(cellData_[i].size());
-  }
-  size_t Nwvar=T_->wall(0).numVariable()+1;
-  for (size_t i=0; i<Nw; ++i) {
-    yScalW[i].resize(wallData_[i].size());
-    yErrW[i].resize(wallData_[i].size());
-    yTempW[i].resize(wallData_[i].size());
-    ak2W[i].resize(wallData_[i].size());
-    ak3W[i].resize(wallData_[i].size());
-    ak4W[i].resize(wallData_[i].size());
-    ak5W[i].resize(wallData_[i].size());
-    ak6W[i].resize(wallData_[i].size());
-    yTempRkckW[i].resize(wallData_[i].size());
-  }
-  size_t Nvvar=T_->vertex(0).numPosition();
-  for (size_t i=0; i<Nv; ++i) {
-    yScalV[i].resize(vertexData_[i].size());
-    yErrV[i].resize(vertexData_[i].size());
-    yTempV[i].resize(vertexData_[i].size());
-    ak2V[i].resize(vertexData_[i].size());
-    ak3V[i].resize(vertexData_[i].size());
-    ak4V[i].resize(vertexData_[i].size());
-    ak5V[i].resize(vertexData_[i].size());
-    ak6V[i].resize(vertexData_[i].size());
-    yTempRkckV[i].resize(vertexData_[i].size());
-  }
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  resizeTemporaries();
+  topologyRevision_ = T_->topologyRevision();
   
   // Initiate print times
   //
@@ -174,33 +131,32 @@ void RK5Adaptive::simulate(size_t verbose)
   numOk_ = numBad_ = 0;
   for (unsigned int nstp = 0;; nstp++) {
     if (debugFlag()) {
-      cellDataCopy_[debugCount()] = cellData_;
+      recordDebug();
     } 
     // Update the derivatives
     T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
 	       vertexDerivs_);
     
-    // Calculate 'scaling' for error measure
-    Nc = yScalC.size();
-    Nw = yScalW.size();
-    Nv = yScalV.size();    
-    for (size_t i=0; i<Nc; ++i) {
-      Ncvar = yScalC[i].size();
-      for (size_t j = 0; j<Ncvar; ++j)
-        yScalC[i][j] = std::fabs(cellData_[i][j]) + 
-	  std::fabs(cellDerivs_[i][j] * h) + tiny;
-    }
-    for (size_t i=0; i<Nw; ++i) {
-      Nwvar = yScalW[i].size();
-      for (size_t j = 0; j<Nwvar; ++j)
-        yScalW[i][j] = std::fabs(wallData_[i][j]) + 
-	  std::fabs(wallDerivs_[i][j] * h) + tiny;
+    // Stop if converged and print the final point (if applicable)
+    if (checkConvergence()) {
+      if (doPrint)
+	print();
+      std::cerr << "Simulation done (" << numOk_ << " steps at the tried size, "
+		<< numBad_ << " with the step decreased).\n";
+      return;
     }
-    for (size_t i=0; i<Nv; ++i) {
-      Nvvar = yScalV[i].size();
-      for (size_t j = 0; j<Nvvar; ++j)
-        yScalV[i][j] = std::fabs(vertexData_[i][j]) + 
-	  std::fabs(vertexDerivs_[i][j] * h) + tiny;
+    
+    // Calculate 'scaling' for error measure
+    yScal_.setErrorScale(y,dydt,h,tiny);
+    // After a topology change the step is decreased if predicted from the
+    // errors of the last step mapped to the new elements
+    if (T_->topologyRevision() != topologyRevision_) {
+      double hPredicted = predictStep(hDid,h);
+      if (hPredicted < h) {
+	h = hPredicted;
+	yScal_.setErrorScale(y,dydt,h,tiny);
+      }
+      topologyRevision_ = T_->topologyRevision();
     }
     // Print if applicable 
     if (doPrint && t_ >= printTime) {
@@ -215,10 +171,7 @@ void RK5Adaptive::simulate(size_t verbose)
     if (t_+h > tMin) h = tMin - t_;
     
     // Update
-    rkqs(h,hDid,hNext,yScalC,yScalW,yScalV,yTempC,yTempW,yTempV, 
-	 yErrC,yErrW,yErrV,ak2C,ak2W,ak2V,ak3C,ak3W,ak3V,
-	 ak4C,ak4W,ak4V,ak5C,ak5W,ak5V,ak6C,ak6W,ak6V, 
-	 yTempRkckC,yTempRkckW,yTempRkckV);
+    rkqs(h,hDid,hNext);
     if (hDid == h) ++numOk_; else ++numBad_;
     
     //
@@ -226,63 +179,38 @@ void RK5Adaptive::simulate(size_t verbose)
     //
     T_->updateDirection(h,cellData_,wallData_,vertexData_,cellDerivs_,
 			wallDerivs_,vertexDerivs_);
+    updateHybrid(hDid);
     T_->updateReactions(cellData_,wallData_,vertexData_,h);
+    // The derivatives of the step are kept aside (swapped) during the
+    // compartment changes, such that the error controller state is only
+    // calculated if the topology changes
+    size_t revision = T_->topologyRevision();
+    if (revision != rowIdRevision_) {
+      dydtStep_.resizeLike(y);
+      for (size_t b=0; b<3; ++b)
+	rowId_[b].resize(y.block(b).size());
+      for (size_t i=0; i<rowId_[0].size(); ++i)
+	rowId_[0][i] = T_->cellStableId(i);
+      for (size_t i=0; i<rowId_[1].size(); ++i)
+	rowId_[1][i] = T_->wallStableId(i);
+      for (size_t i=0; i<rowId_[2].size(); ++i)
+	rowId_[2][i] = T_->vertexStableId(i);
+      rowIdRevision_ = revision;
+    }
+    swapDerivs();
     T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
 			       cellDerivs_,wallDerivs_,vertexDerivs_ );
     
     // Check the tissue connectivity in each step
     T_->checkConnectivity(1);
+    checkRenumber();
+    if (T_->topologyRevision() != revision)
+      storeControllerState(hDid,revision);
+    else
+      swapDerivs();
     
-    // Rescale all temporary vectors as well
-    if (cellData_.size() != yScalC.size() ||
-        wallData_.size() != yScalW.size() ||
-        vertexData_.size() != yScalV.size())
-      {
-        std::cerr << "RK5Adaptive::simulate() WARNING"
-                  << " rescaling temporary vectors not adopted for "
-                  << "center triangulation." << std::endl;
-        yScalC.resize(cellData_.size(), yScalC[0]);
-        yScalW.resize(wallData_.size(), yScalW[0]);
-        yScalV.resize(vertexData_.size(), yScalV[0]);
-        yTempC.resize(cellData_.size(), yTempC[0]);
-        yTempW.resize(wallData_.size(), yTempW[0]);
-        yTempV.resize(vertexData_.size(), yTempV[0]);
-        yErrC.resize(cellData_.size(), yErrC[0]);
-        yErrW.resize(wallData_.size(), yErrW[0]);
-        yErrV.resize(vertexData_.size(), yErrV[0]);
-        ak2C.resize(cellData_.size(), ak2C[0]);
-        ak2W.resize(wallData_.size(), ak2W[0]);
-        ak2V.resize(vertexData_.size(), ak2V[0]);
-        ak3C.resize(cellData_.size(), ak3C[0]);
-        ak3W.resize(wallData_.size(), ak3W[0]);
-        ak3V.resize(vertexData_.size(), ak3V[0]);
-        ak4C.resize(cellData_.size(), ak4C[0]);
-        ak4W.resize(wallData_.size(), ak4W[0]);
-        ak4V.resize(vertexData_.size(), ak4V[0]);
-        ak5C.resize(cellData_.size(), ak5C[0]);
-        ak5W.resize(wallData_.size(), ak5W[0]);
-        ak5V.resize(vertexData_.size(), ak5V[0]);
-        ak6C.resize(cellData_.size(), ak6C[0]);
-        ak6W.resize(wallData_.size(), ak6W[0]);
-        ak6V.resize(vertexData_.size(), ak6V[0]);
-        yTempRkckC.resize(cellData_.size(), yTempRkckC[0]);
-        yTempRkckW.resize(wallData_.size(), yTempRkckW[0]);
-        yTempRkckV.resize(vertexData_.size(), yTempRkckV[0]);
-        
-        
-        for (size_t ii=0; ii<cellData_.size(); ++ii) {
-          yScalC[ii].resize(cellData_[ii].size());
-          yErrC[ii].resize(cellData_[ii].size());
-          yTempC[ii].resize(cellData_[ii].size());
-          ak2C[ii].resize(cellData_[ii].size());
-          ak3C[ii].resize(cellData_[ii].size());
-          ak4C[ii].resize(cellData_[ii].size());
-          ak5C[ii].resize(cellData_[ii].size());
-          ak6C[ii].resize(cellData_[ii].size());
-          yTempRkckC[ii].resize(cellData_[ii].size());
-        }
-                        
-      }
+    // Resize all temporary states as well (rows kept, amortized)
+    resizeTemporaries();
     
     // If the end t is passed return (print if applicable)
     if (t_ >= endTime_) {
@@ -292,7 +220,8 @@ void RK5Adaptive::simulate(size_t verbose)
 									 vertexDerivs_);
 				print();
       }
-      std::cerr << "Simulation done.\n"; 
+      std::cerr << "Simulation done (" << numOk_ << " steps at the tried size, "
+		<< numBad_ << " with the step decreased).\n";
       return;
     }
     //Warn for small step sizes...
@@ -307,73 +236,31 @@ void RK5Adaptive::simulate(size_t verbose)
   }
 }
 
+void RK5Adaptive::resizeTemporaries()
+{
+  SolverState y(cellData_,wallData_,vertexData_);
+  yScal_.resizeLike(y);
+  yTemp_.resizeLike(y);
+  yErr_.resizeLike(y);
+  ak2_.resizeLike(y);
+  ak3_.resizeLike(y);
+  ak4_.resizeLike(y);
+  ak5_.resizeLike(y);
+  ak6_.resizeLike(y);
+  yTempRkck_.resizeLike(y);
+}
+
 #define SAFETY 0.9
 #define PGROW -0.2
 #define PSHRNK -0.25
 #define ERRCON 1.89e-4
-void RK5Adaptive::rkqs(double hTry, double &hDid, double &hNext,
-											 DataMatrix &yScalC,
-											 DataMatrix &yScalW,
-											 DataMatrix &yScalV,
-											 DataMatrix &yTempC,
-											 DataMatrix &yTempW,
-											 DataMatrix &yTempV,
-											 DataMatrix &yErrC,
-											 DataMatrix &yErrW,
-											 DataMatrix &yErrV,
-											 DataMatrix &ak2C,
-											 DataMatrix &ak2W,
-											 DataMatrix &ak2V,
-											 DataMatrix &ak3C,
-											 DataMatrix &ak3W,
-											 DataMatrix &ak3V,
-											 DataMatrix &ak4C,
-											 DataMatrix &ak4W,
-											 DataMatrix &ak4V,
-											 DataMatrix &ak5C,
-											 DataMatrix &ak5W,
-											 DataMatrix &ak5V,
-											 DataMatrix &ak6C,
-											 DataMatrix &ak6W,
-											 DataMatrix &ak6V,
-											 DataMatrix &yTempRkckC,
-											 DataMatrix &yTempRkckW,
-											 DataMatrix &yTempRkckV)
+void RK5Adaptive::rkqs(double hTry, double &hDid, double &hNext)
 {
-  double errMax, h, hTemp, tNew, aux;
+  double errMax, h, hTemp, tNew;
   h = hTry;
   for (;;) {
-    rkck(h,yTempC,yTempW,yTempV,yErrC,yErrW,yErrV,ak2C,ak2W,ak2V,
-	 ak3C,ak3W,ak3V,ak4C,ak4W,ak4V,ak5C,ak5W,ak5V,
-	 ak6C,ak6W,ak6V,yTempRkckC,yTempRkckW,yTempRkckV);
-    errMax = 0.0;
-    size_t N=cellData_.size();
-    for (size_t i=0; i<N; ++i) {
-      size_t Nv=cellData_[i].size();
-      for (size_t j=0; j<Nv; ++j) {
-        aux = std::fabs(yErrC[i][j] / yScalC[i][j]);
-        if (aux > errMax)
-	  errMax = aux;
-      }
-    }
-    N=wallData_.size();
-    for (size_t i=0; i<N; ++i) {
-      size_t Nv=wallData_[i].size();
-      for (size_t j=0; j<Nv; ++j) {
-        aux = std::fabs(yErrW[i][j] / yScalW[i][j]);
-        if (aux > errMax)
-	  errMax = aux;
-      }
-    }
-    N=vertexData_.size();
-    for (size_t i=0; i<N; ++i) {
-      size_t Nv=vertexData_[i].size();
-      for (size_t j=0; j<Nv; ++j) {
-        aux = std::fabs(yErrV[i][j] / yScalV[i][j]);
-        if (aux > errMax)
-	  errMax = aux;
-      }
-    }
+    rkck(h);
+    errMax = yErr_.maxScaledError(yScal_);
     errMax /= eps_;
     if (errMax <= 1.0) break;
     hTemp = SAFETY * h * pow(errMax, PSHRNK);
@@ -391,58 +278,136 @@ void RK5Adaptive::rkqs(double hTry, double &hDid, double &hNext,
   else hNext = 5.0 * h;
   t_ += (hDid = h);
   
-  size_t Nc=cellData_.size();
-  for (size_t i=0; i<Nc; ++i) {
-    size_t Ncvar=cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      cellData_[i][j] = yTempC[i][j];
-  }
-  size_t Nw=wallData_.size();
-  for (size_t i=0; i<Nw; ++i) {
-    size_t Nwvar=wallData_[i].size();
-    for (size_t j=0; j<Nwvar; ++j)
-      wallData_[i][j] = yTempW[i][j];
+  SolverState y(cellData_,wallData_,vertexData_);
+  y.assign(yTemp_);
+}
+
+void RK5Adaptive::rowRate(const SolverState &dydt, const SolverState &dydtProbe,
+			  double delta, std::vector<double> rate[3])
+{
+  const double c[2] = {1.0,-1.0};
+  const SolverState *k[2] = {&dydtProbe,&dydt};
+  yTempRkck_.linearCombination(NULL,1.0,2,c,k);
+  std::vector<double> derivs;
+  for (size_t b=0; b<3; ++b) {
+    dydt.rowMaxScaled(NULL,b,derivs);
+    yTempRkck_.rowMaxScaled(NULL,b,rate[b]);
+    double floor = 0.0;
+    for (size_t i=0; i<derivs.size(); ++i)
+      floor = std::max(floor,derivs[i]);
+    floor = 1e-3*floor + 1e-30;
+    for (size_t i=0; i<rate[b].size(); ++i)
+      rate[b][i] /= delta*(derivs[i] + floor);
   }
-  size_t Nv=vertexData_.size();
-  for (size_t i=0; i<Nv; ++i) {
-    size_t Nvvar=vertexData_[i].size();
-    for (size_t j=0; j<Nvvar; ++j)
-      vertexData_[i][j] = yTempV[i][j];
+}
+
+void RK5Adaptive::swapDerivs()
+{
+  cellDerivs_.swap(dydtStep_.cell());
+  wallDerivs_.swap(dydtStep_.wall());
+  vertexDerivs_.swap(dydtStep_.vertex());
+}
+
+void RK5Adaptive::storeControllerState(double hDid, size_t revision)
+{
+  // The second stage of the accepted step gives the rate of change of the
+  // derivatives, ak2_ = f(y + b21*h*f)
+  rowRate(dydtStep_,ak2_,0.2*hDid,rowRate_);
+  for (size_t b=0; b<3; ++b) {
+    yErr_.rowMaxScaled(&yScal_,b,rowError_[b]);
+    for (size_t i=0; i<rowError_[b].size(); ++i)
+      rowError_[b][i] /= eps_;
+  }
+  topologyRevision_ = revision;
+}
+
+double RK5Adaptive::predictStep(double hDid, double hTry)
+{
+  // Probe the rates of the new state with the second stage of a step hTry
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  double delta = 0.2*hTry;
+  const double one[1] = {1.0};
+  const SolverState *k1[1] = {&dydt};
+  yTempRkck_.linearCombination(&y,delta,1,one,k1);
+  T_->derivs(yTempRkck_.cell(),yTempRkck_.wall(),yTempRkck_.vertex(),
+	     ak2_.cell(),ak2_.wall(),ak2_.vertex());
+  probeStep_ = hTry;
+  std::vector<double> rate[3];
+  rowRate(dydt,ak2_,delta,rate);
+  std::vector<size_t> neighbor;
+  double errMax = 0.0;
+  for (size_t b=0; b<3; ++b) {
+    std::map<size_t,size_t> oldRow;
+    double oldErrMax = 0.0, oldRateMax = 0.0;
+    for (size_t k=0; k<rowId_[b].size(); ++k) {
+      oldRow[rowId_[b][k]] = k;
+      oldErrMax = std::max(oldErrMax,rowError_[b][k]);
+      oldRateMax = std::max(oldRateMax,rowRate_[b][k]);
+    }
+    for (size_t i=0; i<rate[b].size(); ++i) {
+      size_t id = b==0 ? T_->cellStableId(i) :
+	(b==1 ? T_->wallStableId(i) : T_->vertexStableId(i));
+      double err = 0.0, rateRef = 0.0;
+      std::map<size_t,size_t>::const_iterator it = oldRow.find(id);
+      if (it != oldRow.end()) {
+	err = rowError_[b][it->second];
+	rateRef = rowRate_[b][it->second];
+      }
+      else {
+	// New element, use the matched neighbors (e.g. mother and sisters)
+	neighbor.clear();
+	if (b==0) {
+	  for (size_t k=0; k<T_->cell(i).numWall(); ++k) {
+	    Wall *w = T_->cell(i).wall(k);
+	    Cell *c = w->cell1()==&T_->cell(i) ? w->cell2() : w->cell1();
+	    if (c != T_->background())
+	      neighbor.push_back(T_->cellStableId(c->index()));
+	  }
+	}
+	else if (b==1) {
+	  Vertex *v[2] = {T_->wall(i).vertex1(),T_->wall(i).vertex2()};
+	  for (size_t n=0; n<2; ++n)
+	    for (size_t k=0; k<v[n]->numWall(); ++k)
+	      neighbor.push_back(T_->wallStableId(v[n]->wall(k)->index()));
+	}
+	else {
+	  for (size_t k=0; k<T_->vertex(i).numWall(); ++k) {
+	    Wall *w = T_->vertex(i).wall(k);
+	    Vertex *v = w->vertex1()==&T_->vertex(i) ? w->vertex2() : w->vertex1();
+	    neighbor.push_back(T_->vertexStableId(v->index()));
+	  }
+	}
+	size_t numMatched = 0;
+	for (size_t k=0; k<neighbor.size(); ++k) {
+	  std::map<size_t,size_t>::const_iterator n = oldRow.find(neighbor[k]);
+	  if (n != oldRow.end()) {
+	    err = std::max(err,rowError_[b][n->second]);
+	    rateRef = std::max(rateRef,rowRate_[b][n->second]);
+	    ++numMatched;
+	  }
+	}
+	if (!numMatched) {
+	  err = oldErrMax;
+	  rateRef = oldRateMax;
+	}
+      }
+      // Scale the old error by the squared ratio of the new to the old rate
+      if (rateRef > 0.0)
+	err *= pow(rate[b][i]/rateRef,2.0);
+      errMax = std::max(errMax,err);
+    }
   }
+  if (errMax > ERRCON) return SAFETY * hDid * pow(errMax, PGROW);
+  return 5.0 * hDid;
 }
 #undef SAFETY
 #undef PGROW
 #undef PSHRNK
 #undef ERRCON
 
-void RK5Adaptive::
-rkck(double h,
-     DataMatrix &yOutC,
-     DataMatrix &yOutW,
-     DataMatrix &yOutV,
-     DataMatrix &yErrC,
-     DataMatrix &yErrW,
-     DataMatrix &yErrV,
-     DataMatrix &ak2C,
-     DataMatrix &ak2W,
-     DataMatrix &ak2V,
-     DataMatrix &ak3C,
-     DataMatrix &ak3W,
-     DataMatrix &ak3V,
-     DataMatrix &ak4C,
-     DataMatrix &ak4W,
-     DataMatrix &ak4V,
-     DataMatrix &ak5C,
-     DataMatrix &ak5W,
-     DataMatrix &ak5V,
-     DataMatrix &ak6C,
-     DataMatrix &ak6W,
-     DataMatrix &ak6V,
-     DataMatrix &yTempRkckC, 
-     DataMatrix &yTempRkckW, 
-     DataMatrix &yTempRkckV ) 
-{  
-  //static double a2=0.2,a3=0.3,a4=0.6,a5=1.0,a6=0.875;
+void RK5Adaptive::rkck(double h) 
+{
   static double b21=0.2,
     b31=3.0/40.0,b32=9.0/40.0,b41=0.3,b42 = -0.9,b43=1.2,
     b51 = -11.0/54.0, b52=2.5,b53 = -70.0/27.0,b54=35.0/27.0,
@@ -453,130 +418,54 @@ rkck(double h,
   double dc1=c1-2825.0/27648.0,dc3=c3-18575.0/48384.0,
     dc4=c4-13525.0/55296.0,dc6=c6-0.25;
   
-  size_t Nc=cellData_.size(),Nw=wallData_.size(),Nv=vertexData_.size(),
-    Nwvar=wallData_[0].size(),
-    Nvvar=vertexData_[0].size();
-	
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yTempRkckC[i][j]=cellData_[i][j]+b21*h*cellDerivs_[i][j];
-	}
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yTempRkckW[i][j]=wallData_[i][j]+b21*h*wallDerivs_[i][j];
-	}
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yTempRkckV[i][j]=vertexData_[i][j]+b21*h*vertexDerivs_[i][j];
-  }
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  SolverState &yt = yTempRkck_;
   
-  T_->derivs(yTempRkckC,yTempRkckW,yTempRkckV,ak2C,ak2W,ak2V); // t + a2h
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yTempRkckC[i][j]=cellData_[i][j]+h*(b31*cellDerivs_[i][j]+b32*ak2C[i][j]);
-	}
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yTempRkckW[i][j]=wallData_[i][j]+h*(b31*wallDerivs_[i][j]+b32*ak2W[i][j]);
-	}
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yTempRkckV[i][j]=vertexData_[i][j]+h*(b31*vertexDerivs_[i][j]+b32*ak2V[i][j]);
-  }
-
-  T_->derivs(yTempRkckC,yTempRkckW,yTempRkckV,ak3C,ak2W,ak3V); // t + a3h
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yTempRkckC[i][j]=cellData_[i][j]+h*(b41*cellDerivs_[i][j]+b42*ak2C[i][j]+b43*ak3C[i][j]);
-	}
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yTempRkckW[i][j]=wallData_[i][j]+h*(b41*wallDerivs_[i][j]+b42*ak2W[i][j]+b43*ak3W[i][j]);
-	}
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yTempRkckV[i][j]=vertexData_[i][j]+h*(b41*vertexDerivs_[i][j]+b42*ak2V[i][j]+b43*ak3V[i][j]);
-  }
-
-  T_->derivs(yTempRkckC,yTempRkckW,yTempRkckV,ak4C,ak4W,ak4V); // t + a4 * h
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yTempRkckC[i][j]=cellData_[i][j]+h*
-        (b51*cellDerivs_[i][j]+b52*ak2C[i][j]+b53*ak3C[i][j]+b54*ak4C[i][j]);
-  }
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yTempRkckW[i][j]=wallData_[i][j]+h*
-        (b51*wallDerivs_[i][j]+b52*ak2W[i][j]+b53*ak3W[i][j]+b54*ak4W[i][j]);
-  }
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yTempRkckV[i][j]=vertexData_[i][j]+h*
-        (b51*vertexDerivs_[i][j]+b52*ak2V[i][j]+b53*ak3V[i][j]+b54*ak4V[i][j]);
-  }
-
-  T_->derivs(yTempRkckC,yTempRkckW,yTempRkckV,ak5C,ak5W,ak5V); // t + a5 * h
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yTempRkckC[i][j]=cellData_[i][j]+h*
-        (b61*cellDerivs_[i][j]+b62*ak2C[i][j]+b63*ak3C[i][j]+b64*ak4C[i][j]+
-         b65*ak5C[i][j]);
-  }
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yTempRkckW[i][j]=wallData_[i][j]+h*
-        (b61*wallDerivs_[i][j]+b62*ak2W[i][j]+b63*ak3W[i][j]+b64*ak4W[i][j]+
-         b65*ak5W[i][j]);
-  }
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yTempRkckV[i][j]=vertexData_[i][j]+h*
-        (b61*vertexDerivs_[i][j]+b62*ak2V[i][j]+b63*ak3V[i][j]+b64*ak4V[i][j]+
-         b65*ak5V[i][j]);
-  }
+  const double one[1] = {1.0};
+  const SolverState *k2[1] = {&dydt};
+  // The second stage is already given by the probe in predictStep() if the
+  // predicted step is the tried one
+  if (h != probeStep_) {
+    yt.linearCombination(&y,b21*h,1,one,k2);
+    T_->derivs(yt.cell(),yt.wall(),yt.vertex(),
+	       ak2_.cell(),ak2_.wall(),ak2_.vertex()); // t + a2h
+  }
+  probeStep_ = 0.0;
   
-  T_->derivs(yTempRkckC,yTempRkckW,yTempRkckV,ak6C,ak6W,ak6V); // t + a6 * h
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yOutC[i][j]=cellData_[i][j]+h*
-        (c1*cellDerivs_[i][j]+c3*ak3C[i][j]+c4*ak4C[i][j]+c6*ak6C[i][j]);
-  }
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yOutW[i][j]=wallData_[i][j]+h*
-        (c1*wallDerivs_[i][j]+c3*ak3W[i][j]+c4*ak4W[i][j]+c6*ak6W[i][j]);
-  }
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yOutV[i][j]=vertexData_[i][j]+h*
-        (c1*vertexDerivs_[i][j]+c3*ak3V[i][j]+c4*ak4V[i][j]+c6*ak6V[i][j]);
-  }
+  const double c3s[2] = {b31,b32};
+  const SolverState *k3[2] = {&dydt,&ak2_};
+  yt.linearCombination(&y,h,2,c3s,k3);
+  T_->derivs(yt.cell(),yt.wall(),yt.vertex(),
+	     ak3_.cell(),ak3_.wall(),ak3_.vertex()); // t + a3h
   
-  for (size_t i=0; i< Nc; ++i) {
-    size_t Ncvar = cellData_[i].size();
-    for (size_t j=0; j<Ncvar; ++j)
-      yErrC[i][j]=h*
-        (dc1*cellDerivs_[i][j]+dc3*ak3C[i][j]+dc4*ak4C[i][j]+
-         dc5*ak5C[i][j]+dc6*ak6C[i][j]);
-  }
-  for (size_t i=0; i< Nw; ++i) {
-    for (size_t j=0; j<Nwvar; ++j)
-      yErrW[i][j]=h*
-        (dc1*wallDerivs_[i][j]+dc3*ak3W[i][j]+dc4*ak4W[i][j]+
-         dc5*ak5W[i][j]+dc6*ak6W[i][j]);
-  }
-  for (size_t i=0; i< Nv; ++i) {
-    for (size_t j=0; j<Nvvar; ++j)
-      yErrV[i][j]=h*
-        (dc1*vertexDerivs_[i][j]+dc3*ak3V[i][j]+dc4*ak4V[i][j]+
-         dc5*ak5V[i][j]+dc6*ak6V[i][j]);
-  }
+  const double c4s[3] = {b41,b42,b43};
+  const SolverState *k4[3] = {&dydt,&ak2_,&ak3_};
+  yt.linearCombination(&y,h,3,c4s,k4);
+  T_->derivs(yt.cell(),yt.wall(),yt.vertex(),
+	     ak4_.cell(),ak4_.wall(),ak4_.vertex()); // t + a4 * h
+  
+  const double c5s[4] = {b51,b52,b53,b54};
+  const SolverState *k5[4] = {&dydt,&ak2_,&ak3_,&ak4_};
+  yt.linearCombination(&y,h,4,c5s,k5);
+  T_->derivs(yt.cell(),yt.wall(),yt.vertex(),
+	     ak5_.cell(),ak5_.wall(),ak5_.vertex()); // t + a5 * h
+  
+  const double c6s[5] = {b61,b62,b63,b64,b65};
+  const SolverState *k6[5] = {&dydt,&ak2_,&ak3_,&ak4_,&ak5_};
+  yt.linearCombination(&y,h,5,c6s,k6);
+  T_->derivs(yt.cell(),yt.wall(),yt.vertex(),
+	     ak6_.cell(),ak6_.wall(),ak6_.vertex()); // t + a6 * h
+  
+  // Accumulate increments with proper weights
+  const double cOut[4] = {c1,c3,c4,c6};
+  const SolverState *kOut[4] = {&dydt,&ak3_,&ak4_,&ak6_};
+  yTemp_.linearCombination(&y,h,4,cOut,kOut);
+  
+  // Estimate error as difference between fourth and fifth order methods
+  const double cErr[5] = {dc1,dc3,dc4,dc5,dc6};
+  const SolverState *kErr[5] = {&dydt,&ak3_,&ak4_,&ak5_,&ak6_};
+  yErr_.linearCombination(NULL,h,5,cErr,kErr);
 }
 
 //
@@ -645,31 +534,10 @@ void RK4::simulate(size_t verbose)
   assert( vertexData_.size() == T_->numVertex() && 
 	  vertexData_.size()==vertexDerivs_.size() );
   //
-  // Create all vectors that will be needed by rk4()!
+  // Create all temporary states that will be needed by rk4()
   //
-  size_t Nc=T_->numCell(),Nw=T_->numWall(),Nv=T_->numVertex();
-  DataMatrix ytCell(Nc),dytCell(Nc),dymCell(Nc),
-    ytWall(Nw),dytWall(Nw),dymWall(Nw),
-    ytVertex(Nv),dytVertex(Nv),dymVertex(Nv);
-  //Resize each vector
-  //size_t Ncvar=T_->cell(0).numVariable();
-  for( size_t i=0 ; i<Nc ; ++i ) {
-    ytCell[i].resize(cellData_[i].size());
-    dytCell[i].resize(cellData_[i].size());
-    dymCell[i].resize(cellData_[i].size());
-  }
-  //size_t Nwvar=T_->wall(0).numVariable()+1;
-  for( size_t i=0 ; i<Nw ; ++i ) {
-    ytWall[i].resize(wallData_[i].size());
-    dytWall[i].resize(wallData_[i].size());
-    dymWall[i].resize(wallData_[i].size());
-  }
-  //size_t Nvvar=T_->vertex(0).numPosition();
-  for( size_t i=0 ; i<Nv ; ++i ) {
-    ytVertex[i].resize(vertexData_[i].size());
-    dytVertex[i].resize(vertexData_[i].size());
-    dymVertex[i].resize(vertexData_[i].size());
-  }
+  resizeTemporaries();
+  
   // Initiate print times
   //
   double tiny = 1e-10;
@@ -694,12 +562,16 @@ void RK4::simulate(size_t verbose)
   numOk_ = numBad_ = 0;
   while( t_<endTime_ ) {
     if (debugFlag()) {
-      cellDataCopy_[debugCount()] = cellData_;
+      recordDebug();
     } 
     //Update the derivatives
     T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
 	       vertexDerivs_);
     
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+    
     //Print if applicable 
     if( doPrint && t_ >= printTime ) {
       printTime += printDeltaTime;
@@ -712,8 +584,7 @@ void RK4::simulate(size_t verbose)
     //if( t_+h>tMin ) h=tMin-t_;
     
     //Update
-    rk4(ytCell,ytWall,ytVertex,dytCell,dytWall,dytVertex,
-				dymCell,dymWall,dymVertex);
+    rk4();
     numOk_++;
     
     //
@@ -721,25 +592,17 @@ void RK4::simulate(size_t verbose)
     //
     T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
 			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
     T_->updateReactions(cellData_,wallData_,vertexData_,h_);
     T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
 			       cellDerivs_,wallDerivs_,vertexDerivs_ );
     
     // Check the tissue connectivity in each step
     T_->checkConnectivity(1);
+    checkRenumber();
     
-    // Resize temporary containers as well
-    if(cellData_.size() != ytCell.size() ) {
-      ytCell.resize( cellData_.size(), ytCell[0] );
-      ytWall.resize( wallData_.size(), ytWall[0] );
-      ytVertex.resize( vertexData_.size(), ytVertex[0] );
-      dytCell.resize( cellDerivs_.size(), dytCell[0] );
-      dymCell.resize( cellDerivs_.size(), dymCell[0] );
-      dytWall.resize( wallDerivs_.size(), dytWall[0] );
-      dymWall.resize( wallDerivs_.size(), dymWall[0] );
-      dytVertex.resize( vertexDerivs_.size(), dytVertex[0] );
-      dymVertex.resize( vertexDerivs_.size(), dymVertex[0] );
-    }
+    // Resize temporary states as well (rows kept, amortized)
+    resizeTemporaries();
     
     //update time variable
     if( (t_+h_)==t_ ) {
@@ -758,77 +621,45 @@ void RK4::simulate(size_t verbose)
   return;
 }
 
-void RK4::rk4(DataMatrix &ytCell,
-							DataMatrix &ytWall,
-							DataMatrix &ytVertex,
-							DataMatrix &dytCell,
-							DataMatrix &dytWall,
-							DataMatrix &dytVertex,
-							DataMatrix &dymCell,
-							DataMatrix &dymWall,
-							DataMatrix &dymVertex )
+void RK4::resizeTemporaries()
+{
+  SolverState y(cellData_,wallData_,vertexData_);
+  yt_.resizeLike(y);
+  dyt_.resizeLike(y);
+  dym_.resizeLike(y);
+}
+
+void RK4::rk4()
 {  
   double hh=0.5*h_;
   double h6=h_/6.0;
-  // Take first half step
-  // Is this first derivs calculation needed?
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  const double one[1] = {1.0};
+  
+  // Is this derivs calculation needed?
   T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,vertexDerivs_);
-  for( size_t i=0 ; i<ytCell.size() ; ++i )
-    for( size_t j=0 ; j<ytCell[i].size() ; ++j )
-      ytCell[i][j] = cellData_[i][j] + hh*cellDerivs_[i][j];
-  for( size_t i=0 ; i<ytWall.size() ; ++i )
-    for( size_t j=0 ; j<ytWall[i].size() ; ++j )
-      ytWall[i][j] = wallData_[i][j] + hh*wallDerivs_[i][j];
-  for( size_t i=0 ; i<ytVertex.size() ; ++i )
-    for( size_t j=0 ; j<ytVertex[i].size() ; ++j )
-      ytVertex[i][j] = vertexData_[i][j] + hh*vertexDerivs_[i][j];
+  const SolverState *k1[1] = {&dydt};
+  yt_.linearCombination(&y,hh,1,one,k1);
   
-  // Take second half step
-  T_->derivs(ytCell,ytWall,ytVertex,dytCell,dytWall,dytVertex);    
-  for( size_t i=0 ; i<ytCell.size() ; ++i )
-    for( size_t j=0 ; j<ytCell[i].size() ; ++j )
-      ytCell[i][j] = cellData_[i][j] + hh*dytCell[i][j];
-  for( size_t i=0 ; i<ytWall.size() ; ++i )
-    for( size_t j=0 ; j<ytWall[i].size() ; ++j )
-      ytWall[i][j] = wallData_[i][j] + hh*dytWall[i][j];
-  for( size_t i=0 ; i<ytVertex.size() ; ++i )
-    for( size_t j=0 ; j<ytVertex[i].size() ; ++j )
-      ytVertex[i][j] = vertexData_[i][j] + hh*dytVertex[i][j];
+  T_->derivs(yt_.cell(),yt_.wall(),yt_.vertex(),
+	     dyt_.cell(),dyt_.wall(),dyt_.vertex());
+  const SolverState *k2[1] = {&dyt_};
+  yt_.linearCombination(&y,hh,1,one,k2);
   
-  // Take temporary 'full' step
-  T_->derivs(ytCell,ytWall,ytVertex,dymCell,dymWall,dymVertex);
-  for( size_t i=0 ; i<cellData_.size() ; ++i )
-    for( size_t j=0 ; j<cellData_[i].size() ; ++j ) {
-      ytCell[i][j] = cellData_[i][j] + h_*dymCell[i][j];
-      dymCell[i][j] += dytCell[i][j];
-    }
-  for( size_t i=0 ; i<wallData_.size() ; ++i )
-    for( size_t j=0 ; j<wallData_[i].size() ; ++j ) {
-      ytWall[i][j] = wallData_[i][j] + h_*dymWall[i][j];
-      dymWall[i][j] += dytWall[i][j];
-    }
-  for( size_t i=0 ; i<vertexData_.size() ; ++i )
-    for( size_t j=0 ; j<vertexData_[i].size() ; ++j ) {
-      ytVertex[i][j] = vertexData_[i][j] + h_*dymVertex[i][j];
-      dymVertex[i][j] = dytVertex[i][j];
-    }
-  // Take full step
-  T_->derivs(ytCell,ytWall,ytVertex,dytCell,dytWall,dytVertex);
-  for( size_t i=0 ; i<cellData_.size() ; ++i )
-    for( size_t j=0 ; j<cellData_[i].size() ; ++j )
-      cellData_[i][j] = cellData_[i][j] +
-				h6*(cellDerivs_[i][j]+dytCell[i][j]+2.0*dymCell[i][j]);
-  for( size_t i=0 ; i<wallData_.size() ; ++i )
-    for( size_t j=0 ; j<wallData_[i].size() ; ++j )
-      wallData_[i][j] = wallData_[i][j] +
-				h6*(wallDerivs_[i][j]+dytWall[i][j]+2.0*dymWall[i][j]);
-  for( size_t i=0 ; i<vertexData_.size() ; ++i )
-    for( size_t j=0 ; j<vertexData_[i].size() ; ++j )
-      vertexData_[i][j] = vertexData_[i][j] + 
-				h6*(vertexDerivs_[i][j]+dytVertex[i][j]+2.0*dymVertex[i][j]);
+  T_->derivs(yt_.cell(),yt_.wall(),yt_.vertex(),
+	     dym_.cell(),dym_.wall(),dym_.vertex());
+  const SolverState *k3[1] = {&dym_};
+  yt_.linearCombination(&y,h_,1,one,k3);
+  dym_.axpy(1.0,dyt_);
+  
+  T_->derivs(yt_.cell(),yt_.wall(),yt_.vertex(),
+	     dyt_.cell(),dyt_.wall(),dyt_.vertex());
+  const double c[3] = {1.0,1.0,2.0};
+  const SolverState *k[3] = {&dydt,&dyt_,&dym_};
+  y.linearCombination(&y,h6,3,c,k);
 }
 
-//!Finds the maximal |dydt|/|y| for the system
 double RK4::maxDerivative() {  
   std::cerr << "RK4::maxDerivative()" << std::endl;
   exit(-1);
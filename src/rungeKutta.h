@@ -2,6 +2,7 @@
 #define RUNGEKUTTA_H
 
 #include "baseSolver.h"
+#include "solverState.h"
 
 ///
 /// @brief A fifth order Runge-Kutta solver for ODEs
@@ -17,6 +18,35 @@ private:
 	double eps_;
 	double h1_;
 
+	SolverState yScal_, yTemp_, yErr_;
+	SolverState ak2_, ak3_, ak4_, ak5_, ak6_;
+	SolverState yTempRkck_;
+
+	///
+	/// Error controller state of the last accepted step for each cell, wall
+	/// and vertex (block 0,1,2): the scaled error (relative to eps), the
+	/// rate (inverse time scale) of the element, and its stable id.
+	///
+	std::vector<double> rowError_[3];
+	std::vector<double> rowRate_[3];
+	std::vector<size_t> rowId_[3];
+	size_t topologyRevision_;
+	///
+	/// Topology revision for which rowId_ and the shape of dydtStep_ are
+	/// valid
+	///
+	size_t rowIdRevision_;
+	///
+	/// Derivatives at the start of the last step, kept aside during the
+	/// compartment changes
+	///
+	SolverState dydtStep_;
+	///
+	/// Step size for which ak2_ holds the second stage from the probe in
+	/// predictStep() (0 if not valid)
+	///
+	double probeStep_;
+
 public:
 	///
 	/// @brief Main constructor
@@ -58,60 +88,60 @@ public:
 	///
 	/// @brief Fifth order Runge-Kutta adaptive stepper.
 	///
-	void rkqs(double hTry, double &hDid, double &hNext,
-		  DataMatrix &yScalC,
-		  DataMatrix &yScalW,
-		  DataMatrix &yScalV,
-		  DataMatrix &yTempC,
-		  DataMatrix &yTempW,
-		  DataMatrix &yTempV,
-		  DataMatrix &yErrC,
-		  DataMatrix &yErrW,
-		  DataMatrix &yErrV,
-		  DataMatrix &ak2C,
-		  DataMatrix &ak2W,
-		  DataMatrix &ak2V,
-		  DataMatrix &ak3C,
-		  DataMatrix &ak3W,
-		  DataMatrix &ak3V,
-		  DataMatrix &ak4C,
-		  DataMatrix &ak4W,
-		  DataMatrix &ak4V,
-		  DataMatrix &ak5C,
-		  DataMatrix &ak5W,
-		  DataMatrix &ak5V,
-		  DataMatrix &ak6C,
-		  DataMatrix &ak6W,
-		  DataMatrix &ak6V,
-		  DataMatrix &yTempRkckC,
-		  DataMatrix &yTempRkckW,
-		  DataMatrix &yTempRkckV);
+	void rkqs(double hTry, double &hDid, double &hNext);
+	
+	///
+	/// @brief Cash-Karp step of size h, storing the result in yTemp_ and the
+	/// error estimate in yErr_.
+	///
+	void rkck(double h);
 	
-	void rkck(double h,
-		  DataMatrix &yOutC,
-		  DataMatrix &yOutW,
-		  DataMatrix &yOutV,
-		  DataMatrix &yErrC,
-		  DataMatrix &yErrW,
-		  DataMatrix &yErrV,
-		  DataMatrix &ak2C,
-		  DataMatrix &ak2W,
-		  DataMatrix &ak2V,
-		  DataMatrix &ak3C,
-		  DataMatrix &ak3W,
-		  DataMatrix &ak3V,
-		  DataMatrix &ak4C,
-		  DataMatrix &ak4W,
-		  DataMatrix &ak4V,
-		  DataMatrix &ak5C,
-		  DataMatrix &ak5W,
-		  DataMatrix &ak5V,
-		  DataMatrix &ak6C,
-		  DataMatrix &ak6W,
-		  DataMatrix &ak6V,
-		  DataMatrix &yTempRkckC, 
-		  DataMatrix &yTempRkckW, 
-		  DataMatrix &yTempRkckV ); 
+	///
+	/// @brief Adapts the sizes of the temporary states to the current tissue
+	///
+	void resizeTemporaries();
+	
+	///
+	/// @brief Sets the rate of each element from the change of the
+	/// derivatives, |dydtProbe-dydt|/(delta*|dydt|), where dydtProbe are the
+	/// derivatives at y+delta*dydt (uses yTempRkck_)
+	///
+	void rowRate(const SolverState &dydt, const SolverState &dydtProbe,
+		     double delta, std::vector<double> rate[3]);
+	
+	///
+	/// @brief Swaps the derivatives (cellDerivs_, wallDerivs_,
+	/// vertexDerivs_) with dydtStep_
+	///
+	void swapDerivs();
+	
+	///
+	/// @brief Stores the per element error controller state of an accepted
+	/// step (from yErr_, yScal_, the second stage ak2_ and dydtStep_)
+	///
+	/// @details Only called when the topology changed after the step
+	/// (revision is the topology revision of the step), since the state is
+	/// only used by predictStep().
+	///
+	void storeControllerState(double hDid, size_t revision);
+	
+	///
+	/// @brief Predicts the step size after a topology change from the stored
+	/// per element errors and rates
+	///
+	/// @details The rates of the new state are probed with a single
+	/// derivative evaluation at the second stage of a step hTry. Elements are
+	/// matched to the stored ones by their stable ids, and new elements (e.g.
+	/// daughter cells and the walls and vertices created in a division)
+	/// inherit the largest error and rate of their matched neighbors (cells
+	/// sharing a wall, walls sharing a vertex, vertices sharing a wall). The
+	/// error of each element is multiplied by (rate/storedRate)^2 (the
+	/// exponent is empirical, from growth and division models), and the
+	/// step is given by the same rule as in rkqs() from the largest error. The step is only decreased by the prediction,
+	/// and if hTry is kept the probe is reused as the second stage of the
+	/// step.
+	///
+	double predictStep(double hDid, double hTry);
 	
 	double maxDerivative();
 };
@@ -125,6 +155,8 @@ class RK4 : public BaseSolver {
 
   double h_;
 
+  SolverState yt_, dyt_, dym_;
+
  public:	
   ///
   /// @brief Main constructor.
@@ -168,15 +200,12 @@ class RK4 : public BaseSolver {
   ///
   /// @brief Fourth order Runge-Kutta stepper
   ///
-  void rk4(DataMatrix &ytCell,
-	   DataMatrix &ytWall,
-	   DataMatrix &ytVertex,
-	   DataMatrix &dytCell,
-	   DataMatrix &dytWall,
-	   DataMatrix &dytVertex,
-	   DataMatrix &dymCell,
-	   DataMatrix &dymWall,
-	   DataMatrix &dymVertex );
+  void rk4();
+  
+  ///
+  /// @brief Adapts the sizes of the temporary states to the current tissue
+  ///
+  void resizeTemporaries();
   
   double maxDerivative();
 };
@@ -10,6 +10,7 @@
 #include "../baseSolver.h"
 #include "../cell.h"
 #include "../myConfig.h"
+#include "../myParallel.h"
 #include "../mySignal.h"
 #include "../myTimes.h"
 #include "../tissue.h"
@@ -66,6 +67,15 @@ int main(int argc,char *argv[]) {
   //myConfig::registerOption("wallOutput", 0);
   myConfig::registerOption("verbose", 1);
   myConfig::registerOption("debug_output", 1);
+  myConfig::registerOption("debug_steps", 1);
+  myConfig::registerOption("renumber", 1);
+  myConfig::registerOption("threads", 1);
+  myConfig::registerOption("vtu_pieces", 1);
+  myConfig::registerOption("vtu_partition", 1);
+  myConfig::registerOption("geometry", 0);
+  myConfig::registerOption("schedule", 0);
+  myConfig::registerOption("jacobian_check", 0);
+  myConfig::registerOption("jacobian_tolerance", 1);
   
   int verboseFlag=1;
   std::string verboseString;
@@ -101,8 +111,35 @@ int main(int argc,char *argv[]) {
 	      << "Available formats are tissue (default), fem, centerTriTissue and triTissue." << std::endl;
     std::cerr << "-verbose flag - Set flag for verbose (flag=1) or "
 	      << "silent (0) output mode to stderr." << std::endl; 
-    std::cerr << "-debug_output file - Saves the last ten variable"
-	      << " states before exiting." << std::endl;
+    std::cerr << "-debug_output file - Saves the last ten cell, wall and"
+	      << " vertex states before exiting." << std::endl;
+    std::cerr << "-debug_steps num - Number of states kept for -debug_output"
+	      << " (default 10)." << std::endl;
+    std::cerr << "-renumber interval - Renumbers cells, walls and vertices for"
+	      << " memory locality at load and every interval steps (0: only"
+	      << " at load). The stable ids of the printed states are"
+	      << " written to tissue.ids." << std::endl;
+    std::cerr << "-threads num - Number of threads used for parallel parts"
+	      << " (default 1, 0 uses all hardware threads)." << std::endl;
+    std::cerr << "-vtu_pieces num - Splits vtu output (printFlag 1 and 2) into"
+	      << " num pieces written in parallel, with a .pvtu master file per"
+	      << " time point." << std::endl;
+    std::cerr << "-vtu_partition mode - Partitioning of cells into vtu pieces,"
+	      << " index (ranges of cell indices, default) or spatial (recursive"
+	      << " bisection of cell centers)." << std::endl;
+    std::cerr << "-geometry - Calculates reactions providing it (e.g."
+	      << " VertexFromWallSpring, VertexFromTRBS) on the index based"
+	      << " face/edge/vertex geometry." << std::endl;
+    std::cerr << "-schedule - Calculates independent reactions in parallel"
+	      << " (with -threads) using their declared read/write sets."
+	      << std::endl;
+    std::cerr << "-jacobian_check - Compares the vertex Jacobian from the"
+	      << " analytic element blocks (e.g. VertexFromWallSpring,"
+	      << " VertexFromTRBS) with finite differences at the initial"
+	      << " state, and exits with failure if the relative deviation"
+	      << " exceeds the tolerance." << std::endl;
+    std::cerr << "-jacobian_tolerance tol - Relative tolerance for"
+	      << " -jacobian_check (default 1e-6)." << std::endl;
     std::cerr << "-help - Shows this message." << std::endl;
     exit(EXIT_FAILURE);
   } else if (myConfig::argc() != 4 ) {
@@ -110,6 +147,17 @@ int main(int argc,char *argv[]) {
     exit(EXIT_FAILURE);
   }
   
+  std::string threadString = myConfig::getValue("threads", 0);
+  if( !threadString.empty() ) {
+    int numThread = atoi( threadString.c_str() );
+    if( numThread<0 ) {
+      std::cerr << "Number of threads given to -threads must be"
+		<< " non-negative." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    myParallel::setNumThread( static_cast<size_t>(numThread) );
+  }
+  
   // Create the tissue and read init and model files
   std::string modelFile = myConfig::argv(1);
   std::string initFile = myConfig::argv(2);
@@ -127,6 +175,21 @@ int main(int argc,char *argv[]) {
     std::cerr << "Assuming init file format with central triangulation stored in cell variables." << std::endl;
     T.readInitCenterTri(initFile.c_str(),verboseFlag);
   }
+  if (myConfig::getBooleanValue("geometry")) {
+    if (verboseFlag)
+      std::cerr << "Using geometry kernels in derivative calculations." << std::endl;
+    T.setGeometryFlag(1);
+  }
+  if (myConfig::getBooleanValue("schedule")) {
+    T.setScheduleFlag(1);
+    if (verboseFlag) {
+      std::vector<size_t> reactionList(T.numReaction());
+      for (size_t r=0; r<T.numReaction(); ++r)
+	reactionList[r] = r;
+      std::cerr << "Using reaction schedule in derivative calculations: ";
+      T.reactionSchedule(reactionList).print(T.reaction(),std::cerr);
+    }
+  }
   
   // Create solver and initiate values
   if (verboseFlag)
@@ -140,6 +203,21 @@ int main(int argc,char *argv[]) {
   if (verboseFlag)
     std::cerr << "Initiating solver from tissue." << std::endl; 
   S->getInit();
+  if (myConfig::getBooleanValue("jacobian_check")) {
+    double tolerance = 1e-6;
+    std::string toleranceString = myConfig::getValue("jacobian_tolerance", 0);
+    if( !toleranceString.empty() ) {
+      tolerance = atof( toleranceString.c_str() );
+      if( tolerance<0.0 ) {
+	std::cerr << "Tolerance given to -jacobian_tolerance must be"
+		  << " non-negative." << std::endl;
+	exit(EXIT_FAILURE);
+      }
+    }
+    if (!S->checkVertexJacobian(std::cerr,tolerance))
+      return EXIT_FAILURE;
+    return 0;
+  }
   std::cerr << "Start simulation." << std::endl;
   S->simulate();
   
@@ -183,6 +261,7 @@ int main(int argc,char *argv[]) {
 	std::cerr << "Warning: main() - Format " << initFormat << " not recognized. "
 		  << "No init file written." << std::endl;
       }
+      S->printStableId();
     }
   }
 }
@@ -0,0 +1,234 @@
+//
+// Filename     : smallVector.h
+// Description  : A vector with inline storage used for the cell and vertex neighbor lists
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+///
+/// @brief A vector of plain (trivially copyable) elements storing up to N
+/// elements within the object itself
+///
+/// @details Used for the connectivity lists of cells and vertices (pointers
+/// to walls, vertices and cells), which almost always hold a handful of
+/// elements. Lists not larger than N need no heap block, are copied without
+/// allocation (e.g. when a cell is added at division), and are read from
+/// the same cache lines as the rest of the object. Larger lists move to the
+/// heap with doubling capacity as a std::vector. The interface is the
+/// subset of std::vector used for the connectivity, with pointers as
+/// iterators.
+///
+template<class T,size_t N>
+class SmallVector {
+
+ public:
+
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+  typedef size_t size_type;
+
+ private:
+
+  T* data_;
+  size_t size_;
+  size_t capacity_;
+  T inline_[N];
+
+  inline bool isInline() const { return data_==inline_; }
+  void grow(size_t minCapacity);
+
+ public:
+
+  inline SmallVector();
+  inline SmallVector(const SmallVector &other);
+  inline SmallVector(const std::vector<T> &other);
+  inline ~SmallVector();
+  SmallVector & operator=(const SmallVector &other);
+  SmallVector & operator=(const std::vector<T> &other);
+  ///
+  /// @brief Replaces the content with the elements in [first,last)
+  ///
+  void assign(const T* first,const T* last);
+
+  inline size_t size() const { return size_; }
+  inline bool empty() const { return size_==0; }
+  inline size_t capacity() const { return capacity_; }
+  inline void reserve(size_t n) { if( n>capacity_ ) grow(n); }
+
+  inline T& operator[](size_t k) { assert(k<size_); return data_[k]; }
+  inline const T& operator[](size_t k) const { assert(k<size_); return data_[k]; }
+  inline T& front() { return data_[0]; }
+  inline const T& front() const { return data_[0]; }
+  inline T& back() { return data_[size_-1]; }
+  inline const T& back() const { return data_[size_-1]; }
+  inline T* data() { return data_; }
+  inline const T* data() const { return data_; }
+
+  inline iterator begin() { return data_; }
+  inline iterator end() { return data_+size_; }
+  inline const_iterator begin() const { return data_; }
+  inline const_iterator end() const { return data_+size_; }
+
+  inline void clear() { size_=0; }
+  inline void push_back(const T &value);
+  inline void pop_back() { assert(size_); --size_; }
+  void resize(size_t n,const T &value=T());
+  ///
+  /// @brief Inserts value before pos and returns an iterator to it
+  ///
+  iterator insert(iterator pos,const T &value);
+  ///
+  /// @brief Removes the element at pos and returns an iterator to the next
+  ///
+  iterator erase(iterator pos);
+  ///
+  /// @brief Removes the elements in [first,last)
+  ///
+  iterator erase(iterator first,iterator last);
+  ///
+  /// @brief Returns a std::vector copy of the elements
+  ///
+  inline std::vector<T> vector() const { return std::vector<T>(begin(),end()); }
+};
+
+template<class T,size_t N>
+inline SmallVector<T,N>::SmallVector() :
+  data_(inline_), size_(0), capacity_(N)
+{
+}
+
+template<class T,size_t N>
+inline SmallVector<T,N>::SmallVector(const SmallVector &other) :
+  data_(inline_), size_(0), capacity_(N)
+{
+  assign(other.begin(),other.end());
+}
+
+template<class T,size_t N>
+inline SmallVector<T,N>::SmallVector(const std::vector<T> &other) :
+  data_(inline_), size_(0), capacity_(N)
+{
+  assign(other.data(),other.data()+other.size());
+}
+
+template<class T,size_t N>
+inline SmallVector<T,N>::~SmallVector()
+{
+  if( !isInline() )
+    delete[] data_;
+}
+
+template<class T,size_t N>
+SmallVector<T,N> & SmallVector<T,N>::operator=(const SmallVector &other)
+{
+  if( this!=&other )
+    assign(other.begin(),other.end());
+  return *this;
+}
+
+template<class T,size_t N>
+SmallVector<T,N> & SmallVector<T,N>::operator=(const std::vector<T> &other)
+{
+  assign(other.data(),other.data()+other.size());
+  return *this;
+}
+
+template<class T,size_t N>
+void SmallVector<T,N>::assign(const T* first,const T* last)
+{
+  size_t n = last-first;
+  if( n>capacity_ ) {
+    size_=0;
+    grow(n);
+  }
+  if( n )
+    std::memmove(data_,first,n*sizeof(T));
+  size_ = n;
+}
+
+template<class T,size_t N>
+void SmallVector<T,N>::grow(size_t minCapacity)
+{
+  size_t newCapacity = 2*capacity_;
+  if( newCapacity<minCapacity )
+    newCapacity = minCapacity;
+  T* newData = new T[newCapacity];
+  if( size_ )
+    std::memcpy(newData,data_,size_*sizeof(T));
+  if( !isInline() )
+    delete[] data_;
+  data_ = newData;
+  capacity_ = newCapacity;
+}
+
+template<class T,size_t N>
+inline void SmallVector<T,N>::push_back(const T &value)
+{
+  if( size_==capacity_ ) {
+    T copy = value;//value may be an element of this vector
+    grow(size_+1);
+    data_[size_++] = copy;
+    return;
+  }
+  data_[size_++] = value;
+}
+
+template<class T,size_t N>
+void SmallVector<T,N>::resize(size_t n,const T &value)
+{
+  if( n>capacity_ ) {
+    T copy = value;
+    grow(n);
+    for( size_t k=size_ ; k<n ; ++k )
+      data_[k] = copy;
+  }
+  else
+    for( size_t k=size_ ; k<n ; ++k )
+      data_[k] = value;
+  size_ = n;
+}
+
+template<class T,size_t N>
+typename SmallVector<T,N>::iterator SmallVector<T,N>::
+insert(iterator pos,const T &value)
+{
+  size_t k = pos-data_;
+  assert(k<=size_);
+  T copy = value;
+  if( size_==capacity_ )
+    grow(size_+1);
+  if( k<size_ )
+    std::memmove(data_+k+1,data_+k,(size_-k)*sizeof(T));
+  data_[k] = copy;
+  ++size_;
+  return data_+k;
+}
+
+template<class T,size_t N>
+typename SmallVector<T,N>::iterator SmallVector<T,N>::erase(iterator pos)
+{
+  return erase(pos,pos+1);
+}
+
+template<class T,size_t N>
+typename SmallVector<T,N>::iterator SmallVector<T,N>::
+erase(iterator first,iterator last)
+{
+  assert(first>=data_ && last<=data_+size_ && first<=last);
+  size_t n = end()-last;
+  if( n && first!=last )
+    std::memmove(first,last,n*sizeof(T));
+  size_ -= last-first;
+  return first;
+}
+
+#endif
@@ -0,0 +1,162 @@
+//
+// Filename     : solverState.cc
+// Description  : Bundled cell/wall/vertex state used by the numerical solvers
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <assert.h>
+#include <cmath>
+#include "solverState.h"
+
+SolverState::SolverState()
+{
+  for (size_t b=0; b<3; ++b)
+    block_[b] = &own_[b];
+}
+
+SolverState::SolverState(DataMatrix &cellData, DataMatrix &wallData,
+			 DataMatrix &vertexData)
+{
+  block_[0] = &cellData;
+  block_[1] = &wallData;
+  block_[2] = &vertexData;
+}
+
+void SolverState::resizeLike(const SolverState &y)
+{
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    const DataMatrix &ym = *y.block_[b];
+    m.resize(ym.size());
+    for (size_t i=0; i<ym.size(); ++i)
+      if (m[i].size() != ym[i].size())
+	m[i].resize(ym[i].size());
+  }
+}
+
+void SolverState::fill(double val)
+{
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    for (size_t i=0; i<m.size(); ++i) {
+      double *p = m[i].empty() ? NULL : &m[i][0];
+      size_t n = m[i].size();
+      for (size_t j=0; j<n; ++j)
+	p[j] = val;
+    }
+  }
+}
+
+void SolverState::assign(const SolverState &y)
+{
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    const DataMatrix &ym = *y.block_[b];
+    assert(m.size()==ym.size());
+    for (size_t i=0; i<m.size(); ++i) {
+      size_t n = m[i].size();
+      if (!n) continue;
+      double *p = &m[i][0];
+      const double *q = &ym[i][0];
+      for (size_t j=0; j<n; ++j)
+	p[j] = q[j];
+    }
+  }
+}
+
+void SolverState::axpy(double a, const SolverState &x)
+{
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    const DataMatrix &xm = *x.block_[b];
+    assert(m.size()==xm.size());
+    for (size_t i=0; i<m.size(); ++i) {
+      size_t n = m[i].size();
+      if (!n) continue;
+      double *p = &m[i][0];
+      const double *q = &xm[i][0];
+      for (size_t j=0; j<n; ++j)
+	p[j] = p[j] + a*q[j];
+    }
+  }
+}
+
+void SolverState::linearCombination(const SolverState *y0, double h, size_t n,
+				    const double *c, const SolverState * const *k)
+{
+  assert(n>0 && n<=8);
+  const double *kp[8];
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    for (size_t i=0; i<m.size(); ++i) {
+      size_t N = m[i].size();
+      if (!N) continue;
+      double *p = &m[i][0];
+      const double *y0p = y0 ? &y0->block(b)[i][0] : NULL;
+      for (size_t l=0; l<n; ++l)
+	kp[l] = &k[l]->block(b)[i][0];
+      for (size_t j=0; j<N; ++j) {
+	double sum = c[0]*kp[0][j];
+	for (size_t l=1; l<n; ++l)
+	  sum += c[l]*kp[l][j];
+	p[j] = y0p ? y0p[j] + h*sum : h*sum;
+      }
+    }
+  }
+}
+
+void SolverState::setErrorScale(const SolverState &y, const SolverState &dydt,
+				double h, double tiny)
+{
+  for (size_t b=0; b<3; ++b) {
+    DataMatrix &m = *block_[b];
+    for (size_t i=0; i<m.size(); ++i) {
+      size_t N = m[i].size();
+      if (!N) continue;
+      double *p = &m[i][0];
+      const double *yp = &y.block(b)[i][0];
+      const double *dp = &dydt.block(b)[i][0];
+      for (size_t j=0; j<N; ++j)
+	p[j] = std::fabs(yp[j]) + std::fabs(dp[j]*h) + tiny;
+    }
+  }
+}
+
+double SolverState::maxScaledError(const SolverState &scale) const
+{
+  double errMax = 0.0;
+  for (size_t b=0; b<3; ++b) {
+    const DataMatrix &m = *block_[b];
+    for (size_t i=0; i<m.size(); ++i) {
+      size_t N = m[i].size();
+      if (!N) continue;
+      const double *p = &m[i][0];
+      const double *s = &scale.block(b)[i][0];
+      for (size_t j=0; j<N; ++j) {
+	double aux = std::fabs(p[j]/s[j]);
+	if (aux > errMax)
+	  errMax = aux;
+      }
+    }
+  }
+  return errMax;
+}
+
+void SolverState::rowMaxScaled(const SolverState *scale, size_t b,
+			       std::vector<double> &value) const
+{
+  const DataMatrix &m = *block_[b];
+  value.assign(m.size(),0.0);
+  for (size_t i=0; i<m.size(); ++i) {
+    size_t N = m[i].size();
+    if (!N) continue;
+    const double *p = &m[i][0];
+    const double *s = scale ? &scale->block(b)[i][0] : NULL;
+    for (size_t j=0; j<N; ++j) {
+      double aux = s ? std::fabs(p[j]/s[j]) : std::fabs(p[j]);
+      if (aux > value[i])
+	value[i] = aux;
+    }
+  }
+}
@@ -0,0 +1,117 @@
+#ifndef SOLVERSTATE_H
+#define SOLVERSTATE_H
+//
+// Filename     : solverState.h
+// Description  : Bundled cell/wall/vertex state used by the numerical solvers
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <cstddef>
+#include <vector>
+#include "myTypedefs.h"
+
+///
+/// @brief Bundles the cell, wall and vertex matrices of a solver state (or
+/// derivative, error, scale, ...) and provides the vector operations used in
+/// explicit update schemes
+///
+/// @details A SolverState either owns its three DataMatrix blocks (used for
+/// solver temporaries), or refers to matrices owned by someone else (used to
+/// operate directly on e.g. BaseSolver::cellData_, wallData_, vertexData_).
+/// All operations loop over the three blocks in one go, with contiguous
+/// inner loops over each row, such that a stage update is a single call:
+/// @verbatim
+/// SolverState y(cellData_,wallData_,vertexData_);
+/// SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+/// y.axpy(h,dydt);                  // y += h*dydt
+/// @endverbatim
+/// Owned states are adapted to a new size (after divisions/removals) with
+/// resizeLike() which keeps existing rows and capacity, such that
+/// reallocation is amortized over topology changes.
+///
+class SolverState {
+
+ private:
+
+  DataMatrix *block_[3];
+  DataMatrix own_[3];
+
+  SolverState(const SolverState &);
+  SolverState & operator=(const SolverState &);
+
+ public:
+  ///
+  /// @brief Creates an (empty) state owning its data
+  ///
+  SolverState();
+  ///
+  /// @brief Creates a state referring to the given (external) matrices
+  ///
+  SolverState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &vertexData);
+  ///
+  /// @brief Returns the cell, wall and vertex blocks
+  ///
+  inline DataMatrix & cell();
+  inline DataMatrix & wall();
+  inline DataMatrix & vertex();
+  inline const DataMatrix & cell() const;
+  inline const DataMatrix & wall() const;
+  inline const DataMatrix & vertex() const;
+  ///
+  /// @brief Returns block b (0 cell, 1 wall, 2 vertex)
+  ///
+  inline DataMatrix & block(size_t b);
+  inline const DataMatrix & block(size_t b) const;
+  ///
+  /// @brief Resizes all blocks (and rows) to the shape of y, keeping capacity
+  ///
+  void resizeLike(const SolverState &y);
+  ///
+  /// @brief Sets all values to val
+  ///
+  void fill(double val);
+  ///
+  /// @brief Copies the values of y (shapes have to match)
+  ///
+  void assign(const SolverState &y);
+  ///
+  /// @brief this += a*x
+  ///
+  void axpy(double a, const SolverState &x);
+  ///
+  /// @brief this = y0 + h*(c[0]*k[0] + ... + c[n-1]*k[n-1])
+  ///
+  /// If y0 is NULL the state is set to h*(c[0]*k[0] + ...). The terms are
+  /// summed in the given order.
+  ///
+  void linearCombination(const SolverState *y0, double h, size_t n,
+			 const double *c, const SolverState * const *k);
+  ///
+  /// @brief this = |y| + |h*dydt| + tiny (error scaling for adaptive solvers)
+  ///
+  void setErrorScale(const SolverState &y, const SolverState &dydt,
+		     double h, double tiny);
+  ///
+  /// @brief Returns max |this/scale| over all elements
+  ///
+  double maxScaledError(const SolverState &scale) const;
+  ///
+  /// @brief Sets value[i] to max |this/scale| over the elements in row i of
+  /// block b (max |this| if scale is NULL)
+  ///
+  void rowMaxScaled(const SolverState *scale, size_t b,
+		    std::vector<double> &value) const;
+};
+
+inline DataMatrix & SolverState::cell() { return *block_[0]; }
+inline DataMatrix & SolverState::wall() { return *block_[1]; }
+inline DataMatrix & SolverState::vertex() { return *block_[2]; }
+inline const DataMatrix & SolverState::cell() const { return *block_[0]; }
+inline const DataMatrix & SolverState::wall() const { return *block_[1]; }
+inline const DataMatrix & SolverState::vertex() const { return *block_[2]; }
+inline DataMatrix & SolverState::block(size_t b) { return *block_[b]; }
+inline const DataMatrix & SolverState::block(size_t b) const { return *block_[b]; }
+
+#endif
@@ -0,0 +1,261 @@
+//
+// Filename     : stateHistory.cc
+// Description  : Compressed history of the latest solver states used in debug mode
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include "stateHistory.h"
+
+namespace {
+  inline uint64_t bits(double x)
+  {
+    uint64_t w;
+    std::memcpy(&w,&x,sizeof(w));
+    return w;
+  }
+
+  inline double fromBits(uint64_t w)
+  {
+    double x;
+    std::memcpy(&x,&w,sizeof(x));
+    return x;
+  }
+
+  inline unsigned int numSignificantByte(uint64_t w)
+  {
+#ifdef __GNUC__
+    return w ? 8-__builtin_clzll(w)/8 : 0;
+#else
+    unsigned int n=0;
+    while( w ) {
+      w >>= 8;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  ///
+  /// @brief Writes the numByte low bytes of w to out, where out must have
+  /// room for eight bytes
+  ///
+  inline void storeLowBytes(uint64_t w,unsigned int numByte,unsigned char *out)
+  {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+    (void) numByte;
+    std::memcpy(out,&w,sizeof(w));
+#else
+    for( unsigned int b=0 ; b<numByte ; ++b )
+      out[b] = static_cast<unsigned char>(w>>(8*b));
+#endif
+  }
+}
+
+StateHistory::StateHistory(size_t numState) :
+  numState_(numState), numStep_(0), hasCurrent_(0)
+{
+  if( numState_<1 ) {
+    std::cerr << "StateHistory::StateHistory() At least one state must be kept."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void StateHistory::shape(const DataMatrix &data,size_t &numRow,
+			 size_t &numColumn)
+{
+  numRow = data.size();
+  numColumn = numRow ? data[0].size() : 0;
+  for( size_t i=0 ; i<numRow ; ++i )
+    if( data[i].size()!=numColumn ) {
+      std::cerr << "StateHistory::shape() Rows of different sizes ("
+		<< data[i].size() << " in row " << i << ", " << numColumn
+		<< " in row 0)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+size_t StateHistory::encode(const double *x,size_t n,unsigned char *out)
+{
+  //Pairs of values are preceded by a byte with the number of stored (low)
+  //bytes of the words in its two nibbles
+  size_t pos=0, control=0;
+  for( size_t k=0 ; k<n ; ++k ) {
+    uint64_t w = bits(x[k]);
+    unsigned int numByte = numSignificantByte(w);
+    if( k%2==0 ) {
+      control = pos++;
+      out[control] = static_cast<unsigned char>(numByte);
+    }
+    else
+      out[control] |= static_cast<unsigned char>(numByte<<4);
+    storeLowBytes(w,numByte,out+pos);
+    pos += numByte;
+  }
+  return pos;
+}
+
+size_t StateHistory::encodeAndUpdate(const DataMatrix *data[3],
+				     unsigned char *out)
+{
+  //As encode() for the XOR of the stored and new values, read directly
+  //from the rows, while replacing the stored values with the new ones
+  size_t pos=0, control=0, k=0;
+  double *value = value_.data();
+  for( size_t b=0 ; b<3 ; ++b )
+    for( size_t i=0 ; i<current_.numRow[b] ; ++i ) {
+      const double *x = (*data[b])[i].data();
+      for( size_t j=0 ; j<current_.numColumn[b] ; ++j, ++k ) {
+	uint64_t w = bits(value[k])^bits(x[j]);
+	value[k] = x[j];
+	unsigned int numByte = numSignificantByte(w);
+	if( k%2==0 ) {
+	  control = pos++;
+	  out[control] = static_cast<unsigned char>(numByte);
+	}
+	else
+	  out[control] |= static_cast<unsigned char>(numByte<<4);
+	storeLowBytes(w,numByte,out+pos);
+	pos += numByte;
+      }
+    }
+  return pos;
+}
+
+void StateHistory::update(const DataMatrix *data[3])
+{
+  size_t n=0;
+  for( size_t b=0 ; b<3 ; ++b )
+    n += current_.numRow[b]*current_.numColumn[b];
+  value_.resize(n);
+  double *value = value_.data();
+  for( size_t b=0 ; b<3 ; ++b )
+    for( size_t i=0 ; i<current_.numRow[b] ; ++i ) {
+      std::copy((*data[b])[i].begin(),(*data[b])[i].end(),value);
+      value += current_.numColumn[b];
+    }
+}
+
+void StateHistory::decode(const std::vector<unsigned char> &in,double *x,
+			  size_t n,int keyframe)
+{
+  size_t pos=0;
+  for( size_t k=0 ; k<n ; k+=2 ) {
+    unsigned char control = in[pos++];
+    unsigned int numByte[2] = {static_cast<unsigned int>(control & 0xfu),
+			       static_cast<unsigned int>(control>>4)};
+    for( size_t l=0 ; l<2 && k+l<n ; ++l ) {
+      uint64_t w=0;
+      for( unsigned int b=0 ; b<numByte[l] ; ++b )
+	w |= static_cast<uint64_t>(in[pos++])<<(8*b);
+      x[k+l] = keyframe ? fromBits(w) : fromBits(bits(x[k+l])^w);
+    }
+  }
+}
+
+void StateHistory::record(double t,size_t topologyRevision,
+			  const DataMatrix &cellData,const DataMatrix &wallData,
+			  const DataMatrix &vertexData)
+{
+  const DataMatrix *data[3] = {&cellData,&wallData,&vertexData};
+  Header next;
+  next.time = t;
+  next.revision = topologyRevision;
+  for( size_t b=0 ; b<3 ; ++b )
+    shape(*data[b],next.numRow[b],next.numColumn[b]);
+  ++numStep_;
+
+  if( hasCurrent_ && numState_>1 ) {
+    //The current state is stored relative to the new one, reusing the
+    //buffer of the oldest record if full
+    record_.push_back(Record());
+    Record &r = record_.back();
+    if( record_.size()>=numState_ ) {
+      r.data.swap(record_.front().data);
+      record_.pop_front();
+    }
+    r.header = current_;
+    r.keyframe = current_.revision!=next.revision;
+    for( size_t b=0 ; b<3 ; ++b )
+      if( current_.numRow[b]!=next.numRow[b] ||
+	  current_.numColumn[b]!=next.numColumn[b] )
+	r.keyframe = 1;
+    //At most a control byte per pair and eight bytes per value (with room
+    //for storing a full word at the end)
+    size_t maxByte = (value_.size()+1)/2+8*value_.size()+8;
+    if( buffer_.size()<maxByte )
+      buffer_.resize(maxByte);
+    size_t numByte;
+    if( r.keyframe )
+      numByte = encode(value_.data(),value_.size(),buffer_.data());
+    else
+      numByte = encodeAndUpdate(data,buffer_.data());
+    r.data.assign(buffer_.begin(),buffer_.begin()+numByte);
+    current_ = next;
+    if( r.keyframe )
+      update(data);
+  }
+  else {
+    current_ = next;
+    update(data);
+  }
+  hasCurrent_ = 1;
+}
+
+void StateHistory::print(const Header &header,const std::vector<double> &value,
+			 std::ostream &os)
+{
+  size_t pos=0;
+  for( size_t b=0 ; b<3 ; ++b ) {
+    os << header.numRow[b] << " " << header.numColumn[b] << "\n";
+    for( size_t i=0 ; i<header.numRow[b] ; ++i ) {
+      for( size_t j=0 ; j<header.numColumn[b] ; ++j )
+	os << value[pos++] << " ";
+      os << "\n";
+    }
+  }
+}
+
+void StateHistory::print(std::ostream &os) const
+{
+  os << numState() << "\n";
+  if( !hasCurrent_ )
+    return;
+  //Reconstruct backwards from the latest state, and print all digits
+  std::vector<Header> header(numState());
+  std::vector< std::vector<double> > value(numState());
+  header.back() = current_;
+  value.back() = value_;
+  for( size_t k=record_.size() ; k>0 ; --k ) {
+    const Record &r = record_[k-1];
+    size_t n=0;
+    for( size_t b=0 ; b<3 ; ++b )
+      n += r.header.numRow[b]*r.header.numColumn[b];
+    header[k-1] = r.header;
+    if( r.keyframe )
+      value[k-1].resize(n);
+    else
+      value[k-1] = value[k];
+    decode(r.data,value[k-1].data(),n,r.keyframe);
+  }
+  std::streamsize oldPrecision = os.precision(17);
+  for( size_t k=0 ; k<numState() ; ++k ) {
+    os << k << " " << header[k].time << " " << header[k].revision << "\n";
+    print(header[k],value[k],os);
+    os << "\n";
+  }
+  os.precision(oldPrecision);
+}
+
+size_t StateHistory::numByte() const
+{
+  size_t n = value_.size()*sizeof(double);
+  for( size_t k=0 ; k<record_.size() ; ++k )
+    n += record_[k].data.size();
+  return n;
+}
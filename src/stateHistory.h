@@ -0,0 +1,122 @@
+//
+// Filename     : stateHistory.h
+// Description  : Compressed history of the latest solver states used in debug mode
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef STATEHISTORY_H
+#define STATEHISTORY_H
+
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "myTypedefs.h"
+
+///
+/// @brief Keeps the last states (cell, wall and vertex data) of a
+/// simulation as compressed differences, such that they can be written
+/// when the simulation is stopped
+///
+/// @details Only the latest state is stored in full. Each earlier state is
+/// stored as the bitwise XOR of its values with the values of the state
+/// following it, where each 64 bit word is reduced to its non-zero low
+/// bytes (a four bit count per value, such that a value that did not
+/// change only takes its half of the control byte of each pair).
+/// Consecutive solver steps typically only change the low mantissa bytes,
+/// such that a step is stored in a fraction of the size of a copy.
+/// A state whose shape or topology revision (Tissue::topologyRevision())
+/// differs from the following state is stored in full (compressed against
+/// zero), since its rows cannot be compared.
+///
+/// The states are reconstructed backwards from the latest state when
+/// written. Recording a step encodes the stored state directly against the
+/// new rows, updating it in the same pass, into a buffer of maximal size
+/// that is then copied to the reused oldest record, such that it neither
+/// allocates (once the history is full) nor decodes anything.
+///
+/// @see BaseSolver::printDebug()
+///
+class StateHistory {
+
+ private:
+
+  ///
+  /// @brief Shape and time of a state
+  ///
+  struct Header {
+    double time;
+    size_t revision;
+    size_t numRow[3];
+    size_t numColumn[3];
+  };
+  ///
+  /// @brief A state given relative to the following one (or in full for a
+  /// keyframe)
+  ///
+  struct Record {
+    Header header;
+    int keyframe;
+    std::vector<unsigned char> data;
+  };
+
+  size_t numState_;
+  size_t numStep_;
+  int hasCurrent_;
+  Header current_;
+  std::vector<double> value_;
+  std::vector<unsigned char> buffer_;
+  std::deque<Record> record_;
+
+  static void shape(const DataMatrix &data,size_t &numRow,size_t &numColumn);
+  static size_t encode(const double *x,size_t n,unsigned char *out);
+  size_t encodeAndUpdate(const DataMatrix *data[3],unsigned char *out);
+  void update(const DataMatrix *data[3]);
+  static void decode(const std::vector<unsigned char> &in,double *x,size_t n,
+		     int keyframe);
+  static void print(const Header &header,const std::vector<double> &value,
+		    std::ostream &os);
+
+ public:
+  ///
+  /// @brief Keeps the last numState states
+  ///
+  StateHistory(size_t numState);
+  ///
+  /// @brief Adds the state at time t, dropping the oldest one if numState
+  /// states are stored
+  ///
+  void record(double t,size_t topologyRevision,const DataMatrix &cellData,
+	      const DataMatrix &wallData,const DataMatrix &vertexData);
+  ///
+  /// @brief Writes the stored states, oldest first
+  ///
+  /// @details The format is the number of states followed by, for each state,
+  /// a line with its index, time and topology revision and the cell, wall
+  /// and vertex data each given as a line 'numRow numColumn' followed by the
+  /// rows.
+  ///
+  void print(std::ostream &os) const;
+  ///
+  /// @brief Returns the number of stored states
+  ///
+  inline size_t numState() const;
+  ///
+  /// @brief Returns the number of recorded steps
+  ///
+  inline size_t numStep() const;
+  ///
+  /// @brief Returns the number of bytes used by the compressed states
+  ///
+  size_t numByte() const;
+};
+
+inline size_t StateHistory::numState() const
+{
+  return hasCurrent_ ? record_.size()+1 : 0;
+}
+
+inline size_t StateHistory::numStep() const { return numStep_; }
+
+#endif
@@ -0,0 +1,302 @@
+//
+// Filename     : strangSplitting.cc
+// Description  : Multirate operator splitting solver (mechanics/chemistry)
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <cmath>
+#include "strangSplitting.h"
+#include "reactionSchedule.h"
+
+StrangSplitting::StrangSplitting(Tissue *T,std::ifstream &IN)
+  : BaseSolver(T,IN)
+{
+  readParameterFile(IN);
+}
+
+void StrangSplitting::readParameterFile(std::ifstream &IN)
+{
+  IN >> startTime_;
+  t_= startTime_;
+  IN >> endTime_;
+
+  IN >> printFlag_;
+  IN >> numPrint_;
+
+  IN >> h_;
+  IN >> numFastStep_;
+  size_t numFastReaction;
+  IN >> numFastReaction;
+  fastReaction_.resize(numFastReaction);
+  for( size_t k=0 ; k<numFastReaction ; ++k ) {
+    IN >> fastReaction_[k];
+    if( fastReaction_[k]>=T_->numReaction() ) {
+      std::cerr << "StrangSplitting::readParameterFile() Reaction index "
+		<< fastReaction_[k] << " out of range (" << T_->numReaction()
+		<< " reactions)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void StrangSplitting::setReactionGroups()
+{
+  size_t numReaction = T_->numReaction();
+  std::vector<ReactionAccess> access(numReaction);
+  for( size_t r=0 ; r<numReaction ; ++r )
+    T_->reaction(r)->access(access[r]);
+
+  // Reactions not declaring any columns are taken to write the vertex
+  // derivatives if they are non-zero for the initial state
+  std::vector<size_t> single(1);
+  for( size_t r=0 ; r<numReaction ; ++r ) {
+    if( !access[r].exclusive() ||
+	access[r].writes(ReactionAccess::cellDerivs) ||
+	access[r].writes(ReactionAccess::wallDerivs) ||
+	access[r].writes(ReactionAccess::vertexDerivs) )
+      continue;
+    single[0]=r;
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_,single);
+    int found=0;
+    for( size_t i=0 ; i<vertexDerivs_.size() && !found ; ++i )
+      for( size_t d=0 ; d<vertexDerivs_[i].size() ; ++d )
+	if( vertexDerivs_[i][d]!=0.0 ) {
+	  found=1;
+	  break;
+	}
+    if( found )
+      access[r].write(ReactionAccess::vertexDerivs);
+  }
+
+  std::vector<int> fastFlag(numReaction,0);
+  if( fastReaction_.size() ) {
+    for( size_t k=0 ; k<fastReaction_.size() ; ++k )
+      fastFlag[fastReaction_[k]]=1;
+  }
+  else {
+    // Automatic: reactions writing vertex derivatives are fast
+    for( size_t r=0 ; r<numReaction ; ++r )
+      fastFlag[r] = access[r].writes(ReactionAccess::vertexDerivs);
+  }
+  // Reactions reading derivatives have to be in the group of the reactions
+  // writing them, since the derivatives are only summed within a group
+  const ReactionAccess::Block derivsBlock[3] = {ReactionAccess::cellDerivs,
+						ReactionAccess::wallDerivs,
+						ReactionAccess::vertexDerivs};
+  int changed=1;
+  while( changed ) {
+    changed=0;
+    for( size_t r=0 ; r<numReaction ; ++r ) {
+      int numWriter[2] = {0,0};
+      for( size_t b=0 ; b<3 ; ++b ) {
+	if( !access[r].reads(derivsBlock[b]) )
+	  continue;
+	for( size_t s=0 ; s<numReaction ; ++s )
+	  if( s!=r && access[r].readsWritten(derivsBlock[b],access[s]) )
+	    numWriter[fastFlag[s]]++;
+      }
+      if( numWriter[0] && numWriter[1] ) {
+	std::cerr << "StrangSplitting::setReactionGroups() Reaction "
+		  << T_->reaction(r)->id() << " (" << r << ") reads "
+		  << "derivatives written by both fast and slow reactions."
+		  << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      int group = numWriter[1] ? 1 : 0;
+      if( (numWriter[0] || numWriter[1]) && fastFlag[r]!=group ) {
+	if( fastReaction_.size() ) {
+	  std::cerr << "StrangSplitting::setReactionGroups() Reaction "
+		    << T_->reaction(r)->id() << " (" << r << ") reads "
+		    << "derivatives written by the "
+		    << (group ? "fast" : "slow") << " reactions and has to be "
+		    << "in the same group." << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+	fastFlag[r]=group;
+	changed=1;
+      }
+    }
+  }
+  fastReaction_.clear();
+  slowReaction_.clear();
+  for( size_t r=0 ; r<T_->numReaction() ; ++r )
+    if( fastFlag[r] )
+      fastReaction_.push_back(r);
+    else
+      slowReaction_.push_back(r);
+  std::cerr << "StrangSplitting: fast reactions";
+  for( size_t k=0 ; k<fastReaction_.size() ; ++k )
+    std::cerr << " " << T_->reaction(fastReaction_[k])->id();
+  std::cerr << std::endl << "StrangSplitting: slow reactions";
+  for( size_t k=0 ; k<slowReaction_.size() ; ++k )
+    std::cerr << " " << T_->reaction(slowReaction_[k])->id();
+  std::cerr << std::endl;
+}
+
+void StrangSplitting::simulate(size_t verbose)
+{
+  //
+  // Check that parameters are ok
+  //
+  if( !(h_>0. && (endTime_-startTime_)>0. && numFastStep_>0) ) {
+    std::cerr << "StrangSplitting::simulate() Wrong time borders, time step or"
+	      << " number of fast steps for simulation. No simulation performed."
+	      << std::endl;
+    return;
+  }
+  std::cerr << "Simulating using multirate Strang splitting (RK4)." << std::endl;
+
+  //
+  // Check that sizes of permanent data is ok
+  //
+  if( cellData_.size() && cellData_.size() != cellDerivs_.size() ) {
+    cellDerivs_.resize( cellData_.size(),cellData_[0]);
+  }
+  if( wallData_.size() && wallData_.size() != wallDerivs_.size() ) {
+    wallDerivs_.resize( wallData_.size(),wallData_[0]);
+  }
+  if( vertexData_.size() && vertexData_.size() != vertexDerivs_.size() ) {
+    vertexDerivs_.resize( vertexData_.size(),vertexData_[0]);
+  }
+
+  // Initiate reactions and direction for those where it is applicable
+  T_->initiateReactions(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+  if (cellData_.size()!=cellDerivs_.size())
+    cellDerivs_.resize(cellData_.size(),cellDerivs_[0]);
+  if (wallData_.size()!=wallDerivs_.size())
+    wallDerivs_.resize(wallData_.size(),wallDerivs_[0]);
+  if (vertexData_.size()!=vertexDerivs_.size())
+    vertexDerivs_.resize(vertexData_.size(),vertexDerivs_[0]);
+  T_->initiateDirection(cellData_, wallData_, vertexData_, cellDerivs_,
+			wallDerivs_, vertexDerivs_);
+
+  assert( cellData_.size() == T_->numCell() &&
+	  cellData_.size()==cellDerivs_.size() );
+  assert( wallData_.size() == T_->numWall() &&
+	  wallData_.size()==wallDerivs_.size() );
+  assert( vertexData_.size() == T_->numVertex() &&
+	  vertexData_.size()==vertexDerivs_.size() );
+
+  setReactionGroups();
+  double hFast = 0.5*h_/numFastStep_;
+
+  // Initiate print times
+  //
+  double tiny = 1e-10;
+  double printTime=endTime_+tiny;
+  double printDeltaTime=endTime_+2.*tiny;
+  int doPrint=1;
+  if( numPrint_<=0 )//No printing
+    doPrint=0;
+  else if( numPrint_==1 ) {//Print last point (default)
+  }
+  else if( numPrint_==2 ) {//Print first/last point
+    printTime=startTime_-tiny;
+  }
+  else {//Print first/last points and spread the rest uniformly
+    printTime=startTime_-tiny;
+    printDeltaTime=(endTime_-startTime_)/double(numPrint_-1);
+  }
+  // Go
+  //
+  t_=startTime_;
+  numOk_ = numBad_ = 0;
+  while( t_<endTime_ ) {
+    if (debugFlag()) {
+      recordDebug();
+    }
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+
+    //Stop if converged (the final point is printed below)
+    if( checkConvergence() )
+      break;
+
+    //Print if applicable
+    if( doPrint && t_ >= printTime ) {
+      printTime += printDeltaTime;
+      print();
+    }
+
+    //Update (fast half step, slow full step, fast half step)
+    if( fastReaction_.size() )
+      for( size_t k=0 ; k<numFastStep_ ; ++k )
+	rk4Step(fastReaction_,hFast);
+    if( slowReaction_.size() )
+      rk4Step(slowReaction_,h_);
+    if( fastReaction_.size() )
+      for( size_t k=0 ; k<numFastStep_ ; ++k )
+	rk4Step(fastReaction_,hFast);
+    numOk_++;
+
+    //
+    // Check for discrete and reaction updates
+    //
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    T_->updateDirection(h_,cellData_,wallData_,vertexData_,cellDerivs_,
+			wallDerivs_,vertexDerivs_);
+    updateHybrid(h_);
+    T_->updateReactions(cellData_,wallData_,vertexData_,h_);
+    T_->checkCompartmentChange(cellData_,wallData_,vertexData_,
+			       cellDerivs_,wallDerivs_,vertexDerivs_ );
+
+    // Check the tissue connectivity in each step
+    T_->checkConnectivity(1);
+    checkRenumber();
+
+    //update time variable
+    if( (t_+h_)==t_ ) {
+      std::cerr << "StrangSplitting::simulate() Step size too small.";
+      exit(-1);
+    }
+    t_ += h_;
+  }
+  if( doPrint ) {
+    //Update the derivatives
+    T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	       vertexDerivs_);
+    print();
+  }
+  std::cerr << "Simulation done.\n";
+  return;
+}
+
+void StrangSplitting::rk4Step(const std::vector<size_t> &reactionList, double h)
+{
+  SolverState y(cellData_,wallData_,vertexData_);
+  SolverState dydt(cellDerivs_,wallDerivs_,vertexDerivs_);
+  const double one[1] = {1.0};
+  const SolverState *k[1] = {&dydt};
+  const SolverState *acc[1] = {&acc_};
+
+  // Store the start state (also adapts sizes after divisions)
+  y0_.resizeLike(y);
+  y0_.assign(y);
+  acc_.resizeLike(y);
+
+  // k1
+  T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	     vertexDerivs_,reactionList);
+  acc_.assign(dydt);
+  y.linearCombination(&y0_,0.5*h,1,one,k);
+  // k2
+  T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	     vertexDerivs_,reactionList);
+  acc_.axpy(2.0,dydt);
+  y.linearCombination(&y0_,0.5*h,1,one,k);
+  // k3
+  T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	     vertexDerivs_,reactionList);
+  acc_.axpy(2.0,dydt);
+  y.linearCombination(&y0_,h,1,one,k);
+  // k4
+  T_->derivs(cellData_,wallData_,vertexData_,cellDerivs_,wallDerivs_,
+	     vertexDerivs_,reactionList);
+  acc_.axpy(1.0,dydt);
+  y.linearCombination(&y0_,h/6.0,1,one,acc);
+}
@@ -0,0 +1,94 @@
+#ifndef STRANGSPLITTING_H
+#define STRANGSPLITTING_H
+//
+// Filename     : strangSplitting.h
+// Description  : Multirate operator splitting solver (mechanics/chemistry)
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include "baseSolver.h"
+#include "solverState.h"
+
+///
+/// @brief Multirate Strang splitting solver where fast (mechanical)
+/// reactions are integrated with a smaller step than the slow ones
+///
+/// @details The reactions are divided into a fast group (typically the
+/// mechanics updating vertex positions) and a slow group (e.g. molecular
+/// networks and transport updating cell and wall variables). A (macro) step
+/// of size H is taken with Strang splitting:
+///
+/// @f[ y_{n+1} = F_{H/2} \circ S_H \circ F_{H/2} (y_n) @f]
+///
+/// where @f$F_{H/2}@f$ integrates the fast reactions over H/2 using
+/// numFastStep RK4 steps, and @f$S_H@f$ integrates the slow reactions with
+/// a single RK4 step of size H. Each group updates all variables it has
+/// derivatives for.
+///
+/// The fast group can be given explicitly as reaction indices (order in the
+/// model file, starting at 0) in the parameter file. Otherwise it is found
+/// automatically as the reactions declaring vertex derivative writes in
+/// BaseReaction::access(), or, for reactions without declared columns,
+/// giving non-zero vertex derivatives for the initial state. A reaction
+/// reading derivatives (e.g. DilutionFromVertexDerivs) is put in the group
+/// of the reactions writing them, and the simulation stops if these are in
+/// both groups (or if a given fast group separates them).
+///
+class StrangSplitting : public BaseSolver {
+
+ private:
+
+  double h_;
+  size_t numFastStep_;
+  std::vector<size_t> fastReaction_;
+  std::vector<size_t> slowReaction_;
+
+  SolverState y0_, acc_;
+
+ public:
+  ///
+  /// @brief Main constructor
+  ///
+  StrangSplitting(Tissue *T,std::ifstream &IN);
+
+  ///
+  /// @brief Reads the parameters used by the StrangSplitting solver
+  ///
+  /// @details The parameter file sent to the simulator binary looks like:
+  ///
+  /// <pre>
+  /// StrangSplitting
+  /// T_start T_end
+  /// printFlag printNum
+  /// H numFastStep numFastReaction [r_1 ... r_numFastReaction]
+  /// </pre>
+  ///
+  /// where StrangSplitting is the identity string used by
+  /// BaseSolver::getSolver to identify that this algorithm should be
+  /// used. T_start (T_end) is the start (end) time for the simulation,
+  /// printFlag is an integer which sets the output format (read by
+  /// BaseSolver::print()), printNum is the number of equally spread time
+  /// points to be printed. H is the (slow) macro step, numFastStep the
+  /// number of RK4 steps used for the fast reactions in each half step, and
+  /// numFastReaction the number of reaction indices tagged as fast that
+  /// follows (0 means automatic grouping).
+  ///
+  /// @see BaseSolver::getSolver()
+  /// @see BaseSolver::print()
+  ///
+  void readParameterFile(std::ifstream &IN);
+
+  void simulate(size_t verbose=0);
+  ///
+  /// @brief Divides the reactions into a fast and a slow group
+  ///
+  void setReactionGroups();
+  ///
+  /// @brief Takes an RK4 step of size h only including the given reactions
+  ///
+  void rk4Step(const std::vector<size_t> &reactionList, double h);
+};
+
+#endif
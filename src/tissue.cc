@@ -14,6 +14,9 @@
 #include <utility>
 #include <vector>
 #include "tissue.h"
+#include "hybridStochastic.h"
+#include "vertexJacobian.h"
+#include "myParallel.h"
 #include "wall.h"
 #include "myFiles.h"
 #include "myMath.h"
@@ -25,6 +28,12 @@ Tissue::Tissue() {
   vertex_.reserve(200000);
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
 }
 
 Tissue::Tissue( const Tissue & tissueCopy ) {
@@ -33,6 +42,12 @@ Tissue::Tissue( const Tissue & tissueCopy ) {
   vertex_.reserve(200000);
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
 }
 
 Tissue::Tissue( const std::vector<Cell> &cellVal,
@@ -45,9 +60,21 @@ Tissue::Tissue( const std::vector<Cell> &cellVal,
 
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
   cell_ = cellVal;
   wall_ = wallVal;
   vertex_ = vertexVal;
+  for( size_t i=0 ; i<cell_.size() ; ++i )
+    cellStableId_.push_back(nextCellStableId_++);
+  for( size_t i=0 ; i<wall_.size() ; ++i )
+    wallStableId_.push_back(nextWallStableId_++);
+  for( size_t i=0 ; i<vertex_.size() ; ++i )
+    vertexStableId_.push_back(nextVertexStableId_++);
 }
 
 Tissue::Tissue( const char *initFile, int verbose ) {
@@ -57,6 +84,12 @@ Tissue::Tissue( const char *initFile, int verbose ) {
 
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
   readInit(initFile,verbose);
 }
 
@@ -69,6 +102,12 @@ Tissue::Tissue( std::string initFile, int verbose )
 	
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
   readInit(initFile,verbose);
 }
 
@@ -85,6 +124,12 @@ Tissue::Tissue( DataMatrix &cellData,
 	
   Cell tmpCell(static_cast<size_t>(-1),static_cast<std::string>("Background"));
   background_ = tmpCell;
+  topologyRevision_ = 0;
+  geometryFlag_ = 0;
+  scheduleFlag_ = 0;
+  hybrid_ = 0;
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+  nextCellStableId_ = nextWallStableId_ = nextVertexStableId_ = 0;
 	
 	size_t numCell = cellData.size();
 	size_t numWall = wallData.size();
@@ -127,7 +172,7 @@ Tissue::Tissue( DataMatrix &cellData,
               << " At least wall length must be given in wall variables." << std::endl; 
     exit(-1);
   }
-  size_t numWallVar=wallData.size();
+  size_t numWallVar=wallData[0].size();
   for (size_t i = 0; i < numWall; ++i) {
     if (wallData[i].size() != numWallVar) {
       std::cerr << "Tissue::Tissue(cellData,wallData,vertexData,cellVertex,wallVertex) "
@@ -163,7 +208,7 @@ Tissue::Tissue( DataMatrix &cellData,
     exit(-1);
   }
   for (size_t i=0; i<numCell; ++i) {
-    size_t numCellVertex=cellVertex.size();
+    size_t numCellVertex=cellVertex[i].size();
     for (size_t k=0; k<numCellVertex; ++k) {
       size_t j=cellVertex[i][k];
       cell(i).addVertex( vertexP(j) );
@@ -179,7 +224,7 @@ Tissue::Tissue( DataMatrix &cellData,
     exit(-1);
   }
   for (size_t i=0; i<numWall; ++i) {
-    assert (wallVertex.size()==2);
+    assert (wallVertex[i].size()==2);
     size_t j1=wallVertex[i][0];
     size_t j2=wallVertex[i][1];
     vertex(j1).addWall( wallP(i) );
@@ -246,6 +291,7 @@ void Tissue::setWallLengthFromVertexPosition() {
 int Tissue::addReaction( std::istream &IN ) {
   if( !IN ) return -1;
   reaction_.push_back( BaseReaction::createReaction(IN) );
+  reactionSchedule_.clear();
   return 0;
 }
 
@@ -265,6 +311,8 @@ void Tissue::addSisterVertex(size_t val1,size_t val2)
 
 void Tissue::readInit(std::istream &IN,int verbose) {
   
+  //The elements are overwritten and no longer refer to any solver state
+  unbindState();
   unsigned int numCellVal,numWallVal,numVertexVal;
   //std::string idVal;
   
@@ -1360,6 +1408,8 @@ void Tissue::readModel(std::ifstream &IN,int verbose) {
   //Remove any present reactions before adding
   if( numReaction() ) 
     reaction_.resize(0);
+  reactionSchedule_.clear();
+  stochasticReaction_.clear();
   
   if( verbose )
     std::cerr << "reactions...\n"; 
@@ -2258,6 +2308,9 @@ void Tissue::copyState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &v
     std::cerr << "Tissue::copyState() Not the same number of vertices in Tissue as in data." << std::endl;
     exit(EXIT_FAILURE);
   }
+  //The elements already refer to the state
+  if( stateBound(cellData,wallData,vertexData) )
+    return;
   for (size_t i=0; i<numCell(); ++i) {
     assert( cell(i).numVariable()==cellData[i].size() );
     cell(i).setVariable(cellData[i]);
@@ -2273,6 +2326,41 @@ void Tissue::copyState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &v
   }
 }
 
+void Tissue::bindState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &vertexData)
+{
+  if (cellData.size()!=numCell() || wallData.size()!=numWall() ||
+      vertexData.size()!=numVertex()) {
+    std::cerr << "Tissue::bindState() Not the same number of elements in Tissue as in data."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if( stateCellData_ && !stateBound(cellData,wallData,vertexData) )
+    unbindState();
+  for (size_t i=0; i<numCell(); ++i)
+    cell(i).bindVariable(cellData);
+  for (size_t i=0; i<numWall(); ++i)
+    wall(i).bindVariable(wallData);
+  for (size_t i=0; i<numVertex(); ++i)
+    vertex(i).bindPosition(vertexData);
+  stateCellData_ = &cellData;
+  stateWallData_ = &wallData;
+  stateVertexData_ = &vertexData;
+}
+
+void Tissue::unbindState()
+{
+  for (size_t i=0; i<numCell(); ++i)
+    if( cell(i).variableBound() )
+      cell(i).unbindVariable();
+  for (size_t i=0; i<numWall(); ++i)
+    if( wall(i).variableBound() )
+      wall(i).unbindVariable();
+  for (size_t i=0; i<numVertex(); ++i)
+    if( vertex(i).positionBound() )
+      vertex(i).unbindPosition();
+  stateCellData_ = stateWallData_ = stateVertexData_ = 0;
+}
+
 void Tissue::derivs( DataMatrix &cellData,
 		     DataMatrix &wallData,
 		     DataMatrix &vertexData,
@@ -2288,10 +2376,142 @@ void Tissue::derivs( DataMatrix &cellData,
   for( size_t i=0 ; i<vertexDeriv.size() ; ++i )
     std::fill(vertexDeriv[i].begin(),vertexDeriv[i].end(),0.0);
   
+  if( geometryFlag_ ) {
+    std::vector<size_t> reactionList(numReaction());
+    for( size_t r=0 ; r<numReaction() ; ++r )
+      reactionList[r] = r;
+    geometryDerivs(cellData,wallData,vertexData,cellDeriv,wallDeriv,
+		   vertexDeriv,reactionList);
+    return;
+  }
+  if( scheduleFlag_ ) {
+    std::vector<size_t> reactionList(numReaction());
+    for( size_t r=0 ; r<numReaction() ; ++r )
+      reactionList[r] = r;
+    scheduleDerivs(cellData,wallData,vertexData,cellDeriv,wallDeriv,
+		   vertexDeriv,reactionList);
+    return;
+  }
   //Calculate derivative contributions from all reactions
   for( size_t r=0 ; r<numReaction() ; ++r )
-    reaction(r)->derivs(*this,cellData,wallData,vertexData,
-			cellDeriv,wallDeriv,vertexDeriv);
+    if( !stochasticReaction(r) )
+      reaction(r)->derivs(*this,cellData,wallData,vertexData,
+			  cellDeriv,wallDeriv,vertexDeriv);
+}
+
+void Tissue::derivs( DataMatrix &cellData,
+		     DataMatrix &wallData,
+		     DataMatrix &vertexData,
+		     DataMatrix &cellDeriv,
+		     DataMatrix &wallDeriv,
+		     DataMatrix &vertexDeriv,
+		     const std::vector<size_t> &reactionList ) 
+{  
+  //Set all derivatives to zero
+  for( size_t i=0 ; i<cellDeriv.size() ; ++i )
+    std::fill(cellDeriv[i].begin(),cellDeriv[i].end(),0.0);
+  for( size_t i=0 ; i<wallDeriv.size() ; ++i )
+    std::fill(wallDeriv[i].begin(),wallDeriv[i].end(),0.0);
+  for( size_t i=0 ; i<vertexDeriv.size() ; ++i )
+    std::fill(vertexDeriv[i].begin(),vertexDeriv[i].end(),0.0);
+  
+  if( geometryFlag_ ) {
+    geometryDerivs(cellData,wallData,vertexData,cellDeriv,wallDeriv,
+		   vertexDeriv,reactionList);
+    return;
+  }
+  if( scheduleFlag_ ) {
+    scheduleDerivs(cellData,wallData,vertexData,cellDeriv,wallDeriv,
+		   vertexDeriv,reactionList);
+    return;
+  }
+  //Calculate derivative contributions from the listed reactions
+  for( size_t k=0 ; k<reactionList.size() ; ++k )
+    if( !stochasticReaction(reactionList[k]) )
+      reaction(reactionList[k])->derivs(*this,cellData,wallData,vertexData,
+					cellDeriv,wallDeriv,vertexDeriv);
+}
+
+void Tissue::geometryDerivs( DataMatrix &cellData,
+			     DataMatrix &wallData,
+			     DataMatrix &vertexData,
+			     DataMatrix &cellDeriv,
+			     DataMatrix &wallDeriv,
+			     DataMatrix &vertexDeriv,
+			     const std::vector<size_t> &reactionList )
+{
+  //The kernels read the state in place, and sum into flat derivatives
+  const Geometry &G = geometry();
+  geometryState_.view(cellData,wallData,vertexData);
+  geometryDerivs_.resize(numVertex(),geometryState_.dimension(),
+			 numWall(),geometryState_.numEdgeVariable(),
+			 numCell(),geometryState_.numFaceVariable());
+  //Use the geometry kernel if provided, otherwise the Tissue version. The
+  //kernel contributions are added to the derivatives before the next
+  //Tissue version is called, since it may read them (e.g. the vertex
+  //derivatives in DilutionFromVertexDerivs)
+  size_t numPending=0;
+  for( size_t k=0 ; k<reactionList.size() ; ++k ) {
+    if( stochasticReaction(reactionList[k]) )
+      continue;
+    BaseReaction *r = reaction(reactionList[k]);
+    if( r->geometryDerivs(G,geometryState_,geometryDerivs_) ) {
+      ++numPending;
+      continue;
+    }
+    if( numPending ) {
+      geometryDerivs_.addTo(cellDeriv,wallDeriv,vertexDeriv);
+      geometryDerivs_.setZero();
+      numPending=0;
+    }
+    r->derivs(*this,cellData,wallData,vertexData,
+	      cellDeriv,wallDeriv,vertexDeriv);
+  }
+  if( numPending )
+    geometryDerivs_.addTo(cellDeriv,wallDeriv,vertexDeriv);
+}
+
+void Tissue::scheduleDerivs( DataMatrix &cellData,
+			     DataMatrix &wallData,
+			     DataMatrix &vertexData,
+			     DataMatrix &cellDeriv,
+			     DataMatrix &wallDeriv,
+			     DataMatrix &vertexDeriv,
+			     const std::vector<size_t> &reactionList )
+{
+  const ReactionSchedule &schedule = reactionSchedule(reactionList);
+  //Update the (lazily built) topology before the reactions share it
+  topology();
+  for( size_t i=0 ; i<schedule.numLevel() ; ++i ) {
+    const std::vector<size_t> &level = schedule.level(i);
+    myParallel::forEach(0,level.size(),[&](size_t k) {
+	if( !stochasticReaction(level[k]) )
+	  reaction(level[k])->derivs(*this,cellData,wallData,vertexData,
+				     cellDeriv,wallDeriv,vertexDeriv); } );
+  }
+}
+
+void Tissue::setStochasticReaction(size_t r,int value)
+{
+  if( r>=numReaction() ) {
+    std::cerr << "Tissue::setStochasticReaction() Reaction " << r
+	      << " out of range." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if( stochasticReaction_.size()<numReaction() )
+    stochasticReaction_.resize(numReaction(),0);
+  stochasticReaction_[r] = value;
+}
+
+const ReactionSchedule & Tissue::
+reactionSchedule(const std::vector<size_t> &reactionList)
+{
+  for( size_t k=0 ; k<reactionSchedule_.size() ; ++k )
+    if( reactionSchedule_[k].reactionList()==reactionList )
+      return reactionSchedule_[k];
+  reactionSchedule_.push_back(ReactionSchedule());
+  reactionSchedule_.back().build(reaction_,reactionList);
+  return reactionSchedule_.back();
 }
 
 void Tissue::derivsWithAbs( DataMatrix &cellData,
@@ -2320,11 +2540,131 @@ void Tissue::derivsWithAbs( DataMatrix &cellData,
 
   //Calculate derivative contributions from all reactions
   for( size_t r=0 ; r<numReaction() ; ++r ){
+    if( stochasticReaction(r) )
+      continue;
     reaction(r)->derivsWithAbs(*this,cellData,wallData,vertexData,
 			       cellDeriv,wallDeriv,vertexDeriv,
 			       sdydtCell,sdydtWall,sdydtVertex);}
 }
 
+size_t Tissue::vertexJacobian(DataMatrix &cellData,
+			      DataMatrix &wallData,
+			      DataMatrix &vertexData,
+			      VertexJacobian &J,
+			      int analyticFlag)
+{
+  size_t dimension = vertexData.size() ? vertexData[0].size() : 0;
+  if( J.numVertex()!=vertexData.size() || J.dimension()!=dimension )
+    J.resize(vertexData.size(),dimension);
+  else
+    J.clear();
+  
+  //Analytic blocks where provided, finite differences for the others
+  std::vector<size_t> reactionList;
+  ReactionAccess A;
+  for( size_t r=0 ; r<numReaction() ; ++r ) {
+    if( stochasticReaction(r) )
+      continue;
+    A.clear();
+    reaction(r)->access(A);
+    if( !A.exclusive() && !A.writes(ReactionAccess::vertexDerivs) )
+      continue;
+    if( analyticFlag &&
+	reaction(r)->vertexJacobian(*this,cellData,wallData,vertexData,J) )
+      continue;
+    reactionList.push_back(r);
+  }
+  if( reactionList.size() )
+    vertexJacobianFiniteDifference(cellData,wallData,vertexData,J,
+				   reactionList);
+  return reactionList.size();
+}
+
+void Tissue::vertexJacobianFiniteDifference(DataMatrix &cellData,
+					    DataMatrix &wallData,
+					    DataMatrix &vertexData,
+					    VertexJacobian &J,
+					    const std::vector<size_t> &reactionList)
+{
+  const TissueTopology &graph = topology();
+  size_t N = vertexData.size();
+  size_t dimension = J.dimension();
+  
+  //Vertices sharing a cell (including the vertex itself)
+  std::vector< std::vector<size_t> > neighbor(N);
+  for( size_t v=0 ; v<N ; ++v ) {
+    neighbor[v].push_back(v);
+    for( size_t k=0 ; k<graph.numVertexCell(v) ; ++k ) {
+      size_t c = graph.vertexCell(v,k);
+      for( size_t l=0 ; l<graph.numCellVertex(c) ; ++l )
+	neighbor[v].push_back(graph.cellVertex(c,l));
+    }
+    std::sort(neighbor[v].begin(),neighbor[v].end());
+    neighbor[v].erase(std::unique(neighbor[v].begin(),neighbor[v].end()),
+		      neighbor[v].end());
+  }
+  //Greedy colouring where vertices with a common neighbor differ, such that
+  //each vertex has at most one perturbed neighbor per colour
+  size_t none = static_cast<size_t>(-1);
+  std::vector<size_t> colour(N,none),used;
+  size_t numColour=0;
+  for( size_t v=0 ; v<N ; ++v ) {
+    used.assign(numColour+1,0);
+    for( size_t k=0 ; k<neighbor[v].size() ; ++k ) {
+      size_t w = neighbor[v][k];
+      for( size_t l=0 ; l<neighbor[w].size() ; ++l )
+	if( colour[neighbor[w][l]]!=none )
+	  used[colour[neighbor[w][l]]] = 1;
+    }
+    size_t c=0;
+    while( used[c] )
+      ++c;
+    colour[v] = c;
+    if( c==numColour )
+      ++numColour;
+  }
+  
+  DataMatrix cellDataSave(cellData),wallDataSave(wallData);
+  DataMatrix cellDeriv(cellData),wallDeriv(wallData);
+  DataMatrix plus(vertexData),minus(vertexData);
+  std::vector<double> step(N),position(N);
+  for( size_t c=0 ; c<numColour ; ++c )
+    for( size_t j=0 ; j<dimension ; ++j ) {
+      for( size_t v=0 ; v<N ; ++v )
+	if( colour[v]==c ) {
+	  position[v] = vertexData[v][j];
+	  step[v] = 1e-6*(1.0+std::fabs(position[v]));
+	}
+      for( size_t sign=0 ; sign<2 ; ++sign ) {
+	for( size_t v=0 ; v<N ; ++v )
+	  if( colour[v]==c )
+	    vertexData[v][j] = sign ? position[v]-step[v] : position[v]+step[v];
+	derivs(cellData,wallData,vertexData,cellDeriv,wallDeriv,
+	       sign ? minus : plus,reactionList);
+	cellData = cellDataSave;
+	wallData = wallDataSave;
+      }
+      for( size_t v=0 ; v<N ; ++v )
+	if( colour[v]==c )
+	  vertexData[v][j] = position[v];
+      //Column j of block (a,b) for the neighbor b of a with colour c
+      for( size_t a=0 ; a<N ; ++a )
+	for( size_t k=0 ; k<neighbor[a].size() ; ++k ) {
+	  size_t b = neighbor[a][k];
+	  if( colour[b]!=c )
+	    continue;
+	  int nonZero=0;
+	  for( size_t i=0 ; i<dimension ; ++i )
+	    if( plus[a][i]!=minus[a][i] )
+	      nonZero=1;
+	  if( nonZero )
+	    for( size_t i=0 ; i<dimension ; ++i )
+	      J.add(a,b,i,j,(plus[a][i]-minus[a][i])/(2.0*step[b]));
+	  break;
+	}
+    }
+}
+
 void::Tissue::initiateReactions(DataMatrix &cellData,
 				DataMatrix &wallData,
 				DataMatrix &vertexData,
@@ -2393,8 +2733,36 @@ checkCompartmentChange( DataMatrix &cellData,
 			DataMatrix &vertexDeriv ) {
   
   unsigned int uglyHackCounter = 0;
+  int changed = 0;
   
   for( size_t l=0 ; l<numCompartmentChange() ; ++l ) {
+    if( compartmentChange(l)->numChange()==1 &&
+	compartmentChange(l)->hasPlan() ) {
+      //Flag all cells, divide them, and continue with the new cells
+      std::vector<size_t> flagged;
+      size_t begin=0;
+      while( begin<numCell() ) {
+	flagged.clear();
+	size_t end=numCell();
+	for( size_t i=begin ; i<end ; ++i ) {
+	  if (++uglyHackCounter > 1000000) {
+	    // Time to bail out.
+	    std::cerr << "Ugly hack counter lager than a million!\n";
+	    std::exit(EXIT_FAILURE);
+	  }
+	  if( compartmentChange(l)->flag(this,i,cellData,wallData,vertexData,
+					 cellDeriv,wallDeriv,vertexDeriv) )
+	    flagged.push_back(i);
+	}
+	begin=end;
+	if( flagged.empty() )
+	  break;
+	divideCells(compartmentChange(l),flagged,cellData,wallData,vertexData,
+		    cellDeriv,wallDeriv,vertexDeriv);
+	changed = 1;
+      }
+      continue;
+    }
     for( size_t i=0 ; i<numCell() ; ++i ) {
       ++uglyHackCounter;
       
@@ -2406,79 +2774,15 @@ checkCompartmentChange( DataMatrix &cellData,
       
       if( compartmentChange(l)->flag(this,i,cellData,wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv) ) {
 	compartmentChange(l)->update(this,i,cellData,wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv);
+	topologyChanged();
+	changed = 1;
 	//If cell division, sort walls and vertices for cell plus 
 	//divided cell plus their neighbors
-	//Get list of potential cells to be sorted
-	//Also add division rule for directions
 	if( compartmentChange(l)->numChange()==1 ) {
-	  std::set<size_t> sortCell;
-	  sortCell.insert(i);
-	  size_t ii=numCell()-1;
-	  sortCell.insert(ii);
-	  for( size_t k=0 ; k<cell(i).numWall() ; ++k ) {
-	    if( cell(i).wall(k)->cell1()->index() == i )
-	      sortCell.insert(cell(i).wall(k)->cell2()->index());
-	    else
-	      sortCell.insert(cell(i).wall(k)->cell1()->index());
-	  }
-	  for( size_t k=0 ; k<cell(ii).numWall() ; ++k ) {
-	    if( cell(ii).wall(k)->cell1()->index() == ii )
-	      sortCell.insert(cell(ii).wall(k)->cell2()->index());
-	    else
-	      sortCell.insert(cell(ii).wall(k)->cell1()->index());
-	  }									
-	  //Remove if background within the list
-	  sortCell.erase( static_cast<size_t>(-1) );
-	  //Sort the cells
-	  //for( std::set<size_t>::iterator k=sortCell.begin() ; 
-	  //	 k!=sortCell.end() ; ++k )
-	  //std::cerr << *k << " ";
-	  //std::cerr << "to be sorted" << std::endl;
-	  
-	  // If one of the daughter
-	  // cells is on the edge and
-	  // only has the other daughter
-	  // cell as its neighbor the
-	  // other daughter cell needs
-	  // to be sorted
-	  // first. Therefore we save
-	  // all cells with only one
-	  // neighbor in a second set of
-	  // indexes and sort them in a
-	  // second round.
-	  std::set<size_t> oneNeighborCells;
-	  
-	  for (std::set<size_t>::iterator k = sortCell.begin(); k != sortCell.end(); ++k)
-	    {
-	      Cell &cellToSort = cell(*k);
-	      
-	      int counter = 0;
-	      
-	      for (size_t wallIndex = 0; wallIndex < cellToSort.numWall(); ++wallIndex)
-		{
-		  if (cellToSort.cellNeighbor(wallIndex) != background())
-		    {
-		      ++counter;
-		    }
-		}
-	      
-	      if (counter == 1)
-		{
-		  oneNeighborCells.insert(cellToSort.index());
-		}
-	      else
-		{
-		  cellToSort.sortWallAndVertex(*this);
-		}
-	    }
-	  
-	  for (std::set<size_t>::iterator k = oneNeighborCells.begin(); k != oneNeighborCells.end(); ++k)
-	    {
-	      Cell &cellToSort = cell(*k);
-	      
-	      cellToSort.sortWallAndVertex(*this);
-	    }
-	}	
+	  if( hybrid_ )
+	    hybrid_->divide(i,numCell()-1,cellData);
+	  sortDividedCell(i);
+	}
 	else if( compartmentChange(l)->numChange()==-1 )
 	  --i;
 	else if( compartmentChange(l)->numChange()<-1 )
@@ -2486,6 +2790,345 @@ checkCompartmentChange( DataMatrix &cellData,
       }
     }
   }
+  //Bind the elements added by the changes to the state
+  if( changed && stateBound(cellData,wallData,vertexData) )
+    bindState(cellData,wallData,vertexData);
+}
+
+void Tissue::
+divideCells(BaseCompartmentChange *change,
+	    std::vector<size_t> &flagged,
+	    DataMatrix &cellData,
+	    DataMatrix &wallData,
+	    DataMatrix &vertexData,
+	    DataMatrix &cellDeriv,
+	    DataMatrix &wallDeriv,
+	    DataMatrix &vertexDeriv)
+{
+  //A cell is divided when its flagged neighbors with lower index are
+  //divided, i.e. it sees the same walls as when dividing the cells in index
+  //order. The cells ready in a round do not share walls and are unchanged by
+  //the divisions of the others in the round.
+  std::vector<char> pending(numCell(),0);
+  for( size_t k=0 ; k<flagged.size() ; ++k )
+    pending[flagged[k]] = 1;
+  std::vector<size_t> ready,remaining;
+  std::vector<DivisionPlan> plan;
+  std::set<size_t> sortCell;
+  while( !flagged.empty() ) {
+    ready.clear();
+    remaining.clear();
+    for( size_t k=0 ; k<flagged.size() ; ++k ) {
+      size_t i = flagged[k];
+      int wait=0;
+      for( size_t w=0 ; w<cell(i).numWall() && !wait ; ++w ) {
+	size_t n = cell(i).wall(w)->cell1()->index()==i ?
+	  cell(i).wall(w)->cell2()->index() : cell(i).wall(w)->cell1()->index();
+	if( n<i && pending[n] )
+	  wait=1;
+      }
+      if( wait )
+	remaining.push_back(i);
+      else
+	ready.push_back(i);
+    }
+    //The plans only read the tissue and are calculated in parallel
+    plan.resize(ready.size());
+    myParallel::forEach(0,ready.size(),[&](size_t k) {
+	change->plan(this,ready[k],cellData,wallData,vertexData,plan[k]); } );
+    //The new elements of the round are appended at once, and the divided
+    //cells and their neighbors sorted after all commits
+    size_t Nc=numCell(),Nw=numWall(),Nv=numVertex();
+    appendDivisionElements(ready.size());
+    cellData.reserve(Nc+ready.size());
+    cellDeriv.reserve(Nc+ready.size());
+    wallData.reserve(Nw+3*ready.size());
+    wallDeriv.reserve(Nw+3*ready.size());
+    vertexData.reserve(Nv+2*ready.size());
+    vertexDeriv.reserve(Nv+2*ready.size());
+    sortCell.clear();
+    for( size_t k=0 ; k<ready.size() ; ++k ) {
+      plan[k].newCell = Nc+k;
+      plan[k].newWall = Nw+3*k;
+      plan[k].newVertex = Nv+2*k;
+      change->commit(this,ready[k],plan[k],cellData,wallData,vertexData,
+		     cellDeriv,wallDeriv,vertexDeriv);
+      if( hybrid_ )
+	hybrid_->divide(ready[k],Nc+k,cellData);
+      addDividedCell(ready[k],Nc+k,sortCell);
+      pending[ready[k]] = 0;
+    }
+    sortCellWallAndCellVertex(sortCell);
+    flagged.swap(remaining);
+  }
+}
+
+void Tissue::sortDividedCell(size_t i)
+{
+  std::set<size_t> sortCell;
+  addDividedCell(i,numCell()-1,sortCell);
+  // If one of the daughter
+  // cells is on the edge and
+  // only has the other daughter
+  // cell as its neighbor the
+  // other daughter cell needs
+  // to be sorted
+  // first. Therefore cells with
+  // only one neighbor are sorted
+  // in a second round.
+  sortCellWallAndCellVertex(sortCell);
+}
+
+void Tissue::addDividedCell(size_t i,size_t j,std::set<size_t> &sortCell) const
+{
+  //The two daughters and their neighbors (not the background)
+  size_t daughter[2] = {i,j};
+  for( size_t d=0 ; d<2 ; ++d ) {
+    size_t ii = daughter[d];
+    sortCell.insert(ii);
+    for( size_t k=0 ; k<cell(ii).numWall() ; ++k ) {
+      if( cell(ii).wall(k)->cell1()->index() == ii )
+	sortCell.insert(cell(ii).wall(k)->cell2()->index());
+      else
+	sortCell.insert(cell(ii).wall(k)->cell1()->index());
+    }
+  }
+  sortCell.erase( static_cast<size_t>(-1) );
+}
+
+void Tissue::renumber(DataMatrix &cellData,
+		      DataMatrix &wallData,
+		      DataMatrix &vertexData,
+		      DataMatrix &cellDeriv,
+		      DataMatrix &wallDeriv,
+		      DataMatrix &vertexDeriv,
+		      size_t verbose)
+{
+  size_t N = numCell();
+  size_t NW = numWall();
+  size_t NV = numVertex();
+  if( !N || !NV )
+    return;
+  if( cellData.size()!=N || wallData.size()!=NW || vertexData.size()!=NV ||
+      cellDeriv.size()!=N || wallDeriv.size()!=NW || vertexDeriv.size()!=NV ) {
+    std::cerr << "Tissue::renumber() Data and tissue sizes differ." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  //
+  // Cell order from the Morton (Z-order) code of the cell centers
+  //
+  size_t dimension = vertexData[0].size();
+  size_t numBit = dimension ? 63/dimension : 0;
+  if( numBit>21 )
+    numBit = 21;
+  std::vector<double> xMin(vertexData[0]),xMax(vertexData[0]);
+  for( size_t i=1 ; i<NV ; ++i )
+    for( size_t d=0 ; d<dimension ; ++d ) {
+      if( vertexData[i][d]<xMin[d] ) xMin[d] = vertexData[i][d];
+      if( vertexData[i][d]>xMax[d] ) xMax[d] = vertexData[i][d];
+    }
+  double maxCoord = static_cast<double>( (1ULL<<numBit)-1 );
+  std::vector< std::pair<unsigned long long,size_t> > cellCode(N);
+  std::vector<double> center(dimension);
+  std::vector<unsigned long long> coord(dimension);
+  for( size_t i=0 ; i<N ; ++i ) {
+    const Cell &c = cell_[i];
+    for( size_t d=0 ; d<dimension ; ++d )
+      center[d] = 0.0;
+    for( size_t k=0 ; k<c.numVertex() ; ++k )
+      for( size_t d=0 ; d<dimension ; ++d )
+	center[d] += vertexData[c.vertex(k)->index()][d];
+    for( size_t d=0 ; d<dimension ; ++d ) {
+      double range = xMax[d]-xMin[d];
+      double x = (c.numVertex() && range>0.0) ? 
+	(center[d]/c.numVertex()-xMin[d])/range : 0.0;
+      coord[d] = static_cast<unsigned long long>(x*maxCoord+0.5);
+    }
+    unsigned long long code=0;
+    for( size_t b=numBit ; b>0 ; --b )
+      for( size_t d=0 ; d<dimension ; ++d )
+	code = (code<<1) | ((coord[d]>>(b-1)) & 1ULL);
+    cellCode[i] = std::make_pair(code,i);
+  }
+  std::sort(cellCode.begin(),cellCode.end());
+  //
+  // Vertex and wall order from first touch when going through the cells
+  //
+  size_t unset = static_cast<size_t>(-1);
+  std::vector<size_t> cellNew(N),wallNew(NW,unset),vertexNew(NV,unset);
+  std::vector<size_t> cellOld(N),wallOld,vertexOld;
+  wallOld.reserve(NW);
+  vertexOld.reserve(NV);
+  for( size_t i=0 ; i<N ; ++i ) {
+    size_t iOld = cellCode[i].second;
+    cellOld[i] = iOld;
+    cellNew[iOld] = i;
+    const Cell &c = cell_[iOld];
+    for( size_t k=0 ; k<c.numVertex() ; ++k ) {
+      size_t vI = c.vertex(k)->index();
+      if( vertexNew[vI]==unset ) {
+	vertexNew[vI] = vertexOld.size();
+	vertexOld.push_back(vI);
+      }
+    }
+    for( size_t k=0 ; k<c.numWall() ; ++k ) {
+      size_t wI = c.wall(k)->index();
+      if( wallNew[wI]==unset ) {
+	wallNew[wI] = wallOld.size();
+	wallOld.push_back(wI);
+      }
+    }
+  }
+  for( size_t i=0 ; i<NV ; ++i )
+    if( vertexNew[i]==unset ) {
+      vertexNew[i] = vertexOld.size();
+      vertexOld.push_back(i);
+    }
+  for( size_t i=0 ; i<NW ; ++i )
+    if( wallNew[i]==unset ) {
+      wallNew[i] = wallOld.size();
+      wallOld.push_back(i);
+    }
+  reorder(cellOld,wallOld,vertexOld,cellNew,wallNew,vertexNew,
+	  cellData,wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv);
+  
+  if( verbose )
+    std::cerr << "Tissue::renumber() " << N << " cells, " << NW << " walls and "
+	      << NV << " vertices renumbered." << std::endl;
+}
+
+void Tissue::reorder(const std::vector<size_t> &cellOld,
+		     const std::vector<size_t> &wallOld,
+		     const std::vector<size_t> &vertexOld,
+		     const std::vector<size_t> &cellNew,
+		     const std::vector<size_t> &wallNew,
+		     const std::vector<size_t> &vertexNew,
+		     DataMatrix &cellData,
+		     DataMatrix &wallData,
+		     DataMatrix &vertexData,
+		     DataMatrix &cellDeriv,
+		     DataMatrix &wallDeriv,
+		     DataMatrix &vertexDeriv)
+{
+  //
+  // Create the reordered vectors (with the same reserved capacity such that
+  // pointers stay valid when elements are added) and reconnect the pointers
+  //
+  size_t N = cellOld.size();
+  size_t NW = wallOld.size();
+  size_t NV = vertexOld.size();
+  Cell *cellBase = cell_.size() ? &cell_[0] : NULL;
+  Wall *wallBase = wall_.size() ? &wall_[0] : NULL;
+  Vertex *vertexBase = vertex_.size() ? &vertex_[0] : NULL;
+  std::vector<Cell> newCell;
+  std::vector<Wall> newWall;
+  std::vector<Vertex> newVertex;
+  newCell.reserve(cell_.capacity());
+  newWall.reserve(wall_.capacity());
+  newVertex.reserve(vertex_.capacity());
+  for( size_t i=0 ; i<N ; ++i ) {
+    newCell.push_back(cell_[cellOld[i]]);
+    newCell[i].setIndex(i);
+  }
+  for( size_t i=0 ; i<NW ; ++i ) {
+    newWall.push_back(wall_[wallOld[i]]);
+    newWall[i].setIndex(i);
+  }
+  for( size_t i=0 ; i<NV ; ++i ) {
+    newVertex.push_back(vertex_[vertexOld[i]]);
+    newVertex[i].setIndex(i);
+  }
+  for( size_t i=0 ; i<N ; ++i ) {
+    Cell &c = newCell[i];
+    for( size_t k=0 ; k<c.numWall() ; ++k )
+      c.setWall(k,&newWall[wallNew[c.wall(k)-wallBase]]);
+    for( size_t k=0 ; k<c.numVertex() ; ++k )
+      c.setVertex(k,&newVertex[vertexNew[c.vertex(k)-vertexBase]]);
+  }
+  for( size_t k=0 ; k<background_.numWall() ; ++k )
+    background_.setWall(k,&newWall[wallNew[background_.wall(k)-wallBase]]);
+  for( size_t k=0 ; k<background_.numVertex() ; ++k )
+    background_.setVertex(k,&newVertex[vertexNew[background_.vertex(k)-vertexBase]]);
+  for( size_t i=0 ; i<NW ; ++i ) {
+    Wall &w = newWall[i];
+    Cell *c1 = w.cell1()==&background_ ? &background_ : &newCell[cellNew[w.cell1()-cellBase]];
+    Cell *c2 = w.cell2()==&background_ ? &background_ : &newCell[cellNew[w.cell2()-cellBase]];
+    w.setCell(c1,c2);
+    w.setVertex(&newVertex[vertexNew[w.vertex1()-vertexBase]],
+		&newVertex[vertexNew[w.vertex2()-vertexBase]]);
+  }
+  for( size_t i=0 ; i<NV ; ++i ) {
+    Vertex &v = newVertex[i];
+    for( size_t k=0 ; k<v.numCell() ; ++k )
+      if( v.cell(k)!=&background_ )
+	v.setCell(k,&newCell[cellNew[v.cell(k)-cellBase]]);
+    for( size_t k=0 ; k<v.numWall() ; ++k )
+      v.setWall(k,&newWall[wallNew[v.wall(k)-wallBase]]);
+  }
+  cell_.swap(newCell);
+  wall_.swap(newWall);
+  vertex_.swap(newVertex);
+  //
+  // Move data, derivatives, stable ids and index lists
+  //
+  DataMatrix tmpData;
+  tmpData.resize(N);
+  for( size_t i=0 ; i<N ; ++i ) tmpData[i].swap(cellData[cellOld[i]]);
+  cellData.swap(tmpData);
+  tmpData.resize(N);
+  for( size_t i=0 ; i<N ; ++i ) tmpData[i].swap(cellDeriv[cellOld[i]]);
+  cellDeriv.swap(tmpData);
+  tmpData.resize(NW);
+  for( size_t i=0 ; i<NW ; ++i ) tmpData[i].swap(wallData[wallOld[i]]);
+  wallData.swap(tmpData);
+  tmpData.resize(NW);
+  for( size_t i=0 ; i<NW ; ++i ) tmpData[i].swap(wallDeriv[wallOld[i]]);
+  wallDeriv.swap(tmpData);
+  tmpData.resize(NV);
+  for( size_t i=0 ; i<NV ; ++i ) tmpData[i].swap(vertexData[vertexOld[i]]);
+  vertexData.swap(tmpData);
+  tmpData.resize(NV);
+  for( size_t i=0 ; i<NV ; ++i ) tmpData[i].swap(vertexDeriv[vertexOld[i]]);
+  vertexDeriv.swap(tmpData);
+  
+  std::vector<size_t> tmpIndex;
+  if( cellStableId_.size()==cellNew.size() ) {
+    tmpIndex.resize(N);
+    for( size_t i=0 ; i<N ; ++i ) tmpIndex[i] = cellStableId_[cellOld[i]];
+    cellStableId_.swap(tmpIndex);
+  }
+  if( wallStableId_.size()==wallNew.size() ) {
+    tmpIndex.resize(NW);
+    for( size_t i=0 ; i<NW ; ++i ) tmpIndex[i] = wallStableId_[wallOld[i]];
+    wallStableId_.swap(tmpIndex);
+  }
+  if( vertexStableId_.size()==vertexNew.size() ) {
+    tmpIndex.resize(NV);
+    for( size_t i=0 ; i<NV ; ++i ) tmpIndex[i] = vertexStableId_[vertexOld[i]];
+    vertexStableId_.swap(tmpIndex);
+  }
+  if( directionalWall_.size()==cellNew.size() ) {
+    tmpIndex.resize(N);
+    for( size_t i=0 ; i<N ; ++i ) tmpIndex[i] = directionalWall_[cellOld[i]];
+    directionalWall_.swap(tmpIndex);
+  }
+  // Sister vertex pairs including a dropped vertex are removed
+  size_t unset = static_cast<size_t>(-1);
+  size_t numSister=0;
+  for( size_t i=0 ; i<sisterVertexIndex_.size() ; ++i ) {
+    int keep=1;
+    for( size_t k=0 ; k<sisterVertexIndex_[i].size() ; ++k ) {
+      size_t vI = sisterVertexIndex_[i][k];
+      if( vI>=vertexNew.size() || vertexNew[vI]==unset )
+	keep=0;
+      else
+	sisterVertexIndex_[i][k] = vertexNew[vI];
+    }
+    if( keep )
+      sisterVertexIndex_[numSister++].swap(sisterVertexIndex_[i]);
+  }
+  sisterVertexIndex_.resize(numSister);
+  topologyChanged();
 }
 
 void Tissue::removeCell(size_t cellIndex,
@@ -2658,16 +3301,134 @@ removeCells(std::vector<size_t> &cellIndex,
             DataMatrix &wallDeriv,
             DataMatrix &vertexDeriv ) 
 {
-  // Sort the indices to make sure highest indices are removed first 
-  // (since removed index is occupied with the last one)
-  sort(cellIndex.begin(),cellIndex.end());
-  
-  size_t numRemove = cellIndex.size();
-  for (size_t ii=0; ii<numRemove; ++ii) {
-    size_t i = numRemove-(ii+1);
-    removeCell(cellIndex[i],cellData,wallData,vertexData,cellDeriv,wallDeriv,
-               vertexDeriv);
+  size_t N = numCell();
+  size_t NW = numWall();
+  size_t NV = numVertex();
+  if( cellData.size()!=N || wallData.size()!=NW || vertexData.size()!=NV ||
+      cellDeriv.size()!=N || wallDeriv.size()!=NW || vertexDeriv.size()!=NV ) {
+    std::cerr << "Tissue::removeCells() Data and tissue sizes differ." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  //
+  // Mark cells
+  //
+  std::vector<char> cellRemove(N,0),wallRemove(NW,0),vertexRemove(NV,0);
+  std::vector<size_t> cellR;
+  cellR.reserve(cellIndex.size());
+  for( size_t i=0 ; i<cellIndex.size() ; ++i ) {
+    if( cellIndex[i]>=N ) {
+      std::cerr << "Tissue::removeCells() Cell index " << cellIndex[i]
+		<< " out of range (" << N << " cells)." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if( !cellRemove[cellIndex[i]] ) {
+      cellRemove[cellIndex[i]]=1;
+      cellR.push_back(cellIndex[i]);
+    }
+  }
+  if( !cellR.size() )
+    return;
+  //
+  // Mark walls only connected to removed cells (or the background), and
+  // switch removed neighbors to the background for the others
+  //
+  for( size_t i=0 ; i<cellR.size() ; ++i ) {
+    Cell &c = cell(cellR[i]);
+    for( size_t k=0 ; k<c.numWall() ; ++k ) {
+      Wall *w = c.wall(k);
+      Cell *other;
+      if( w->cell1()==&c )
+	other = w->cell2();
+      else if( w->cell2()==&c )
+	other = w->cell1();
+      else {
+	std::cerr << "Tissue::removeCells() wall not connected to cell"
+		  << std::endl;
+	exit(EXIT_FAILURE);
+      }
+      if( other==background() || cellRemove[other->index()] )
+	wallRemove[w->index()]=1;
+      else if( w->cell1()==&c )
+	w->setCell1( background() );
+      else
+	w->setCell2( background() );
+    }
+  }
+  //
+  // Disconnect removed cells and walls from vertices, and mark vertices
+  // left without any connection
+  //
+  std::vector<size_t> vertexTouched;
+  for( size_t i=0 ; i<cellR.size() ; ++i ) {
+    Cell &c = cell(cellR[i]);
+    for( size_t k=0 ; k<c.numVertex() ; ++k ) {
+      Vertex *v = c.vertex(k);
+      v->removeCell( &c );
+      vertexTouched.push_back(v->index());
+    }
+  }
+  for( size_t i=0 ; i<NW ; ++i )
+    if( wallRemove[i] ) {
+      wall(i).vertex1()->removeWall( &wall(i) );
+      wall(i).vertex2()->removeWall( &wall(i) );
+    }
+  for( size_t i=0 ; i<vertexTouched.size() ; ++i ) {
+    Vertex &v = vertex(vertexTouched[i]);
+    if( v.numCell()==0 && v.numWall()==0 )
+      vertexRemove[v.index()]=1;
+    else if( v.numCell()==0 || v.numWall()==0 ) {
+      std::cerr << "Tissue::removeCells() strange vertex " << v.index()
+		<< ". It has " << v.numCell() << " cells and " << v.numWall()
+		<< " walls." << std::endl;
+      exit(EXIT_FAILURE);
+    }
   }
+  //
+  // Remove dropped walls and vertices from the background
+  //
+  std::vector<Wall*> bgWall;
+  for( size_t k=0 ; k<background_.numWall() ; ++k )
+    if( !wallRemove[background_.wall(k)->index()] )
+      bgWall.push_back(background_.wall(k));
+  background_.setWall(bgWall);
+  std::vector<Vertex*> bgVertex;
+  for( size_t k=0 ; k<background_.numVertex() ; ++k )
+    if( !vertexRemove[background_.vertex(k)->index()] )
+      bgVertex.push_back(background_.vertex(k));
+  background_.setVertex(bgVertex);
+  //
+  // Single remap table per entity type, keeping the relative order
+  //
+  size_t unset = static_cast<size_t>(-1);
+  std::vector<size_t> cellNew(N,unset),wallNew(NW,unset),vertexNew(NV,unset);
+  std::vector<size_t> cellOld,wallOld,vertexOld;
+  cellOld.reserve(N);
+  wallOld.reserve(NW);
+  vertexOld.reserve(NV);
+  for( size_t i=0 ; i<N ; ++i )
+    if( !cellRemove[i] ) {
+      cellNew[i] = cellOld.size();
+      cellOld.push_back(i);
+    }
+  for( size_t i=0 ; i<NW ; ++i )
+    if( !wallRemove[i] ) {
+      wallNew[i] = wallOld.size();
+      wallOld.push_back(i);
+    }
+  for( size_t i=0 ; i<NV ; ++i )
+    if( !vertexRemove[i] ) {
+      vertexNew[i] = vertexOld.size();
+      vertexOld.push_back(i);
+    }
+  reorder(cellOld,wallOld,vertexOld,cellNew,wallNew,vertexNew,
+	  cellData,wallData,vertexData,cellDeriv,wallDeriv,vertexDeriv);
+  
+  assert( cellData.size() == numCell() );
+  assert( wallData.size() == numWall() );
+  assert( vertexData.size() == numVertex() );	
+  std::cerr << "Tissue::removeCells() " << N-numCell() << " cells, "
+	    << NW-numWall() << " walls, and " << NV-numVertex()
+	    << " vertices removed" << std::endl;
 }
 
 void Tissue::
@@ -2713,10 +3474,7 @@ removeEpidermalCells(DataMatrix &cellData,
   }
   
   // Remove cells
-  for (size_t i = 0; i < cellR.size(); ++i) {
-    removeCell(cellR[i], cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
-    //checkConnectivity(1);
-  }
+  removeCells(cellR, cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
 }
 
 void Tissue::removeEpidermalCellsMk2(DataMatrix &cellData,
@@ -2776,10 +3534,7 @@ void Tissue::removeEpidermalCellsMk2(DataMatrix &cellData,
   }
   
   // Remove cells
-  for (size_t i = 0; i < cellR.size(); ++i) {
-    removeCell(cellR[i], cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
-    //checkConnectivity(1);
-  }
+  removeCells(cellR, cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
 }
 
 void Tissue::
@@ -2819,10 +3574,30 @@ removeEpidermalCellsAtDistance(DataMatrix &cellData,
   }
   
   // Remove cells
-  for (size_t i = 0; i < cellR.size(); ++i) {
-    removeCell(cellR[i], cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
-    //checkConnectivity(1);
+  removeCells(cellR, cellData, wallData, vertexData, cellDeriv, wallDeriv, vertexDeriv);
+}
+
+void Tissue::appendDivisionElements(size_t numDivision)
+{
+  //Checked since the elements are connected by pointers
+  if( numCell()+numDivision>cell_.capacity() ||
+      numWall()+3*numDivision>wall_.capacity() ||
+      numVertex()+2*numDivision>vertex_.capacity() ) {
+    std::cerr << "Tissue::appendDivisionElements() Reserved number of cells,"
+	      << " walls or vertices exceeded." << std::endl;
+    exit(EXIT_FAILURE);
   }
+  cell_.resize(numCell()+numDivision);
+  wall_.resize(numWall()+3*numDivision);
+  vertex_.resize(numVertex()+2*numDivision);
+  for( size_t k=0 ; k<numDivision ; ++k ) {
+    cellStableId_.push_back(nextCellStableId_++);
+    for( size_t l=0 ; l<2 ; ++l )
+      vertexStableId_.push_back(nextVertexStableId_++);
+    for( size_t l=0 ; l<3 ; ++l )
+      wallStableId_.push_back(nextWallStableId_++);
+  }
+  topologyChanged();
 }
 
 void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I, 
@@ -2837,8 +3612,28 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
 			 std::vector<size_t> &volumeChangeList,
 			 double threshold) 
   
-{	
+{
+  size_t i = divCell->index();
   size_t Nc=numCell(),Nw=numWall(),Nv=numVertex();
+  appendDivisionElements(1);
+  divideCell(&(cell(i)),wI,w3I,v1Pos,v2Pos,cellData,wallData,vertexData,
+	     cellDeriv,wallDeriv,vertexDeriv,volumeChangeList,threshold,
+	     Nc,Nw,Nv);
+}
+
+void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I, 
+			 std::vector<double> &v1Pos,
+			 std::vector<double> &v2Pos,
+			 DataMatrix &cellData,
+			 DataMatrix &wallData,
+			 DataMatrix &vertexData,
+			 DataMatrix &cellDeriv,
+			 DataMatrix &wallDeriv,
+			 DataMatrix &vertexDeriv,
+			 std::vector<size_t> &volumeChangeList,
+			 double threshold,
+			 size_t Nc,size_t Nw,size_t Nv) 
+{	
   size_t i = divCell->index();
   size_t dimension = vertexData[0].size();
   
@@ -2910,8 +3705,8 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
   
   //Create the new data structure and set indices in the tissue vectors
   //
-  //Add the new cell
-  addCell( cell(i) );
+  //Set the new cell (the elements are appended by appendDivisionElements())
+  cell(Nc) = cell(i);
   cell(Nc).setIndex(Nc);
   cellData.resize(Nc+1,cellData[i]);
   cellDeriv.resize(Nc+1,cellDeriv[0]);
@@ -2920,11 +3715,11 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
   Vertex tmpVertex;
   tmpVertex.setPosition(v1Pos);
   tmpVertex.setIndex(Nv);
-  addVertex(tmpVertex);
+  vertex(Nv) = tmpVertex;
   vertexData.resize(Nv+1,v1Pos);  
   tmpVertex.setPosition(v2Pos);
   tmpVertex.setIndex(Nv+1);
-  addVertex(tmpVertex);
+  vertex(Nv+1) = tmpVertex;
   vertexData.resize(Nv+2,v2Pos);  
   vertexDeriv.resize(Nv+2,vertexDeriv[0]);  
   
@@ -2932,7 +3727,7 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
   Wall tmpWall;
   //New wall dividing old cell into two
   tmpWall.setIndex(Nw);
-  addWall(tmpWall);
+  wall(Nw) = tmpWall;
   wallData.resize(Nw+1,wallData[0]);
   double tmpLength = 0.0;
   for( size_t d=0 ; d<dimension ; ++d )
@@ -2940,7 +3735,7 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
   wallData[Nw][0] = std::sqrt( tmpLength );
   
   //Wall continuing the first selected wall
-  addWall( *(cell(i).wall(wI)) );
+  wall(Nw+1) = *(cell(i).wall(wI));
   wall(Nw+1).setIndex(Nw+1);
   //Set new lengths as fractions of the old determined from the new 
   //vertex position
@@ -2963,7 +3758,7 @@ void Tissue::divideCell( Cell *divCell, size_t wI, size_t w3I,
   wallData[Nw+1][0] = oldL-wallData[cell(i).wall(wI)->index()][0];
   
   //Wall continuing the second selected wall
-  addWall(*(cell(i).wall(w3I)));
+  wall(Nw+2) = *(cell(i).wall(w3I));
   wall(Nw+2).setIndex(Nw+2);
   //Set new lengths as fractions of the old determined from the new
   //vertex position
@@ -6368,38 +7163,214 @@ void Tissue::sortCellWallAndCellVertex(Cell *cell)
 {	
 	std::vector<size_t> sortedFlag(numCell());
 	size_t numSorted=0;
+	if( !cell && myParallel::numThread()>1 ) {
+	  sortCellParallel(sortedFlag, numSorted);
+	  std::cerr << "Tissue::sortCellWallAndCellVertex() " << numSorted << " of " << numCell()
+		    << " faces (cells) sorted using " << myParallel::numThread() << " threads."
+		    << std::endl;
+	  return;
+	}
 	if( !cell ) { //sort all		
 	  size_t startSortIndex=0;
 	  do {
 	    if (!sortedFlag[startSortIndex]) {
 	      cell = this->cellP(startSortIndex);	  
-	      sortCellRecursive(cell, sortedFlag, numSorted);
+	      sortCellIterative(cell, sortedFlag, numSorted);
 	    }
 	    startSortIndex++;
-	    //std::cerr << "Tissue::sortCellWallAndCellVertex() numSorted = " << numSorted 
-	    //	      << " startSortIndex = " << startSortIndex << std::endl;
 	  } while (numSorted<numCell() && startSortIndex<numCell());
 	}
-	else { //sort recursively around given cell (at division?)
-	  sortCellRecursive(cell, sortedFlag, numSorted);
+	else { //sort around given cell (at division?)
+	  sortCellIterative(cell, sortedFlag, numSorted);
 	}
 	std::cerr << "Tissue::sortCellWallAndCellVertex() " << numSorted << " of " << numCell()
-		  << " faces (cells) sorted recursively." << std::endl;
+		  << " faces (cells) sorted." << std::endl;
 }
 
-void Tissue::sortCellRecursive( Cell* cell, std::vector<size_t> &sortedFlag, size_t &numSorted)
+void Tissue::sortCellWallAndCellVertex(const std::set<size_t> &cellIndex)
+{
+  std::vector<size_t> oneNeighborCells;
+  for (std::set<size_t>::const_iterator k=cellIndex.begin(); k!=cellIndex.end(); ++k) {
+    Cell &cellToSort = cell(*k);
+    int counter = 0;
+    for (size_t wallIndex=0; wallIndex<cellToSort.numWall(); ++wallIndex)
+      if (cellToSort.cellNeighbor(wallIndex) != background())
+	++counter;
+    if (counter == 1)
+      oneNeighborCells.push_back(cellToSort.index());
+    else
+      cellToSort.sortWallAndVertex(*this);
+  }
+  for (size_t k=0; k<oneNeighborCells.size(); ++k)
+    cell(oneNeighborCells[k]).sortWallAndVertex(*this);
+}
+
+void Tissue::sortCellIterative( Cell* cell, std::vector<size_t> &sortedFlag, size_t &numSorted)
 {
   if (sortedFlag[cell->index()])
     return;
+  // Worklist of cells with the next neighbor (wall) to visit
+  std::vector< std::pair<Cell*,size_t> > stack;
   cell->sortWallAndVertex(*this);
   sortedFlag[cell->index()]++;
   numSorted++;
-  for (size_t k=0; k<cell->numWall(); ++k) {
-    Cell *cellNext = cell->cellNeighbor(k);
-    if (cellNext!=background())
-      sortCellRecursive(cellNext,sortedFlag,numSorted);
+  stack.push_back(std::make_pair(cell,size_t(0)));
+  while (stack.size()) {
+    Cell *current = stack.back().first;
+    size_t k = stack.back().second;
+    if (k>=current->numWall()) {
+      stack.pop_back();
+      continue;
+    }
+    ++stack.back().second;
+    Cell *cellNext = current->cellNeighbor(k);
+    if (cellNext!=background() && !sortedFlag[cellNext->index()]) {
+      cellNext->sortWallAndVertex(*this);
+      sortedFlag[cellNext->index()]++;
+      numSorted++;
+      stack.push_back(std::make_pair(cellNext,size_t(0)));
+    }
+  }
+}
+
+void Tissue::sortCellParallel( std::vector<size_t> &sortedFlag, size_t &numSorted)
+{
+  size_t N = numCell();
+  size_t unset = static_cast<size_t>(-1);
+  // Wall lists and sorting flags before sorting, to restore the serial start
+  std::vector<size_t> wallStart(N+1,0);
+  std::vector<Wall*> wallBefore;
+  for (size_t i=0; i<N; ++i) {
+    for (size_t k=0; k<cell(i).numWall(); ++k)
+      wallBefore.push_back(cell(i).wall(k));
+    wallStart[i+1] = wallBefore.size();
+  }
+  std::vector<char> flagBefore(numWall());
+  for (size_t i=0; i<numWall(); ++i)
+    flagBefore[i] = wall(i).cellSort1()!=0;
+  // Breadth-first levels from the first cell in each connected patch
+  std::vector<size_t> level(N,unset),order;
+  order.reserve(N);
+  for (size_t root=0; root<N; ++root) {
+    if (level[root]!=unset)
+      continue;
+    level[root] = 0;
+    size_t front = order.size();
+    order.push_back(root);
+    while (front<order.size()) {
+      Cell &c = cell(order[front++]);
+      for (size_t k=0; k<c.numWall(); ++k) {
+	Cell *cellNext = c.cellNeighbor(k);
+	if (cellNext!=background() && level[cellNext->index()]==unset) {
+	  level[cellNext->index()] = level[c.index()]+1;
+	  order.push_back(cellNext->index());
+	}
+      }
+    }
+  }
+  // Sub-waves within a level such that no neighbors are sorted concurrently
+  std::vector<size_t> wave(N,unset);
+  std::vector<char> used;
+  size_t numLevel=0,numWave=0;
+  for (size_t i=0; i<N; ++i) {
+    Cell &c = cell(order[i]);
+    used.assign(used.size(),0);
+    for (size_t k=0; k<c.numWall(); ++k) {
+      Cell *cellNext = c.cellNeighbor(k);
+      if (cellNext!=background() && level[cellNext->index()]==level[c.index()] &&
+	  wave[cellNext->index()]!=unset) {
+	if (wave[cellNext->index()]>=used.size())
+	  used.resize(wave[cellNext->index()]+1,0);
+	used[wave[cellNext->index()]] = 1;
+      }
+    }
+    size_t w=0;
+    while (w<used.size() && used[w])
+      ++w;
+    wave[c.index()] = w;
+    if (level[c.index()]+1>numLevel) numLevel = level[c.index()]+1;
+    if (w+1>numWave) numWave = w+1;
+  }
+  // Bucket cells per (level,wave), keeping the breadth-first order
+  std::vector< std::vector<size_t> > group(numLevel*numWave);
+  for (size_t i=0; i<N; ++i)
+    group[level[order[i]]*numWave+wave[order[i]]].push_back(order[i]);
+  for (size_t g=0; g<group.size(); ++g) {
+    const std::vector<size_t> &cellList = group[g];
+    myParallel::forEach(0,cellList.size(),[this,&cellList](size_t j) {
+	cell(cellList[j]).sortWallAndVertex(*this,0); } );
+  }
+  sortCellSerialStart(wallStart,wallBefore,flagBefore);
+  topologyChanged();
+  for (size_t i=0; i<N; ++i)
+    sortedFlag[i] = 1;
+  numSorted = N;
+}
+
+void Tissue::sortCellSerialStart(const std::vector<size_t> &wallStart,
+				 const std::vector<Wall*> &wallBefore,
+				 const std::vector<char> &flagBefore)
+{
+  // The serial sort keeps the first wall (in the list before sorting) that
+  // has a sorting flag in place, where the flags come from earlier sorts or
+  // from neighbors sorted before in the depth-first order. The depth-first
+  // order is repeated here on the sorted lists.
+  size_t N = numCell();
+  std::vector<char> visited(N,0);
+  std::vector< std::pair<size_t,size_t> > stack;
+  std::vector<Wall*> tmpWall;
+  std::vector<Vertex*> tmpVertex;
+  for (size_t root=0; root<N; ++root) {
+    if (visited[root])
+      continue;
+    size_t next = root;
+    do {
+      if (next!=static_cast<size_t>(-1)) {
+	Cell &c = cell(next);
+	size_t n = c.numWall();
+	size_t s=0;
+	for (size_t j=0; j<n; ++j) {
+	  Wall *w = wallBefore[wallStart[next]+j];
+	  Cell *other = w->cell1()==&c ? w->cell2() : w->cell1();
+	  if (flagBefore[w->index()] ||
+	      (other!=background() && visited[other->index()])) {
+	    s=j;
+	    break;
+	  }
+	}
+	size_t p=0;
+	while (p<n && c.wall(p)!=wallBefore[wallStart[next]+s])
+	  ++p;
+	assert( p<n );
+	if (p!=s) {
+	  size_t shift = s+n-p;
+	  tmpWall.resize(n);
+	  tmpVertex.resize(n);
+	  for (size_t j=0; j<n; ++j) {
+	    tmpWall[(j+shift)%n] = c.wall(j);
+	    tmpVertex[(j+shift)%n] = c.vertex(j);
+	  }
+	  c.setWall(tmpWall);
+	  c.setVertex(tmpVertex);
+	  if (numDirectionalWall() && directionalWall(next)<n)
+	    setDirectionalWall(next,(directionalWall(next)+shift)%n);
+	}
+	visited[next] = 1;
+	stack.push_back(std::make_pair(next,size_t(0)));
+      }
+      next = static_cast<size_t>(-1);
+      size_t i = stack.back().first;
+      size_t k = stack.back().second;
+      if (k>=cell(i).numWall()) {
+	stack.pop_back();
+	continue;
+      }
+      ++stack.back().second;
+      Cell *cellNext = cell(i).cellNeighbor(k);
+      if (cellNext!=background() && !visited[cellNext->index()])
+	next = cellNext->index();
+    } while (stack.size() || next!=static_cast<size_t>(-1));
   }
-  return;
 }
 
 void Tissue::checkConnectivity(size_t verbose) 
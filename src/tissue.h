@@ -12,16 +12,22 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <set>
 #include <string>
 #include <vector>
 #include "baseReaction.h"
 #include "baseCompartmentChange.h"
 #include "cell.h"
 #include "direction.h"
+#include "geometry.h"
 #include "myTypedefs.h"
+#include "reactionSchedule.h"
+#include "tissueTopology.h"
 #include "vertex.h"
 #include "wall.h"
 
+class HybridStochastic;
+
 ///
 /// @brief Defines the properties of a two-dimensional cell tissue model
 ///
@@ -51,6 +57,121 @@ class Tissue {
 
   std::vector< std::vector<size_t> > sisterVertexIndex_;
 
+  size_t topologyRevision_;
+  TissueTopology topology_;
+  int geometryFlag_;
+  Geometry geometry_;
+  GeometryState geometryState_;
+  GeometryState geometryDerivs_;
+  int scheduleFlag_;
+  std::vector<ReactionSchedule> reactionSchedule_;
+  std::vector<int> stochasticReaction_;
+  HybridStochastic *hybrid_;
+  DataMatrix *stateCellData_;
+  DataMatrix *stateWallData_;
+  DataMatrix *stateVertexData_;
+
+  std::vector<size_t> cellStableId_;
+  std::vector<size_t> wallStableId_;
+  std::vector<size_t> vertexStableId_;
+  size_t nextCellStableId_;
+  size_t nextWallStableId_;
+  size_t nextVertexStableId_;
+
+  ///
+  /// @brief Moves cells, walls and vertices to their new indices and
+  /// reconnects all pointers
+  ///
+  /// @details xOld[i] gives the old index of the entity placed at i, and
+  /// xNew the inverse map (size_t(-1) for entities that are dropped). The
+  /// entity vectors keep their capacity such that pointers into them stay
+  /// valid for later additions. Data, derivatives, stable ids, directional
+  /// walls and sister vertices are moved along. Dropped entities must have
+  /// been disconnected from the remaining ones before the call.
+  ///
+  void reorder(const std::vector<size_t> &cellOld,
+	       const std::vector<size_t> &wallOld,
+	       const std::vector<size_t> &vertexOld,
+	       const std::vector<size_t> &cellNew,
+	       const std::vector<size_t> &wallNew,
+	       const std::vector<size_t> &vertexNew,
+	       DataMatrix &cellData,
+	       DataMatrix &wallData,
+	       DataMatrix &vertexData,
+	       DataMatrix &cellDeriv,
+	       DataMatrix &wallDeriv,
+	       DataMatrix &vertexDeriv);
+  ///
+  /// @brief Adds the central difference Jacobian of the listed reactions to J
+  ///
+  /// @see vertexJacobian()
+  ///
+  void vertexJacobianFiniteDifference(DataMatrix &cellData,
+				      DataMatrix &wallData,
+				      DataMatrix &vertexData,
+				      VertexJacobian &J,
+				      const std::vector<size_t> &reactionList);
+  ///
+  /// @brief Adds the contributions from the listed reactions to the (zeroed)
+  /// derivatives using the geometry kernels where provided
+  ///
+  /// @see setGeometryFlag()
+  ///
+  void geometryDerivs(DataMatrix &cellData,
+		      DataMatrix &wallData,
+		      DataMatrix &vertexData,
+		      DataMatrix &cellDeriv,
+		      DataMatrix &wallDeriv,
+		      DataMatrix &vertexDeriv,
+		      const std::vector<size_t> &reactionList);
+  ///
+  /// @brief Adds the contributions from the listed reactions to the (zeroed)
+  /// derivatives running the levels of the ReactionSchedule in parallel
+  ///
+  /// @see setScheduleFlag()
+  ///
+  void scheduleDerivs(DataMatrix &cellData,
+		      DataMatrix &wallData,
+		      DataMatrix &vertexData,
+		      DataMatrix &cellDeriv,
+		      DataMatrix &wallDeriv,
+		      DataMatrix &vertexDeriv,
+		      const std::vector<size_t> &reactionList);
+  ///
+  /// @brief Divides the flagged cells with the plans of a compartment change
+  /// in rounds of cells not sharing walls
+  ///
+  /// @details A cell is ready when all flagged cells sharing a wall with it
+  /// and having a lower index are divided, such that it is divided with the
+  /// same walls as when the cells are divided one by one in index order. The
+  /// ready cells do not share walls, and in each round their plans are
+  /// calculated in parallel and then committed (in index order) into the
+  /// elements appended for the whole round (appendDivisionElements()),
+  /// after which the divided cells and their neighbors are sorted once.
+  /// Only the numbering of the new cells can differ from the order of the
+  /// one by one division.
+  ///
+  /// @see BaseCompartmentChange::plan()
+  ///
+  void divideCells(BaseCompartmentChange *change,
+		   std::vector<size_t> &flagged,
+		   DataMatrix &cellData,
+		   DataMatrix &wallData,
+		   DataMatrix &vertexData,
+		   DataMatrix &cellDeriv,
+		   DataMatrix &wallDeriv,
+		   DataMatrix &vertexDeriv);
+  ///
+  /// @brief Sorts the walls and vertices of a divided cell, its new sister
+  /// (the last cell) and their neighbors
+  ///
+  void sortDividedCell(size_t i);
+  ///
+  /// @brief Adds the divided cell i, its sister j and their neighbors to
+  /// the cells to be sorted
+  ///
+  void addDividedCell(size_t i,size_t j,std::set<size_t> &sortCell) const;
+
  public:
   
   ///
@@ -383,6 +504,30 @@ class Tissue {
   ///
   void copyState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &vertexData);
   ///
+  /// @brief Lets all cells, walls, and vertices refer to the given state
+  ///
+  /// @details After binding, the cell variables, wall lengths and variables,
+  /// and vertex positions are read and written directly in the rows of the
+  /// state matrices (e.g. the solver data), and the elements do not keep
+  /// copies. The matrices have to be kept in the order of the element
+  /// indices, which is the case for the compartment changes. Elements added
+  /// by a compartment change are bound at the end of
+  /// checkCompartmentChange(). When bound, copyState() for the same matrices
+  /// only checks the sizes.
+  ///
+  /// @see Cell::bindVariable()
+  ///
+  void bindState(DataMatrix &cellData, DataMatrix &wallData, DataMatrix &vertexData);
+  ///
+  /// @brief Copies the bound state into the elements and ends the binding
+  ///
+  void unbindState();
+  ///
+  /// @brief Returns true if the elements are bound to the given state
+  ///
+  inline int stateBound(const DataMatrix &cellData, const DataMatrix &wallData,
+			const DataMatrix &vertexData) const;
+  ///
   /// @brief The tissue name
   ///
   inline std::string id() const;
@@ -401,6 +546,93 @@ class Tissue {
   ///
   inline size_t numVertex() const;
   ///
+  /// @brief Returns the current topology revision
+  ///
+  /// The revision is increased every time the connectivity between cells,
+  /// walls and vertices (or its ordering) is changed, e.g. at divisions and
+  /// removals.
+  ///
+  inline size_t topologyRevision() const;
+  ///
+  /// @brief Marks the connectivity as changed
+  ///
+  /// Should be called by any function changing the cell/wall/vertex
+  /// connectivity without using the Tissue add/remove functions.
+  ///
+  inline void topologyChanged();
+  ///
+  /// @brief Returns an index based (CSR) snapshot of the connectivity
+  ///
+  /// The snapshot is rebuilt (lazily) only if the topology has changed since
+  /// it was last built, and can be used in hot loops instead of following
+  /// the Cell/Wall/Vertex pointers.
+  ///
+  /// @see TissueTopology
+  ///
+  inline const TissueTopology & topology();
+  ///
+  /// @brief Returns the cell/wall/vertex connectivity as a face/edge/vertex
+  /// Geometry
+  ///
+  /// Rebuilt (lazily) from topology() when the topology has changed.
+  ///
+  /// @see Geometry
+  ///
+  inline const Geometry & geometry();
+  ///
+  /// @brief Switches the geometry kernels on (1) or off (0) in derivs()
+  ///
+  /// When on, reactions providing BaseReaction::geometryDerivs() are
+  /// calculated on the Geometry with a GeometryState viewing the state in
+  /// place, and the remaining reactions as usual. Consecutive
+  /// kernel contributions are summed in the GeometryState and added to the
+  /// derivatives before the next remaining reaction, such that reactions
+  /// reading the derivatives see all preceding reactions in model file
+  /// order. Within a kernel the terms may be summed in a different order
+  /// than in BaseReaction::derivs().
+  ///
+  inline void setGeometryFlag(int value);
+  inline int geometryFlag() const;
+  ///
+  /// @brief Switches the scheduled (parallel) reaction calculation on (1) or
+  /// off (0) in derivs()
+  ///
+  /// When on, the reactions are divided into levels of independent reactions
+  /// given by their declared read/write sets (BaseReaction::access()), and
+  /// the reactions within a level are calculated in parallel over
+  /// myParallel::numThread() threads. Dependent reactions keep the model file
+  /// order, and reactions not declaring their columns are run exclusively.
+  /// The geometry kernels (setGeometryFlag()) take precedence if both are
+  /// on.
+  ///
+  /// @see ReactionSchedule
+  ///
+  inline void setScheduleFlag(int value);
+  inline int scheduleFlag() const;
+  ///
+  /// @brief Returns the schedule for the listed reactions
+  ///
+  /// The schedules are built when first needed and kept until the reactions
+  /// are changed.
+  ///
+  const ReactionSchedule & reactionSchedule(const std::vector<size_t> &
+					    reactionList);
+  ///
+  /// @brief Marks reaction r as simulated stochastically (1), which removes
+  /// it from derivs() and derivsWithAbs(), or as deterministic (0)
+  ///
+  /// @see HybridStochastic
+  ///
+  void setStochasticReaction(size_t r,int value);
+  inline int stochasticReaction(size_t r) const;
+  ///
+  /// @brief Sets the hybrid engine partitioning its copy numbers at cell
+  /// divisions (0 removes it)
+  ///
+  /// @see HybridStochastic::divide()
+  ///
+  inline void setHybrid(HybridStochastic *hybrid);
+  ///
   /// @brief Returns the number of reactions in the tissue model
   ///
   inline size_t numReaction() const;
@@ -421,6 +653,28 @@ class Tissue {
   ///
   inline size_t directionalWall(size_t i) const;
   ///
+  /// @brief Returns the stable (output) identity of cell i
+  ///
+  /// @details Cells are given stable ids in the order they are created
+  /// (read or divided), and the id follows the cell when it is moved by
+  /// removals or renumber(). Ids of removed cells are not reused.
+  ///
+  /// @see renumber()
+  ///
+  inline size_t cellStableId(size_t i) const;
+  ///
+  /// @brief Returns the stable (output) identity of wall i
+  ///
+  /// @see cellStableId()
+  ///
+  inline size_t wallStableId(size_t i) const;
+  ///
+  /// @brief Returns the stable (output) identity of vertex i
+  ///
+  /// @see cellStableId()
+  ///
+  inline size_t vertexStableId(size_t i) const;
+  ///
   /// @brief Returns a (const) reference to the tissue cell vector
   ///
   inline const std::vector<Cell> & cell() const;
@@ -526,6 +780,10 @@ class Tissue {
   ///
   inline BaseReaction* reaction(size_t i) const;
   ///
+  /// @brief Returns the pointers to all reactions in the tissue model
+  ///
+  inline const std::vector<BaseReaction*> & reaction() const;
+  ///
   /// @brief Returns a pointer to compartmentChange i in the tissue model
   ///
   inline BaseCompartmentChange* compartmentChange(size_t i) const;
@@ -628,6 +886,22 @@ class Tissue {
 	       DataMatrix &wallDeriv,
 	       DataMatrix &vertexDeriv );
   ///
+  /// @brief Calculates the derivatives from a subset of the reactions
+  ///
+  /// As derivs(), but only the reactions with indices given in reactionList
+  /// contribute (in the given order). Used by splitting solvers that
+  /// advance groups of reactions separately.
+  ///
+  /// @see StrangSplitting
+  ///
+  void derivs( DataMatrix &cellData,
+	       DataMatrix &wallData,
+	       DataMatrix &vertexData,
+	       DataMatrix &cellDeriv,
+	       DataMatrix &wallDeriv,
+	       DataMatrix &vertexDeriv,
+	       const std::vector<size_t> &reactionList );
+  ///
   /// @brief Calculates the derivatives given the state provided and stores also abs values of derivatives  
   ///
   /// A derivatives function used when integrating the
@@ -647,6 +921,28 @@ class Tissue {
 		      DataMatrix &sdydtWall,
 		      DataMatrix &sdydtVertex );
   ///
+  /// @brief Assembles the Jacobian of the vertex derivatives with respect to
+  /// the vertex positions
+  ///
+  /// Reactions providing BaseReaction::vertexJacobian() add their analytic
+  /// blocks (if analyticFlag is set). The remaining reactions writing vertex
+  /// derivatives (ReactionAccess::vertexDerivs, or exclusive) are
+  /// differentiated together by central differences of derivs(), where
+  /// vertices not sharing a cell with a common vertex are perturbed
+  /// simultaneously (a distance two colouring of the cell -> vertex
+  /// graph). Only couplings between vertices of a common cell are
+  /// captured. The cell and wall data are restored after each evaluation.
+  /// J is resized if needed, and otherwise cleared keeping its pattern.
+  /// Returns the number of reactions differentiated numerically.
+  ///
+  /// @see VertexJacobian
+  ///
+  size_t vertexJacobian(DataMatrix &cellData,
+			DataMatrix &wallData,
+			DataMatrix &vertexData,
+			VertexJacobian &J,
+			int analyticFlag=1);
+  ///
   /// @brief Initiates the variables via reactions
   ///
   /// This function is called before numerical integration of the
@@ -712,6 +1008,12 @@ class Tissue {
   ///
   /// @brief Checks for and updates the tissue according to CompartmentChange rules 
   ///
+  /// @details Divisions providing plans (BaseCompartmentChange::hasPlan())
+  /// are flagged for all cells first and then applied by divideCells(),
+  /// where the plans are calculated in parallel. Cells created by the
+  /// divisions are flagged afterwards. Other changes are flagged and
+  /// applied cell by cell.
+  ///
   /// @see BaseCompartmentChange
   ///
   void checkCompartmentChange(DataMatrix &cellData,
@@ -721,6 +1023,32 @@ class Tissue {
 			      DataMatrix &wallDeriv,
 			      DataMatrix &vertexDeriv );
   ///
+  /// @brief Renumbers cells, walls and vertices for memory locality
+  ///
+  /// @details Cells are sorted along a Morton (Z-order) curve of their
+  /// centers (mean vertex position from vertexData). Vertices and walls are
+  /// then numbered in the order they are first touched when going through
+  /// the cells in the new order (unconnected ones are kept last in their
+  /// old order). The cell, wall and vertex vectors, all connecting pointers,
+  /// the directional walls, sister vertices, stable ids and the data and
+  /// derivative matrices are permuted consistently, and the topology
+  /// revision is increased.
+  ///
+  /// Used by the solvers when the simulator is called with the -renumber
+  /// option (at load and with a given interval of steps). Note that
+  /// reactions that store cell/wall/vertex indices between time steps will
+  /// not follow the renumbering.
+  ///
+  /// @see cellStableId()
+  ///
+  void renumber(DataMatrix &cellData,
+		DataMatrix &wallData,
+		DataMatrix &vertexData,
+		DataMatrix &cellDeriv,
+		DataMatrix &wallDeriv,
+		DataMatrix &vertexDeriv,
+		size_t verbose=0);
+  ///
   /// @brief Updates topology and variables for a cell removal
   ///
   void removeCell(size_t cellIndex,
@@ -731,7 +1059,14 @@ class Tissue {
 		  DataMatrix &wallDeriv,
 		  DataMatrix &vertexDeriv );			
   ///
-  /// @brief Calls removeCell(index,...) for all indices given in the vector
+  /// @brief Removes all cells given in the vector in a single pass
+  ///
+  /// @details Same update as removeCell(index,...) applied to all cells,
+  /// but the cells are first marked, walls only connecting removed cells
+  /// (or the background) and vertices left without cells and walls are
+  /// marked in turn, and then all entity vectors and data/derivative
+  /// matrices are compacted at once using a single remap table. The
+  /// remaining cells, walls and vertices keep their relative order.
   ///
   void removeCells(std::vector<size_t> &cellIndex,
 		   DataMatrix &cellData,
@@ -741,7 +1076,7 @@ class Tissue {
 		   DataMatrix &wallDeriv,
 		   DataMatrix &vertexDeriv );			
   ///
-  /// @brief Calls removeCell(index,...) for all cells that are at 
+  /// @brief Calls removeCells(...) for all cells that are at 
   /// boundary and outside a radial threshold
   ///
   void removeEpidermalCells(DataMatrix &cellData,
@@ -754,7 +1089,7 @@ class Tissue {
 			    const bool checkBackground = true);
   
   ///
-  /// @brief Calls removeCell(index,...) for all cells that are at 
+  /// @brief Calls removeCells(...) for all cells that are at 
   /// boundary and outside (all vertices) a radial threshold
   ///
   void removeEpidermalCellsMk2(DataMatrix &cellData,
@@ -766,7 +1101,7 @@ class Tissue {
 			       double radialThreshold = 0.0);
   
   ///
-  /// @brief Calls removeCell(index,...) for all cells that are at the boundary and away from the max
+  /// @brief Calls removeCells(...) for all cells that are at the boundary and away from the max
   ///
   void removeEpidermalCellsAtDistance(DataMatrix &cellData,
 				      DataMatrix &wallData,
@@ -790,6 +1125,35 @@ class Tissue {
 		   DataMatrix &vertexDeriv,
 		   std::vector<size_t> &volumeChangeList,
 		   double threshold=0.0);
+  ///
+  /// @brief Divides a cell into elements appended by
+  /// appendDivisionElements()
+  ///
+  /// @details The new cell is Nc, the new walls Nw, Nw+1 and Nw+2, and the
+  /// new vertices Nv and Nv+1, while the data rows are appended at the end
+  /// of the data matrices (which have to be of sizes Nc, Nw and Nv).
+  ///
+  void divideCell( Cell *divCell, size_t w1, size_t w2, 
+		   std::vector<double> &v1Pos,
+		   std::vector<double> &v2Pos,
+		   DataMatrix &cellData,
+		   DataMatrix &wallData,
+		   DataMatrix &vertexData,
+		   DataMatrix &cellDeriv,
+		   DataMatrix &wallDeriv,
+		   DataMatrix &vertexDeriv,
+		   std::vector<size_t> &volumeChangeList,
+		   double threshold,
+		   size_t Nc,size_t Nw,size_t Nv);
+  ///
+  /// @brief Appends (unconnected) cells, walls and vertices for
+  /// numDivision divisions
+  ///
+  /// @details Each division uses one cell, three walls and two vertices,
+  /// in order. The elements are connected by divideCell(), and the
+  /// simulation stops if the reserved element vectors would be reallocated.
+  ///
+  void appendDivisionElements(size_t numDivision);
 
 
 
@@ -834,11 +1198,58 @@ class Tissue {
   ///
   /// @brief Sorts cell.wall and cell.vertex vectors to be cyclic 
   ///
+  /// @details Cells are sorted one at a time in depth-first order over
+  /// cell neighbors (starting at the given cell, or at the first unsorted
+  /// cell of each connected patch if cell is NULL), such that the sorting
+  /// direction is propagated between neighbors via the wall cellSort flags.
+  ///
+  /// When all cells are sorted and more than one thread is set
+  /// (myParallel::numThread()) the cells are instead sorted in waves of
+  /// non-neighboring cells in parallel, see sortCellParallel().
+  ///
   void sortCellWallAndCellVertex(Cell* cell=NULL);
   ///
-  /// @brief Recursive algorithm to sort all cells in a tissue
+  /// @brief Sorts the given cells only (e.g. the cells touched by a
+  /// division)
+  ///
+  /// @details Cells with a single non-background neighbor are sorted last,
+  /// such that they can use the sorting direction of their (sorted)
+  /// neighbor.
+  ///
+  void sortCellWallAndCellVertex(const std::set<size_t> &cellIndex);
+  ///
+  /// @brief Depth-first sort of all cells connected to cell, using an
+  /// explicit worklist instead of recursion
+  ///
+  /// @details Cells are sorted in the same order as a recursive traversal
+  /// over Cell::cellNeighbor(), but without risking to run out of stack for
+  /// large tissues.
   ///
-  void sortCellRecursive( Cell* cell, std::vector<size_t> &sortedFlag, size_t &numSorted);
+  void sortCellIterative( Cell* cell, std::vector<size_t> &sortedFlag, size_t &numSorted);
+  ///
+  /// @brief Sorts all cells in parallel waves
+  ///
+  /// @details Cells are given a level from a breadth-first traversal from
+  /// the first cell of each connected patch, and cells within a level are
+  /// divided into sub-waves without neighbors in common. The waves are
+  /// sorted one after the other, and the cells within a wave in parallel,
+  /// such that each cell gets its sorting direction from already sorted
+  /// neighbors. The resulting cyclic orderings (and normal directions) are
+  /// the same as for the serial sort, and the lists are then rotated to
+  /// start as in the serial sort (sortCellSerialStart()).
+  ///
+  void sortCellParallel( std::vector<size_t> &sortedFlag, size_t &numSorted);
+  ///
+  /// @brief Rotates the sorted wall and vertex lists to start at the same
+  /// wall as the serial (depth-first) sort
+  ///
+  /// @details The lists before sorting are given by wallBefore (cell i at
+  /// wallStart[i]), and flagBefore marks the walls with a cellSort1 flag
+  /// before sorting.
+  ///
+  void sortCellSerialStart(const std::vector<size_t> &wallStart,
+			   const std::vector<Wall*> &wallBefore,
+			   const std::vector<char> &flagBefore);
   ///
   /// @brief Checks all connectivities as well as cell sort for inconsistencies
   ///
@@ -920,6 +1331,51 @@ inline size_t Tissue::numWall() const { return wall_.size(); }
 
 inline size_t Tissue::numVertex() const { return vertex_.size(); }
 
+inline size_t Tissue::topologyRevision() const { return topologyRevision_; }
+
+inline void Tissue::topologyChanged() { ++topologyRevision_; }
+
+inline const TissueTopology & Tissue::topology()
+{
+  if( topology_.revision() != topologyRevision_ ||
+      !topology_.isValid(numCell(),numWall(),numVertex()) )
+    topology_.build(*this,topologyRevision_);
+  return topology_;
+}
+
+inline const Geometry & Tissue::geometry()
+{
+  const TissueTopology &T = topology();
+  if( geometry_.revision() != T.revision() ||
+      geometry_.numFace() != numCell() || geometry_.numEdge() != numWall() ||
+      geometry_.numVertex() != numVertex() )
+    geometry_.build(T);
+  return geometry_;
+}
+
+inline void Tissue::setGeometryFlag(int value) { geometryFlag_ = value; }
+
+inline int Tissue::geometryFlag() const { return geometryFlag_; }
+
+inline void Tissue::setScheduleFlag(int value) { scheduleFlag_ = value; }
+
+inline int Tissue::scheduleFlag() const { return scheduleFlag_; }
+
+inline int Tissue::stochasticReaction(size_t r) const
+{
+  return r<stochasticReaction_.size() ? stochasticReaction_[r] : 0;
+}
+
+inline void Tissue::setHybrid(HybridStochastic *hybrid) { hybrid_ = hybrid; }
+
+inline int Tissue::stateBound(const DataMatrix &cellData,
+			      const DataMatrix &wallData,
+			      const DataMatrix &vertexData) const
+{
+  return stateCellData_==&cellData && stateWallData_==&wallData &&
+    stateVertexData_==&vertexData;
+}
+
 inline size_t Tissue::numReaction() const { return reaction_.size(); }
 
 inline size_t Tissue::numCompartmentChange() const 
@@ -940,6 +1396,21 @@ inline size_t Tissue::directionalWall(size_t i) const
   return directionalWall_[i];
 }
 
+inline size_t Tissue::cellStableId(size_t i) const
+{
+  return i<cellStableId_.size() ? cellStableId_[i] : i;
+}
+
+inline size_t Tissue::wallStableId(size_t i) const
+{
+  return i<wallStableId_.size() ? wallStableId_[i] : i;
+}
+
+inline size_t Tissue::vertexStableId(size_t i) const
+{
+  return i<vertexStableId_.size() ? vertexStableId_[i] : i;
+}
+
 inline const std::vector<Cell> & Tissue::cell() const { return cell_; }
 
 inline const Cell & Tissue::cell(size_t i) const { return cell_[i]; }
@@ -948,7 +1419,12 @@ inline Cell & Tissue::cell(size_t i) { return cell_[i]; }
 
 inline Cell* Tissue::cellP(size_t i) {return &cell_[i];}
 
-inline void Tissue::addCell( Cell val ) { cell_.push_back(val);}
+inline void Tissue::addCell( Cell val ) 
+{ 
+  cell_.push_back(val);
+  cellStableId_.push_back(nextCellStableId_++);
+  topologyChanged();
+}
 
 inline void Tissue::removeCell( size_t index ) {
   assert(index<numCell());
@@ -970,6 +1446,11 @@ inline void Tissue::removeCell( size_t index ) {
 	  cell_[index].vertex(k)->setCell(l,cpNew);
   }
   cell_.pop_back();
+  if( cellStableId_.size()>index ) {
+    cellStableId_[index] = cellStableId_.back();
+    cellStableId_.resize(numCell());
+  }
+  topologyChanged();
 }
 
 inline Cell* Tissue::background() { return &background_;}
@@ -984,7 +1465,12 @@ inline Wall & Tissue::wall(size_t i) { return wall_[i]; }
 
 inline Wall * Tissue::wallP(size_t i) { return &wall_[i]; }
 
-inline void Tissue::addWall( Wall val ) { wall_.push_back(val);}
+inline void Tissue::addWall( Wall val ) 
+{ 
+  wall_.push_back(val);
+  wallStableId_.push_back(nextWallStableId_++);
+  topologyChanged();
+}
 
 inline void Tissue::removeWall( size_t index ) {
   assert(index<numWall());
@@ -1009,6 +1495,11 @@ inline void Tissue::removeWall( size_t index ) {
 	wall_[index].vertex2()->setWall(l,wpNew);	
   }
   wall_.pop_back();
+  if( wallStableId_.size()>index ) {
+    wallStableId_[index] = wallStableId_.back();
+    wallStableId_.resize(numWall());
+  }
+  topologyChanged();
 }
 
 inline const std::vector<Vertex> & Tissue::vertex() const { return vertex_; }
@@ -1024,7 +1515,12 @@ inline size_t Tissue::numDimension()
   return vertex(0).numPosition();
 }
 
-inline void Tissue::addVertex( Vertex val ) { vertex_.push_back(val);}
+inline void Tissue::addVertex( Vertex val ) 
+{ 
+  vertex_.push_back(val);
+  vertexStableId_.push_back(nextVertexStableId_++);
+  topologyChanged();
+}
 
 inline void Tissue::removeVertex( size_t index ) {
   assert(index<numVertex());
@@ -1057,6 +1553,11 @@ inline void Tissue::removeVertex( size_t index ) {
 	vertex_[index].wall(k)->setVertex2(vpNew);
   }
   vertex_.pop_back();
+  if( vertexStableId_.size()>index ) {
+    vertexStableId_[index] = vertexStableId_.back();
+    vertexStableId_.resize(numVertex());
+  }
+  topologyChanged();
 }
 
 inline BaseReaction* Tissue::reaction(size_t i) const { 
@@ -1064,6 +1565,10 @@ inline BaseReaction* Tissue::reaction(size_t i) const {
   return reaction_[i];
 }
 
+inline const std::vector<BaseReaction*> & Tissue::reaction() const {
+  return reaction_;
+}
+
 inline BaseCompartmentChange* Tissue::compartmentChange(size_t i) const { 
   assert( i<compartmentChange_.size() );
   return compartmentChange_[i];
@@ -1081,14 +1586,26 @@ inline void Tissue::setId(std::string value) {
 
 inline void Tissue::setNumCell(size_t val) {
   cell_.resize(val);
+  while( cellStableId_.size()<val )
+    cellStableId_.push_back(nextCellStableId_++);
+  cellStableId_.resize(val);
+  topologyChanged();
 }
 
 inline void Tissue::setNumWall(size_t val) {
   wall_.resize(val);
+  while( wallStableId_.size()<val )
+    wallStableId_.push_back(nextWallStableId_++);
+  wallStableId_.resize(val);
+  topologyChanged();
 }
 
 inline void Tissue::setNumVertex(size_t val) {
   vertex_.resize(val);
+  while( vertexStableId_.size()<val )
+    vertexStableId_.push_back(nextVertexStableId_++);
+  vertexStableId_.resize(val);
+  topologyChanged();
 }
 
 inline void Tissue::setNumDirectionalWall(size_t val) 
@@ -0,0 +1,128 @@
+//
+// Filename     : tissueTopology.cc
+// Description  : Compressed sparse row (CSR) snapshot of the tissue connectivity
+// Author(s)    : Henrik Jonsson (henrik@thep.lu.se)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include "tissueTopology.h"
+#include "tissue.h"
+
+TissueTopology::TissueTopology()
+  : revision_(static_cast<size_t>(-1)), numCell_(0), numWall_(0), numVertex_(0)
+{
+}
+
+void TissueTopology::build(const Tissue &T, size_t revision)
+{
+  numCell_ = T.numCell();
+  numWall_ = T.numWall();
+  numVertex_ = T.numVertex();
+  //
+  // cell -> vertex and cell -> wall
+  //
+  cellVertexStart_.resize(numCell_+1);
+  cellWallStart_.resize(numCell_+1);
+  cellVertexStart_[0] = cellWallStart_[0] = 0;
+  for (size_t i=0; i<numCell_; ++i) {
+    cellVertexStart_[i+1] = cellVertexStart_[i] + T.cell(i).numVertex();
+    cellWallStart_[i+1] = cellWallStart_[i] + T.cell(i).numWall();
+  }
+  cellVertex_.resize(cellVertexStart_[numCell_]);
+  cellWall_.resize(cellWallStart_[numCell_]);
+  for (size_t i=0; i<numCell_; ++i) {
+    const Cell &c = T.cell(i);
+    size_t *cv = &cellVertex_[0] + cellVertexStart_[i];
+    for (size_t k=0; k<c.numVertex(); ++k)
+      cv[k] = c.vertex(k)->index();
+    size_t *cw = &cellWall_[0] + cellWallStart_[i];
+    for (size_t k=0; k<c.numWall(); ++k)
+      cw[k] = c.wall(k)->index();
+  }
+  //
+  // vertex -> cell
+  //
+  vertexCellStart_.resize(numVertex_+1);
+  vertexCellStart_[0] = 0;
+  for (size_t i=0; i<numVertex_; ++i)
+    vertexCellStart_[i+1] = vertexCellStart_[i] + T.vertex(i).numCell();
+  vertexCell_.resize(vertexCellStart_[numVertex_]);
+  for (size_t i=0; i<numVertex_; ++i) {
+    const Vertex::CellList &vc = T.vertex(i).cell();
+    for (size_t k=0; k<vc.size(); ++k)
+      vertexCell_[vertexCellStart_[i]+k] = vc[k]->index();
+  }
+  //
+  // wall -> vertex and wall -> cell (background index is size_t(-1) already)
+  //
+  wallVertex_.resize(2*numWall_);
+  wallCell_.resize(2*numWall_);
+  for (size_t i=0; i<numWall_; ++i) {
+    const Wall &w = T.wall(i);
+    wallVertex_[2*i] = w.vertex1()->index();
+    wallVertex_[2*i+1] = w.vertex2()->index();
+    wallCell_[2*i] = w.cell1()->index();
+    wallCell_[2*i+1] = w.cell2()->index();
+  }
+  //
+  // cell -> cell via internal walls (from the wall arrays above)
+  //
+  cellNeighborStart_.resize(numCell_+1);
+  cellNeighborStart_[0] = 0;
+  for (size_t i=0; i<numCell_; ++i) {
+    size_t numNeighbor=0;
+    for (size_t k=cellWallStart_[i]; k<cellWallStart_[i+1]; ++k) {
+      size_t w = cellWall_[k];
+      if (wallCell_[2*w]!=background && wallCell_[2*w+1]!=background)
+	++numNeighbor;
+    }
+    cellNeighborStart_[i+1] = cellNeighborStart_[i] + numNeighbor;
+  }
+  cellNeighbor_.resize(cellNeighborStart_[numCell_]);
+  cellNeighborWall_.resize(cellNeighborStart_[numCell_]);
+  for (size_t i=0; i<numCell_; ++i) {
+    size_t n = cellNeighborStart_[i];
+    for (size_t k=cellWallStart_[i]; k<cellWallStart_[i+1]; ++k) {
+      size_t w = cellWall_[k];
+      size_t c1 = wallCell_[2*w], c2 = wallCell_[2*w+1];
+      if (c1==background || c2==background)
+	continue;
+      cellNeighbor_[n] = c1==i ? c2 : c1;
+      cellNeighborWall_[n] = w;
+      ++n;
+    }
+  }
+  revision_ = revision;
+}
+
+void TissueTopology::addCellDiffusion(const DataMatrix &cellData,
+				      DataMatrix &cellDerivs,
+				      const std::vector<size_t> &species,
+				      const std::vector<double> &rate,
+				      const DataMatrix *wallData,
+				      size_t weightIndex) const
+{
+  assert( species.size()==rate.size() );
+  assert( cellData.size()==numCell_ && cellDerivs.size()==numCell_ );
+  size_t numSpecies = species.size();
+  if (!numSpecies)
+    return;
+  std::vector<double> yi(numSpecies),sum(numSpecies);
+  const size_t *sI = &species[0];
+  for (size_t i=0; i<numCell_; ++i) {
+    const double *y = &cellData[i][0];
+    for (size_t s=0; s<numSpecies; ++s) {
+      yi[s] = y[sI[s]];
+      sum[s] = 0.0;
+    }
+    for (size_t k=cellNeighborStart_[i]; k<cellNeighborStart_[i+1]; ++k) {
+      const double *yj = &cellData[cellNeighbor_[k]][0];
+      double weight = wallData ? (*wallData)[cellNeighborWall_[k]][weightIndex] : 1.0;
+      for (size_t s=0; s<numSpecies; ++s)
+	sum[s] += weight*(yj[sI[s]]-yi[s]);
+    }
+    double *dydt = &cellDerivs[i][0];
+    for (size_t s=0; s<numSpecies; ++s)
+      dydt[sI[s]] += rate[s]*sum[s];
+  }
+}
@@ -0,0 +1,333 @@
+//
+// Filename     : tissueTopology.h
+// Description  : Compressed sparse row (CSR) snapshot of the tissue connectivity
+// Author(s)    : Henrik Jonsson (henrik@thep.lu.se)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef TISSUETOPOLOGY_H
+#define TISSUETOPOLOGY_H
+
+#include <assert.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "myTypedefs.h"
+
+class Tissue;
+
+///
+/// @brief Index based (CSR) snapshot of the cell, wall and vertex connectivity
+///
+/// @details The Tissue stores its connectivity as pointers in Cell, Wall and
+/// Vertex. For loops over many elements (e.g. mechanical derivatives) these
+/// pointer hops are scattered in memory. The TissueTopology stores the same
+/// information as contiguous index arrays:
+/// @verbatim
+/// cell -> vertex (cyclic order as in Cell::vertex())
+/// cell -> wall   (cyclic order as in Cell::wall())
+/// vertex -> cell
+/// wall -> vertex (two per wall)
+/// wall -> cell   (two per wall, background given as TissueTopology::background)
+/// cell -> cell   (neighbor and wall for each internal wall, in Cell::wall() order)
+/// @endverbatim
+/// The cell -> cell incidence is the sparsity pattern of the cell graph
+/// Laplacian used by addCellDiffusion().
+/// The snapshot is created by Tissue::topology() and is only rebuilt when the
+/// topology revision of the tissue has changed (divisions, removals, sorting),
+/// and hence reactions can use it in their derivs() functions.
+///
+/// @see Tissue::topology()
+/// @see Tissue::topologyRevision()
+///
+class TissueTopology {
+
+ private:
+
+  size_t revision_;
+  size_t numCell_;
+  size_t numWall_;
+  size_t numVertex_;
+
+  std::vector<size_t> cellVertexStart_;
+  std::vector<size_t> cellVertex_;
+  std::vector<size_t> cellWallStart_;
+  std::vector<size_t> cellWall_;
+  std::vector<size_t> vertexCellStart_;
+  std::vector<size_t> vertexCell_;
+  std::vector<size_t> wallVertex_;
+  std::vector<size_t> wallCell_;
+  std::vector<size_t> cellNeighborStart_;
+  std::vector<size_t> cellNeighbor_;
+  std::vector<size_t> cellNeighborWall_;
+
+ public:
+
+  ///
+  /// @brief Index used for the background 'cell' in the wall -> cell array
+  ///
+  static const size_t background = static_cast<size_t>(-1);
+  ///
+  /// @brief Empty constructor, creates an invalid (never built) snapshot
+  ///
+  TissueTopology();
+  ///
+  /// @brief Rebuilds all index arrays from the pointer connectivity of T
+  ///
+  /// The revision is stored such that Tissue::topology() can detect when the
+  /// snapshot is outdated.
+  ///
+  void build(const Tissue &T, size_t revision);
+  ///
+  /// @brief Returns the tissue topology revision the snapshot was built from
+  ///
+  inline size_t revision() const;
+  ///
+  /// @brief Returns true if the snapshot has been built for the given sizes
+  ///
+  inline bool isValid(size_t numCellVal,size_t numWallVal,size_t numVertexVal) const;
+
+  inline size_t numCell() const;
+  inline size_t numWall() const;
+  inline size_t numVertex() const;
+  ///
+  /// @brief Number of vertices (and walls) of cell i
+  ///
+  inline size_t numCellVertex(size_t i) const;
+  inline size_t numCellWall(size_t i) const;
+  inline size_t numVertexCell(size_t i) const;
+  ///
+  /// @brief Vertex index of the k-th (cyclic) vertex of cell i
+  ///
+  inline size_t cellVertex(size_t i,size_t k) const;
+  ///
+  /// @brief Wall index of the k-th (cyclic) wall of cell i
+  ///
+  inline size_t cellWall(size_t i,size_t k) const;
+  ///
+  /// @brief Cell index of the k-th cell of vertex i
+  ///
+  inline size_t vertexCell(size_t i,size_t k) const;
+  ///
+  /// @brief Vertex index k (0/1) of wall i
+  ///
+  inline size_t wallVertex(size_t i,size_t k) const;
+  ///
+  /// @brief Cell index k (0/1) of wall i, TissueTopology::background if outside
+  ///
+  inline size_t wallCell(size_t i,size_t k) const;
+  ///
+  /// @brief Cell index on the other side of the k-th (cyclic) wall of cell i
+  ///
+  /// As Cell::cellNeighbor(), i.e. the index of the background 'cell' for
+  /// a boundary wall.
+  ///
+  inline size_t cellWallNeighbor(size_t i,size_t k) const;
+  ///
+  /// @brief Length of wall i calculated from the vertex positions in
+  /// vertexData, as Wall::lengthFromVertexPosition()
+  ///
+  inline double wallLength(size_t i,const DataMatrix &vertexData) const;
+  ///
+  /// @brief Number of neighboring cells (internal walls) of cell i
+  ///
+  inline size_t numCellNeighbor(size_t i) const;
+  ///
+  /// @brief Cell index of the k-th neighbor of cell i
+  ///
+  inline size_t cellNeighbor(size_t i,size_t k) const;
+  ///
+  /// @brief Wall index between cell i and its k-th neighbor
+  ///
+  inline size_t cellNeighborWall(size_t i,size_t k) const;
+  ///
+  /// @brief Adds cell-to-cell diffusion (graph Laplacian) terms for a set
+  /// of cell variables
+  ///
+  /// @details For each variable index species[s] the derivative is updated
+  /// as
+  ///
+  /// @f[ \frac{dy_{i}}{dt} += r_s \sum_{w} c_w (y_{j(w)} - y_{i}) @f]
+  ///
+  /// where the sum is over the internal walls w of cell i (neighbor j(w)),
+  /// and r_s is rate[s]. The wall weight c_w is wallData[w][weightIndex] if
+  /// wallData is given and 1 otherwise. All variables are updated in a
+  /// single sweep over the cell -> cell CSR arrays (SpMM), and each cell only
+  /// writes its own row.
+  ///
+  void addCellDiffusion(const DataMatrix &cellData,
+			DataMatrix &cellDerivs,
+			const std::vector<size_t> &species,
+			const std::vector<double> &rate,
+			const DataMatrix *wallData=0,
+			size_t weightIndex=0) const;
+  ///
+  /// @brief Raw CSR arrays to be used in streaming loops
+  ///
+  inline const std::vector<size_t> & cellVertexStart() const;
+  inline const std::vector<size_t> & cellVertex() const;
+  inline const std::vector<size_t> & cellWallStart() const;
+  inline const std::vector<size_t> & cellWall() const;
+  inline const std::vector<size_t> & vertexCellStart() const;
+  inline const std::vector<size_t> & vertexCell() const;
+  inline const std::vector<size_t> & wallVertex() const;
+  inline const std::vector<size_t> & wallCell() const;
+  inline const std::vector<size_t> & cellNeighborStart() const;
+  inline const std::vector<size_t> & cellNeighbor() const;
+  inline const std::vector<size_t> & cellNeighborWall() const;
+};
+
+inline size_t TissueTopology::revision() const
+{
+  return revision_;
+}
+
+inline bool TissueTopology::
+isValid(size_t numCellVal,size_t numWallVal,size_t numVertexVal) const
+{
+  return cellVertexStart_.size()==numCellVal+1 && numCell_==numCellVal &&
+    numWall_==numWallVal && numVertex_==numVertexVal;
+}
+
+inline size_t TissueTopology::numCell() const { return numCell_; }
+
+inline size_t TissueTopology::numWall() const { return numWall_; }
+
+inline size_t TissueTopology::numVertex() const { return numVertex_; }
+
+inline size_t TissueTopology::numCellVertex(size_t i) const
+{
+  return cellVertexStart_[i+1]-cellVertexStart_[i];
+}
+
+inline size_t TissueTopology::numCellWall(size_t i) const
+{
+  return cellWallStart_[i+1]-cellWallStart_[i];
+}
+
+inline size_t TissueTopology::numVertexCell(size_t i) const
+{
+  return vertexCellStart_[i+1]-vertexCellStart_[i];
+}
+
+inline size_t TissueTopology::cellVertex(size_t i,size_t k) const
+{
+  assert( k<numCellVertex(i) );
+  return cellVertex_[cellVertexStart_[i]+k];
+}
+
+inline size_t TissueTopology::cellWall(size_t i,size_t k) const
+{
+  assert( k<numCellWall(i) );
+  return cellWall_[cellWallStart_[i]+k];
+}
+
+inline size_t TissueTopology::vertexCell(size_t i,size_t k) const
+{
+  assert( k<numVertexCell(i) );
+  return vertexCell_[vertexCellStart_[i]+k];
+}
+
+inline size_t TissueTopology::wallVertex(size_t i,size_t k) const
+{
+  assert( k<2 );
+  return wallVertex_[2*i+k];
+}
+
+inline size_t TissueTopology::wallCell(size_t i,size_t k) const
+{
+  assert( k<2 );
+  return wallCell_[2*i+k];
+}
+
+inline size_t TissueTopology::cellWallNeighbor(size_t i,size_t k) const
+{
+  size_t w = cellWall(i,k);
+  return wallCell_[2*w]==i ? wallCell_[2*w+1] : wallCell_[2*w];
+}
+
+inline double TissueTopology::
+wallLength(size_t i,const DataMatrix &vertexData) const
+{
+  const std::vector<double> &x1 = vertexData[wallVertex_[2*i]];
+  const std::vector<double> &x2 = vertexData[wallVertex_[2*i+1]];
+  size_t dimension = x1.size();
+  double distance=0.0;
+  for( size_t d=0 ; d<dimension ; ++d )
+    distance += ( x1[d]-x2[d] ) * ( x1[d]-x2[d] );
+  return std::sqrt(distance);
+}
+
+inline size_t TissueTopology::numCellNeighbor(size_t i) const
+{
+  return cellNeighborStart_[i+1]-cellNeighborStart_[i];
+}
+
+inline size_t TissueTopology::cellNeighbor(size_t i,size_t k) const
+{
+  assert( k<numCellNeighbor(i) );
+  return cellNeighbor_[cellNeighborStart_[i]+k];
+}
+
+inline size_t TissueTopology::cellNeighborWall(size_t i,size_t k) const
+{
+  assert( k<numCellNeighbor(i) );
+  return cellNeighborWall_[cellNeighborStart_[i]+k];
+}
+
+inline const std::vector<size_t> & TissueTopology::cellVertexStart() const
+{
+  return cellVertexStart_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellVertex() const
+{
+  return cellVertex_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellWallStart() const
+{
+  return cellWallStart_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellWall() const
+{
+  return cellWall_;
+}
+
+inline const std::vector<size_t> & TissueTopology::vertexCellStart() const
+{
+  return vertexCellStart_;
+}
+
+inline const std::vector<size_t> & TissueTopology::vertexCell() const
+{
+  return vertexCell_;
+}
+
+inline const std::vector<size_t> & TissueTopology::wallVertex() const
+{
+  return wallVertex_;
+}
+
+inline const std::vector<size_t> & TissueTopology::wallCell() const
+{
+  return wallCell_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellNeighborStart() const
+{
+  return cellNeighborStart_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellNeighbor() const
+{
+  return cellNeighbor_;
+}
+
+inline const std::vector<size_t> & TissueTopology::cellNeighborWall() const
+{
+  return cellNeighborWall_;
+}
+
+#endif
@@ -7,186 +7,210 @@
 //
 #include <iostream>
 #include <fstream>
-#include<vector>
+#include <sstream>
+#include <vector>
 
-#include "cell.h"
-#include "tissue.h"
-#include "myConfig.h"
-#include "myFiles.h"
-//#include "mySignal.h"
-#include "myTimes.h"
-#include "vertex.h"
-#include "wall.h"
+#include "../frameStream.h"
+#include "../tissue.h"
+#include "../myConfig.h"
+#include "../myFiles.h"
+#include "../myParallel.h"
+#include "../myTimes.h"
 
 ///
-/// @brief Extracts a timePoint state and adds it into a Tissue
+/// @brief Reads a list of column indices separated by spaces or commas
 ///
-void putTimePointIntoTissue(size_t timePoint);
-///
-/// @brief Reads a tissue data file (with cells and walls)
-///
-void readData( std::string dataFile,
-							 std::vector< std::vector< std::vector<double> > > &cellData,
-							 std::vector< std::vector< std::vector<double> > > &wallData,
-							 std::vector< std::vector< std::vector<double> > > &vertexPos,
-							 std::vector< std::vector< std::vector<size_t> > > &cellVertex,
-							 std::vector< std::vector< std::vector<size_t> > > &wallVertex);
+void readColumns(std::string value, std::vector<size_t> &column);
 
 int main(int argc,char *argv[]) {
-	
+
   //Command line handling
-	myConfig::registerOption("init_output_format", 1);
-	//myConfig::registerOption("rk2", 0);
-	myConfig::registerOption("help", 0);
-	myConfig::registerOption("verbose", 1);
-	
-	int verboseFlag=1;
-	std::string verboseString;
-	verboseString = myConfig::getValue("verbose", 0);
-	if( !verboseString.empty() ) {
-		verboseFlag = atoi( verboseString.c_str() );
-		if( verboseFlag != 0 || verboseFlag !=1 ) {
-			verboseFlag=0;
-			std::cerr << "Flag given to -verbose not recognized (0, 1 allowed)."
-								<< " Setting it to zero (silent)." << std::endl;
-		}
-	}
-	
-	// Get current time (at start of program)
+  myConfig::registerOption("init_output_format", 1);
+  myConfig::registerOption("help", 0);
+  myConfig::registerOption("verbose", 1);
+  myConfig::registerOption("print_flag", 1);
+  myConfig::registerOption("frame", 1);
+  myConfig::registerOption("cell_variable", 1);
+  myConfig::registerOption("cell_statistics", 1);
+  myConfig::registerOption("cell_peaks", 1);
+  myConfig::registerOption("threads", 1);
+
+  // Get current time (at start of program)
   myTimes::getTime();
-	std::string configFile(getenv("HOME"));
-	configFile.append("/.tissue");
-	myConfig::initConfig(argc, argv, configFile);
-	
-	if (myConfig::getBooleanValue("help")) {
-		std::cerr << std::endl 
-							<< "Usage: " << argv[0] << " dataFile " << std::endl
-							<< std::endl;
-		std::cerr << "Possible additional flags are:" << std::endl;
-		std::cerr << "-init_output_format format - Sets format for output of"
-							<< " final state in specified init file format." << std::endl
-							<< "Available formats are tissue (default), and fem." << std::endl;
-		
-		std::cerr << "-verbose flag - Set flag for verbose (flag=1) or "
-							<< "silent (0) output mode to stderr." << std::endl; 
-		std::cerr << "-help - Shows this message." << std::endl;
+  std::string configFile(getenv("HOME"));
+  configFile.append("/.tissue");
+  myConfig::initConfig(argc, argv, configFile);
+
+  int verboseFlag=1;
+  std::string verboseString;
+  verboseString = myConfig::getValue("verbose", 0);
+  if( !verboseString.empty() ) {
+    verboseFlag = atoi( verboseString.c_str() );
+    if( verboseFlag != 0 && verboseFlag !=1 ) {
+      verboseFlag=0;
+      std::cerr << "Flag given to -verbose not recognized (0, 1 allowed)."
+		<< " Setting it to zero (silent)." << std::endl;
+    }
+  }
+
+  if (myConfig::getBooleanValue("help")) {
+    std::cerr << std::endl
+	      << "Usage: " << argv[0] << " dataFile " << std::endl
+	      << std::endl
+	      << "Reads simulator output (printFlag 0, 3, 4 or 11) one frame at a"
+	      << " time. Without filter flags a single frame is printed in init"
+	      << " format, otherwise the filters are applied to all frames."
+	      << std::endl << std::endl;
+    std::cerr << "Possible additional flags are:" << std::endl;
+    std::cerr << "-print_flag flag - printFlag used when the data file was"
+	      << " written (0 (default), 3, 4 or 11)." << std::endl;
+    std::cerr << "-frame num - Frame printed in init format (default last)."
+	      << std::endl;
+    std::cerr << "-init_output_format format - Sets format for output of"
+	      << " final state in specified init file format." << std::endl
+	      << "Available formats are tissue (default), and fem." << std::endl;
+    std::cerr << "-cell_variable \"c_0 c_1 ...\" - Prints the cell columns for"
+	      << " each cell and frame." << std::endl;
+    std::cerr << "-cell_statistics \"c_0 c_1 ...\" - Prints mean, std, min and"
+	      << " max of the cell columns for each frame." << std::endl;
+    std::cerr << "-cell_peaks c - Prints the cells with local maxima in cell"
+	      << " column c for each frame." << std::endl;
+    std::cerr << "-threads num - Number of frames processed in parallel"
+	      << " (default 1, 0 uses all hardware threads)." << std::endl;
+    std::cerr << "-verbose flag - Set flag for verbose (flag=1) or "
+	      << "silent (0) output mode to stderr." << std::endl;
+    std::cerr << "-help - Shows this message." << std::endl;
+    exit(EXIT_FAILURE);
+  } else if (myConfig::argc() != 2 ) {
+    std::cerr << "Type '" << argv[0] << " -help' for usage." << std::endl;
     exit(EXIT_FAILURE);
-	} else if (myConfig::argc() != 2 ) {
-		std::cerr << "Type '" << argv[0] << " -help' for usage." << std::endl;
-		exit(EXIT_FAILURE);
   }
-	
-  // Create the tissue and read init and model files
-  std::string dataFile = myConfig::argv(1);
-	std::vector< std::vector< std::vector<double> > > cellData,wallData,vertexPos;
-	std::vector< std::vector< std::vector<size_t> > > cellVertex,wallVertex;
-	readData(dataFile,cellData,wallData,vertexPos,cellVertex,wallVertex);
 
+  std::string threadString = myConfig::getValue("threads", 0);
+  if( !threadString.empty() ) {
+    int numThread = atoi( threadString.c_str() );
+    if( numThread<0 ) {
+      std::cerr << "Number of threads given to -threads must be"
+		<< " non-negative." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    myParallel::setNumThread( static_cast<size_t>(numThread) );
+  }
+  int printFlag=0;
+  std::string printFlagString = myConfig::getValue("print_flag", 0);
+  if( !printFlagString.empty() )
+    printFlag = atoi( printFlagString.c_str() );
 
-	size_t t=10;
-	Tissue T(cellData[t],wallData[t],vertexPos[t],cellVertex[t],wallVertex[t]);
-	
+  // Open the data file for streaming
+  std::string dataFile = myConfig::argv(1);
+  std::istream *IN = myFiles::openFile(dataFile);
+  if( !IN ) {
+    std::cerr << "main() Cannot open file " << dataFile << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  FrameReader reader(*IN,printFlag);
 
-	// Print time point in init format
-	std::string initFormat;
-	initFormat = myConfig::getValue("init_output_format",0);
-	if (initFormat.empty() || initFormat.compare("tissue")==0) {
-		std::cerr << "Printing init to standard out using tissue format." << std::endl;
-		T.printInit(std::cout);
-	}
-	else if (initFormat.compare("fem")==0) {
-		std::cerr << "Printing init to standard out using fem format." << std::endl;
-		std::cerr << "NOT YET!" << std::endl;
-		//T.printInitFem(std::cout);
-	}
-	else {
-		std::cerr << "Warning: main() - Format " << initFormat << " not recognized. "
-							<< "No init file written." << std::endl;
-	}
- 	std::cerr << "Data manipulation done." << std::endl;
-}
+  // Apply filters to all frames
+  std::vector<FrameFilter*> filter;
+  std::vector<size_t> column;
+  std::string value;
+  value = myConfig::getValue("cell_variable", 0);
+  if( !value.empty() ) {
+    readColumns(value,column);
+    filter.push_back( new CellVariableFilter(column) );
+  }
+  value = myConfig::getValue("cell_statistics", 0);
+  if( !value.empty() ) {
+    readColumns(value,column);
+    filter.push_back( new CellStatisticsFilter(column) );
+  }
+  value = myConfig::getValue("cell_peaks", 0);
+  if( !value.empty() )
+    filter.push_back( new CellPeakFilter( atoi(value.c_str()) ) );
 
+  if( filter.size() ) {
+    size_t numFrame = processFrames(reader,filter,std::cout);
+    if( verboseFlag )
+      std::cerr << numFrame << " frames processed." << std::endl;
+    for( size_t f=0 ; f<filter.size() ; ++f )
+      delete filter[f];
+    delete IN;
+    std::cerr << "Data manipulation done." << std::endl;
+    return 0;
+  }
 
-void readData( std::string dataFile,
-							 std::vector< std::vector< std::vector<double> > > &cellData,
-							 std::vector< std::vector< std::vector<double> > > &wallData,
-							 std::vector< std::vector< std::vector<double> > > &vertexPos,
-							 std::vector< std::vector< std::vector<size_t> > > &cellVertex,
-							 std::vector< std::vector< std::vector<size_t> > > &wallVertex)
-{
-  std::ifstream IN;
-  IN.open( dataFile.c_str() );
-  if( !IN ) {
-    std::cerr << "readData() Cannot open file " << dataFile << "\n";
-    exit(-1);
+  // Stream to the requested frame and create a tissue from it
+  if( printFlag!=0 && printFlag!=11 ) {
+    std::cerr << "main() Init output needs cell and wall data (printFlag 0 or"
+	      << " 11)." << std::endl;
+    exit(EXIT_FAILURE);
   }
-  
-  size_t numTimeStep,numVertex,d,dimension=-1;
-  std::vector<double> timePoint;
-  
-  IN >> numTimeStep;
-  timePoint.resize(numTimeStep);
-  cellData.resize(numTimeStep);
-  wallData.resize(numTimeStep);
-  cellVertex.resize(numTimeStep);
-  wallVertex.resize(numTimeStep);
-  vertexPos.resize(numTimeStep);
-  
-  for( size_t t=0 ; t<numTimeStep ; ++t ) {
-    //Read vertex positions
-    IN >> numVertex;
-    IN >> d;
-    if (t==0) {
-      dimension=d;
-    }
-    if (d!=dimension) {
-      std::cerr << "readData() Dimension at time point " << t << " wrong." 
-		<< std::endl;
-      exit(-1);
-    }
-    IN >> timePoint[t];
-    vertexPos[t].resize(numVertex);
-    for( size_t i=0 ; i<numVertex ; ++i ) {
-      vertexPos[t][i].resize( dimension );
-      for( size_t j=0 ; j<d ; ++j )
-	IN >> vertexPos[t][i][j];
-    }
-    size_t numCell,numVar;
-    //Read cell data
-    IN >> numCell;
-    IN >> numVar;
-    cellVertex[t].resize(numCell);
-    cellData[t].resize(numCell);
-    for( size_t i=0 ; i<numCell ; ++i ) {
-      size_t numCellVertex;
-      IN >> numCellVertex;
-      cellVertex[t][i].resize(numCellVertex);
-      for( size_t k=0 ; k<numCellVertex ; ++k )
-	IN >> cellVertex[t][i][k];
-      cellData[t][i].resize(numVar);
-      for( size_t k=0 ; k<numVar ; ++k )
-	IN >> cellData[t][i][k];
-    }
-    size_t numWall,numVarWall;
-    //Read wall data
-    IN >> numWall;
-    IN >> numVarWall;
-    wallVertex[t].resize(numWall);
-    wallData[t].resize(numWall);
-    for( size_t i=0 ; i<numWall ; ++i ) {
-      size_t numWallVertex=2;
-      //IN >> numWallVertex;
-      wallVertex[t][i].resize(numWallVertex);
-      for( size_t k=0 ; k<numWallVertex ; ++k )
-	IN >> wallVertex[t][i][k];
-      wallData[t][i].resize(numVarWall);
-      for( size_t k=0 ; k<numVarWall ; ++k )
-	IN >> wallData[t][i][k];
-    }		
+  std::string frameString = myConfig::getValue("frame", 0);
+  size_t timePoint = frameString.empty() ? size_t(-1) :
+    static_cast<size_t>( atoi(frameString.c_str()) );
+  Frame frame,next;
+  bool found=false;
+  while( reader.read(next) ) {
+    frame.index = next.index;
+    frame.vertexPosition.swap(next.vertexPosition);
+    frame.cellData.swap(next.cellData);
+    frame.cellVertex.swap(next.cellVertex);
+    frame.wallData.swap(next.wallData);
+    frame.wallVertex.swap(next.wallVertex);
+    found = true;
+    if( frame.index==timePoint )
+      break;
   }
-}
+  delete IN;
+  if( !found || (timePoint!=size_t(-1) && frame.index!=timePoint) ) {
+    std::cerr << "main() Frame " << frameString << " not found in "
+	      << dataFile << " (" << reader.frameCount() << " frames)."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if( verboseFlag )
+    std::cerr << "Using frame " << frame.index << std::endl;
+  // Remove the derived columns (cell volume and number of walls; wall
+  // index, length and strains) written by BaseSolver::print()
+  for( size_t i=0 ; i<frame.cellData.size() ; ++i )
+    frame.cellData[i].resize(frame.cellData[i].size()-2);
+  for( size_t i=0 ; i<frame.wallData.size() ; ++i )
+    frame.wallData[i].resize(frame.wallData[i].size()-4);
+  Tissue T(frame.cellData,frame.wallData,frame.vertexPosition,frame.cellVertex,
+	   frame.wallVertex);
 
-void putTimePointIntoTissue(size_t timePoint) {
+  // Print time point in init format
+  std::string initFormat;
+  initFormat = myConfig::getValue("init_output_format",0);
+  if (initFormat.empty() || initFormat.compare("tissue")==0) {
+    std::cerr << "Printing init to standard out using tissue format." << std::endl;
+    T.printInit(std::cout);
+  }
+  else if (initFormat.compare("fem")==0) {
+    std::cerr << "Printing init to standard out using fem format." << std::endl;
+    std::cerr << "NOT YET!" << std::endl;
+    //T.printInitFem(std::cout);
+  }
+  else {
+    std::cerr << "Warning: main() - Format " << initFormat << " not recognized. "
+	      << "No init file written." << std::endl;
+  }
+  std::cerr << "Data manipulation done." << std::endl;
+}
 
+void readColumns(std::string value, std::vector<size_t> &column)
+{
+  for( size_t k=0 ; k<value.size() ; ++k )
+    if( value[k]==',' )
+      value[k]=' ';
+  std::istringstream IN(value);
+  column.clear();
+  size_t col;
+  while( IN >> col )
+    column.push_back(col);
+  if( !column.size() ) {
+    std::cerr << "readColumns() No column indices given in '" << value << "'."
+	      << std::endl;
+    exit(EXIT_FAILURE);
+  }
 }
-		
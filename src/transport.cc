@@ -180,16 +180,18 @@ DiffusionSimple(std::vector<double> &paraValue,
 
   //Do some checks on the parameters and variable indeces
   //
-  if( paraValue.size() !=1 ) {
+  if( paraValue.size()<1 ) {
     std::cerr << "DiffusionModelSimple::"
 	      << "DiffusionModelSimple() "
-	      << "One parameter (diffusion constant) used: p_0" << std::endl;
+	      << "One parameter (diffusion constant) per variable used: p_0 ..."
+	      << std::endl;
     exit(EXIT_FAILURE);
   }
-  if( indValue.size() != 1 || indValue[0].size() != 1) {
+  if( indValue.size() != 1 || indValue[0].size() != paraValue.size() ) {
     std::cerr << "DiffusionSimple::"
 	      << "DiffusionSimple() "
-	      << "One level of one variable indices used" << std::endl;
+	      << "One level of variable indices used, with one index per"
+	      << " diffusion constant" << std::endl;
     exit(EXIT_FAILURE);
   }
   //Set the variable values
@@ -203,6 +205,8 @@ DiffusionSimple(std::vector<double> &paraValue,
   std::vector<std::string> tmp( numParameter() );
   tmp.resize( numParameter() );
   tmp[0] = "p_0";
+  for( size_t k=1 ; k<numParameter() ; ++k )
+    tmp[k] = "p_" + std::to_string(k);
 
   setParameterId( tmp );
 }
@@ -216,28 +220,37 @@ derivs(Tissue &T,
        DataMatrix &wallDerivs,
        DataMatrix &vertexDerivs ) 
 {  
-  size_t numCells = T.numCell();
-  size_t aI = variableIndex(0,0);
-  assert( aI<cellData[0].size());
-  
-  for( size_t i=0 ; i<numCells ; ++i ) {
-    
-    size_t numWalls=T.cell(i).numWall();
-    
-    for( size_t n=0 ; n<numWalls ; ++n ) {
-      if( T.cell(i).wall(n)->cell1() != T.background() &&
-	  T.cell(i).wall(n)->cell2() != T.background() ) { 
-	size_t neighIndex;
-	if( T.cell(i).wall(n)->cell1()->index()==i )
-	  neighIndex = T.cell(i).wall(n)->cell2()->index();				
-	else {
-	  neighIndex = T.cell(i).wall(n)->cell1()->index();				
-	}
-	cellDerivs[i][aI] -= parameter(0)*(cellData[i][aI] - cellData[neighIndex][aI]);
-	cellDerivs[neighIndex][aI] += parameter(0)*(cellData[i][aI] - cellData[neighIndex][aI]);
-      }
-    }
+  // Each internal wall is visited from both its cells in the pointer based
+  // version, hence the factor two in the rate
+  size_t numSpecies = numVariableIndex(0);
+  std::vector<size_t> species(numSpecies);
+  std::vector<double> rate(numSpecies);
+  for( size_t s=0 ; s<numSpecies ; ++s ) {
+    species[s] = variableIndex(0,s);
+    assert( species[s]<cellData[0].size());
+    rate[s] = 2.0*parameter(s);
   }
+  T.topology().addCellDiffusion(cellData,cellDerivs,species,rate);
+}
+
+int DiffusionSimple::
+linearCellTransport(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    std::vector<size_t> &species,
+		    DataMatrix &coefficient)
+{
+  // Same coefficient (2*p_s, see derivs()) for all neighbors
+  size_t numSpecies = numVariableIndex(0);
+  size_t numEntry = T.topology().cellNeighbor().size();
+  species.resize(numSpecies);
+  coefficient.resize(numSpecies);
+  for( size_t s=0 ; s<numSpecies ; ++s ) {
+    species[s] = variableIndex(0,s);
+    coefficient[s].assign(numEntry,2.0*parameter(s));
+  }
+  return 1;
 }
 
 DiffusionConductiveSimple::
@@ -294,46 +307,33 @@ derivs(Tissue &T,
        DataMatrix &wallDerivs,
        DataMatrix &vertexDerivs ) 
 {  
-  // Cell variable updates
-  //
-  size_t numCells = T.numCell();
+  const TissueTopology &topology = T.topology();
+  size_t numWalls = topology.numWall();
   size_t cI = variableIndex(0,0);
   size_t CI = variableIndex(1,0);
   assert( cI<cellData[0].size() && CI<wallData[0].size());
   
-  for( size_t i=0 ; i<numCells ; ++i ) {
-    
-    size_t numWalls=T.cell(i).numWall();
-    
-    for( size_t n=0 ; n<numWalls ; ++n ) {
-      if( T.cell(i).wall(n)->cell1() != T.background() &&
-	  T.cell(i).wall(n)->cell2() != T.background() ) { 
-	size_t wallI = T.cell(i).wall(n)->index();
-	size_t neighIndex;
-	if( T.cell(i).wall(n)->cell1()->index()==i )
-	  neighIndex = T.cell(i).wall(n)->cell2()->index();				
-	else {
-	  neighIndex = T.cell(i).wall(n)->cell1()->index();				
-	}
-	if( i<neighIndex) {
-	  double conductance = wallData[wallI][CI];
-	  double flux = parameter(0)*conductance*
-	    (cellData[i][cI] - cellData[neighIndex][cI]);
-	  cellDerivs[i][cI] -= flux;
-	  cellDerivs[neighIndex][cI] += flux;
-	  // Update wall variables (conductance)
-	  if (conductance>0.0) {
-	    flux = std::fabs(flux);
-	    wallDerivs[wallI][CI] += parameter(1) *
-	      (
-	       (std::pow(flux,parameter(2))/std::pow(conductance,parameter(3)+1))
-	       - parameter(4) ) * conductance;
-	    //std::cerr << wallI << " " << CI << " "
-	    //	      << wallData[wallI][CI] << " "
-	    //	      << wallDerivs[wallI][CI] << std::endl;
-	  }
-	}
-      }
+  // Cell variable updates (conductance weighted Laplacian)
+  //
+  std::vector<size_t> species(1,cI);
+  std::vector<double> rate(1,parameter(0));
+  topology.addCellDiffusion(cellData,cellDerivs,species,rate,&wallData,CI);
+  
+  // Wall variable updates (conductance)
+  //
+  const size_t *wallCell = numWalls ? &topology.wallCell()[0] : 0;
+  for( size_t wallI=0 ; wallI<numWalls ; ++wallI ) {
+    size_t i = wallCell[2*wallI], neighIndex = wallCell[2*wallI+1];
+    if( i==TissueTopology::background || neighIndex==TissueTopology::background )
+      continue;
+    double conductance = wallData[wallI][CI];
+    if (conductance>0.0) {
+      double flux = std::fabs(parameter(0)*conductance*
+			      (cellData[i][cI] - cellData[neighIndex][cI]));
+      wallDerivs[wallI][CI] += parameter(1) *
+	(
+	 (std::pow(flux,parameter(2))/std::pow(conductance,parameter(3)+1))
+	 - parameter(4) ) * conductance;
     }
   }
 }
@@ -432,6 +432,49 @@ derivs(Tissue &T,
 }
 
 
+int Diffusion2d::
+linearCellTransport(Tissue &T,
+		    DataMatrix &cellData,
+		    DataMatrix &wallData,
+		    DataMatrix &vertexData,
+		    std::vector<size_t> &species,
+		    DataMatrix &coefficient)
+{
+  // Each wall contributes from both its cells in derivs(), giving
+  // a_ik = 2 p_0 L_w / (V_i d_ij) for cell i and its k-th neighbor j
+  const TissueTopology &topology = T.topology();
+  size_t numCells = T.numCell();
+  size_t dimension = vertexData[0].size();
+  species.assign(1,variableIndex(0,0));
+  coefficient.resize(1);
+  coefficient[0].resize(topology.cellNeighbor().size());
+
+  DataMatrix cellPos(numCells);
+  std::vector<double> cellVolume(numCells);
+  for( size_t i=0 ; i<numCells ; ++i ) {
+    cellPos[i] = T.cell(i).positionFromVertex();
+    cellVolume[i] = T.cell(i).calculateVolume(vertexData);
+  }
+  const std::vector<size_t> &start = topology.cellNeighborStart();
+  for( size_t i=0 ; i<numCells ; ++i )
+    for( size_t k=start[i] ; k<start[i+1] ; ++k ) {
+      size_t j = topology.cellNeighbor()[k];
+      size_t w = topology.cellNeighborWall()[k];
+      size_t v1 = topology.wallVertex(w,0);
+      size_t v2 = topology.wallVertex(w,1);
+      double distance=0.0, contactLength=0.0;
+      for( size_t d=0 ; d<dimension ; ++d ) {
+	distance += (cellPos[j][d]-cellPos[i][d])*(cellPos[j][d]-cellPos[i][d]);
+	contactLength += (vertexData[v1][d]-vertexData[v2][d])*
+	  (vertexData[v1][d]-vertexData[v2][d]);
+      }
+      coefficient[0][k] = 2.0*parameter(0)*std::sqrt(contactLength)/
+	(cellVolume[i]*std::sqrt(distance));
+    }
+  return 1;
+}
+
+
 
  ActiveTransportCellEfflux::
  ActiveTransportCellEfflux(std::vector<double> &paraValue, 
@@ -36,7 +36,7 @@
 ///
 /// @note The Simple in the name reflects the fact that no geometric factors are included.
 ///
-class MembraneDiffusionSimple : public BaseReaction {
+class MembraneDiffusionSimple : public BaseChemicalReaction {
   
  public:
   
@@ -77,7 +77,7 @@ class MembraneDiffusionSimple : public BaseReaction {
 ///
 /// @note The Simple in the name reflects the fact that no geometric factors are included.
 ///
-class MembraneDiffusionSimple2 : public BaseReaction {
+class MembraneDiffusionSimple2 : public BaseChemicalReaction {
   
  public:
   
@@ -103,9 +103,11 @@ class MembraneDiffusionSimple2 : public BaseReaction {
 /// Note that cell volume and other topological properties are not taken into account.
 /// The diffusion is described by the equation
 ///  
-/// @f[ \frac{dc_{i}}{dt} = - p_0 \sum_j ( c_{i} - c_{j}) @f] 
+/// @f[ \frac{dc_{i}}{dt} = - 2 p_0 \sum_j ( c_{i} - c_{j}) @f] 
 ///  
-/// where p_0 is the diffusion rate, $c_i$ is the cell concentration and $c_j$ is the concentration in a neighboring cell.
+/// where p_0 is the diffusion rate, $c_i$ is the cell concentration and $c_j$ is the concentration in a neighboring cell
+/// (the sum is over internal walls, and the factor 2 is kept from the original implementation visiting each
+/// wall from both cells).
 ///  
 /// In a model file the reaction is defined as
 ///
@@ -115,10 +117,19 @@ class MembraneDiffusionSimple2 : public BaseReaction {
 /// c_index
 /// @endverbatim
 ///
+/// Several variables can be given (one rate per variable), in which case they are all updated in a single sweep
+/// over the tissue (TissueTopology::addCellDiffusion()):
+///
+/// @verbatim
+/// DiffusionSimple N 1 N
+/// p_0 ... p_N-1
+/// c_index_0 ... c_index_N-1
+/// @endverbatim
+///
 ///
 /// @note The Simple in the name reflects the fact that no geometric factors are included.
 ///
-class DiffusionSimple : public BaseReaction {
+class DiffusionSimple : public BaseChemicalReaction {
   
  public:
   
@@ -133,6 +144,17 @@ class DiffusionSimple : public BaseReaction {
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Provides the (constant) diffusion coefficients for implicit integration
+  ///
+  /// @see BaseReaction::linearCellTransport()
+  ///
+  int linearCellTransport(Tissue &T,
+			  DataMatrix &cellData,
+			  DataMatrix &wallData,
+			  DataMatrix &vertexData,
+			  std::vector<size_t> &species,
+			  DataMatrix &coefficient);
 };
 
 ///
@@ -168,7 +190,7 @@ class DiffusionSimple : public BaseReaction {
 ///
 /// @note The Simple in the name reflects the fact that no geometric factors are included.
 ///
-class DiffusionConductiveSimple : public BaseReaction {
+class DiffusionConductiveSimple : public BaseChemicalReaction {
   
  public:
   
@@ -213,7 +235,7 @@ class DiffusionConductiveSimple : public BaseReaction {
 ///
 /// @note The Simple in the name reflects the fact that no geometric factors are included.
 ///
-class Diffusion2d : public BaseReaction {
+class Diffusion2d : public BaseChemicalReaction {
   
 public:
   
@@ -228,6 +250,17 @@ public:
 	      DataMatrix &cellDerivs,
 	      DataMatrix &wallDerivs,
 	      DataMatrix &vertexDerivs );
+  ///
+  /// @brief Provides the geometry dependent diffusion coefficients for implicit integration
+  ///
+  /// @see BaseReaction::linearCellTransport()
+  ///
+  int linearCellTransport(Tissue &T,
+			  DataMatrix &cellData,
+			  DataMatrix &wallData,
+			  DataMatrix &vertexData,
+			  std::vector<size_t> &species,
+			  DataMatrix &coefficient);
 };
 
 
@@ -260,7 +293,7 @@ public:
 ///
 ///
 ///
-class ActiveTransportCellEfflux  : public BaseReaction {
+class ActiveTransportCellEfflux  : public BaseChemicalReaction {
   
  public:
   
@@ -313,7 +346,7 @@ class ActiveTransportCellEfflux  : public BaseReaction {
 ///
  
 
-class ActiveTransportCellEffluxMM  : public BaseReaction {
+class ActiveTransportCellEffluxMM  : public BaseChemicalReaction {
   
  public:
   
@@ -363,7 +396,7 @@ class ActiveTransportCellEffluxMM  : public BaseReaction {
 ///
  
 
-class ActiveTransportWall  : public BaseReaction {
+class ActiveTransportWall  : public BaseChemicalReaction {
   
  public:
   
@@ -0,0 +1,1080 @@
+//
+// Filename     : trbsKernel.h
+// Description  : Triangular biquadratic spring element kernel with compile time material and output policies
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#ifndef TRBSKERNEL_H
+#define TRBSKERNEL_H
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include "tissue.h"
+
+///
+/// @brief Element calculations for the isotropic triangular biquadratic
+/// springs (TRBS) shared by the TRBS reactions
+///
+/// @details The element stiffness only depends on the resting lengths and
+/// the Lame coefficients, and the update of the element vertices is given by
+/// edge coefficients linear in the biquadratic strains
+/// @f$ \Delta_k = l_k^2-L_k^2 @f$ (H. Delingette, IEEE Trans Vis Comput
+/// Graph 14, 329-41 (2008)). The center triangulation kernel is templated on
+/// a Material policy (giving the Young modulus and Poisson ratio of a cell)
+/// and an Output policy (accumulating and storing strain/stress), such that
+/// the reactions select an instantiation from their parameters and the
+/// element loop has no runtime branches for them. The anisotropic (MT)
+/// reactions are in the same way instantiated on a Fiber policy (the
+/// longitudinal and transverse Young moduli), a Direction policy (the MT
+/// direction) and a RestingLength policy, and get their anisotropic
+/// correction of the element update from stressForce() or invariantForce().
+///
+/// @see VertexFromTRBS
+/// @see VertexFromTRBScenterTriangulation
+/// @see VertexFromTRBScenterTriangulationConcentrationHill
+/// @see VertexFromTRBScenterTriangulationMT
+/// @see VertexFromTRBScenterTriangulationMTOpt
+/// @see VertexFromTRLScenterTriangulationMT
+/// @see VertexFromTRBScenterTriangulationConcentrationHillMT
+///
+namespace TRBS {
+
+  ///
+  /// @brief Stiffness of a triangle element with resting lengths
+  /// L0 (vertex 0-1), L1 (vertex 1-2) and L2 (vertex 2-0)
+  ///
+  struct Element {
+    double restingLength[3];
+    double restingArea;
+    double cosAngle[3];
+    double cotan[3];
+    double tensileStiffness[3];
+    double angularStiffness[3];
+  };
+
+  ///
+  /// @brief Sets the resting area and the cosines of the angles (at vertex
+  /// 0, 1 and 2) of E from its resting lengths
+  ///
+  inline void restingShape(Element &E)
+  {
+    const double *restingLength = E.restingLength;
+    // Area of the element (using Heron's formula)
+    E.restingArea=std::sqrt( ( restingLength[0]+restingLength[1]+restingLength[2])*
+			     (-restingLength[0]+restingLength[1]+restingLength[2])*
+			     ( restingLength[0]-restingLength[1]+restingLength[2])*
+			     ( restingLength[0]+restingLength[1]-restingLength[2])  )*0.25;
+
+    //Angles of the element ( assuming the order: 0,L0,1,L1,2,L2 )
+    E.cosAngle[0]=(restingLength[0]*restingLength[0]+restingLength[2]*restingLength[2]-restingLength[1]*restingLength[1])/
+      (restingLength[0]*restingLength[2]*2);
+    E.cosAngle[1]=(restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
+      (restingLength[0]*restingLength[1]*2);
+    E.cosAngle[2]=(restingLength[1]*restingLength[1]+restingLength[2]*restingLength[2]-restingLength[0]*restingLength[0])/
+      (restingLength[1]*restingLength[2]*2);
+  }
+
+  ///
+  /// @brief Sets the cotangents of the angles of E directly from their
+  /// cosines, @f$ \cot A = \cos A/\sqrt{1-\cos^2 A} @f$
+  ///
+  /// This is how the anisotropic (MT) reactions compute them, which rounds
+  /// differently from the acos/tan in stiffness().
+  ///
+  inline void cosineCotan(Element &E)
+  {
+    for (size_t k=0; k<3; ++k)
+      E.cotan[k] = E.cosAngle[k]/std::sqrt(1-E.cosAngle[k]*E.cosAngle[k]);
+  }
+
+  ///
+  /// @brief Sets the tensile and angular stiffness of E from its resting
+  /// area and cotangents
+  ///
+  /// mio is twice the shear modulus, i.e. Y/(1+nu) for the isotropic
+  /// reactions.
+  ///
+  inline void edgeStiffness(double lambda,double mio,Element &E)
+  {
+    double const temp = 1.0/(E.restingArea*16);
+    const double *cotan = E.cotan;
+    E.tensileStiffness[0]=(2*cotan[2]*cotan[2]*(lambda+mio)+mio)*temp;
+    E.tensileStiffness[1]=(2*cotan[0]*cotan[0]*(lambda+mio)+mio)*temp;
+    E.tensileStiffness[2]=(2*cotan[1]*cotan[1]*(lambda+mio)+mio)*temp;
+    E.angularStiffness[0]=(2*cotan[1]*cotan[2]*(lambda+mio)-mio)*temp;
+    E.angularStiffness[1]=(2*cotan[0]*cotan[2]*(lambda+mio)-mio)*temp;
+    E.angularStiffness[2]=(2*cotan[0]*cotan[1]*(lambda+mio)-mio)*temp;
+  }
+
+  ///
+  /// @brief Sets the resting area and stiffness of E from its resting lengths
+  ///
+  inline void stiffness(double lambda,double mio,Element &E)
+  {
+    restingShape(E);
+    for (size_t k=0; k<3; ++k)
+      E.cotan[k] = 1.0/std::tan(std::acos(E.cosAngle[k]));
+    edgeStiffness(lambda,mio,E);
+  }
+
+  ///
+  /// @brief Sets the resting area and stiffness of E as stiffness(), with
+  /// the cotangents from cosineCotan()
+  ///
+  inline void cosineStiffness(double lambda,double mio,Element &E)
+  {
+    restingShape(E);
+    cosineCotan(E);
+    edgeStiffness(lambda,mio,E);
+  }
+
+  ///
+  /// @brief Lame coefficients of the anisotropic (MT) reactions
+  ///
+  /// lambda is given for plane strain or plane stress and mio is the shear
+  /// modulus Y/(2(1+nu)) (use 2*mio in edgeStiffness()).
+  ///
+  inline void shearLame(double young,double poisson,bool planeStrain,
+			double &lambda,double &mio)
+  {
+    if (planeStrain)
+      lambda=young*poisson/((1+poisson)*(1-2*poisson));
+    else
+      lambda=young*poisson/(1-poisson*poisson);
+    mio=young/(2*(1+poisson));
+  }
+
+  ///
+  /// @brief Adds the update of the three element vertices to force
+  ///
+  /// The update of vertex a is @f$ \sum_b c_{ab}(x_b-x_a) @f$, with Delta
+  /// the biquadratic strains of the element.
+  ///
+  inline void force(const Element &E,const double Delta[3],
+		    const double *position0,const double *position1,
+		    const double *position2,size_t dimension,
+		    double *force0,double *force1,double *force2)
+  {
+    const double *tensileStiffness = E.tensileStiffness;
+    const double *angularStiffness = E.angularStiffness;
+    //Coefficients of the forces along the element edges
+    double c01 = tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2];
+    double c02 = tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0];
+    double c10 = tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1];
+    double c12 = tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0];
+    double c20 = tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1];
+    double c21 = tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2];
+    for( size_t d=0 ; d<dimension ; ++d ) {
+      force0[d] += c01*(position1[d]-position0[d])+c02*(position2[d]-position0[d]);
+      force1[d] += c10*(position0[d]-position1[d])+c12*(position2[d]-position1[d]);
+      force2[d] += c20*(position0[d]-position2[d])+c21*(position1[d]-position2[d]);
+    }
+  }
+
+  ///
+  /// @brief Sets the update of the three element vertices (rows of Force)
+  /// as in force(), with a correction (e.g. an anisotropic term) added
+  ///
+  inline void force(const Element &E,const double Delta[3],
+		    const DataMatrix &position,const double correction[3][3],
+		    double Force[3][3])
+  {
+    const double *tensileStiffness = E.tensileStiffness;
+    const double *angularStiffness = E.angularStiffness;
+    double c01 = tensileStiffness[0]*Delta[0]+angularStiffness[1]*Delta[1]+angularStiffness[0]*Delta[2];
+    double c02 = tensileStiffness[2]*Delta[2]+angularStiffness[2]*Delta[1]+angularStiffness[0]*Delta[0];
+    double c10 = tensileStiffness[0]*Delta[0]+angularStiffness[0]*Delta[2]+angularStiffness[1]*Delta[1];
+    double c12 = tensileStiffness[1]*Delta[1]+angularStiffness[2]*Delta[2]+angularStiffness[1]*Delta[0];
+    double c20 = tensileStiffness[2]*Delta[2]+angularStiffness[0]*Delta[0]+angularStiffness[2]*Delta[1];
+    double c21 = tensileStiffness[1]*Delta[1]+angularStiffness[1]*Delta[0]+angularStiffness[2]*Delta[2];
+    for( size_t d=0 ; d<3 ; ++d ) {
+      Force[0][d] = c01*(position[1][d]-position[0][d])+c02*(position[2][d]-position[0][d])
+	+ correction[0][d];
+      Force[1][d] = c10*(position[0][d]-position[1][d])+c12*(position[2][d]-position[1][d])
+	+ correction[1][d];
+      Force[2][d] = c20*(position[0][d]-position[2][d])+c21*(position[1][d]-position[2][d])
+	+ correction[2][d];
+    }
+  }
+
+  ///
+  /// @brief Sets the anisotropic correction of the three element vertex
+  /// updates (rows of deltaF) from a correction deltaS of the second
+  /// Piola-Kirchhoff stress
+  ///
+  /// DeformGrad, deltaS and ShapeVectorResting are given in the element
+  /// plane, and the columns of rotation are the element axes in the global
+  /// frame.
+  ///
+  inline void stressForce(double restingArea,const double DeformGrad[2][2],
+			  const double deltaS[2][2],
+			  const double ShapeVectorResting[3][3],
+			  const double rotation[3][3],double deltaF[3][3])
+  {
+    double TPK[2][2];// 2nd Piola Kirchhoff stress tensor
+    TPK[0][0]=restingArea*(DeformGrad[0][0]*deltaS[0][0]+DeformGrad[0][1]*deltaS[1][0]);
+    TPK[1][0]=restingArea*(DeformGrad[1][0]*deltaS[0][0]+DeformGrad[1][1]*deltaS[1][0]);
+    TPK[0][1]=restingArea*(DeformGrad[0][0]*deltaS[0][1]+DeformGrad[0][1]*deltaS[1][1]);
+    TPK[1][1]=restingArea*(DeformGrad[1][0]*deltaS[0][1]+DeformGrad[1][1]*deltaS[1][1]);
+
+    double deltaFTPKlocal[3][2];
+    for (size_t i=0; i<3; ++i) {
+      deltaFTPKlocal[i][0]= TPK[0][0]*ShapeVectorResting[i][0]+TPK[0][1]*ShapeVectorResting[i][1];
+      deltaFTPKlocal[i][1]= TPK[1][0]*ShapeVectorResting[i][0]+TPK[1][1]*ShapeVectorResting[i][1];
+    }
+    for (size_t i=0; i<3; ++i)
+      for (size_t j=0; j<3; ++j)
+	deltaF[i][j]=-(rotation[j][0]*deltaFTPKlocal[i][0]+rotation[j][1]*deltaFTPKlocal[i][1]);
+  }
+
+  ///
+  /// @brief Sets the anisotropic correction of the three element vertex
+  /// updates (rows of deltaF) from the derivatives of the strain invariants
+  /// I1, I4 and I5
+  ///
+  /// teta holds the angles between the (resting) MT direction and the
+  /// shape vectors of the element, and Area is the current area.
+  ///
+  inline void invariantForce(const Element &E,const double currentLength[3],
+			     double Area,const double teta[3],
+			     const DataMatrix &position,const double Delta[3],
+			     double deltaLam,double deltaMio,double deltaF[3][3])
+  {
+    double restingArea = E.restingArea;
+    const double *cotan = E.cotan;
+    // square of radius of circumscribed circle in current shape
+    double Rcirc2=(0.25*currentLength[0]*currentLength[1]*currentLength[2]/Area)*
+      (0.25*currentLength[0]*currentLength[1]*currentLength[2]/Area);
+
+    double derIprim1[3][3];         // Invariants and their derivatives
+    double derIprim4[3][3];
+    double derIprim5[3][3];
+
+    double DiDm=0;                  // inner products between shape vectors
+    double DnDr=0;
+    double DsDp=0;
+
+    double QiQj=0;                  // inner products between position vectors of vertices
+    double QrQs;
+
+    double aDi;                     // inner products between shape vectors and anisotropy vector(direction)
+    double aDj;
+    double aDm;
+    double aDp;
+    double aDr;
+    double aDs;
+    double aDn;
+
+    // Lengths in the order of the shape vectors
+    double restingLength[3]={E.restingLength[1],E.restingLength[2],E.restingLength[0]};
+    double length[3]={currentLength[1],currentLength[2],currentLength[0]};
+
+    int kPerm=0;
+    for ( int m=0 ; m<3 ; ++m ) {
+      for ( int coor=0 ; coor<3 ; ++coor )
+	derIprim1[m][coor]=0;
+      for ( int i=0 ; i<3 ; ++i ) {
+	if ((i==0 && m==1)||(i==1 && m==0)) kPerm=2;
+	if ((i==0 && m==2)||(i==2 && m==0)) kPerm=1;
+	if ((i==1 && m==2)||(i==2 && m==1)) kPerm=0;
+	if (i!=m) DiDm=-0.5*cotan[kPerm]/restingArea;
+	if (i==m) DiDm=0.25*restingLength[i]*restingLength[i] / (restingArea*restingArea);
+	for ( int coor=0 ; coor<3 ; ++coor )
+	  derIprim1[m][coor]=derIprim1[m][coor]+2*DiDm*position[m][coor];
+      }
+    }
+
+    double Iprim4=0;
+    for ( int i=0 ; i<3 ; ++i ) {
+      for ( int j=0 ; j<3 ; ++j ) {
+	if ((i==0 && j==1)||(i==1 && j==0)) kPerm=2;
+	if ((i==0 && j==2)||(i==2 && j==0)) kPerm=1;
+	if ((i==1 && j==2)||(i==2 && j==1)) kPerm=0;
+	if (i!=j) QiQj=Rcirc2-(length[kPerm]*length[kPerm])*0.5;
+	if (i==j) QiQj=Rcirc2;
+	aDi=0.5*std::cos(teta[i])*restingLength[i]/restingArea;
+	aDj=0.5*std::cos(teta[j])*restingLength[j]/restingArea;
+	Iprim4=Iprim4+ QiQj*aDi*aDj;
+      }
+    }
+
+    for ( int p=0 ; p<3 ; ++p ) {
+      for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=0;
+      for ( int m=0 ; m<3 ; ++m ) {
+	aDm=0.5*std::cos(teta[m])*restingLength[m]/restingArea;
+	for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=derIprim4[p][coor]+aDm*position[m][coor];
+      }
+      aDp=0.5*std::cos(teta[p])*restingLength[p]/restingArea;
+      for ( int coor=0 ; coor<3 ; ++coor ) derIprim4[p][coor]=2*aDp*derIprim4[p][coor];
+    }
+
+    for ( int p=0 ; p<3 ; ++p ) {
+      for ( int coor=0 ; coor<3 ; ++coor ) derIprim5[p][coor]=0;
+      for ( int n=0 ; n<3 ; ++n ) {
+	for ( int r=0 ; r<3 ; ++r ) {
+	  for ( int s=0 ; s<3 ; ++s ) {
+	    QrQs=position[r][0]*position[s][0]+position[r][1]*position[s][1]+position[r][2]*position[s][2];
+
+	    if ((n==0 && r==1)||(n==1 && r==0)) kPerm=2;
+	    if ((n==0 && r==2)||(n==2 && r==0)) kPerm=1;
+	    if ((n==1 && r==2)||(n==2 && r==1)) kPerm=0;
+	    if ( n!=r )  DnDr=-0.5*cotan[kPerm]/restingArea;
+	    if ( n==r )  DnDr=0.25*restingLength[n]*restingLength[n] / (restingArea*restingArea);
+
+	    if ((s==0 && p==1)||(s==1 && p==0)) kPerm=2;
+	    if ((s==0 && p==2)||(s==2 && p==0)) kPerm=1;
+	    if ((s==1 && p==2)||(s==2 && p==1)) kPerm=0;
+	    if ( s!=p ) DsDp=-0.5*cotan[kPerm]/restingArea;
+	    if ( s==p ) DsDp=0.25*restingLength[s]*restingLength[s] / (restingArea*restingArea);
+
+	    aDs=0.5*std::cos(teta[s])*restingLength[s]/restingArea;
+	    aDp=0.5*std::cos(teta[p])*restingLength[p]/restingArea;
+	    aDr=0.5*std::cos(teta[r])*restingLength[r]/restingArea;
+	    aDn=0.5*std::cos(teta[n])*restingLength[n]/restingArea;
+
+	    for ( int coor=0 ; coor<3 ; ++coor )
+	      derIprim5[p][coor] = derIprim5[p][coor] +
+		2*(DnDr*aDs*aDp+DsDp*aDr*aDn)*QrQs*position[n][coor];
+	  }
+	}
+      }
+    }
+
+    double derI1[3][3];             // Invariants and their derivatives
+    double derI4[3][3];
+    double derI5[3][3];
+
+    double I1=( Delta[1]*cotan[0]+ Delta[2]*cotan[1]+Delta[0]*cotan[2])/(4*restingArea);
+    double I4=0.5*Iprim4-0.5;
+
+    for ( int i=0 ; i<3 ; ++i )
+      for ( int j=0 ; j<3 ; ++j ) {
+	derI1[i][j]=0.5*derIprim1[i][j];
+	derI4[i][j]=0.5*derIprim4[i][j];
+	derI5[i][j]=0.25*derIprim5[i][j]-0.5*derIprim4[i][j];
+      }
+    for ( int i=0 ; i<3 ; ++i )
+      for ( int j=0 ; j<3 ; ++j )
+	deltaF[i][j]=(-deltaLam*(I4*derI1[i][j]+I1*derI4[i][j])-deltaMio*derI5[i][j]+(deltaMio+deltaLam)*I4*derI4[i][j])*restingArea;
+  }
+
+  ///
+  /// @brief Material policy with constant Young modulus and Poisson ratio
+  ///
+  class ConstantModulus {
+    double young_,poisson_;
+  public:
+    ConstantModulus(double young,double poisson) :
+      young_(young), poisson_(poisson) {}
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &young,double &poisson) const
+    {
+      young = young_;
+      poisson = poisson_;
+    }
+  };
+
+  ///
+  /// @brief Material policy with a Young modulus decreasing with a cell
+  /// concentration as @f$ Y_{min}+Y_{max}K^n/(K^n+c^n) @f$
+  ///
+  class HillModulus {
+    double youngMin_,youngMax_,poisson_,Kpow_,n_;
+    size_t concIndex_;
+  public:
+    HillModulus(double youngMin,double youngMax,double poisson,double K,
+		double n,size_t concIndex) :
+      youngMin_(youngMin), youngMax_(youngMax), poisson_(poisson),
+      Kpow_(std::pow(K,n)), n_(n), concIndex_(concIndex) {}
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &young,double &poisson) const
+    {
+      young = youngMin_ +
+	youngMax_*Kpow_/( Kpow_+std::pow(cellData[cellIndex][concIndex_],n_) );
+      poisson = poisson_;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy of the anisotropic (MT) reactions with unit
+  /// Young moduli
+  ///
+  /// @details A fiber policy gives the Young moduli along (youngL) and
+  /// across (youngT) the MT direction of a cell from the matrix and fiber
+  /// moduli, the longitudinal modulus stored at youngLIndex (e.g. by
+  /// FiberModel) and the fiber modulus stored at fiberIndex. adaptive marks
+  /// the policies whose reactions store the resting area and von Mises
+  /// stress instead of the area ratio and energies.
+  ///
+  class UnitFiber {
+  protected:
+    double youngMatrix_,youngFiber_;
+    size_t youngLIndex_,fiberIndex_;
+  public:
+    static const bool adaptive = false;
+    UnitFiber(double youngMatrix,double youngFiber,size_t youngLIndex,
+	      size_t fiberIndex) :
+      youngMatrix_(youngMatrix), youngFiber_(youngFiber),
+      youngLIndex_(youngLIndex), fiberIndex_(fiberIndex) {}
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = 1;
+      youngT = 1;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy with unit Young moduli and the adaptive storage
+  ///
+  class AdaptiveUnitFiber : public UnitFiber {
+  public:
+    static const bool adaptive = true;
+    using UnitFiber::UnitFiber;
+  };
+
+  ///
+  /// @brief Fiber policy with constant material anisotropy, youngL=Y_M+Y_F
+  /// and youngT=Y_M
+  ///
+  class ConstantFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = youngMatrix_+youngFiber_;
+      youngT = youngMatrix_;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy as ConstantFiber, but isotropic with half the
+  /// fibers in cells marked by 100 in cell variable 40
+  ///
+  class MarkedConstantFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = youngMatrix_+youngFiber_;
+      youngT = youngMatrix_;
+      if (cellData[cellIndex][40]==100) {
+	youngL = youngMatrix_+youngFiber_/2;
+	youngT = youngMatrix_+youngFiber_/2;
+      }
+    }
+  };
+
+  ///
+  /// @brief Fiber policy with the longitudinal modulus from the fiber
+  /// model, youngT=2Y_M+Y_F-youngL
+  ///
+  class ModelFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = cellData[cellIndex][youngLIndex_];
+      youngT = 2*youngMatrix_+youngFiber_-youngL;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy for varying anisotropy with constant total
+  /// stiffness (Y_M), youngL=Y_F and youngT=Y_M-Y_F
+  ///
+  class TotalStiffnessFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = youngFiber_;
+      youngT = youngMatrix_-youngL;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy for varying anisotropy with constant total
+  /// stiffness (Y_M) given the anisotropy Y_F
+  ///
+  class AnisotropyFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      double totalElast=youngMatrix_;
+      double Maniso=youngFiber_;
+      youngT = ((1-Maniso)/(2-Maniso))*totalElast;
+      youngL = totalElast-youngT;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy for the resolution adaptive stiffness of pavement
+  /// cells, with the cell fiber modulus at fiberIndex
+  ///
+  class AdaptiveFiber : public UnitFiber {
+  public:
+    static const bool adaptive = true;
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      double youngFiber = cellData[cellIndex][fiberIndex_];
+      double fiberL = cellData[cellIndex][youngLIndex_];
+      youngL = youngMatrix_+fiberL;
+      youngT = youngMatrix_+youngFiber-fiberL;
+    }
+  };
+
+  ///
+  /// @brief Fraction of the fibers remaining at the (auxin) concentration
+  /// in cell variable 13 (ad hoc Hill repression)
+  ///
+  inline double auxinFraction(const DataMatrix &cellData,size_t cellIndex)
+  {
+    double Kconc=0.005;
+    double Nc1=2;
+    double conc=cellData[cellIndex][13];
+    return (1-std::pow(conc,Nc1)/(std::pow(Kconc,Nc1)+std::pow(conc,Nc1)));
+  }
+
+  ///
+  /// @brief Fiber policy as ModelFiber with an auxin dependent loosening
+  /// of the whole wall
+  ///
+  class AuxinLooseningFiber : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = cellData[cellIndex][youngLIndex_];
+      youngT = 2*youngMatrix_+youngFiber_-youngL;
+      double frac=auxinFraction(cellData,cellIndex);
+      youngL*=0.25+0.75*frac;
+      youngT*=0.25+0.75*frac;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy as ModelFiber with the fibers removed by auxin
+  ///
+  class AuxinFiberRemoval : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = cellData[cellIndex][youngLIndex_]-youngMatrix_;
+      youngT = 2*youngMatrix_+youngFiber_-youngL-2*youngMatrix_;
+      double frac=auxinFraction(cellData,cellIndex);
+      youngL*=frac;
+      youngT*=frac;
+      youngL+=youngMatrix_;
+      youngT+=youngMatrix_;
+    }
+  };
+
+  ///
+  /// @brief Fiber policy as ModelFiber with the fibers and 80% of the
+  /// matrix removed by auxin
+  ///
+  class AuxinMatrixRemoval : public UnitFiber {
+  public:
+    using UnitFiber::UnitFiber;
+    inline void modulus(const DataMatrix &cellData,size_t cellIndex,
+			double &youngL,double &youngT) const
+    {
+      youngL = cellData[cellIndex][youngLIndex_]-youngMatrix_;
+      youngT = 2*youngMatrix_+youngFiber_-youngL-2*youngMatrix_;
+      double frac=auxinFraction(cellData,cellIndex);
+      youngL*=frac;
+      youngT*=frac;
+      youngL+=youngMatrix_*(0.2+0.8*frac);
+      youngT+=youngMatrix_*(0.2+0.8*frac);
+    }
+  };
+
+  ///
+  /// @brief Anisotropy policy reading the MT direction of a cell from the
+  /// cell variables at directionIndex
+  ///
+  /// @details An anisotropy policy sets the MT direction of a cell before
+  /// its elements are updated.
+  ///
+  class CellDirection {
+  public:
+    CellDirection(double angle,double alternativeAngle,size_t directionIndex) {}
+    inline void set(DataMatrix &cellData,size_t cellIndex) const {}
+  };
+
+  ///
+  /// @brief Anisotropy policy with an MT direction in the xy-plane given by
+  /// angle, and by alternativeAngle in cells 1 and 3
+  ///
+  class AngleDirection {
+    double angle_,alternativeAngle_;
+    size_t directionIndex_;
+  public:
+    AngleDirection(double angle,double alternativeAngle,size_t directionIndex) :
+      angle_(angle), alternativeAngle_(alternativeAngle),
+      directionIndex_(directionIndex) {}
+    inline void set(DataMatrix &cellData,size_t cellIndex) const
+    {
+      double angle = (cellIndex==1 || cellIndex==3) ? alternativeAngle_ : angle_;
+      cellData[cellIndex][directionIndex_]=std::cos(angle);
+      cellData[cellIndex][directionIndex_+1]=std::sin(angle);
+      cellData[cellIndex][directionIndex_+2]=0;
+    }
+  };
+
+  ///
+  /// @brief Resting length policy with one resting length per internal
+  /// edge and wall
+  ///
+  /// @details A resting length policy sets the resting lengths of element k
+  /// (com-vertex(k), wall(k), com-vertex(k+1)) of a cell with the internal
+  /// resting lengths from lengthInternalIndex.
+  ///
+  class SingleRestingLength {
+    size_t lengthInternalIndex_,wallLengthIndex_;
+  public:
+    SingleRestingLength(size_t lengthInternalIndex,size_t wallLengthIndex) :
+      lengthInternalIndex_(lengthInternalIndex),
+      wallLengthIndex_(wallLengthIndex) {}
+    inline void set(const DataMatrix &cellData,const DataMatrix &wallData,
+		    size_t cellIndex,size_t numWalls,size_t k,size_t w,
+		    double restingLength[3]) const
+    {
+      restingLength[0] = cellData[cellIndex][lengthInternalIndex_ + k];
+      restingLength[1] = wallData[w][wallLengthIndex_];
+      restingLength[2] = cellData[cellIndex][lengthInternalIndex_ + (k+1)%numWalls];
+    }
+  };
+
+  ///
+  /// @brief Resting length policy with independent resting lengths for the
+  /// two elements sharing an internal edge, and a cell specific addition to
+  /// the wall resting lengths
+  ///
+  class DoubleRestingLength {
+    size_t lengthInternalIndex_,wallLengthIndex_;
+  public:
+    DoubleRestingLength(size_t lengthInternalIndex,size_t wallLengthIndex) :
+      lengthInternalIndex_(lengthInternalIndex),
+      wallLengthIndex_(wallLengthIndex) {}
+    inline void set(const DataMatrix &cellData,const DataMatrix &wallData,
+		    size_t cellIndex,size_t numWalls,size_t k,size_t w,
+		    double restingLength[3]) const
+    {
+      restingLength[0] = cellData[cellIndex][lengthInternalIndex_ + 2*k+1];
+      restingLength[1] = wallData[w][wallLengthIndex_]+
+	cellData[cellIndex][lengthInternalIndex_+2*numWalls+k];
+      restingLength[2] = cellData[cellIndex][lengthInternalIndex_ + 2*((k+1)%numWalls)];
+    }
+  };
+
+  ///
+  /// @brief Output policy without strain/stress calculation
+  ///
+  class NoOutput {
+  public:
+    inline void beginCell() {}
+    inline void addElement(const Element &E,const double length[3],
+			   const double Delta[3],const DataMatrix &position,
+			   double lambda,double mio) {}
+    inline void endCell(DataMatrix &cellData,size_t cellIndex) {}
+  };
+
+  ///
+  /// @brief Output policy storing the maximal principal strain and/or stress
+  /// of each cell
+  ///
+  /// @details The (Almansi) strain and the isotropic true stress of each
+  /// element are rotated to the global frame and averaged over the cell
+  /// weighted by resting area. The eigenvector of the largest eigenvalue
+  /// followed by the value (four cell variables) is stored from strainIndex
+  /// and stressIndex (not stored if the index is size_t(-1)).
+  ///
+  class PrincipalOutput {
+    size_t strainIndex_,stressIndex_;
+    double strainCell_[3][3];
+    double stressCell_[3][3];
+    double totalRestingArea_;
+
+    static inline void principal(double tensor[3][3],double eigenVector[3][3],
+				 double &maximalValue,int &maximalIndex);
+  public:
+    PrincipalOutput(size_t strainIndex,size_t stressIndex) :
+      strainIndex_(strainIndex), stressIndex_(stressIndex) {}
+    inline void beginCell();
+    inline void addElement(const Element &E,const double length[3],
+			   const double Delta[3],const DataMatrix &position,
+			   double lambda,double mio);
+    inline void endCell(DataMatrix &cellData,size_t cellIndex);
+  };
+
+  ///
+  /// @brief Updates for a center triangulation, where each cell is divided
+  /// into one triangle per wall using the cell center (position at comIndex
+  /// and internal resting lengths following in the cell variables)
+  ///
+  /// The update of the cell center is added to the cell derivatives.
+  ///
+  template<class Material,class Output>
+  void centerTriangulationDerivs(Tissue &T,
+				 DataMatrix &cellData,
+				 DataMatrix &wallData,
+				 DataMatrix &vertexData,
+				 DataMatrix &cellDerivs,
+				 DataMatrix &vertexDerivs,
+				 size_t wallLengthIndex,
+				 size_t comIndex,
+				 const Material &material,
+				 Output &output,
+				 const char *id)
+  {
+    size_t dimension = 3;
+    assert (dimension==vertexData[0].size());
+    size_t numCells = T.numCell();
+    size_t lengthInternalIndex = comIndex+dimension;
+    DataMatrix position(3,std::vector<double>(dimension));
+    Element E;
+    // Index based connectivity (cell -> vertex/wall, wall -> vertex)
+    const TissueTopology &topology = T.topology();
+
+    for (size_t cellIndex=0 ; cellIndex<numCells ; ++cellIndex) {
+      size_t numWalls = topology.numCellWall(cellIndex);
+
+      if(  topology.numCellVertex(cellIndex)!= numWalls ) {
+	std::cerr << id << "::derivs() same number of vertices and walls."
+		  << " Not for cells with " << numWalls << " walls and "
+		  << topology.numCellVertex(cellIndex) << " vertices!"
+		  << std::endl;
+	exit(-1);
+      }
+
+      double young,poisson;
+      material.modulus(cellData,cellIndex,young,poisson);
+      // Lame coefficients
+      double lambda=young*poisson/(1-poisson*poisson);
+      double mio=young/(1+poisson);
+      output.beginCell();
+
+      // One triangle per 'vertex' in cyclic order
+      for (size_t k=0; k<numWalls; ++k) {
+	size_t kPlusOneMod = (k+1)%numWalls;
+	size_t v2 = topology.cellVertex(cellIndex,k);
+	size_t v3 = topology.cellVertex(cellIndex,kPlusOneMod);
+	size_t w2 = topology.cellWall(cellIndex,k);
+
+	// Position matrix holds in rows positions for com, vertex(k), vertex(k+1)
+	for (size_t d=0; d<dimension; ++d) {
+	  position[0][d] = cellData[cellIndex][comIndex+d]; // com position
+	  position[1][d] = vertexData[v2][d];
+	  position[2][d] = vertexData[v3][d];
+	}
+
+	// Resting lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
+	E.restingLength[0] = cellData[cellIndex][lengthInternalIndex + k];
+	E.restingLength[1] = wallData[w2][wallLengthIndex];
+	E.restingLength[2] = cellData[cellIndex][lengthInternalIndex + kPlusOneMod];
+
+	// Lengths are from com-vertex(k), vertex(k)-vertex(k+1) (wall(k)), com-vertex(k+1)
+	double length[3];
+	length[0] = std::sqrt( (position[0][0]-position[1][0])*(position[0][0]-position[1][0]) +
+			       (position[0][1]-position[1][1])*(position[0][1]-position[1][1]) +
+			       (position[0][2]-position[1][2])*(position[0][2]-position[1][2]) );
+	length[1] = topology.wallLength(w2,vertexData);
+	length[2] = std::sqrt( (position[0][0]-position[2][0])*(position[0][0]-position[2][0]) +
+			       (position[0][1]-position[2][1])*(position[0][1]-position[2][1]) +
+			       (position[0][2]-position[2][2])*(position[0][2]-position[2][2]) );
+
+	stiffness(lambda,mio,E);
+
+	//Calculate biquadratic strains
+	double Delta[3];
+	for (size_t i=0; i<3; ++i)
+	  Delta[i]=length[i]*length[i]-E.restingLength[i]*E.restingLength[i];
+
+	output.addElement(E,length,Delta,position,lambda,mio);
+
+	force(E,Delta,&position[0][0],&position[1][0],&position[2][0],dimension,
+	      &cellDerivs[cellIndex][comIndex],&vertexDerivs[v2][0],
+	      &vertexDerivs[v3][0]);
+      }
+      output.endCell(cellData,cellIndex);
+    }
+  }
+
+  inline void PrincipalOutput::beginCell()
+  {
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++)
+	strainCell_[r][s] = stressCell_[r][s] = 0.0;
+    totalRestingArea_ = 0.0;
+  }
+
+  inline void PrincipalOutput::addElement(const Element &E,
+					  const double length[3],
+					  const double Delta[3],
+					  const DataMatrix &position,
+					  double lambda,double mio)
+  {
+    const double *restingLength = E.restingLength;
+    double restingArea = E.restingArea;
+
+    //Area of the element (using Heron's formula)
+    double Area=std::sqrt( ( length[0]+length[1]+length[2])*
+			   (-length[0]+length[1]+length[2])*
+			   ( length[0]-length[1]+length[2])*
+			   ( length[0]+length[1]-length[2])  )*0.25;
+
+    //Current shape local coordinate of the element  (counterclockwise ordering of nodes/edges)
+    double CurrentAngle1=std::acos(  (length[0]*length[0]+length[1]*length[1]-length[2]*length[2])/
+				     (length[0]*length[1]*2)    );
+    double Qa=std::cos(CurrentAngle1)*length[0];
+    double Qc=std::sin(CurrentAngle1)*length[0];
+    double Qb=length[1];
+
+    //Resting shape vectors
+    double RestingAngle1=std::acos(  (restingLength[0]*restingLength[0]+restingLength[1]*restingLength[1]-restingLength[2]*restingLength[2])/
+				     (restingLength[0]*restingLength[1]*2)    );
+    double Pa=std::cos(RestingAngle1)*restingLength[0];
+    double Pc=std::sin(RestingAngle1)*restingLength[0];
+    double Pb=restingLength[1];
+    double ShapeVectorResting[3][3]={ {  0   ,       1/Pc      , 0 },
+				      {-1/Pb , (Pa-Pb)/(Pb*Pc) , 1 },
+				      { 1/Pb ,     -Pa/(Pb*Pc) , 0 }  };
+
+    double trE=( Delta[1]*E.cotan[0]+ Delta[2]*E.cotan[1]+Delta[0]*E.cotan[2])/(4*restingArea);
+
+    double positionLocal[3][2]={ {Qa , Qc},
+				 {0  , 0 },
+				 {Qb , 0 }  };
+
+    double DeformGrad[2][2]={{0,0},{0,0}}; // F= Qi x Di
+    for ( int i=0 ; i<3 ; ++i ) {
+      DeformGrad[0][0]=DeformGrad[0][0]+positionLocal[i][0]*ShapeVectorResting[i][0];
+      DeformGrad[1][0]=DeformGrad[1][0]+positionLocal[i][1]*ShapeVectorResting[i][0];
+      DeformGrad[0][1]=DeformGrad[0][1]+positionLocal[i][0]*ShapeVectorResting[i][1];
+      DeformGrad[1][1]=DeformGrad[1][1]+positionLocal[i][1]*ShapeVectorResting[i][1];
+    }
+
+    double LeftCauchy[2][2]; // B=FFt
+    LeftCauchy[0][0]=DeformGrad[0][0]*DeformGrad[0][0]+DeformGrad[0][1]*DeformGrad[0][1];
+    LeftCauchy[1][0]=DeformGrad[1][0]*DeformGrad[0][0]+DeformGrad[1][1]*DeformGrad[0][1];
+    LeftCauchy[0][1]=DeformGrad[0][0]*DeformGrad[1][0]+DeformGrad[0][1]*DeformGrad[1][1];
+    LeftCauchy[1][1]=DeformGrad[1][0]*DeformGrad[1][0]+DeformGrad[1][1]*DeformGrad[1][1];
+
+    double StrainAlmansi[2][2]; // e=0.5(1-B^-1)  True strain tensor
+    double temp=LeftCauchy[0][0]*LeftCauchy[1][1]-LeftCauchy[1][0]*LeftCauchy[0][1]; // det(B)
+    StrainAlmansi[0][0]=0.5*(1-(LeftCauchy[1][1]/temp));
+    StrainAlmansi[1][0]=0.5*LeftCauchy[1][0]/temp;
+    StrainAlmansi[0][1]=0.5*LeftCauchy[0][1]/temp;
+    StrainAlmansi[1][1]=0.5*(1-(LeftCauchy[0][0]/temp));
+
+    double B2[2][2];// LeftCauchy^2
+    B2[0][0]=LeftCauchy[0][0]*LeftCauchy[0][0]+LeftCauchy[0][1]*LeftCauchy[1][0];
+    B2[1][0]=LeftCauchy[1][0]*LeftCauchy[0][0]+LeftCauchy[1][1]*LeftCauchy[1][0];
+    B2[0][1]=LeftCauchy[0][0]*LeftCauchy[0][1]+LeftCauchy[0][1]*LeftCauchy[1][1];
+    B2[1][1]=LeftCauchy[1][0]*LeftCauchy[0][1]+LeftCauchy[1][1]*LeftCauchy[1][1];
+
+    double StressTensor[3][3]; // true stress tensor (isotropic term) based on lambdaT and mioT
+    StressTensor[0][0]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[0][0]+(mio/2)*B2[0][0]);
+    StressTensor[1][0]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[1][0]+(mio/2)*B2[1][0]);
+    StressTensor[0][1]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[0][1]+(mio/2)*B2[0][1]);
+    StressTensor[1][1]=(Area/restingArea)*((lambda*trE-mio/2)*LeftCauchy[1][1]+(mio/2)*B2[1][1]);
+
+    double StrainTensor[3][3]; // there are other alternatives than StrainAlmansi for strain tensor
+    StrainTensor[0][0]=StrainAlmansi[0][0];
+    StrainTensor[1][0]=StrainAlmansi[1][0];
+    StrainTensor[0][1]=StrainAlmansi[0][1];
+    StrainTensor[1][1]=StrainAlmansi[1][1];
+
+    // adding 3rd dimension which is zero, the tensor is still in element plane
+    StrainTensor[0][2]=StrainTensor[1][2]=StrainTensor[2][2]=0;
+    StrainTensor[2][0]=StrainTensor[2][1]=0;
+    StressTensor[0][2]=StressTensor[1][2]=StressTensor[2][2]=0;
+    StressTensor[2][0]=StressTensor[2][1]=0;
+
+    //Rotation from the element plane to the global frame
+    double tempA=std::sqrt((position[2][0]-position[1][0])*(position[2][0]-position[1][0])+
+			   (position[2][1]-position[1][1])*(position[2][1]-position[1][1])+
+			   (position[2][2]-position[1][2])*(position[2][2]-position[1][2])  );
+    double tempB=std::sqrt((position[0][0]-position[1][0])*(position[0][0]-position[1][0])+
+			   (position[0][1]-position[1][1])*(position[0][1]-position[1][1])+
+			   (position[0][2]-position[1][2])*(position[0][2]-position[1][2])  );
+
+    double Xcurrent[3];
+    Xcurrent[0]= (position[2][0]-position[1][0])/tempA;
+    Xcurrent[1]= (position[2][1]-position[1][1])/tempA;
+    Xcurrent[2]= (position[2][2]-position[1][2])/tempA;
+
+    double Bcurrent[3];
+    Bcurrent[0]= (position[0][0]-position[1][0])/tempB;
+    Bcurrent[1]= (position[0][1]-position[1][1])/tempB;
+    Bcurrent[2]= (position[0][2]-position[1][2])/tempB;
+
+    double Zcurrent[3];
+    Zcurrent[0]= Xcurrent[1]*Bcurrent[2]-Xcurrent[2]*Bcurrent[1];
+    Zcurrent[1]= Xcurrent[2]*Bcurrent[0]-Xcurrent[0]*Bcurrent[2];
+    Zcurrent[2]= Xcurrent[0]*Bcurrent[1]-Xcurrent[1]*Bcurrent[0];
+
+    tempA=std:: sqrt(Zcurrent[0]*Zcurrent[0]+Zcurrent[1]*Zcurrent[1]+Zcurrent[2]*Zcurrent[2]);
+    Zcurrent[0]=Zcurrent[0]/tempA;
+    Zcurrent[1]=Zcurrent[1]/tempA;
+    Zcurrent[2]=Zcurrent[2]/tempA;
+
+    double Ycurrent[3];
+    Ycurrent[0]= Zcurrent[1]*Xcurrent[2]-Zcurrent[2]*Xcurrent[1];
+    Ycurrent[1]= Zcurrent[2]*Xcurrent[0]-Zcurrent[0]*Xcurrent[2];
+    Ycurrent[2]= Zcurrent[0]*Xcurrent[1]-Zcurrent[1]*Xcurrent[0];
+
+    double rotation[3][3];
+    for (int r=0 ; r<3 ; r++) {
+      rotation[r][0]=Xcurrent[r];
+      rotation[r][1]=Ycurrent[r];
+      rotation[r][2]=Zcurrent[r];
+    }
+
+    double tempR[3][3]={{0,0,0},{0,0,0},{0,0,0}};
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++)
+	for(int w=0 ; w<3 ; w++)
+	  tempR[r][s]=tempR[r][s]+rotation[r][w]*StrainTensor[w][s];
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++) {
+	StrainTensor[r][s]=0;
+	for(int w=0 ; w<3 ; w++)
+	  StrainTensor[r][s]=StrainTensor[r][s]+tempR[r][w]*rotation[s][w];
+      }
+
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++)
+	tempR[r][s]=0;
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++)
+	for(int w=0 ; w<3 ; w++)
+	  tempR[r][s]=tempR[r][s]+rotation[r][w]*StressTensor[w][s];
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++) {
+	StressTensor[r][s]=0;
+	for(int w=0 ; w<3 ; w++)
+	  StressTensor[r][s]=StressTensor[r][s]+tempR[r][w]*rotation[s][w];
+      }
+
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++) {
+	strainCell_[r][s]= strainCell_[r][s]+restingArea*StrainTensor[r][s];
+	stressCell_[r][s]= stressCell_[r][s]+restingArea*StressTensor[r][s];
+      }
+    totalRestingArea_=totalRestingArea_+restingArea;
+  }
+
+  inline void PrincipalOutput::endCell(DataMatrix &cellData,size_t cellIndex)
+  {
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++) {
+	strainCell_[r][s]= strainCell_[r][s]/totalRestingArea_;
+	stressCell_[r][s]= stressCell_[r][s]/totalRestingArea_;
+      }
+    double eigenVector[3][3];
+    double maximalValue;
+    int maximalIndex;
+    size_t none = static_cast<size_t>(-1);
+    //Maximal value is stored after its eigenvector
+    if (strainIndex_!=none) {
+      principal(strainCell_,eigenVector,maximalValue,maximalIndex);
+      for (size_t d=0; d<3; ++d)
+	cellData[cellIndex][strainIndex_+d] = eigenVector[d][maximalIndex];
+      cellData[cellIndex][strainIndex_+3] = maximalValue;
+    }
+    if (stressIndex_!=none) {
+      principal(stressCell_,eigenVector,maximalValue,maximalIndex);
+      for (size_t d=0; d<3; ++d)
+	cellData[cellIndex][stressIndex_+d] = eigenVector[d][maximalIndex];
+      cellData[cellIndex][stressIndex_+3] = maximalValue;
+    }
+  }
+
+  inline void PrincipalOutput::principal(double tensor[3][3],
+					 double eigenVector[3][3],
+					 double &maximalValue,int &maximalIndex)
+  {
+    //Jacobi rotations diagonalizing the (symmetric) tensor
+    for (int r=0 ; r<3 ; r++)
+      for (int s=0 ; s<3 ; s++)
+	eigenVector[r][s] = r==s ? 1.0 : 0.0;
+    double pivot=1;
+    double pi=3.1415;
+    int I,J;
+    double RotAngle,Si,Co;
+    while (pivot>0.00001) {
+      pivot=std::fabs(tensor[1][0]);
+      I=1;
+      J=0;
+      if (std::fabs(tensor[2][0])>pivot) {
+	pivot=std::fabs(tensor[2][0]);
+	I=2;
+	J=0;
+      }
+      if (std::fabs(tensor[2][1])>pivot) {
+	pivot=std::fabs(tensor[2][1]);
+	I=2;
+	J=1;
+      }
+      if (std::fabs(tensor[I][I]-tensor[J][J])<0.00001) {
+	RotAngle=pi/4;
+      }
+      else {
+	RotAngle=0.5*std::atan((2*tensor[I][J])/(tensor[J][J]-tensor[I][I]));
+      }
+      Si=std::sin(RotAngle);
+      Co=std::cos(RotAngle);
+      double tempRot[3][3]={{1,0,0},{0,1,0},{0,0,1}};
+      tempRot[I][I]=Co;
+      tempRot[J][J]=Co;
+      tempRot[I][J]=Si;
+      tempRot[J][I]=-Si;
+      double temp[3][3]={{0,0,0},{0,0,0},{0,0,0}};
+      for (int r=0 ; r<3 ; r++)
+	for (int s=0 ; s<3 ; s++)
+	  for(int w=0 ; w<3 ; w++)
+	    temp[r][s]=temp[r][s]+tensor[r][w]*tempRot[w][s];
+      for (int r=0 ; r<3 ; r++)
+	for (int s=0 ; s<3 ; s++) {
+	  tensor[r][s]=0;
+	  for(int w=0 ; w<3 ; w++)
+	    tensor[r][s]=tensor[r][s]+tempRot[w][r]*temp[w][s];
+	}
+      for (int r=0 ; r<3 ; r++)
+	for (int s=0 ; s<3 ; s++)
+	  temp[r][s]=eigenVector[r][s];
+      for (int r=0 ; r<3 ; r++)
+	for (int s=0 ; s<3 ; s++) {
+	  eigenVector[r][s]=0;
+	  for(int w=0 ; w<3 ; w++)
+	    eigenVector[r][s]=eigenVector[r][s]+temp[r][w]*tempRot[w][s];
+	}
+    }
+    maximalValue=tensor[0][0];
+    maximalIndex=0;
+    for (int r=1 ; r<3 ; r++)
+      if (tensor[r][r]>maximalValue) {
+	maximalValue=tensor[r][r];
+	maximalIndex=r;
+      }
+  }
+
+} // namespace TRBS
+
+#endif
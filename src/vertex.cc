@@ -5,6 +5,7 @@
 // Created      : April 2006
 // Revision     : $Id$
 //
+#include <assert.h>
 #include <cmath>
 #include <cstdlib>
 #include <vector>
@@ -13,7 +14,8 @@
 #include "vertex.h"
 #include "wall.h"
 
-Vertex::Vertex() 
+Vertex::Vertex() :
+  positionStore_(0)
 {
 }
 
@@ -21,7 +23,8 @@ Vertex::Vertex( const Vertex & vertexCopy )
 {
   index_ = vertexCopy.index();
   id_ = vertexCopy.id();
-  position_ = vertexCopy.position();
+  positionStore_ = vertexCopy.positionStore_;
+  position_ = vertexCopy.position_;
   cell_ = vertexCopy.cell();
   wall_ = vertexCopy.wall();
   stressDirection_ = vertexCopy.stressDirection();
@@ -31,6 +34,7 @@ Vertex::
 Vertex( const std::vector<double> &position, size_t indexVal )
 {
   position_ = position;
+  positionStore_ = 0;
   index_ = indexVal;
   id_ = "";
   //cell_ = vertexCopy.cell();
@@ -42,6 +46,21 @@ Vertex::~Vertex()
 {
 }
 
+void Vertex::bindPosition(DataMatrix &data)
+{
+  assert( index_<data.size() );
+  positionStore_ = &data;
+  std::vector<double>().swap(position_);
+}
+
+void Vertex::unbindPosition()
+{
+  if( !positionStore_ )
+    return;
+  position_ = (*positionStore_)[index_];
+  positionStore_ = 0;
+}
+
 int Vertex::removeCell( Cell* val ) 
 {
   for (size_t k=0; k<cell_.size(); ++k)
@@ -14,6 +14,7 @@
 #include<iostream>
 #include<fstream>
 #include"myTypedefs.h"
+#include"smallVector.h"
 
 class Cell;
 class Wall;
@@ -23,18 +24,33 @@ class Wall;
 ///
 class Vertex {
   
+ public:
+  
+  ///
+  /// @brief Containers for the cell and wall neighbors, holding up to four
+  /// elements inline
+  ///
+  /// @see SmallVector
+  ///
+  typedef SmallVector<Cell*,4> CellList;
+  typedef SmallVector<Wall*,4> WallList;
+  
  private:
   
   size_t index_;
   std::string id_;           
   
-  std::vector<Cell*> cell_;
-  std::vector<Wall*> wall_;
+  CellList cell_;
+  WallList wall_;
   
   std::vector<double> position_;
+  DataMatrix *positionStore_;
   
   std::vector<double> stressDirection_;
   
+  inline std::vector<double> & positionRef();
+  inline const std::vector<double> & positionRef() const;
+  
  public:
   
   Vertex();
@@ -82,7 +98,7 @@ class Vertex {
   ///
   /// @see Cell
   ///
-  inline const std::vector<Cell*> & cell() const;
+  inline const CellList & cell() const;
   ///
   /// @brief Returns the cell pointer from position k in the Cell vector for the vertex.
   ///
@@ -97,7 +113,7 @@ class Vertex {
   /// 
   /// @see Wall
   ///
-  inline const std::vector<Wall*> & wall() const;
+  inline const WallList & wall() const;
   ///
   /// @brief Returns the wall pointer from position k in the Wall vector for the Vertex.
   ///
@@ -192,6 +208,23 @@ class Vertex {
   ///
   inline void setPosition(size_t d, double pos);
   ///
+  /// @brief Lets the position refer to row index() of data
+  ///
+  /// @details While bound the position is read and written in the row (e.g.
+  /// of BaseSolver::vertexData_), and the vertex does not store its own copy.
+  ///
+  /// @see Cell::bindVariable()
+  ///
+  void bindPosition(DataMatrix &data);
+  ///
+  /// @brief Copies the row back into the vertex and ends the binding
+  ///
+  void unbindPosition();
+  ///
+  /// @brief Returns true if the position refers to external data
+  ///
+  inline int positionBound() const;
+  ///
   /// @brief Check if the vertex is at the boundary of the tissue.
   ///
   /// A boundary vertex is defined from whether any of the connected walls is
@@ -236,13 +269,13 @@ inline size_t Vertex::index() const { return index_; }
 inline std::string Vertex::id() const { return id_; }
 inline size_t Vertex::numCell() const { return cell_.size(); }
 inline size_t Vertex::numWall() const { return wall_.size(); }
-inline size_t Vertex::numPosition() const { return position_.size(); }
-inline const std::vector<Cell*> & Vertex::cell() const { return cell_; }
+inline size_t Vertex::numPosition() const { return positionRef().size(); }
+inline const Vertex::CellList & Vertex::cell() const { return cell_; }
 inline Cell* Vertex::cell( size_t k ) { return cell_[k]; }
-inline const std::vector<Wall*> & Vertex::wall() const { return wall_; }
+inline const Vertex::WallList & Vertex::wall() const { return wall_; }
 inline Wall* Vertex::wall( size_t k ) const { return wall_[k]; }
-inline const std::vector<double> & Vertex::position() const { return position_; }
-inline double Vertex::position(size_t d) const { return position_[d]; }
+inline const std::vector<double> & Vertex::position() const { return positionRef(); }
+inline double Vertex::position(size_t d) const { return positionRef()[d]; }
 inline void Vertex::setIndex( size_t value ) { index_ = value; }
 inline void Vertex::setCell( size_t index,Cell* val ) { cell_[index]=val; }
 inline void Vertex::setCell( std::vector<Cell*> &val ) { cell_=val; }
@@ -250,7 +283,18 @@ inline void Vertex::addCell( Cell* val ) { cell_.push_back(val); }
 inline void Vertex::setWall( size_t index,Wall* val ) { wall_[index]=val; }
 inline void Vertex::setWall( std::vector<Wall*> &val ) { wall_=val; }
 inline void Vertex::addWall( Wall* val ) { wall_.push_back(val); }
-inline void Vertex::setPosition(std::vector<double> &pos) { position_=pos; }
-inline void Vertex::setPosition(size_t d,double pos) { position_[d]=pos; }
+inline void Vertex::setPosition(std::vector<double> &pos) { positionRef()=pos; }
+inline void Vertex::setPosition(size_t d,double pos) { positionRef()[d]=pos; }
+inline int Vertex::positionBound() const { return positionStore_!=0; }
+
+inline std::vector<double> & Vertex::positionRef()
+{
+  return positionStore_ ? (*positionStore_)[index_] : position_;
+}
+
+inline const std::vector<double> & Vertex::positionRef() const
+{
+  return positionStore_ ? (*positionStore_)[index_] : position_;
+}
 
 #endif
@@ -0,0 +1,96 @@
+//
+// Filename     : vertexJacobian.cc
+// Description  : Block sparse Jacobian of the vertex derivatives with respect to the vertex positions
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+#include <algorithm>
+#include <cmath>
+#include "vertexJacobian.h"
+
+VertexJacobian::VertexJacobian() :
+  dimension_(0)
+{
+}
+
+void VertexJacobian::resize(size_t numVertex,size_t dimension)
+{
+  dimension_ = dimension;
+  column_.assign(numVertex,std::vector<size_t>());
+  value_.assign(numVertex,std::vector<double>());
+}
+
+void VertexJacobian::clear()
+{
+  for( size_t a=0 ; a<value_.size() ; ++a )
+    std::fill(value_[a].begin(),value_[a].end(),0.0);
+}
+
+double* VertexJacobian::block(size_t a,size_t b)
+{
+  size_t blockSize = dimension_*dimension_;
+  std::vector<size_t> &col = column_[a];
+  std::vector<size_t>::iterator it = std::lower_bound(col.begin(),col.end(),b);
+  size_t k = it-col.begin();
+  if( it==col.end() || *it!=b ) {
+    col.insert(it,b);
+    value_[a].insert(value_[a].begin()+k*blockSize,blockSize,0.0);
+  }
+  return &value_[a][k*blockSize];
+}
+
+const double* VertexJacobian::find(size_t a,size_t b) const
+{
+  const std::vector<size_t> &col = column_[a];
+  std::vector<size_t>::const_iterator it =
+    std::lower_bound(col.begin(),col.end(),b);
+  if( it==col.end() || *it!=b )
+    return 0;
+  return &value_[a][(it-col.begin())*dimension_*dimension_];
+}
+
+void VertexJacobian::multiply(const DataMatrix &x,DataMatrix &y) const
+{
+  for( size_t a=0 ; a<column_.size() ; ++a ) {
+    std::fill(y[a].begin(),y[a].begin()+dimension_,0.0);
+    for( size_t k=0 ; k<column_[a].size() ; ++k ) {
+      const double *J = value(a,k);
+      const std::vector<double> &xb = x[column_[a][k]];
+      for( size_t i=0 ; i<dimension_ ; ++i )
+	for( size_t j=0 ; j<dimension_ ; ++j )
+	  y[a][i] += J[i*dimension_+j]*xb[j];
+    }
+  }
+}
+
+double VertexJacobian::maxDifference(const VertexJacobian &other,
+				     double &maxValue) const
+{
+  size_t blockSize = dimension_*dimension_;
+  double maxDiff=0.0;
+  maxValue=0.0;
+  const VertexJacobian *J[2] = {this,&other};
+  for( size_t n=0 ; n<2 ; ++n )
+    for( size_t a=0 ; a<J[n]->numVertex() ; ++a )
+      for( size_t k=0 ; k<J[n]->numColumn(a) ; ++k ) {
+	const double *A = J[n]->value(a,k);
+	const double *B = J[1-n]->find(a,J[n]->column(a,k));
+	for( size_t l=0 ; l<blockSize ; ++l ) {
+	  double diff = std::fabs(A[l]-(B ? B[l] : 0.0));
+	  if( diff>maxDiff )
+	    maxDiff = diff;
+	  if( std::fabs(A[l])>maxValue )
+	    maxValue = std::fabs(A[l]);
+	}
+      }
+  return maxDiff;
+}
+
+size_t VertexJacobian::numBlock() const
+{
+  size_t n=0;
+  for( size_t a=0 ; a<column_.size() ; ++a )
+    n += column_[a].size();
+  return n;
+}
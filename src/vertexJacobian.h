@@ -0,0 +1,118 @@
+#ifndef VERTEXJACOBIAN_H
+#define VERTEXJACOBIAN_H
+//
+// Filename     : vertexJacobian.h
+// Description  : Block sparse Jacobian of the vertex derivatives with respect to the vertex positions
+// Author(s)    : Henrik Jonsson (henrik.jonsson@slcu.cam.ac.uk)
+// Created      : October 2026
+// Revision     : $Id:$
+//
+
+#include <cstddef>
+#include <vector>
+#include "myTypedefs.h"
+
+///
+/// @brief Block sparse matrix of the vertex derivatives with respect to the
+/// vertex positions
+///
+/// @details Rows and columns are keyed by vertex index, and each stored
+/// block (a,b) is a dimension x dimension matrix (row major) with
+/// @f[ J_{ab}[i][j] = \frac{\partial \dot{x}_{a,i}}{\partial x_{b,j}}. @f]
+/// For mechanical reactions (where the vertex derivatives are the forces)
+/// this is minus the stiffness (Hessian of the energy). The column vertices
+/// of each row are kept sorted, and clear() keeps the sparsity pattern such
+/// that an assembly repeated on the same topology does not allocate.
+///
+/// @see BaseReaction::vertexJacobian()
+/// @see Tissue::vertexJacobian()
+///
+class VertexJacobian {
+
+ private:
+
+  size_t dimension_;
+  std::vector< std::vector<size_t> > column_;
+  std::vector< std::vector<double> > value_;
+
+ public:
+
+  VertexJacobian();
+  ///
+  /// @brief Removes all blocks and sets the number of vertices and the
+  /// dimension of the blocks
+  ///
+  void resize(size_t numVertex,size_t dimension);
+  ///
+  /// @brief Sets all stored blocks to zero (keeping the pattern)
+  ///
+  void clear();
+  ///
+  /// @brief Returns block (a,b), which is added (as zero) if not stored
+  ///
+  /// The pointer is valid until another block is added to row a.
+  ///
+  double* block(size_t a,size_t b);
+  ///
+  /// @brief Returns block (a,b) or 0 if not stored
+  ///
+  const double* find(size_t a,size_t b) const;
+  ///
+  /// @brief Adds value to element (i,j) of block (a,b)
+  ///
+  inline void add(size_t a,size_t b,size_t i,size_t j,double value);
+  ///
+  /// @brief Calculates y = J x for vertex matrices x and y
+  ///
+  void multiply(const DataMatrix &x,DataMatrix &y) const;
+  ///
+  /// @brief Returns the maximal absolute difference to other over the blocks
+  /// stored in any of them, and the maximal absolute element in maxValue
+  ///
+  double maxDifference(const VertexJacobian &other,double &maxValue) const;
+  inline size_t numVertex() const;
+  inline size_t dimension() const;
+  ///
+  /// @brief Returns the number of stored blocks
+  ///
+  size_t numBlock() const;
+  ///
+  /// @brief Returns the number of stored blocks in row a
+  ///
+  inline size_t numColumn(size_t a) const;
+  ///
+  /// @brief Returns the column vertex of the k-th stored block in row a
+  ///
+  inline size_t column(size_t a,size_t k) const;
+  ///
+  /// @brief Returns the k-th stored block in row a
+  ///
+  inline const double* value(size_t a,size_t k) const;
+};
+
+inline void VertexJacobian::add(size_t a,size_t b,size_t i,size_t j,
+				double value)
+{
+  block(a,b)[i*dimension_+j] += value;
+}
+
+inline size_t VertexJacobian::numVertex() const { return column_.size(); }
+
+inline size_t VertexJacobian::dimension() const { return dimension_; }
+
+inline size_t VertexJacobian::numColumn(size_t a) const
+{
+  return column_[a].size();
+}
+
+inline size_t VertexJacobian::column(size_t a,size_t k) const
+{
+  return column_[a][k];
+}
+
+inline const double* VertexJacobian::value(size_t a,size_t k) const
+{
+  return &value_[a][k*dimension_*dimension_];
+}
+
+#endif
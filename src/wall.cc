@@ -6,6 +6,7 @@
 // Revision     : $Id$
 //
 
+#include<assert.h>
 #include"wall.h"
 #include<cmath>  
 
@@ -14,27 +15,44 @@ Wall::Wall() {
 
   cellSort_.first = 0;
   cellSort_.second = 0;
+  variableStore_ = 0;
 }
 
 Wall::Wall( const Wall& wallCopy ) {
 
   index_ = wallCopy.index();
   id_ = wallCopy.id();
-  length_ = wallCopy.length();
+  variableStore_ = wallCopy.variableStore_;
+  length_ = wallCopy.length_;
   cell_.first = wallCopy.cell1();
   cell_.second = wallCopy.cell2();
   cellSort_.first = wallCopy.cellSort1();
   cellSort_.second = wallCopy.cellSort2();
   vertex_.first = wallCopy.vertex1();
   vertex_.second = wallCopy.vertex2();
-  variable_.resize(wallCopy.numVariable());
-  for( size_t i=0 ; i<variable_.size() ; ++i )
-    variable_[i] = wallCopy.variable(i);
+  variable_ = wallCopy.variable_;
 }
   
 Wall::~Wall() {
 }
 
+void Wall::bindVariable(DataMatrix &data)
+{
+  assert( index_<data.size() && data[index_].size() );
+  variableStore_ = &data;
+  std::vector<double>().swap(variable_);
+}
+
+void Wall::unbindVariable()
+{
+  if( !variableStore_ )
+    return;
+  const std::vector<double> &row = (*variableStore_)[index_];
+  length_ = row[0];
+  variable_.assign(row.begin()+1,row.end());
+  variableStore_ = 0;
+}
+
 double Wall::setLengthFromVertexPosition() {
   size_t dimension = vertex1()->numPosition();
   double distance=0.0;
@@ -71,7 +89,7 @@ lengthFromVertexPosition()
 }
 
 double Wall::
-lengthFromVertexPosition( DataMatrix &vertexData)
+lengthFromVertexPosition( const DataMatrix &vertexData)
 {
   size_t dimension = vertex1()->numPosition();
   size_t v1I=vertex1()->index();
@@ -8,6 +8,7 @@
 #ifndef WALL_H
 #define WALL_H
 
+#include<algorithm>
 #include<utility>
 #include<vector>
 #include<string>
@@ -40,6 +41,7 @@ class Wall {
   std::pair<Vertex*,Vertex*> vertex_;
   double length_;
   std::vector<double> variable_;
+  DataMatrix *variableStore_;
   
  public:
   
@@ -139,7 +141,7 @@ class Wall {
   ///
   /// @brief Returns the wall length calculated from the vertex positions in vertexData
   ///
-  double lengthFromVertexPosition( DataMatrix 
+  double lengthFromVertexPosition( const DataMatrix 
 				   &vertexData);
   ///
   /// @brief Returns the number of variables stored by the Wall.
@@ -165,6 +167,24 @@ class Wall {
   /// @brief Adds a new variable to the variable vector
   ///
   inline void addVariable(double val);
+  ///
+  /// @brief Lets the length and variables refer to row index() of data
+  ///
+  /// @details The row holds the length followed by the variables (as
+  /// BaseSolver::wallData_). While bound the wall does not store its own
+  /// copy, and the row has to follow the wall index.
+  ///
+  /// @see Cell::bindVariable()
+  ///
+  void bindVariable(DataMatrix &data);
+  ///
+  /// @brief Copies the row back into the wall and ends the binding
+  ///
+  void unbindVariable();
+  ///
+  /// @brief Returns true if the length and variables refer to external data
+  ///
+  inline int variableBound() const;
   
   //!Sets the index variable
   inline void setIndex( size_t value );
@@ -278,28 +298,57 @@ inline Vertex* Wall::vertex2() const {
   return vertex_.second;
 }
 
-inline double Wall::length() const { return length_; }
+inline double Wall::length() const
+{
+  return variableStore_ ? (*variableStore_)[index_][0] : length_;
+}
 
-inline size_t Wall::numVariable() const { return variable_.size(); }
+inline size_t Wall::numVariable() const
+{
+  return variableStore_ ? (*variableStore_)[index_].size()-1 :
+    variable_.size();
+}
 
 inline size_t Wall::setNumVariable(size_t n) { 
+  if( variableStore_ ) {
+    (*variableStore_)[index_].resize(n+1); return n; }
   variable_.resize(n); return variable_.size(); }
 
-inline double Wall::variable(size_t i) const { return variable_[i];}
+inline double Wall::variable(size_t i) const
+{
+  return variableStore_ ? (*variableStore_)[index_][i+1] : variable_[i];
+}
 
 inline void Wall::setVariable(size_t iVal,double val)
 {
-	variable_[iVal] = val;
+	if( variableStore_ )
+		(*variableStore_)[index_][iVal+1] = val;
+	else
+		variable_[iVal] = val;
 }
 
 inline void Wall::setVariable(std::vector<double> variable)
 {
-	variable_ = variable;
+	if( variableStore_ ) {
+		std::vector<double> &row = (*variableStore_)[index_];
+		row.resize(variable.size()+1);
+		std::copy(variable.begin(),variable.end(),row.begin()+1);
+	}
+	else
+		variable_ = variable;
 }
 
 inline void Wall::addVariable(double val)
 {
-	variable_.push_back(val);
+	if( variableStore_ )
+		(*variableStore_)[index_].push_back(val);
+	else
+		variable_.push_back(val);
+}
+
+inline int Wall::variableBound() const
+{
+  return variableStore_!=0;
 }
 
 inline void Wall::setIndex( size_t value ) { index_ = value; }
@@ -357,7 +406,13 @@ inline int Wall::hasVertex( Vertex *val )
 	return 0;
 }
 
-inline void Wall::setLength(double val) { length_=val; }
+inline void Wall::setLength(double val)
+{
+  if( variableStore_ )
+    (*variableStore_)[index_][0] = val;
+  else
+    length_=val;
+}
 
 
 #endif